@@ -0,0 +1,115 @@
+#include "AABB.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Constrói uma caixa vazia
+AABB::AABB()
+{
+	this->min = Vector3(INFINITY, INFINITY, INFINITY);
+	this->max = Vector3(-INFINITY, -INFINITY, -INFINITY);
+}
+
+// Constrói a caixa com os cantos dados
+AABB::AABB(Vector3 min, Vector3 max)
+{
+	this->min = min;
+	this->max = max;
+}
+
+// Aumenta a caixa para conter um ponto
+void AABB::expand(const Vector3& point)
+{
+	this->min = this->min.cwiseMin(point);
+	this->max = this->max.cwiseMax(point);
+}
+
+// Aumenta a caixa para conter outra caixa
+void AABB::expand(const AABB& box)
+{
+	this->min = this->min.cwiseMin(box.min);
+	this->max = this->max.cwiseMax(box.max);
+}
+
+// Aumenta a caixa para conter um disco
+void AABB::expandDisc(const Vector3& center, const Vector3& normal, Scalar radius)
+{
+	Vector3 n = normal.normalized();
+	Vector3 e;
+
+	for (int i = 0; i < 3; i++)
+	{
+		e[i] = radius * std::sqrt(std::max<Scalar>(0, 1 - n[i] * n[i]));
+	}
+
+	this->expand(AABB(center - e, center + e));
+}
+
+// Centro da caixa
+Vector3 AABB::centroid() const
+{
+	return (this->min + this->max) / 2;
+}
+
+// Área da superfície da caixa
+Scalar AABB::surfaceArea() const
+{
+	Vector3 d = this->max - this->min;
+
+	if (d[0] < 0 || d[1] < 0 || d[2] < 0)
+	{
+		return 0;
+	}
+
+	return 2 * (d[0] * d[1] + d[1] * d[2] + d[2] * d[0]);
+}
+
+/**
+ * @brief Teste de slabs: intersecta o raio com os três pares de planos da caixa
+ * e verifica se os intervalos de entrada e saída se sobrepõem.
+ */
+bool AABB::intersect(const Vector3& origin, const Vector3& invDir, Scalar sMax, Scalar* sNear) const
+{
+	Scalar tNear = 0;
+	Scalar tFar = sMax;
+
+	for (int i = 0; i < 3; i++)
+	{
+		Scalar t1 = (this->min[i] - origin[i]) * invDir[i];
+		Scalar t2 = (this->max[i] - origin[i]) * invDir[i];
+
+		// std::min/max com NaN (raio paralelo sobre a face) preservam o intervalo atual
+		tNear = std::max(tNear, std::min(t1, t2));
+
+		// Folga para o erro de arredondamento: raios que passam rente a uma aresta,
+		// ou atingem um ponto sobre a própria face, não podem ser descartados
+		Scalar far = std::max(t1, t2) * (1 + 4 * std::numeric_limits<Scalar>::epsilon());
+		tFar = std::min(tFar, far);
+	}
+
+	*sNear = tNear;
+	return tNear <= tFar;
+}
+
+/**
+ * @brief Teste de slabs com os sinais do raio: em cada eixo, o plano de entrada é o de
+ * min quando a direção é positiva e o de max quando é negativa.
+ */
+bool AABB::intersect(const Ray& ray, Scalar tMax, Scalar* tNear) const
+{
+	Scalar tEntry = ray.tMin;
+	Scalar tExit = tMax;
+
+	for (int i = 0; i < 3; i++)
+	{
+		Scalar t1 = ((ray.sign[i] ? this->max[i] : this->min[i]) - ray.initialPoint[i]) * ray.invDirection[i];
+		Scalar t2 = ((ray.sign[i] ? this->min[i] : this->max[i]) - ray.initialPoint[i]) * ray.invDirection[i];
+
+		// Como na outra versão, um NaN (raio paralelo sobre a face) preserva o intervalo atual
+		tEntry = std::max(tEntry, t1);
+		tExit = std::min(tExit, t2 * (1 + 4 * std::numeric_limits<Scalar>::epsilon()));
+	}
+
+	*tNear = tEntry;
+	return tEntry <= tExit;
+}
@@ -0,0 +1,96 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+
+#include "Ray.h"
+#include "Scalar.h"
+
+#ifndef AABB_H
+#define AABB_H
+
+/**
+ * @brief Caixa delimitadora alinhada aos eixos.
+ *
+ * Usada pela BVH para descartar rapidamente grupos de objetos que o raio não atinge.
+ */
+class AABB
+{
+public:
+	Vector3 min; /**< Canto mínimo da caixa */
+	Vector3 max; /**< Canto máximo da caixa */
+
+	/**
+	 * @brief Constrói uma caixa vazia (que não contém nenhum ponto).
+	 */
+	AABB();
+
+	/**
+	 * @brief Constrói a caixa com os cantos dados.
+	 *
+	 * @param min Canto mínimo.
+	 * @param max Canto máximo.
+	 */
+	AABB(Vector3 min, Vector3 max);
+
+	/**
+	 * @brief Aumenta a caixa para conter um ponto.
+	 *
+	 * @param point O ponto.
+	 */
+	void expand(const Vector3& point);
+
+	/**
+	 * @brief Aumenta a caixa para conter outra caixa.
+	 *
+	 * @param box A outra caixa.
+	 */
+	void expand(const AABB& box);
+
+	/**
+	 * @brief Aumenta a caixa para conter um disco.
+	 *
+	 * A extensão do disco no eixo i é radius * sqrt(1 - normal[i]^2), o que dá a caixa exata
+	 * do disco (e, juntando duas tampas, a do cilindro).
+	 *
+	 * @param center Centro do disco.
+	 * @param normal Normal do plano do disco.
+	 * @param radius Raio do disco.
+	 */
+	void expandDisc(const Vector3& center, const Vector3& normal, Scalar radius);
+
+	/**
+	 * @brief Centro da caixa.
+	 */
+	Vector3 centroid() const;
+
+	/**
+	 * @brief Área da superfície da caixa (0 para caixas vazias).
+	 */
+	Scalar surfaceArea() const;
+
+	/**
+	 * @brief Teste de slabs entre um raio e a caixa.
+	 *
+	 * O raio é dado na forma origin + s * dir, com s >= 0 à frente do raio.
+	 *
+	 * @param origin Origem do raio.
+	 * @param invDir Inverso (componente a componente) da direção do raio.
+	 * @param sMax Maior distância de interesse.
+	 * @param sNear Ponteiro para armazenar a distância de entrada na caixa.
+	 * @return true se o raio atravessa a caixa em [0, sMax].
+	 */
+	bool intersect(const Vector3& origin, const Vector3& invDir, Scalar sMax, Scalar* sNear) const;
+
+	/**
+	 * @brief Teste de slabs com o inverso e os sinais pré-calculados do raio.
+	 *
+	 * Os sinais escolhem de antemão qual plano de cada par é o de entrada, dispensando o
+	 * min/max da outra versão; o intervalo começa em ray.tMin.
+	 *
+	 * @param ray O raio.
+	 * @param tMax Maior distância de interesse (ray.tMax, ou a interseção mais próxima já encontrada).
+	 * @param tNear Ponteiro para armazenar a distância de entrada na caixa.
+	 * @return true se o raio atravessa a caixa em [ray.tMin, tMax].
+	 */
+	bool intersect(const Ray& ray, Scalar tMax, Scalar* tNear) const;
+};
+
+#endif
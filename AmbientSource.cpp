@@ -5,15 +5,16 @@
  * 
  * @param intensity Intensidade da fonte de luz ambiente.
  */
-AmbientSource::AmbientSource(Eigen::Vector3d intensity)
+AmbientSource::AmbientSource(Vector3 intensity)
 {
 	this->intensity = intensity;
-	this->origin = Eigen::Vector3d(0, 0, 0);
+	this->origin = Vector3(0, 0, 0);
+	this->type = AMBIENT;
 }
 
-Eigen::Vector3d AmbientSource::getDirection(Eigen::Vector3d pInt)
+Vector3 AmbientSource::getDirection(Vector3 pInt)
 {
-	Eigen::Vector3d placeholder(0, 0, 0);
+	Vector3 placeholder(0, 0, 0);
 	return placeholder;
 }
 
@@ -32,14 +33,14 @@ Eigen::Vector3d AmbientSource::getDirection(Eigen::Vector3d pInt)
  * @param specularIndex Índice de especularidade.
  * @param shadowed Indica se a superfície está em sombra.
  */
-void AmbientSource::computeIntensity(Eigen::Vector3d pInt, Ray ray, Eigen::Vector3d* ptrIntensityAmbient, Eigen::Vector3d* ptrIntensityDifuse, Eigen::Vector3d* ptrIntensitySpecular, 
-	Eigen::Vector3d normal, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex, bool shadowed)
+void AmbientSource::computeIntensity(Vector3 pInt, const Ray& ray, Vector3* ptrIntensityAmbient, Vector3* ptrIntensityDifuse, Vector3* ptrIntensitySpecular, 
+	Vector3 normal, Vector3 kAmbient, Vector3 kDif, Vector3 kEsp, int specularIndex, bool shadowed)
 {
 	
-	Eigen::Vector3d temp = ((this->intensity).cwiseProduct(kAmbient));
+	Vector3 temp = ((this->intensity).cwiseProduct(kAmbient));
 
 
-	Eigen::Vector3d intensityAmbient = *ptrIntensityAmbient;
+	Vector3 intensityAmbient = *ptrIntensityAmbient;
 
 	// Soma as intensidades
 	intensityAmbient[0] += temp[0] > 0 ? temp[0] : 0;
@@ -49,14 +50,19 @@ void AmbientSource::computeIntensity(Eigen::Vector3d pInt, Ray ray, Eigen::Vecto
 	*ptrIntensityAmbient = intensityAmbient;
 }
 
-void AmbientSource::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void AmbientSource::convertToCamera(Matrix4 transformationMatrix)
 {	
 	// Converte a origem para coordenadas de câmera
-	Eigen::Vector4d origin4(this->origin[0], this->origin[1], this->origin[2], 1);
+	Vector4 origin4(this->origin[0], this->origin[1], this->origin[2], 1);
 
 	// Multiplica a origem pela matriz de transformação
 	origin4 = transformationMatrix * origin4;
 
 	// Atualiza a origem
-	this->origin = Eigen::Vector3d(origin4[0], origin4[1], origin4[2]);
+	this->origin = Vector3(origin4[0], origin4[1], origin4[2]);
+}
+
+LightSource* AmbientSource::clone() const
+{
+	return new AmbientSource(*this);
 }
@@ -1,5 +1,6 @@
 #include "../eigen-3.4.0/Eigen/Dense"
 #include "LightSource.h"
+#include "Scalar.h"
 
 #ifndef AmbientSource_H
 #define AmbientSource_H
@@ -18,7 +19,7 @@ public:
 	 * 
 	 * @param intensity The intensity of the ambient light source.
 	 */
-	AmbientSource(Eigen::Vector3d intensity);
+	AmbientSource(Vector3 intensity);
 
 	/**
 	 * @brief Calculates the direction from the ambient light source to a given point.
@@ -26,7 +27,7 @@ public:
 	 * @param pInt The position of the point.
 	 * @return The direction from the ambient light source to the point.
 	 */
-	Eigen::Vector3d getDirection(Eigen::Vector3d pInt);
+	Vector3 getDirection(Vector3 pInt);
 
 	/**
 	 * @brief Computes the intensity of the ambient light source at a given point.
@@ -46,8 +47,8 @@ public:
 	 * @param specularIndex The specular index.
 	 * @param shadowed Flag indicating if the point is shadowed.
 	 */
-	void computeIntensity(Eigen::Vector3d pInt, Ray ray, Eigen::Vector3d* ptrIntesityAmbient, Eigen::Vector3d* ptrIntesityDifuse, Eigen::Vector3d* ptrIntesitySpecular, 
-		Eigen::Vector3d normal, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex, bool shadowed);
+	void computeIntensity(Vector3 pInt, const Ray& ray, Vector3* ptrIntesityAmbient, Vector3* ptrIntesityDifuse, Vector3* ptrIntesitySpecular, 
+		Vector3 normal, Vector3 kAmbient, Vector3 kDif, Vector3 kEsp, int specularIndex, bool shadowed);
 
 	/**
 	 * @brief Converts the ambient light source to camera space.
@@ -57,7 +58,14 @@ public:
 	 * 
 	 * @param transformationMatrix The transformation matrix.
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
+
+	/**
+	 * @brief Creates a copy of the ambient light source.
+	 * 
+	 * @return Pointer to the new light source.
+	 */
+	LightSource* clone() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,433 @@
+#include "BVH.h"
+#include "SphereSet.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+
+// No GCC e no Clang em x86 o teste de caixas dos pacotes também é compilado para AVX2 e escolhido
+// em tempo de execução, como os núcleos do SphereSet
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BVH_AVX2_LANES
+#define BVH_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define BVH_ALWAYS_INLINE __forceinline
+#else
+#define BVH_ALWAYS_INLINE inline
+#endif
+
+// Com menos raios ativos que isso num nó, o pacote se separa em raios individuais
+static const int PACKET_MIN_ACTIVE = 4;
+
+/**
+ * @brief Constrói uma BVH vazia.
+ */
+BVH::BVH()
+{
+}
+
+/**
+ * @brief Constrói a árvore sobre os objetos dados.
+ *
+ * @param objects Os objetos da cena.
+ */
+void BVH::build(const std::vector<Object*>& objects)
+{
+	this->nodes.clear();
+	this->primitives.clear();
+	this->unbounded.clear();
+
+	std::vector<BuildEntry> entries, infinite;
+	int numObjects = objects.size();
+
+	for (int i = 0; i < numObjects; i++)
+	{
+		BuildEntry entry;
+		entry.object = objects[i];
+		entry.index = i;
+		entry.kind = PrimitiveStore::classify(objects[i]);
+
+		if (objects[i]->getBounds(&entry.box))
+		{
+			entry.centroid = entry.box.centroid();
+			entries.push_back(entry);
+		}
+		else
+		{
+			infinite.push_back(entry);
+		}
+	}
+
+	// O desempate usa o índice original, então a ordem dentro de uma lista não muda o resultado
+	// e os objetos podem ser agrupados por tipo
+	auto byKind = [](const BuildEntry& a, const BuildEntry& b)
+	{
+		return a.kind < b.kind;
+	};
+
+	std::stable_sort(infinite.begin(), infinite.end(), byKind);
+	for (auto& entry : infinite)
+	{
+		this->unbounded.add(entry.object, entry.index);
+	}
+
+	if (entries.empty())
+	{
+		return;
+	}
+
+	this->nodes.reserve(2 * entries.size());
+	BVHBuilder::build(entries, &this->nodes);
+
+	for (auto& node : this->nodes)
+	{
+		if (node.count > 0)
+		{
+			std::stable_sort(entries.begin() + node.first, entries.begin() + node.first + node.count, byKind);
+		}
+	}
+
+	for (auto& entry : entries)
+	{
+		this->primitives.add(entry.object, entry.index);
+	}
+}
+
+/**
+ * @brief Encontra a interseção mais próxima de um raio com os objetos.
+ *
+ * A busca começa limitada por ray.tMax e trabalha numa cópia do raio cujo intervalo vai sendo
+ * encurtado pelas interseções encontradas. O registro só é preenchido no final, pelo objeto vencedor.
+ */
+bool BVH::intersect(const Ray& ray, HitRecord* hit, Object** object) const
+{
+	Ray segment = ray;
+	PrimitiveStore::Closest closest(ray.tMax);
+
+	this->unbounded.intersect(0, this->unbounded.size(), &segment, &closest);
+
+	if (!this->nodes.empty())
+	{
+		this->intersectSubtree(&segment, 0, &closest);
+	}
+
+	return closest.finish(ray, hit, object);
+}
+
+/**
+ * @brief Percorre a subárvore de root com um único raio, a partir da melhor interseção já conhecida.
+ */
+void BVH::intersectSubtree(Ray* ray, int root, PrimitiveStore::Closest* closest) const
+{
+	int stack[BVHBuilder::MAX_DEPTH + 2];
+	Scalar stackNear[BVHBuilder::MAX_DEPTH + 2];
+	int top = 0;
+
+	Scalar sNear;
+	if (this->nodes[root].box.intersect(*ray, closest->t, &sNear))
+	{
+		stack[top] = root;
+		stackNear[top] = sNear;
+		top++;
+	}
+
+	while (top > 0)
+	{
+		top--;
+
+		// A interseção mais próxima pode ter mudado desde que o nó foi empilhado
+		if (stackNear[top] > closest->t)
+		{
+			continue;
+		}
+
+		const Node& node = this->nodes[stack[top]];
+
+		if (node.count > 0)
+		{
+			this->primitives.intersect(node.first, node.count, ray, closest);
+			continue;
+		}
+
+		Scalar nearLeft, nearRight;
+		bool hitLeft = this->nodes[node.first].box.intersect(*ray, closest->t, &nearLeft);
+		bool hitRight = this->nodes[node.first + 1].box.intersect(*ray, closest->t, &nearRight);
+
+		// Empilha o filho mais distante primeiro para visitar o mais próximo antes
+		if (hitLeft && hitRight)
+		{
+			bool leftFirst = nearLeft <= nearRight;
+			stack[top] = leftFirst ? node.first + 1 : node.first;
+			stackNear[top] = leftFirst ? nearRight : nearLeft;
+			top++;
+			stack[top] = leftFirst ? node.first : node.first + 1;
+			stackNear[top] = leftFirst ? nearLeft : nearRight;
+			top++;
+		}
+		else if (hitLeft)
+		{
+			stack[top] = node.first;
+			stackNear[top] = nearLeft;
+			top++;
+		}
+		else if (hitRight)
+		{
+			stack[top] = node.first + 1;
+			stackNear[top] = nearRight;
+			top++;
+		}
+	}
+}
+
+/**
+ * @brief Raios de um pacote em estrutura de vetores, para que os laços sobre os raios vetorizem.
+ */
+struct PacketLanes
+{
+	int count;
+	Scalar ox[BVH::MAX_PACKET], oy[BVH::MAX_PACKET], oz[BVH::MAX_PACKET];
+	Scalar ix[BVH::MAX_PACKET], iy[BVH::MAX_PACKET], iz[BVH::MAX_PACKET];
+	Scalar tMin[BVH::MAX_PACKET];
+};
+
+/**
+ * @brief Teste de slabs de uma caixa contra todos os raios do pacote (o mesmo de AABB::intersect).
+ *
+ * O laço não tem desvios, então o compilador testa vários raios por instrução. Só os raios com
+ * mask[i] = 1 podem continuar ativos; mask é atualizado e a função devolve quantos continuam.
+ */
+static BVH_ALWAYS_INLINE int intersectBoxLanesBody(const AABB& box, const PacketLanes& lanes, const Scalar* sMax, unsigned char* mask)
+{
+	const Scalar slack = 1 + 4 * std::numeric_limits<Scalar>::epsilon();
+	const Scalar minX = box.min[0], minY = box.min[1], minZ = box.min[2];
+	const Scalar maxX = box.max[0], maxY = box.max[1], maxZ = box.max[2];
+
+	// Cópia local: mask pode, para o compilador, apontar para lanes.count
+	const int count = lanes.count;
+	int active = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		Scalar x1 = (minX - lanes.ox[i]) * lanes.ix[i], x2 = (maxX - lanes.ox[i]) * lanes.ix[i];
+		Scalar y1 = (minY - lanes.oy[i]) * lanes.iy[i], y2 = (maxY - lanes.oy[i]) * lanes.iy[i];
+		Scalar z1 = (minZ - lanes.oz[i]) * lanes.iz[i], z2 = (maxZ - lanes.oz[i]) * lanes.iz[i];
+
+		Scalar tNear = lanes.tMin[i];
+		tNear = std::max(tNear, std::min(x1, x2));
+		tNear = std::max(tNear, std::min(y1, y2));
+		tNear = std::max(tNear, std::min(z1, z2));
+
+		Scalar tFar = sMax[i];
+		tFar = std::min(tFar, std::max(x1, x2) * slack);
+		tFar = std::min(tFar, std::max(y1, y2) * slack);
+		tFar = std::min(tFar, std::max(z1, z2) * slack);
+
+		mask[i] = mask[i] & (unsigned char)(tNear <= tFar);
+		active += mask[i];
+	}
+
+	return active;
+}
+
+static int intersectBoxLanesGeneric(const AABB& box, const PacketLanes& lanes, const Scalar* sMax, unsigned char* mask)
+{
+	return intersectBoxLanesBody(box, lanes, sMax, mask);
+}
+
+#ifdef BVH_AVX2_LANES
+// O mesmo laço compilado para AVX2: só com as instruções de mínimo e máximo com máscara do AVX
+// o compilador consegue vetorizá-lo preservando o tratamento de NaN de std::min e std::max
+__attribute__((target("avx2"))) static int intersectBoxLanesAVX2(const AABB& box, const PacketLanes& lanes, const Scalar* sMax, unsigned char* mask)
+{
+	return intersectBoxLanesBody(box, lanes, sMax, mask);
+}
+#endif
+
+/**
+ * @brief Escolhe, na primeira chamada, a versão do teste de caixas para a CPU (a mesma detecção do SphereSet).
+ */
+static int intersectBoxLanes(const AABB& box, const PacketLanes& lanes, const Scalar* sMax, unsigned char* mask)
+{
+#ifdef BVH_AVX2_LANES
+	static const bool useAVX2 = SphereSet::detectKernel() == SphereSet::AVX2;
+	if (useAVX2)
+	{
+		return intersectBoxLanesAVX2(box, lanes, sMax, mask);
+	}
+#endif
+	return intersectBoxLanesGeneric(box, lanes, sMax, mask);
+}
+
+/**
+ * @brief Encontra a interseção mais próxima de cada raio de um pacote.
+ *
+ * O pacote desce pela árvore com uma máscara de raios ativos: cada nó é testado contra todos
+ * os raios de uma vez e só os que atingem a caixa seguem para os filhos e para os objetos das
+ * folhas, que também são testados contra esses raios de uma vez. Quando sobram menos de PACKET_MIN_ACTIVE raios ativos num nó, os raios divergiram e
+ * cada um termina aquela subárvore sozinho, por intersectSubtree.
+ */
+void BVH::intersectPacket(const Ray* rays, int count, HitRecord* hits, Object** objects, bool* found) const
+{
+	Ray segments[MAX_PACKET];
+	PrimitiveStore::Closest closest[MAX_PACKET];
+	Scalar best[MAX_PACKET]; // Cópia de closest[i].t, contígua para o teste de caixas
+
+	unsigned char all[MAX_PACKET];
+	for (int i = 0; i < count; i++)
+	{
+		segments[i] = rays[i];
+		closest[i] = PrimitiveStore::Closest(rays[i].tMax);
+		all[i] = 1;
+	}
+
+	this->unbounded.intersectPacket(0, this->unbounded.size(), all, count, segments, closest);
+	for (int i = 0; i < count; i++)
+	{
+		best[i] = closest[i].t;
+	}
+
+	if (!this->nodes.empty())
+	{
+		PacketLanes lanes;
+		lanes.count = count;
+		for (int i = 0; i < count; i++)
+		{
+			lanes.ox[i] = rays[i].initialPoint[0];
+			lanes.oy[i] = rays[i].initialPoint[1];
+			lanes.oz[i] = rays[i].initialPoint[2];
+			lanes.ix[i] = rays[i].invDirection[0];
+			lanes.iy[i] = rays[i].invDirection[1];
+			lanes.iz[i] = rays[i].invDirection[2];
+			lanes.tMin[i] = rays[i].tMin;
+		}
+
+		// Cada entrada da pilha guarda o nó e os raios que atingiram a caixa do pai
+		int stack[BVHBuilder::MAX_DEPTH + 2];
+		unsigned char masks[BVHBuilder::MAX_DEPTH + 2][MAX_PACKET];
+		int top = 0;
+
+		stack[top] = 0;
+		std::fill(masks[top], masks[top] + count, 1);
+		top++;
+
+		while (top > 0)
+		{
+			top--;
+			int nodeIndex = stack[top];
+			unsigned char* mask = masks[top];
+			const Node& node = this->nodes[nodeIndex];
+
+			int active = intersectBoxLanes(node.box, lanes, best, mask);
+			if (active == 0)
+			{
+				continue;
+			}
+
+			if (active < PACKET_MIN_ACTIVE)
+			{
+				for (int i = 0; i < count; i++)
+				{
+					if (mask[i])
+					{
+						this->intersectSubtree(&segments[i], nodeIndex, &closest[i]);
+						best[i] = closest[i].t;
+					}
+				}
+				continue;
+			}
+
+			if (node.count > 0)
+			{
+				this->primitives.intersectPacket(node.first, node.count, mask, count, segments, closest);
+				for (int i = 0; i < count; i++)
+				{
+					best[i] = closest[i].t;
+				}
+				continue;
+			}
+
+			// Visita antes o filho cujo centro está mais à frente no primeiro raio ativo
+			int lane = std::find(mask, mask + count, 1) - mask;
+			Vector3 origin(lanes.ox[lane], lanes.oy[lane], lanes.oz[lane]);
+			Scalar nearLeft = (this->nodes[node.first].box.centroid() - origin).dot(rays[lane].direction);
+			Scalar nearRight = (this->nodes[node.first + 1].box.centroid() - origin).dot(rays[lane].direction);
+			int first = nearLeft <= nearRight ? node.first : node.first + 1;
+
+			// A máscara do pai é copiada para os dois filhos; o mais próximo fica no topo
+			std::copy(mask, mask + count, masks[top + 1]);
+			stack[top] = node.first + node.first + 1 - first;
+			stack[top + 1] = first;
+			top += 2;
+		}
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		found[i] = closest[i].finish(rays[i], &hits[i], &objects[i]);
+	}
+}
+
+/**
+ * @brief Verifica se algum objeto bloqueia o segmento.
+ *
+ * Os nós são visitados em qualquer ordem: basta um objeto no segmento para encerrar a busca.
+ */
+bool BVH::occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+{
+	Ray segment = Ray::fromDirection(origin, direction, 0, tMax);
+
+	if (this->unbounded.occluded(0, this->unbounded.size(), segment))
+	{
+		return true;
+	}
+
+	if (this->nodes.empty())
+	{
+		return false;
+	}
+
+	int stack[BVHBuilder::MAX_DEPTH + 2];
+	int top = 0;
+	stack[top++] = 0;
+
+	Scalar sNear;
+	while (top > 0)
+	{
+		const Node& node = this->nodes[stack[--top]];
+
+		if (!node.box.intersect(segment, tMax, &sNear))
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			if (this->primitives.occluded(node.first, node.count, segment))
+			{
+				return true;
+			}
+			continue;
+		}
+
+		stack[top++] = node.first + 1;
+		stack[top++] = node.first;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Obtém o número de nós da árvore.
+ */
+int BVH::getNumNodes() const
+{
+	return this->nodes.size();
+}
+
+/**
+ * @brief Obtém o número de objetos infinitos, testados fora da árvore.
+ */
+int BVH::getNumUnbounded() const
+{
+	return this->unbounded.size();
+}
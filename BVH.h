@@ -0,0 +1,117 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <vector>
+
+#include "AABB.h"
+#include "BVHBuilder.h"
+#include "Object.h"
+#include "PrimitiveStore.h"
+#include "Ray.h"
+#include "Scalar.h"
+
+#ifndef BVH_H
+#define BVH_H
+
+/**
+ * @brief Hierarquia de volumes delimitadores (BVH) sobre os objetos de uma cena.
+ *
+ * A árvore é construída com a heurística de área de superfície (SAH, em BVHBuilder) sobre as caixas de
+ * todos os objetos limitados. Objetos infinitos (planos) ficam numa lista à parte e são
+ * testados sempre. A busca pela interseção mais próxima reduz a distância máxima conforme
+ * encontra interseções, descartando nós que começam depois dela.
+ *
+ * Os objetos das folhas e a lista de infinitos ficam em PrimitiveStores, ordenados por tipo
+ * dentro de cada folha, de forma que cada folha é testada em lotes por tipo, sem chamadas virtuais
+ * para as primitivas simples.
+ */
+class BVH
+{
+public:
+	static const int MAX_PACKET = PrimitiveStore::MAX_PACKET; /**< Maior número de raios de um pacote (8 x 8 pixels) */
+
+	/**
+	 * @brief Constrói uma BVH vazia.
+	 */
+	BVH();
+
+	/**
+	 * @brief Constrói a árvore sobre os objetos dados (nas suas coordenadas atuais).
+	 *
+	 * Em caso de empate na distância, intersect devolve o objeto que aparece primeiro
+	 * em objects, como na busca linear.
+	 *
+	 * @param objects Os objetos da cena.
+	 */
+	void build(const std::vector<Object*>& objects);
+
+	/**
+	 * @brief Encontra a interseção mais próxima de um raio com os objetos.
+	 *
+	 * @param ray O raio.
+	 * @param hit Registro a ser preenchido com a interseção mais próxima.
+	 * @param object Ponteiro para armazenar o objeto atingido.
+	 * @return true se algum objeto foi atingido.
+	 */
+	bool intersect(const Ray& ray, HitRecord* hit, Object** object) const;
+
+	/**
+	 * @brief Encontra a interseção mais próxima de cada raio de um pacote de raios coerentes.
+	 *
+	 * Os raios percorrem a árvore juntos, testando cada caixa e cada esfera, plano, disco ou face
+	 * triangular contra todos os raios ativos de uma vez; raios que divergem terminam a travessia
+	 * sozinhos. O resultado de cada raio é o mesmo de intersect.
+	 *
+	 * @param rays Os raios (até MAX_PACKET).
+	 * @param count O número de raios.
+	 * @param hits Registros a serem preenchidos, um por raio.
+	 * @param objects Objetos atingidos, um por raio.
+	 * @param found Indica, para cada raio, se algum objeto foi atingido.
+	 */
+	void intersectPacket(const Ray* rays, int count, HitRecord* hits, Object** objects, bool* found) const;
+
+	/**
+	 * @brief Verifica se algum objeto bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 *
+	 * Para no primeiro objeto que bloqueia o segmento, sem procurar o mais próximo.
+	 *
+	 * @param origin A origem do segmento.
+	 * @param direction A direção (unitária) do segmento.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se o segmento estiver bloqueado.
+	 */
+	bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const;
+
+	/**
+	 * @brief Obtém o número de nós da árvore.
+	 */
+	int getNumNodes() const;
+
+	/**
+	 * @brief Obtém o número de objetos infinitos, testados fora da árvore.
+	 */
+	int getNumUnbounded() const;
+
+private:
+	// Nó da árvore; nas folhas, first e count são um intervalo de entradas de primitives
+	typedef BVHNode Node;
+
+	/**
+	 * Objeto durante a construção: caixa, centro da caixa, posição original e tipo no PrimitiveStore.
+	 */
+	struct BuildEntry
+	{
+		AABB box;
+		Vector3 centroid;
+		Object* object;
+		int index;
+		int kind;
+	};
+
+	std::vector<Node> nodes;
+	PrimitiveStore primitives; // Objetos das folhas, agrupados por tipo dentro de cada folha
+	PrimitiveStore unbounded;  // Objetos infinitos, agrupados por tipo
+
+	// Percorre a subárvore de root com um raio, atualizando a melhor interseção e o fim do intervalo do raio
+	void intersectSubtree(Ray* ray, int root, PrimitiveStore::Closest* closest) const;
+};
+
+#endif
@@ -0,0 +1,173 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "AABB.h"
+#include "Scalar.h"
+
+#ifndef BVHBuilder_H
+#define BVHBuilder_H
+
+/**
+ * @brief Nó de uma BVH guardada num vetor.
+ *
+ * Em nós internos, first é o índice do filho esquerdo (o direito é first + 1) e count é 0; em
+ * folhas, first é a primeira entrada e count o número de entradas. Os filhos vêm sempre depois do pai.
+ */
+struct BVHNode
+{
+	AABB box;
+	int first;
+	int count;
+};
+
+/**
+ * @brief Construção de uma BVH pela heurística de área de superfície (SAH) em baldes.
+ *
+ * É a mesma construção para a BVH da cena (sobre objetos) e para a BVH de cada TriangleMesh (sobre
+ * triângulos). As entradas são de qualquer tipo com os campos box e centroid (o centro da caixa);
+ * o resto da entrada é o que a árvore guarda nas folhas, e a construção só reordena as entradas,
+ * de forma que as folhas ficam em intervalos consecutivos delas.
+ */
+class BVHBuilder
+{
+public:
+	static const int NUM_BINS = 16;     /**< Número de baldes usados para avaliar a SAH em cada eixo */
+	static const int MAX_LEAF_SIZE = 4; /**< Folhas com até esse número de entradas não são divididas se a SAH não compensar */
+	static const int MAX_DEPTH = 48;    /**< Profundidade máxima da árvore (limita a pilha da travessia) */
+
+	/**
+	 * @brief Constrói a árvore sobre as entradas, com a raiz em nodes[0].
+	 *
+	 * @param entries As entradas (reordenadas na ordem das folhas); não pode ser vazio.
+	 * @param nodes Vetor de nós, inicialmente vazio, que recebe a árvore.
+	 */
+	template <typename Entry>
+	static void build(std::vector<Entry>& entries, std::vector<BVHNode>* nodes)
+	{
+		nodes->push_back(BVHNode());
+		buildNode(nodes, 0, entries, 0, entries.size(), 0);
+	}
+
+private:
+	/**
+	 * @brief Constrói recursivamente o nó nodeIndex sobre entries[first, first + count).
+	 *
+	 * Os centros das caixas são distribuídos em NUM_BINS baldes por eixo e, para cada
+	 * fronteira entre baldes, o custo é estimado como área(esq) * n(esq) + área(dir) * n(dir).
+	 */
+	template <typename Entry>
+	static void buildNode(std::vector<BVHNode>* nodes, int nodeIndex, std::vector<Entry>& entries, int first, int count, int depth)
+	{
+		AABB box, centroidBox;
+		for (int i = first; i < first + count; i++)
+		{
+			box.expand(entries[i].box);
+			centroidBox.expand(entries[i].centroid);
+		}
+
+		(*nodes)[nodeIndex].box = box;
+		(*nodes)[nodeIndex].first = first;
+		(*nodes)[nodeIndex].count = count;
+
+		if (count == 1 || depth >= MAX_DEPTH)
+		{
+			return;
+		}
+
+		// Procura a melhor divisão entre todos os eixos
+		Scalar bestCost = INFINITY;
+		int bestAxis = -1, bestSplit = -1;
+		Vector3 extent = centroidBox.max - centroidBox.min;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (extent[axis] <= 0)
+			{
+				continue;
+			}
+
+			AABB binBoxes[NUM_BINS];
+			int binCounts[NUM_BINS] = { 0 };
+			Scalar scale = NUM_BINS / extent[axis];
+
+			for (int i = first; i < first + count; i++)
+			{
+				int b = std::min(NUM_BINS - 1, (int)((entries[i].centroid[axis] - centroidBox.min[axis]) * scale));
+				binCounts[b]++;
+				binBoxes[b].expand(entries[i].box);
+			}
+
+			// Varre da direita para a esquerda acumulando áreas e contagens
+			Scalar rightArea[NUM_BINS];
+			int rightCount[NUM_BINS];
+			AABB accumulated;
+			int accumulatedCount = 0;
+			for (int b = NUM_BINS - 1; b > 0; b--)
+			{
+				accumulated.expand(binBoxes[b]);
+				accumulatedCount += binCounts[b];
+				rightArea[b] = accumulated.surfaceArea();
+				rightCount[b] = accumulatedCount;
+			}
+
+			accumulated = AABB();
+			accumulatedCount = 0;
+			for (int b = 0; b < NUM_BINS - 1; b++)
+			{
+				accumulated.expand(binBoxes[b]);
+				accumulatedCount += binCounts[b];
+
+				if (accumulatedCount == 0 || rightCount[b + 1] == 0)
+				{
+					continue;
+				}
+
+				Scalar cost = accumulated.surfaceArea() * accumulatedCount + rightArea[b + 1] * rightCount[b + 1];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b;
+				}
+			}
+		}
+
+		// Custo de não dividir: testar todos os objetos sempre que o nó é atingido
+		Scalar leafCost = box.surfaceArea() * count;
+
+		int mid;
+		if (bestAxis != -1 && (bestCost < leafCost || count > MAX_LEAF_SIZE))
+		{
+			Scalar scale = NUM_BINS / extent[bestAxis];
+			Scalar minimum = centroidBox.min[bestAxis];
+			Entry* middle = std::partition(&entries[first], &entries[first] + count, [&](const Entry& e)
+			{
+				return std::min(NUM_BINS - 1, (int)((e.centroid[bestAxis] - minimum) * scale)) <= bestSplit;
+			});
+			mid = middle - &entries[0];
+		}
+		else if (count > MAX_LEAF_SIZE)
+		{
+			// Todos os centros coincidem: divide ao meio
+			mid = first + count / 2;
+		}
+		else
+		{
+			return;
+		}
+
+		int left = nodes->size();
+		nodes->push_back(BVHNode());
+		nodes->push_back(BVHNode());
+
+		(*nodes)[nodeIndex].first = left;
+		(*nodes)[nodeIndex].count = 0;
+
+		buildNode(nodes, left, entries, first, mid - first, depth + 1);
+		buildNode(nodes, left + 1, entries, mid, first + count - mid, depth + 1);
+	}
+};
+
+#endif
@@ -7,7 +7,7 @@
  * @param lookAt O ponto para onde a câmera está olhando.
  * @param viewUp O vetor de orientação da câmera.
  */
-Camera::Camera(Eigen::Vector3d position, Eigen::Vector3d lookAt, Eigen::Vector3d viewUp)
+Camera::Camera(Vector3 position, Vector3 lookAt, Vector3 viewUp)
 {
 	this->position = position;
 	this->lookAt = lookAt;
@@ -30,7 +30,7 @@ Camera::Camera(Eigen::Vector3d position, Eigen::Vector3d lookAt, Eigen::Vector3d
  * 
  * @return A matriz de transformação da câmera.
  */
-Eigen::Matrix4d Camera::getTransformationMatrix()
+Matrix4 Camera::getTransformationMatrix()
 {
 	return this->transformationMatrix;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "../eigen-3.4.0/Eigen/Dense" 
 
+#include "Scalar.h"
+
 #ifndef Camera_H
 #define Camera_H
 
@@ -9,15 +11,15 @@
 class Camera
 {
 public:
-	Eigen::Vector3d position; // < Posição da câmera
-	Eigen::Vector3d lookAt;   // < Ponto para onde a câmera está olhando
-	Eigen::Vector3d viewUp;   // < Vetor de orientação da câmera
+	Vector3 position; // < Posição da câmera
+	Vector3 lookAt;   // < Ponto para onde a câmera está olhando
+	Vector3 viewUp;   // < Vetor de orientação da câmera
 
-	Eigen::Vector3d i;  // < Vetor i do sistema de coordenadas da câmera
-	Eigen::Vector3d j;  // < Vetor j do sistema de coordenadas da câmera
-	Eigen::Vector3d k;  // < Vetor k do sistema de coordenadas da câmera
+	Vector3 i;  // < Vetor i do sistema de coordenadas da câmera
+	Vector3 j;  // < Vetor j do sistema de coordenadas da câmera
+	Vector3 k;  // < Vetor k do sistema de coordenadas da câmera
 
-	Eigen::Matrix4d transformationMatrix; // < Matriz de transformação da câmera
+	Matrix4 transformationMatrix; // < Matriz de transformação da câmera
 
 	/**
 	 * Construtor da classe Camera.
@@ -25,10 +27,10 @@ public:
 	 * @param lookAt Ponto para onde a câmera está olhando
 	 * @param viewUp Vetor de orientação da câmera
 	 */
-	Camera(Eigen::Vector3d position, Eigen::Vector3d lookAt, Eigen::Vector3d viewUp);
+	Camera(Vector3 position, Vector3 lookAt, Vector3 viewUp);
 
 	//Obtém a matriz de transformação da câmera
-	Eigen::Matrix4d getTransformationMatrix();
+	Matrix4 getTransformationMatrix();
 };
 
 #endif
\ No newline at end of file
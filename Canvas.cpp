@@ -1,5 +1,18 @@
 #include "Canvas.h"
+#include "PhongBatch.h"
 #include <vector>
+#include <algorithm>
+
+// Fração do segmento até o ponto ignorada pelos raios de sombra, para que a própria superfície não bloqueie a luz;
+// em float o erro de arredondamento do ponto de interseção é bem maior e a folga precisa acompanhar
+#ifdef CG_SCALAR_FLOAT
+static const Scalar SHADOW_EPSILON = 1e-4f;
+#else
+static const Scalar SHADOW_EPSILON = 1e-6;
+#endif
+
+// Pixels sombreados de uma vez pelo PhongBatch na passada de sombreamento
+static const int SHADE_BATCH_SIZE = 64;
 
 /**
  * @brief Construtor da classe Canvas.
@@ -10,7 +23,7 @@
  * @param numLines Número de linhas do canvas.
  * @param numColumns Número de colunas do canvas.
  */
-Canvas::Canvas(double windowDistance, double windowWidth, double windowHeight, double numLines, double numColumns)
+Canvas::Canvas(Scalar windowDistance, Scalar windowWidth, Scalar windowHeight, Scalar numLines, Scalar numColumns)
 {
 	this->windowDistance = windowDistance;
 	this->windowWidth = windowWidth;  // pov_w
@@ -23,171 +36,465 @@ Canvas::Canvas(double windowDistance, double windowWidth, double windowHeight, d
 
 	this->jXMin = -(windowWidth / 2);  // - half_w
 	this->jYMax = windowHeight / 2;  // half_h
+
+	this->numThreads = 1;
+	this->tileSize = 16;
+	this->packetSize = 0;
+	this->threadPool = NULL;
 }
 
+/**
+ * @brief Destrutor da classe Canvas. Encerra o pool de threads, se existir.
+ */
+Canvas::~Canvas()
+{
+	delete this->threadPool;
+}
 
 /**
- * @brief Classe que representa um tensor.
+ * @brief Configura a renderização por blocos.
  * 
- * Um tensor é uma estrutura de dados multidimensional que armazena elementos de um determinado tipo.
- * Neste caso, o tensor é utilizado para armazenar os valores RGB de cada pixel em um canvas.
+ * @param numThreads Número de threads; valores menores que 1 usam o número de núcleos da máquina.
+ * @param tileSize Lado de cada bloco, em pixels.
  */
-Tensor Canvas::raycast(Eigen::Vector3d observable, Scene scene, bool toCamera)
+void Canvas::setTiling(int numThreads, int tileSize)
 {
-	Tensor canvas(this->numColumns, this->numLines);
-	double yL, xC;
-
-	// Numero de objetos e de hitboxes na cena
-	int numObjects = scene.getNumElements(), numHitBoxes = scene.getNumHitBoxes();
-	Eigen::Vector3d pJ;
-	int numObjectsVector = numObjects;
-
-	// Converte os objetos para coordenadas de câmera, se necessario
-	if (toCamera)
+	if (numThreads < 1)
 	{
-		scene.convertObjectsToCamera(true);
+		numThreads = std::max(1, (int)std::thread::hardware_concurrency());
 	}
 
-	// Calcula o numero de objetos na cena e nas hitboxes
-	for (int i = 0; i < numHitBoxes; i++)
+	this->numThreads = numThreads;
+	this->tileSize = std::max(1, tileSize);
+
+	// O pool só é recriado quando o número de threads muda
+	if (this->threadPool != NULL && this->threadPool->getNumThreads() != numThreads)
 	{
-		numObjectsVector += (*scene.hitboxes[i]).getNumElements();
+		delete this->threadPool;
+		this->threadPool = NULL;
 	}
+}
 
-	std::vector<double> distanceToObjects(numObjectsVector);
-	std::vector<Object*> objects(numObjectsVector);
-	int idx;
-
-	for (int l = 0; l < this->numLines; l++)
-	{
-		yL = this->jYMax - l * this->deltaY - this->deltaY / 2;
+/**
+ * @brief Liga (4 ou 8) ou desliga (0) o traçado de raios primários em pacotes.
+ * 
+ * @param packetSize Lado dos pacotes, em pixels.
+ */
+void Canvas::setPacketSize(int packetSize)
+{
+	this->packetSize = std::min(8, std::max(0, packetSize));
+}
 
-		for (int c = 0; c < this->numColumns; c++)
-		{
-			xC = this->jXMin + c * this->deltaX + this->deltaX / 2;
+/**
+ * @brief Raio primário do pixel (l, c), pelo centro do pixel na janela.
+ */
+Ray Canvas::primaryRay(int l, int c, const Vector3& observable) const
+{
+	Vector3 pJ;
 
-			pJ << xC, yL, -(this->windowDistance);
+	Scalar yL = this->jYMax - l * this->deltaY - this->deltaY / 2;
+	Scalar xC = this->jXMin + c * this->deltaX + this->deltaX / 2;
 
-			Ray ray(observable, pJ);
+	pJ << xC, yL, -(this->windowDistance);
 
-			idx = 0;
+	// O pixel tem largura deltaX na janela, vista inclinada fora do centro
+	Ray ray(observable, pJ);
+	ray.spread = this->deltaX * this->windowDistance / (pJ - observable).squaredNorm();
+	return ray;
+}
 
-			std::vector <bool> isShadowed;
+/**
+ * @brief Traça os raios primários de uma região da imagem e entrega cada interseção a visit.
+ * 
+ * Com packetSize 0 cada pixel é traçado sozinho; com 4 ou 8 a região é percorrida em pacotes de
+ * packetSize x packetSize pixels (menores na borda) que atravessam a BVH juntos.
+ * 
+ * @param line Primeira linha da região.
+ * @param column Primeira coluna da região.
+ * @param numLines Número de linhas da região.
+ * @param numColumns Número de colunas da região.
+ * @param observable O ponto de observação.
+ * @param scene A cena compilada.
+ * @param visit Chamada como visit(l, c, ray, hit, object) para cada pixel, com object NULL se o raio não atingiu nada.
+ */
+template <typename Visit>
+void Canvas::traceRegion(int line, int column, int numLines, int numColumns, const Vector3& observable, const RenderScene& scene, Visit visit)
+{
+	if (this->packetSize == 0)
+	{
+		HitRecord closest;
+		Object* closestObject = NULL;
 
-			/*Calculamos as distancias para cada objeto
-			presente na cena ou em alguma hitbox*/
-			for (int i = 0; i < numObjects; i++)
+		for (int l = line; l < line + numLines; l++)
+		{
+			for (int c = column; c < column + numColumns; c++)
 			{
-				distanceToObjects[idx] = ((*scene.objects[i]).hasInterceptedRay(ray));
-				objects[idx] = &(*scene.objects[i]);
-				idx++;
+				Ray ray = this->primaryRay(l, c, observable);
+
+				// Interseção mais próxima entre todos os objetos da cena (inclusive os das hitboxes)
+				bool found = scene.intersect(ray, &closest, &closestObject);
+				visit(l, c, ray, closest, found ? closestObject : NULL);
 			}
+		}
+		return;
+	}
+
+	Ray rays[BVH::MAX_PACKET];
+	HitRecord hits[BVH::MAX_PACKET];
+	Object* objects[BVH::MAX_PACKET];
+	bool found[BVH::MAX_PACKET];
+
+	for (int packetLine = line; packetLine < line + numLines; packetLine += this->packetSize)
+	{
+		for (int packetColumn = column; packetColumn < column + numColumns; packetColumn += this->packetSize)
+		{
+			int packetLines = std::min(this->packetSize, line + numLines - packetLine);
+			int packetColumns = std::min(this->packetSize, column + numColumns - packetColumn);
+			int count = 0;
 
-			for (int i = 0; i < numHitBoxes; i++)
+			for (int l = packetLine; l < packetLine + packetLines; l++)
 			{
-				int numElements = (*scene.hitboxes[i]).getNumElements();
-				if ((*scene.hitboxes[i]).hasInterceptedRay(ray))
+				for (int c = packetColumn; c < packetColumn + packetColumns; c++)
 				{
-					for (int j = 0; j < numElements; j++)
-					{
-						distanceToObjects[idx] = ((*scene.hitboxes[i]->objects[j]).hasInterceptedRay(ray));
-						objects[idx] = &(*scene.hitboxes[i]->objects[j]);
-						idx++;
-					}
+					rays[count++] = this->primaryRay(l, c, observable);
 				}
 			}
 
-			/*Vemos qual tem distancia minima*/
-			double minimum = -INFINITY;
-			int idxMin = -1;
+			scene.intersectPacket(rays, count, hits, objects, found);
 
-			for (int i = 0; i < idx; i++)
+			int i = 0;
+			for (int l = packetLine; l < packetLine + packetLines; l++)
 			{
-				if (distanceToObjects[i] < 0 && distanceToObjects[i] > minimum)
+				for (int c = packetColumn; c < packetColumn + packetColumns; c++, i++)
 				{
-					minimum = distanceToObjects[i];
-					idxMin = i;
+					visit(l, c, rays[i], hits[i], found[i] ? objects[i] : NULL);
 				}
 			}
+		}
+	}
+}
+
+/**
+ * @brief Escolhe as fontes que iluminam a interseção e testa, para cada uma, se algum objeto
+ * bloqueia o segmento entre a fonte e a interseção.
+ * 
+ * @param ray O raio primário.
+ * @param closest A interseção mais próxima do raio.
+ * @param scene A cena compilada.
+ * @param seed A semente do sorteio de fontes do pixel.
+ * @param lights Seleção de fontes da thread (sobrescrita aqui, sem alocar).
+ */
+void Canvas::traceShadows(const Ray& ray, const HitRecord& closest, const RenderScene& scene, unsigned int seed, LightIndex::Selection* lights) const
+{
+	const std::vector<LightSource*>& sources = scene.getSources();
+	std::vector<bool>& isShadowed = lights->shadows;
+
+	Vector3 pInt = ray.initialPoint + closest.t * ray.direction;
+	Vector3 sourceDirection(0, 0, 0);
+
+	// Só as fontes que alcançam o ponto (ou as sorteadas) são testadas e sombreadas
+	scene.getLightIndex().select(pInt, seed, lights);
+	isShadowed.resize(lights->indices.size());
+		
+	for (size_t k = 0; k < lights->indices.size(); k++)
+	{
+		int i = lights->indices[k];
+		LightSource* source = sources[i];
+		sourceDirection = source->getDirection(pInt);
+
+		if (sourceDirection.norm() != 0)
+		{
+			// O ponto está na sombra se algum objeto bloqueia o segmento entre a fonte e o ponto
+			Scalar distance = (pInt - source->origin).norm();
+			isShadowed[k] = scene.sourceOccluded(i, sourceDirection, distance * (1 - SHADOW_EPSILON));
+		}
+		else
+		{
+			isShadowed[k] = false;
+		}
+	}
+}
+
+/**
+ * @brief Calcula a cor de uma interseção: testa as sombras de cada fonte e sombreia o objeto.
+ * 
+ * @param ray O raio primário.
+ * @param closest A interseção mais próxima do raio.
+ * @param closestObject O objeto atingido.
+ * @param scene A cena compilada.
+ * @param seed A semente do sorteio de fontes do pixel.
+ * @param lights Seleção de fontes da thread (sobrescrita aqui, sem alocar).
+ * @return A cor do pixel.
+ */
+Vector3 Canvas::shadeHit(const Ray& ray, const HitRecord& closest, Object* closestObject, const RenderScene& scene, unsigned int seed, LightIndex::Selection* lights) const
+{
+	this->traceShadows(ray, closest, scene, seed, lights);
+
+	// Calcula a cor do pixel com as fontes escolhidas
+	return closestObject->shade(ray, closest, lights->sources, lights->shadows, scene.getMaterials());
+}
+
+/**
+ * @brief Garante uma seleção de fontes por thread, com espaço para todas as fontes da cena.
+ * 
+ * @param scene A cena compilada.
+ */
+void Canvas::prepareLightBuffers(const RenderScene& scene)
+{
+	int numWorkers = this->numThreads <= 1 ? 1 : this->numThreads;
+	if ((int)this->lightBuffers.size() < numWorkers)
+	{
+		this->lightBuffers.resize(numWorkers);
+	}
+	for (auto& buffer : this->lightBuffers)
+	{
+		scene.getLightIndex().prepare(&buffer);
+	}
+}
+
+/**
+ * @brief Semente do sorteio de fontes do pixel (l, c): a mesma em raycast, trace e shade.
+ */
+unsigned int Canvas::pixelSeed(int l, int c) const
+{
+	return (unsigned int)l * (unsigned int)this->numColumns + (unsigned int)c;
+}
+
+/**
+ * @brief Executa job para cada bloco: em sequência com uma thread, ou no pool de threads.
+ * 
+ * @param numTiles Número de blocos.
+ * @param job Função chamada como job(bloco, thread).
+ */
+void Canvas::runTiles(int numTiles, const std::function<void(int, int)>& job)
+{
+	if (this->numThreads <= 1)
+	{
+		for (int tile = 0; tile < numTiles; tile++)
+		{
+			job(tile, 0);
+		}
+
+		return;
+	}
+
+	if (this->threadPool == NULL)
+	{
+		this->threadPool = new ThreadPool(this->numThreads);
+	}
+
+	// A cena compilada não muda durante a renderização, então todas as threads a compartilham
+	this->threadPool->run(numTiles, job);
+}
+
+
+/**
+ * @brief Classe que representa um tensor.
+ * 
+ * Um tensor é uma estrutura de dados multidimensional que armazena elementos de um determinado tipo.
+ * Neste caso, o tensor é utilizado para armazenar os valores RGB de cada pixel em um canvas.
+ * 
+ * A imagem é percorrida em blocos de tileSize x tileSize pixels. Com numThreads > 1 os blocos
+ * são distribuídos entre as threads do pool; o resultado é idêntico ao da renderização sequencial.
+ * Cada bloco escreve só na sua região da imagem, que é contígua em cada linha.
+ */
+void Canvas::raycast(Vector3 observable, const RenderScene& scene, Framebuffer* image)
+{
+	int lines = (int)this->numLines, columns = (int)this->numColumns;
+	int tilesX = (columns + this->tileSize - 1) / this->tileSize;
+	int tilesY = (lines + this->tileSize - 1) / this->tileSize;
+
+	this->prepareLightBuffers(scene);
+
+	// Renderiza um bloco da imagem
+	auto renderTile = [&](int tile, int worker)
+	{
+		LightIndex::Selection* lights = &this->lightBuffers[worker];
+		Framebuffer::Tile region = image->tile((tile / tilesX) * this->tileSize, (tile % tilesX) * this->tileSize, this->tileSize, this->tileSize);
+
+		this->traceRegion(region.line, region.column, region.numLines, region.numColumns, observable, scene,
+						  [&](int l, int c, const Ray& ray, const HitRecord& hit, Object* object)
+		{
+			// Se não houver interseção, o pixel fica preto
+			region.setPixel(l, c, object != NULL ? this->shadeHit(ray, hit, object, scene, this->pixelSeed(l, c), lights) : Vector3(0, 0, 0));
+		});
+	};
+
+	this->runTiles(tilesX * tilesY, [&](int tile, int worker)
+	{
+		renderTile(tile, worker);
+	});
+}
+
+/**
+ * @brief Renderiza em um Framebuffer RGB_FLOAT e o converte para Tensor (compatibilidade).
+ */
+Tensor Canvas::raycast(Vector3 observable, const RenderScene& scene)
+{
+	Framebuffer image((int)this->numColumns, (int)this->numLines, Framebuffer::RGB_FLOAT);
+	this->raycast(observable, scene, &image);
+	return Tensor(image);
+}
+
+/**
+ * @brief Compila a cena para a sua câmera e a renderiza. Os objetos da cena não são alterados.
+ */
+Tensor Canvas::raycast(Vector3 observable, const Scene& scene)
+{
+	RenderScene compiled(scene);
+	return this->raycast(observable, compiled);
+}
+
+/**
+ * @brief Passada de visibilidade da renderização adiada.
+ * 
+ * Percorre a imagem em blocos, como raycast, mas em vez de sombrear grava no G-buffer a interseção
+ * e a máscara de sombras de cada pixel.
+ */
+void Canvas::trace(Vector3 observable, const RenderScene& scene, GBuffer* gbuffer)
+{
+	int lines = (int)this->numLines, columns = (int)this->numColumns;
+	int tilesX = (columns + this->tileSize - 1) / this->tileSize;
+	int tilesY = (lines + this->tileSize - 1) / this->tileSize;
+
+	// Se a seleção de fontes varia entre pixels, a de cada pixel fica no G-buffer para Canvas::shade
+	const LightIndex& lightIndex = scene.getLightIndex();
+	gbuffer->resize(columns, lines, scene.getSources().size(), lightIndex.isUniform() ? 0 : lightIndex.getMaxSelected());
+	gbuffer->observable = observable;
+
+	this->prepareLightBuffers(scene);
+
+	auto traceTile = [&](int tile, int worker)
+	{
+		LightIndex::Selection* lights = &this->lightBuffers[worker];
+		int line = (tile / tilesX) * this->tileSize, column = (tile % tilesX) * this->tileSize;
+
+		this->traceRegion(line, column, std::min(this->tileSize, lines - line), std::min(this->tileSize, columns - column), observable, scene,
+						  [&](int l, int c, const Ray& ray, const HitRecord& hit, Object* object)
+		{
+			if (object == NULL)
+			{
+				gbuffer->setMiss(gbuffer->index(l, c));
+				return;
+			}
+
+			this->traceShadows(ray, hit, scene, this->pixelSeed(l, c), lights);
+			gbuffer->setHit(gbuffer->index(l, c), object, hit, *lights);
+		});
+	};
+
+	this->runTiles(tilesX * tilesY, [&](int tile, int worker)
+	{
+		traceTile(tile, worker);
+	});
+}
+
+/**
+ * @brief Passada de sombreamento da renderização adiada.
+ * 
+ * Não traça raios: o raio primário de cada pixel é refeito a partir do ponto de observação
+ * guardado no G-buffer, e a interseção e as sombras vêm do G-buffer. Se todos os pixels veem as
+ * mesmas fontes, cada linha do bloco é sombreada em lotes de SHADE_BATCH_SIZE pixels pelo
+ * PhongBatch; senão cada pixel usa as fontes escolhidas em trace, guardadas no G-buffer, e é
+ * sombreado sozinho. Nos dois casos as contas são as de Object::shade, e a cor é a mesma de raycast.
+ */
+void Canvas::shade(const RenderScene& scene, const GBuffer& gbuffer, Framebuffer* image)
+{
+	int lines = (int)this->numLines, columns = (int)this->numColumns;
+	int tilesX = (columns + this->tileSize - 1) / this->tileSize;
+	int tilesY = (lines + this->tileSize - 1) / this->tileSize;
+
+	this->prepareLightBuffers(scene);
+
+	auto shadeTile = [&](int tile, int worker)
+	{
+		LightIndex::Selection* lights = &this->lightBuffers[worker];
+		Framebuffer::Tile region = image->tile((tile / tilesX) * this->tileSize, (tile % tilesX) * this->tileSize, this->tileSize, this->tileSize);
+		HitRecord hit;
+
+		if (gbuffer.getMaxLights() == 0)
+		{
+			// Em trace todos os pixels viram todas as fontes da cena, em ordem
+			lights->indices.clear();
+			lights->weights.clear();
+			for (size_t source = 0; source < scene.getSources().size(); source++)
+			{
+				lights->indices.push_back(source);
+			}
+			scene.getLightIndex().restore(lights);
 
-			// Se houver interseção, calcula a cor do pixel
-			if (idxMin != -1)
+			PhongBatch<SHADE_BATCH_SIZE> batch;
+			int pixels[SHADE_BATCH_SIZE], batchColumns[SHADE_BATCH_SIZE];
+			Vector3 ambient;
+			int material;
+
+			for (int l = region.line; l < region.line + region.numLines; l++)
 			{
-				Eigen::Vector3d pInt = ray.initialPoint + minimum * ray.direction;
-				Eigen::Vector3d sourceDirection(0, 0, 0);
-					
-				for (auto& source : scene.sources)
+				for (int first = region.column; first < region.column + region.numColumns; first += SHADE_BATCH_SIZE)
 				{
-					int idx2 = 0;
-					sourceDirection = source->getDirection(pInt);
+					int last = std::min(first + SHADE_BATCH_SIZE, region.column + region.numColumns);
+					batch.clear();
 
-					if (sourceDirection.norm() != 0)
+					for (int c = first, i = gbuffer.index(l, first); c < last; c++, i++)
 					{
-						std::vector<double> distanceToSource(numObjectsVector);
-						Ray sourceRay(source->origin, pInt);
+						Object* object = gbuffer.objects[i];
 
-						for (int i = 0; i < numObjects; i++)
+						if (object == NULL)
 						{
-							distanceToSource[idx2] = ((*scene.objects[i]).hasInterceptedRay(sourceRay));
-							idx2++;
+							region.setPixel(l, c, Vector3(0, 0, 0));
+							continue;
 						}
 
-						for (int i = 0; i < numHitBoxes; i++)
-						{
-							int numElements = (*scene.hitboxes[i]).getNumElements();
-							if ((*scene.hitboxes[i]).hasInterceptedRay(sourceRay))
-							{
-								for (int j = 0; j < numElements; j++)
-								{
-									distanceToSource[idx2] = ((*scene.hitboxes[i]->objects[j]).hasInterceptedRay(sourceRay));
-									idx2++;
-								}
-							}
-						}
+						gbuffer.getHit(i, &hit);
+						Ray ray = this->primaryRay(l, c, gbuffer.observable);
+						object->getSurface(ray, hit, &ambient, &material);
 
-						double minimum2 = -INFINITY;
-						int idxMin2 = -1;
+						int k = batch.add(ray.initialPoint + hit.t * ray.direction, hit.normal, ray.direction, ambient, scene.getMaterials().get(material));
+						pixels[k] = i;
+						batchColumns[k] = c;
+					}
 
-						for (int i = 0; i < idx2; i++)
-						{
-							if (distanceToSource[i] < 0 && distanceToSource[i] > minimum2)
-							{
-								minimum2 = distanceToSource[i];
-								idxMin2 = i;
-							}
-						}
+					batch.shade(lights->sources, [&](int source, int k)
+					{
+						return gbuffer.isShadowed(pixels[k], lights->indices[source]);
+					});
 
-						if (idxMin == idxMin2)
-						{
-							isShadowed.push_back(false);
-						}
-						else
-						{
-							isShadowed.push_back(true);
-						}
-					}
-					else
+					for (int k = 0; k < batch.count; k++)
 					{
-						isShadowed.push_back(false);
+						region.setPixel(l, batchColumns[k], batch.getColor(k));
 					}
 				}
+			}
+			return;
+		}
 
-				// Calcula a cor do pixel
-				Eigen::Vector3d color = objects[idxMin]->computeColor(minimum, ray, scene.sources, isShadowed);
+		for (int l = region.line; l < region.line + region.numLines; l++)
+		{
+			int i = gbuffer.index(l, region.column);
 
-				canvas.red(l, c) = color(0);
-				canvas.green(l, c) = color(1);
-				canvas.blue(l, c) = color(2);
-			}
-			else
+			for (int c = region.column; c < region.column + region.numColumns; c++, i++)
 			{
-				canvas.red(l, c) = 0;
-				canvas.green(l, c) = 0;
-				canvas.blue(l, c) = 0;
+				Object* object = gbuffer.objects[i];
+
+				if (object == NULL)
+				{
+					region.setPixel(l, c, Vector3(0, 0, 0));
+					continue;
+				}
+
+				gbuffer.getHit(i, &hit);
+
+				// As fontes são as escolhidas em trace (as sombras só valem para elas), com as intensidades atuais
+				Ray ray = this->primaryRay(l, c, gbuffer.observable);
+				gbuffer.getLights(i, lights);
+				scene.getLightIndex().restore(lights);
+				region.setPixel(l, c, object->shade(ray, hit, lights->sources, lights->shadows, scene.getMaterials()));
 			}
-			
 		}
-	}
+	};
 
-	return canvas;
-}
\ No newline at end of file
+	this->runTiles(tilesX * tilesY, [&](int tile, int worker)
+	{
+		shadeTile(tile, worker);
+	});
+}
@@ -1,8 +1,15 @@
 #include "../eigen-3.4.0/Eigen/Dense" 
+#include <functional>
+#include <vector>
 
+#include "Framebuffer.h"
+#include "GBuffer.h"
+#include "Scalar.h"
 #include "Tensor.h"
 #include "Ray.h"
 #include "Scene.h"
+#include "RenderScene.h"
+#include "ThreadPool.h"
 
 #ifndef Canvas_H
 #define Canvas_H
@@ -13,29 +20,142 @@ class Canvas
 	Classe do Canvas
 	*/
 public:
-	double windowDistance;
-	double windowWidth;
-	double windowHeight;
-	double numLines;
-	double numColumns;
-	double deltaX;
-	double deltaY;
-	double jXMin;
-	double jYMax;
+	Scalar windowDistance;
+	Scalar windowWidth;
+	Scalar windowHeight;
+	Scalar numLines;
+	Scalar numColumns;
+	Scalar deltaX;
+	Scalar deltaY;
+	Scalar jXMin;
+	Scalar jYMax;
+
+	int numThreads; // Número de threads da renderização por blocos (1 = sem threads)
+	int tileSize;   // Lado, em pixels, de cada bloco da imagem
+	int packetSize; // Lado dos pacotes de raios primários (0 = um raio por vez)
 
 	// Construtor da Classe Canvas
-	Canvas(double windowDistance, double windowWidth, double windowHeight, double numLines, double numColumns);
+	Canvas(Scalar windowDistance, Scalar windowWidth, Scalar windowHeight, Scalar numLines, Scalar numColumns);
+
+	// Destrutor da Classe Canvas (encerra o pool de threads)
+	~Canvas();
+
+	Canvas(const Canvas&) = delete;
+	Canvas& operator=(const Canvas&) = delete;
 
+	/**
+	 * Configura a renderização por blocos.
+	 * 
+	 * A imagem é dividida em blocos de tileSize x tileSize pixels, renderizados por um pool
+	 * de numThreads threads que é mantido entre chamadas de raycast.
+	 * 
+	 * @param numThreads Número de threads; valores menores que 1 usam o número de núcleos da máquina.
+	 * @param tileSize Lado de cada bloco, em pixels.
+	 */
+	void setTiling(int numThreads, int tileSize);
+
+	/**
+	 * Liga ou desliga o traçado de raios primários em pacotes.
+	 * 
+	 * Com packetSize 4 ou 8, cada bloco da imagem é percorrido em pacotes de packetSize x packetSize
+	 * pixels que atravessam a BVH juntos (RenderScene::intersectPacket). A imagem é a mesma do
+	 * traçado de um raio por vez; só as sombras e o sombreamento continuam raio a raio.
+	 *
+	 * Os pacotes compartilham os testes de caixas e de esferas, planos, discos e faces triangulares;
+	 * cilindros, cones, malhas e as esferas do SphereSet são testados raio a raio. O ganho depende
+	 * da cena: é grande quando as folhas têm muitos desses objetos simples, e pequeno ou nenhum
+	 * quando a maior parte do custo está nos demais, como na cena das estações.
+	 * 
+	 * @param packetSize 0 para desligar, 4 ou 8; outros valores são limitados a [0, 8].
+	 */
+	void setPacketSize(int packetSize);
+
+
+	/**
+	 * Realiza um lançamento de raio a partir de um ponto de observação e escreve o resultado em uma imagem.
+	 * 
+	 * Cada bloco da renderização escreve só na sua região da imagem (Framebuffer::Tile).
+	 * 
+	 * @param observable O ponto de observação a partir do qual o raio é lançado.
+	 * @param scene A cena compilada (em coordenadas de câmera) na qual o raio é lançado.
+	 * @param image A imagem de destino, com numColumns colunas e numLines linhas (RGB_FLOAT ou RGBA8).
+	 */
+	void raycast(Vector3 observable, const RenderScene& scene, Framebuffer* image);
 
 	/**
 	 * Realiza um lançamento de raio a partir de um ponto de observação para a cena especificada.
 	 * 
+	 * Mantido por compatibilidade: renderiza em um Framebuffer RGB_FLOAT e o converte para Tensor.
+	 * 
+	 * @param observable O ponto de observação a partir do qual o raio é lançado.
+	 * @param scene A cena compilada (em coordenadas de câmera) na qual o raio é lançado.
+	 * @return Um tensor contendo as informações resultantes do lançamento de raio.
+	 */
+	Tensor raycast(Vector3 observable, const RenderScene& scene);
+
+	/**
+	 * Compila a cena para a câmera dela e realiza o lançamento de raio.
+	 * 
+	 * Os objetos da cena não são alterados. Para renderizar a mesma cena várias vezes ou
+	 * selecionar objetos com o mouse, prefira compilar uma RenderScene e reutilizá-la.
+	 * 
 	 * @param observable O ponto de observação a partir do qual o raio é lançado.
-	 * @param scene A cena na qual o raio é lançado.
-	 * @param toCamera Um valor booleano que indica se o raio deve ser lançado em direção à câmera.
+	 * @param scene A cena de autoria.
 	 * @return Um tensor contendo as informações resultantes do lançamento de raio.
 	 */
-	Tensor raycast(Eigen::Vector3d observable, Scene scene, bool toCamera);
+	Tensor raycast(Vector3 observable, const Scene& scene);
+
+	/**
+	 * Passada de visibilidade da renderização adiada: traça os raios primários e os raios de sombra
+	 * e grava no G-buffer, para cada pixel, o objeto atingido, a interseção e as sombras.
+	 * 
+	 * trace seguido de shade produz a mesma imagem de raycast. Depois de trace, mudanças que só
+	 * afetam o sombreamento (intensidade das fontes, materiais, texturas) só precisam de shade.
+	 * 
+	 * @param observable O ponto de observação a partir do qual o raio é lançado.
+	 * @param scene A cena compilada (em coordenadas de câmera) na qual o raio é lançado.
+	 * @param gbuffer O G-buffer de destino; é redimensionado para numColumns x numLines pixels.
+	 */
+	void trace(Vector3 observable, const RenderScene& scene, GBuffer* gbuffer);
+
+	/**
+	 * Passada de sombreamento da renderização adiada: calcula a cor de cada pixel a partir do G-buffer,
+	 * sem traçar nenhum raio.
+	 * 
+	 * @param scene A mesma cena compilada usada em trace (os objetos do G-buffer apontam para ela),
+	 * com o mesmo número de fontes de luz.
+	 * @param gbuffer O G-buffer preenchido por trace.
+	 * @param image A imagem de destino, com numColumns colunas e numLines linhas (RGB_FLOAT ou RGBA8).
+	 */
+	void shade(const RenderScene& scene, const GBuffer& gbuffer, Framebuffer* image);
+
+private:
+	ThreadPool* threadPool; // Pool persistente, criado na primeira renderização com threads
+
+	// Fontes escolhidas e sombras de cada thread, reaproveitadas entre pixels e quadros
+	std::vector<LightIndex::Selection> lightBuffers;
+
+	// Raio primário do pixel (l, c)
+	Ray primaryRay(int l, int c, const Vector3& observable) const;
+
+	// Reserva a seleção de fontes de cada thread para as fontes da cena (só aloca quando a cena ganha fontes)
+	void prepareLightBuffers(const RenderScene& scene);
+
+	// Semente do sorteio de fontes do pixel (l, c)
+	unsigned int pixelSeed(int l, int c) const;
+
+	// Executa job(bloco, thread) para cada bloco da imagem, na thread atual ou no pool
+	void runTiles(int numTiles, const std::function<void(int, int)>& job);
+
+	// Traça os raios primários de uma região (um raio por vez ou em pacotes) e chama visit(l, c, ray, hit, object) em cada pixel, com object NULL se nada foi atingido
+	template <typename Visit>
+	void traceRegion(int line, int column, int numLines, int numColumns, const Vector3& observable, const RenderScene& scene, Visit visit);
+
+	// Escolhe as fontes que iluminam o ponto de uma interseção e testa se cada uma está bloqueada
+	void traceShadows(const Ray& ray, const HitRecord& hit, const RenderScene& scene, unsigned int seed, LightIndex::Selection* lights) const;
+
+	// Cor de uma interseção já encontrada: raios de sombra e sombreamento do objeto
+	Vector3 shadeHit(const Ray& ray, const HitRecord& hit, Object* object, const RenderScene& scene, unsigned int seed, LightIndex::Selection* lights) const;
 };
 
 #endif
\ No newline at end of file
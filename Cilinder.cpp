@@ -7,29 +7,23 @@
  * @param radius O raio do cilindro.
  * @param centerBase O centro da base do cilindro.
  * @param centerTop O centro do topo do cilindro.
- * @param kAmbient O coeficiente de reflexão ambiente do cilindro.
- * @param kDif O coeficiente de reflexão difusa do cilindro.
- * @param kEsp O coeficiente de reflexão especular do cilindro.
- * @param specularIndex O índice especular do cilindro.
+ * @param material Índice do material na tabela de materiais da cena (Scene::materials).
  */
-Cilinder::Cilinder(double radius, Eigen::Vector3d centerBase, Eigen::Vector3d centerTop, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex)
+Cilinder::Cilinder(Scalar radius, Vector3 centerBase, Vector3 centerTop, int material)
 {
 	this->radius = radius;
 	this->centerBase = centerBase;
 	this->centerTop = centerTop;
 	this->direction = (centerTop - centerBase).normalized();
 	this->height = (centerTop - centerBase).norm();
-	this->kAmbient = kAmbient;
-	this->kDif = kDif;
-	this->kEsp = kEsp;
-	this->specularIndex = specularIndex;
-
-	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
-	this->structure = 0;
+	this->material = material;
+
+	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->material);
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
-Cilinder::Cilinder(double radius, double height, Eigen::Vector3d centerBase, Eigen::Vector3d direction, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex)
+Cilinder::Cilinder(Scalar radius, Scalar height, Vector3 centerBase, Vector3 direction, int material)
 {
 	this->radius = radius;
 	this->height = height;
@@ -38,123 +32,214 @@ Cilinder::Cilinder(double radius, double height, Eigen::Vector3d centerBase, Eig
 
 	this->centerTop = centerBase + height * this->direction;
 
-	this->kAmbient = kAmbient;
-	this->kDif = kDif;
-	this->kEsp = kEsp;
-	this->specularIndex = specularIndex;
+	this->material = material;
+
+	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->material);
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
+}
+
+/**
+ * @brief Recalcula os termos que não dependem do raio e escolhe a variante de interseção.
+ *
+ * Chamada ao final dos construtores e de cada transformação. A variante alinhada é usada quando
+ * a direção é exatamente ±x, ±y ou ±z: nesse caso os produtos escalares com a direção são
+ * exatamente ± uma coordenada, e as duas variantes dão o mesmo resultado.
+ */
+void Cilinder::updateGeometry()
+{
+	this->radius2 = this->radius * this->radius;
+	this->axis = -1;
+	this->axisSign = 1;
 
-	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
-	this->structure = 0;
+	for (int k = 0; k < 3; k++)
+	{
+		if (std::abs(this->direction[k]) == 1 && this->direction[(k + 1) % 3] == 0 && this->direction[(k + 2) % 3] == 0)
+		{
+			this->axis = k;
+			this->axisSign = this->direction[k];
+		}
+	}
 }
 
 /**
  * Calcula o ponto de intersecção entre o raio e o cilindro.
  *
  * @param ray The ray to intersect with the cylinder.
- * @return The parameter value t at which the intersection occurs. Returns 1 if no intersection is found.
+ * @param hit The record filled with t, the part that was hit (0 = side, 1 = top, 2 = bottom) and the normal.
+ * @return true if an intersection is found.
+ */
+bool Cilinder::intersect(const Ray& ray, HitRecord* hit) const
+{
+	if (this->axis >= 0)
+	{
+		return this->intersectAligned(ray, hit);
+	}
+
+	return this->intersectGeneral(ray, hit);
+}
+
+/**
+ * Interseção com um cilindro de direção qualquer.
  */
-double Cilinder::hasInterceptedRay(Ray ray)
+bool Cilinder::intersectGeneral(const Ray& ray, HitRecord* hit) const
 {
-	Eigen::Vector3d w = ray.initialPoint - this->centerBase;
-	Eigen::Vector3d pInt(0, 0, 0);
+	Vector3 w = ray.initialPoint - this->centerBase;
+	Scalar tSide = INFINITY;
 
-	double returnValue = 1;
+	Scalar dDotAxis = ray.direction.dot(this->direction);
+	Scalar wDotAxis = w.dot(this->direction);
 
-	double a = ray.direction.dot(ray.direction) - pow(ray.direction.dot(this->direction), 2);
-	double b = 2 * w.dot(ray.direction) - 2 * w.dot(this->direction) * ray.direction.dot(this->direction);
-	double c = w.dot(w) - pow(w.dot(this->direction), 2) - pow(this->radius, 2);
+	Scalar a = ray.direction.dot(ray.direction) - dDotAxis * dDotAxis;
+	Scalar b = 2 * w.dot(ray.direction) - 2 * wDotAxis * dDotAxis;
+	Scalar c = w.dot(w) - wDotAxis * wDotAxis - this->radius2;
 
-	double delta = b * b - 4 * a * c;
-	// Se delta < 0, não há intersecção
-	if (a != 0 && delta >= 0)
+	Scalar delta = b * b - 4 * a * c;
+
+	// A reta não atinge o cilindro infinito, então também não atinge as tampas, que estão dentro dele
+	if (a != 0 && delta < 0)
 	{
-		double tInt = (sqrt(delta) - b) / (2 * a);
+		return false;
+	}
 
-		pInt = ray.initialPoint + tInt * ray.direction;
-		double insideInterval = (pInt - this->centerBase).dot(this->direction);
+	if (a != 0)
+	{
+		Scalar tInt = (-b - sqrt(delta)) / (2 * a);
+
+		Vector3 pInt = ray.initialPoint + tInt * ray.direction;
+		Scalar insideInterval = (pInt - this->centerBase).dot(this->direction);
 
 		// Verifica se o ponto de intersecção está dentro do intervalo do cilindro
 		if (insideInterval >= 0 && insideInterval <= this->height)
 		{
-			returnValue = tInt;
-			this->structure = 0;
+			tSide = tInt;
 		}
+	}
+
+	// As tampas são sempre CircularPlane: a chamada qualificada dispensa a busca na tabela virtual
+	HitRecord caps[2];
+	caps[0].t = this->top->CircularPlane::intersect(ray, &caps[0]) ? caps[0].t : INFINITY;
+	caps[1].t = this->bottom->CircularPlane::intersect(ray, &caps[1]) ? caps[1].t : INFINITY;
+
+	return this->closestHit(ray, tSide, caps, hit);
+}
+
+/**
+ * Interseção com um cilindro paralelo ao eixo axis: as mesmas contas de intersectGeneral, com
+ * os produtos escalares com a direção trocados pela coordenada axis.
+ */
+bool Cilinder::intersectAligned(const Ray& ray, HitRecord* hit) const
+{
+	int k = this->axis;
+	Vector3 w = ray.initialPoint - this->centerBase;
+	Scalar tSide = INFINITY;
+
+	Scalar dDotAxis = this->axisSign * ray.direction[k];
+	Scalar wDotAxis = this->axisSign * w[k];
+
+	Scalar a = ray.direction.dot(ray.direction) - dDotAxis * dDotAxis;
+	Scalar b = 2 * w.dot(ray.direction) - 2 * wDotAxis * dDotAxis;
+	Scalar c = w.dot(w) - wDotAxis * wDotAxis - this->radius2;
+
+	Scalar delta = b * b - 4 * a * c;
 
+	if (a != 0 && delta < 0)
+	{
+		return false;
 	}
-	// Verifica se o raio intercepta a base superior(e inferior) do cilindro
-	double top = this->top->hasInterceptedRay(ray);
-	double bottom = this->bottom->hasInterceptedRay(ray);
 
-	double minimum = -INFINITY;
+	if (a != 0)
+	{
+		Scalar tInt = (-b - sqrt(delta)) / (2 * a);
+		Scalar insideInterval = this->axisSign * (ray.initialPoint[k] + tInt * ray.direction[k] - this->centerBase[k]);
+
+		if (insideInterval >= 0 && insideInterval <= this->height)
+		{
+			tSide = tInt;
+		}
+	}
+
+	HitRecord caps[2];
+	caps[0].t = this->top->intersectAxis(ray, k, &caps[0]) ? caps[0].t : INFINITY;
+	caps[1].t = this->bottom->intersectAxis(ray, k, &caps[1]) ? caps[1].t : INFINITY;
+
+	return this->closestHit(ray, tSide, caps, hit);
+}
+
+/**
+ * Escolhe a interseção mais próxima entre a lateral e as tampas e preenche hit.
+ *
+ * @param ray O raio.
+ * @param tSide O t da lateral (infinito se não houver).
+ * @param caps Os registros do topo e da base (t infinito se não houver).
+ * @param hit O registro a ser preenchido.
+ * @return true se alguma parte foi atingida.
+ */
+bool Cilinder::closestHit(const Ray& ray, Scalar tSide, const HitRecord* caps, HitRecord* hit) const
+{
+	Scalar minimum = INFINITY;
 	int idx = -1;
-	std::vector <double> distances = { returnValue, top, bottom };
+	Scalar distances[3] = { tSide, caps[0].t, caps[1].t };
 	
 	// Verifica qual é o ponto de intersecção mais próximo
 	for (int i = 0; i < 3; i++)
 	{
-		// Se o ponto de intersecção for válido e menor que o mínimo atual
-		if (distances[i] < 0 && distances[i] > minimum)
+		// Se o ponto de intersecção estiver no intervalo do raio e for menor que o mínimo atual
+		if (ray.contains(distances[i]) && distances[i] < minimum)
 		{
 			minimum = distances[i];
 			idx = i;
-			this->structure = i;
 		}
 	}
 
-	if (idx != -1)
-		return distances[idx];
+	if (idx == -1)
+		return false;
 
-	return 1;
+	// A normal das tampas vem do próprio plano circular
+	if (idx != 0)
+	{
+		*hit = caps[idx - 1];
+		hit->structure = idx;
+		return true;
+	}
+
+	Vector3 pInt = ray.initialPoint + minimum * ray.direction;
+
+	Vector3 v = pInt - this->centerBase;
+	Vector3 projection = (v.dot(this->direction)) * this->direction;
+
+	hit->t = minimum;
+	hit->structure = 0;
+	hit->normal = (v - projection).normalized();
+	hit->hasUV = false;
+	return true;
 }
 
 /**
- * Função que calcular a cor de um cilindro.
+ * Função que obtém a intensidade ambiente inicial e o material de um cilindro no ponto de interseção.
  * 
- * @param tInt O valor de t da interseção do raio com o cilindro.
  * @param ray O raio que intersecta o cilindro.
- * @param sources Um vetor de ponteiros para as fontes de luz.
- * @param shadows Um vetor de booleanos indicando se há sombras nas fontes de luz.
- * 
- * @return A cor calculada para o cilindro.
+ * @param hit O registro da interseção.
+ * @param ambient Ponteiro para a intensidade ambiente inicial.
+ * @param material Ponteiro para o índice do material.
  */
-Eigen::Vector3d Cilinder::computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows)
+void Cilinder::getSurface(const Ray& ray, const HitRecord& hit, Vector3* ambient, int* material) const
 {	
-	// computa a cor do cilindro
-	if (this->structure == 0)
+	// superfície lateral do cilindro
+	if (hit.structure == 0)
 	{
-		Eigen::Vector3d intesityEye(0, 0, 0);
-		Eigen::Vector3d pInt = ray.initialPoint + tInt * ray.direction;
-
-		Eigen::Vector3d intesityAmbient(0, 0, 0);
-		Eigen::Vector3d intesityDifuse(0, 0, 0);
-		Eigen::Vector3d intesitySpecular(0, 0, 0);
-		Eigen::Vector3d singleDifuse;
-		Eigen::Vector3d singleSpecular;
-
-		Eigen::Vector3d v = pInt - this->centerBase;
-		Eigen::Vector3d projection = (v.dot(this->direction)) * this->direction;
-		Eigen::Vector3d normal = (v - projection).normalized();
-
-		int idx = 0;
-		for (auto& source : sources)
-		{
-			source->computeIntensity(pInt, ray, &intesityAmbient, &intesityDifuse, &intesitySpecular, normal, this->kAmbient, this->kDif, this->kEsp, this->specularIndex, shadows[idx]);
-			idx++;
-		}
-
-		intesityEye = intesityDifuse + intesitySpecular + intesityAmbient;
-		return intesityEye;
+		*ambient = Vector3(0, 0, 0);
+		*material = this->material;
 	}
-	// computa a cor da tampa superior
-	else if (this->structure == 1)
+	// tampa superior
+	else if (hit.structure == 1)
 	{
-		return this->top->computeColor(tInt, ray, sources, shadows);
+		this->top->getSurface(ray, hit, ambient, material);
 	}
-	// computa a cor da tampa inferior
+	// tampa inferior
 	else
 	{
-		return this->bottom->computeColor(tInt, ray, sources, shadows);
+		this->bottom->getSurface(ray, hit, ambient, material);
 	}
 }
 
@@ -163,16 +248,16 @@ Eigen::Vector3d Cilinder::computeColor(double tInt, Ray ray, std::vector<LightSo
  *  Função de translação do cilindro.	
  
 */
-void Cilinder::translate(double x, double y, double z)
+void Cilinder::translate(Scalar x, Scalar y, Scalar z)
 {
-	Eigen::Matrix4d m;
+	Matrix4 m;
 	m << 1, 0, 0, x,
 		 0, 1, 0, y,
 	  	 0, 0, 1, z,
 		 0, 0, 0, 1;
 
-	Eigen::Vector4d centerTop4;
-	Eigen::Vector4d centerBase4;
+	Vector4 centerTop4;
+	Vector4 centerBase4;
 
 	// Adiciona uma quarta coordenada para realizar a translação
 	centerTop4 << this->centerTop[0], this->centerTop[1], this->centerTop[2], 1;
@@ -189,9 +274,10 @@ void Cilinder::translate(double x, double y, double z)
 	this->direction = (this->centerTop - this->centerBase).normalized();
 	this->bottom->translate(x, y, z);
 	this->top->translate(x, y, z);
+	this->updateGeometry();
 }
 
-void  Cilinder::scale(double x, double y, double z)
+void  Cilinder::scale(Scalar x, Scalar y, Scalar z)
 {
 	/*
 	x -> Raio
@@ -204,8 +290,11 @@ void  Cilinder::scale(double x, double y, double z)
 
 	// Atualiza o centro do topo e da base
 	this->centerTop = this->centerBase + this->height * this->direction;
-	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
+	delete this->top;
+	delete this->bottom;
+	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->material);
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
 
@@ -214,15 +303,15 @@ void  Cilinder::scale(double x, double y, double z)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void  Cilinder::rotateX(double angle)
+void  Cilinder::rotateX(Scalar angle)
 {
-	Eigen::Matrix4d rx;
+	Matrix4 rx;
 	rx << 1, 0, 0, 0,
 		  0, cos(angle), -sin(angle), 0,
 		  0, sin(angle), cos(angle), 0,
 		  0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->direction[0], this->direction[1], this->direction[2], 0;
 
 	newDir = rx * newDir;
@@ -230,8 +319,11 @@ void  Cilinder::rotateX(double angle)
 	this->direction = (this->direction).normalized();
 
 	this->centerTop = this->centerBase + this->height * this->direction;
-	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
+	delete this->top;
+	delete this->bottom;
+	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->material);
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
 /**
@@ -239,15 +331,15 @@ void  Cilinder::rotateX(double angle)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void  Cilinder::rotateY(double angle)
+void  Cilinder::rotateY(Scalar angle)
 {
-	Eigen::Matrix4d ry;
+	Matrix4 ry;
 	ry << cos(angle), 0, sin(angle), 0,
 		0, 1, 0, 0,
 		-sin(angle), 0, cos(angle), 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->direction[0], this->direction[1], this->direction[2], 0;
 
 	newDir = ry * newDir;
@@ -255,8 +347,11 @@ void  Cilinder::rotateY(double angle)
 	this->direction = (this->direction).normalized();
 
 	this->centerTop = this->centerBase + this->height * this->direction;
-	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
+	delete this->top;
+	delete this->bottom;
+	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->material);
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
 /**
@@ -264,15 +359,15 @@ void  Cilinder::rotateY(double angle)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void  Cilinder::rotateZ(double angle)
+void  Cilinder::rotateZ(Scalar angle)
 {
-	Eigen::Matrix4d rz;
+	Matrix4 rz;
 	rz << cos(angle), -sin(angle), 0, 0,
 		  sin(angle), cos(angle), 0, 0,
 		  0, 0, 1, 0,
 		  0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->direction[0], this->direction[1], this->direction[2], 0;
 
 	newDir = rz * newDir;
@@ -280,15 +375,18 @@ void  Cilinder::rotateZ(double angle)
 	this->direction = (this->direction).normalized();
 
 	this->centerTop = this->centerBase + this->height * this->direction;
-	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
+	delete this->top;
+	delete this->bottom;
+	this->top = new CircularPlane(this->direction, this->centerTop, this->radius, this->material);
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
 // Converte o cilindro para o sistema de coordenadas da câmera
-void Cilinder::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void Cilinder::convertToCamera(Matrix4 transformationMatrix)
 {
-	Eigen::Vector4d centerTop;
-	Eigen::Vector4d centerBase;
+	Vector4 centerTop;
+	Vector4 centerBase;
 
 	centerTop << this->centerTop[0], this->centerTop[1], this->centerTop[2], 1;
 	centerBase << this->centerBase[0], this->centerBase[1], this->centerBase[2], 1;
@@ -302,4 +400,55 @@ void Cilinder::convertToCamera(Eigen::Matrix4d transformationMatrix)
 	this->direction = (this->centerTop - this->centerBase).normalized();
 	this->bottom->convertToCamera(transformationMatrix);
 	this->top->convertToCamera(transformationMatrix);
+	this->updateGeometry();
+}
+
+// Construtor de cópia: o cilindro novo tem as suas próprias tampas
+Cilinder::Cilinder(const Cilinder& other)
+	: Object(other), radius(other.radius), height(other.height), centerBase(other.centerBase), centerTop(other.centerTop),
+	  direction(other.direction), bottom(new CircularPlane(*other.bottom)), top(new CircularPlane(*other.top)),
+	  radius2(other.radius2), axis(other.axis), axisSign(other.axisSign)
+{
+}
+
+// Atribuição: as tampas continuam sendo deste cilindro e recebem uma cópia das tampas de other
+Cilinder& Cilinder::operator=(const Cilinder& other)
+{
+	if (this != &other)
+	{
+		Object::operator=(other);
+		this->radius = other.radius;
+		this->height = other.height;
+		this->centerBase = other.centerBase;
+		this->centerTop = other.centerTop;
+		this->direction = other.direction;
+		*this->bottom = *other.bottom;
+		*this->top = *other.top;
+		this->radius2 = other.radius2;
+		this->axis = other.axis;
+		this->axisSign = other.axisSign;
+	}
+	return *this;
+}
+
+// Destrutor: as tampas pertencem ao cilindro
+Cilinder::~Cilinder()
+{
+	delete this->top;
+	delete this->bottom;
+}
+
+// Cria uma cópia do cilindro, com cópias próprias das tampas
+Object* Cilinder::clone() const
+{
+	return new Cilinder(*this);
+}
+
+// Calcula a caixa delimitadora do cilindro: a união dos discos da base e do topo
+bool Cilinder::getBounds(AABB* box) const
+{
+	*box = AABB();
+	box->expandDisc(this->centerBase, this->direction, this->radius);
+	box->expandDisc(this->centerTop, this->direction, this->radius);
+	return true;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "LightSource.h"
 #include "Object.h"
 #include "CircularPlane.h"
+#include "Scalar.h"
 
 #ifndef Cilinder_H
 #define Cilinder_H
@@ -15,36 +16,67 @@ class Cilinder : public Object
 	Classe para representar uma Cilindro
 	*/
 public:
-	int structure; // Variável para armazenar a estrutura do cilindro
-	double radius; // Raio do cilindro
-	double height; // Altura do cilindro
-	Eigen::Vector3d centerBase; // Centro da base do cilindro
-	Eigen::Vector3d centerTop; // Centro do topo do cilindro
-	Eigen::Vector3d direction; // Direção do cilindro
+	Scalar radius; // Raio do cilindro
+	Scalar height; // Altura do cilindro
+	Vector3 centerBase; // Centro da base do cilindro
+	Vector3 centerTop; // Centro do topo do cilindro
+	Vector3 direction; // Direção do cilindro
 	CircularPlane* bottom; // Ponteiro para o plano circular da base do cilindro
 	CircularPlane* top; // Ponteiro para o plano circular do topo do cilindro
 
 	// Construtor para cilindro com base e topo definidos
-	Cilinder(double radius, Eigen::Vector3d centerBase, Eigen::Vector3d centerTop, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex);
+	Cilinder(Scalar radius, Vector3 centerBase, Vector3 centerTop, int material);
 
 	// Construtor para cilindro com base, altura e direção definidos
-	Cilinder(double radius, double height, Eigen::Vector3d centerBase, Eigen::Vector3d direction, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex);
+	Cilinder(Scalar radius, Scalar height, Vector3 centerBase, Vector3 direction, int material);
 
-	// Função para verificar se o raio intercepta o cilindro
-	double hasInterceptedRay(Ray ray);
+	// Função para calcular a interseção do raio com o cilindro (structure: 0 = lateral, 1 = topo, 2 = base)
+	bool intersect(const Ray& ray, HitRecord* hit) const;
 
-	// Função para calcular a cor do cilindro no ponto de interseção
-	Eigen::Vector3d computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows);
+	// Função para obter a intensidade ambiente e o material no ponto de interseção (da tampa, se for o caso)
+	void getSurface(const Ray& ray, const HitRecord& hit, Vector3* ambient, int* material) const;
 
 	// Funções para realizar transformações no cilindro
-	void translate(double x, double y, double z);
-	void scale(double x, double y, double z);
-	void rotateX(double angle);
-	void rotateY(double angle);
-	void rotateZ(double angle);
+	void translate(Scalar x, Scalar y, Scalar z);
+	void scale(Scalar x, Scalar y, Scalar z);
+	void rotateX(Scalar angle);
+	void rotateY(Scalar angle);
+	void rotateZ(Scalar angle);
 
 	// Função para converter o cilindro para o sistema de coordenadas da câmera
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
+
+	// Construtor de cópia: as tampas são copiadas, não compartilhadas
+	Cilinder(const Cilinder& other);
+
+	// Atribuição: copia as tampas de other sobre as tampas deste cilindro
+	Cilinder& operator=(const Cilinder& other);
+
+	// Destrutor (libera as tampas)
+	~Cilinder();
+
+	// Função para criar uma cópia do cilindro (as tampas também são copiadas)
+	Object* clone() const;
+
+	// Função para calcular a caixa delimitadora do cilindro
+	bool getBounds(AABB* box) const;
+
+private:
+	Scalar radius2; // Quadrado do raio
+	int axis;       // Eixo (0 = x, 1 = y, 2 = z) quando a direção é paralela a um dos eixos; -1 no caso geral
+	Scalar axisSign; // Sinal da direção ao longo de axis (+1 ou -1)
+
+	// Recalcula os termos que não dependem do raio e escolhe a variante de interseção; chamada ao final do construtor e de cada transformação
+	void updateGeometry();
+
+	// Interseção com um cilindro de direção qualquer
+	bool intersectGeneral(const Ray& ray, HitRecord* hit) const;
+
+	// Interseção com um cilindro paralelo a um eixo (os troncos da cena): os produtos com a direção viram uma coordenada
+	bool intersectAligned(const Ray& ray, HitRecord* hit) const;
+
+	// Escolhe entre a lateral (tSide) e as tampas a interseção mais próxima e preenche hit
+	bool closestHit(const Ray& ray, Scalar tSide, const HitRecord* caps, HitRecord* hit) const;
 };
 
 #endif
\ No newline at end of file
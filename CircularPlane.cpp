@@ -6,84 +6,77 @@
  * @param normal Vetor normal ao plano.
  * @param center Vetor que representa o centro do plano.
  * @param radius Raio do plano circular.
- * @param kAmbient Coeficientes de reflexão ambiente do plano.
- * @param kDif Coeficientes de reflexão difusa do plano.
- * @param kEsp Coeficientes de reflexão especular do plano.
- * @param specularIndex Índice especular do plano.
+ * @param material Índice do material na tabela de materiais da cena.
  */
-CircularPlane::CircularPlane(Eigen::Vector3d normal, Eigen::Vector3d center, double radius, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex)
-	: Plane(NULL, normal, center, kAmbient, kDif, kEsp, specularIndex)
+CircularPlane::CircularPlane(Vector3 normal, Vector3 center, Scalar radius, int material)
+	: Plane(NULL, normal, center, material)
 {
 	this->radius = radius;
 }
 
 /**
- * Cheque se o raio intercepta o plano circular
+ * Calcula a interseção do raio com o plano circular
  * 
  * @param ray O raio a ser verificado.
- * @return O parametro t da interseção, ou -1 se não houver interseção.
+ * @param hit O registro a ser preenchido.
+ * @return true se houver interseção.
  */
-double CircularPlane::hasInterceptedRay(Ray ray)
+bool CircularPlane::intersect(const Ray& ray, HitRecord* hit) const
 {
-	Eigen::Vector3d w = ray.initialPoint - this->center;
-	double tInt = -(this->normal.dot(w)) / (this->normal.dot(ray.direction));
+	Vector3 w = ray.initialPoint - this->center;
+	Scalar tInt = -(this->normal.dot(w)) / (this->normal.dot(ray.direction));
 
-	Eigen::Vector3d pInt = ray.initialPoint + tInt * ray.direction;
+	Vector3 pInt = ray.initialPoint + tInt * ray.direction;
 
-	double insideInterval = pow((pInt - this->center).norm(), 2);
-
-	if (tInt < 0 && insideInterval >= 0 && insideInterval <= pow(this->radius, 2))
+	if (ray.contains(tInt) && (pInt - this->center).squaredNorm() <= this->radius * this->radius)
 	{
-		return tInt;
+		hit->t = tInt;
+		hit->structure = 0;
+		hit->normal = this->normal;
+		hit->hasUV = false;
+		return true;
 	}
 
-	return 1;
+	return false;
 }
 
 /**
- * Calcula a cor resultante da interseção entre um raio e um plano circular.
+ * Calcula a interseção do raio com o plano circular quando a normal é ±x, ±y ou ±z
+ * (tampas de cilindros e cones alinhados aos eixos). Dá o mesmo resultado de intersect.
  * 
- * @param tInt O parâmetro t da interseção entre o raio e o plano circular.
- * @param ray O raio que intersecta o plano circular.
- * @param sources Um vetor contendo as fontes de luz no cenário.
- * @param shadows Um vetor de booleanos indicando se cada fonte de luz está bloqueada por sombras.
- * @return A cor resultante da interseção entre o raio e o plano circular.
+ * @param ray O raio a ser verificado.
+ * @param axis O eixo da normal (0, 1 ou 2).
+ * @param hit O registro a ser preenchido.
+ * @return true se houver interseção.
  */
-Eigen::Vector3d CircularPlane::computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows)
+bool CircularPlane::intersectAxis(const Ray& ray, int axis, HitRecord* hit) const
 {
-	Eigen::Vector3d intesityEye(0, 0, 0);
-	Eigen::Vector3d intesityAmbient(0, 0, 0);
-	Eigen::Vector3d intesityDifuse(0, 0, 0);
-	Eigen::Vector3d intesitySpecular(0, 0, 0);
-	Eigen::Vector3d singleDifuse;
-	Eigen::Vector3d singleSpecular;
-	Eigen::Vector3d normal = this->normal;
-	Eigen::Vector3d pInt = ray.initialPoint + tInt * ray.direction;
-
-	int idx = 0;
-
-	for (auto& source : sources)
+	Scalar tInt = (this->center[axis] - ray.initialPoint[axis]) / ray.direction[axis];
+
+	Vector3 pInt = ray.initialPoint + tInt * ray.direction;
+
+	if (ray.contains(tInt) && (pInt - this->center).squaredNorm() <= this->radius * this->radius)
 	{
-		source->computeIntensity(pInt, ray, &intesityAmbient, &intesityDifuse, &intesitySpecular, normal, this->kAmbient, this->kDif, this->kEsp, this->specularIndex, shadows[idx]);
-		idx++;
+		hit->t = tInt;
+		hit->structure = 0;
+		hit->normal = this->normal;
+		hit->hasUV = false;
+		return true;
 	}
 
-	intesityEye = intesityDifuse + intesitySpecular + intesityAmbient;
-
-	return intesityEye;
+	return false;
 }
 
-
 // Metodo para transladar o plano circular
-void CircularPlane::translate(double x, double y, double z)
+void CircularPlane::translate(Scalar x, Scalar y, Scalar z)
 {
-	Eigen::Matrix4d m;
+	Matrix4 m;
 	m << 1, 0, 0, x,
 		 0, 1, 0, y,
 		 0, 0, 1, z,
 		 0, 0, 0, 1;
 
-	Eigen::Vector4d center4;
+	Vector4 center4;
 	center4 << this->center[0], this->center[1], this->center[2], 1;
 
 	center4 = m * center4;
@@ -92,15 +85,15 @@ void CircularPlane::translate(double x, double y, double z)
 }
 
 // Metodo para escalar o plano circular
-void CircularPlane::scale(double x, double y, double z)
+void CircularPlane::scale(Scalar x, Scalar y, Scalar z)
 {
-	Eigen::Matrix4d m;
+	Matrix4 m;
 	m << x, 0, 0, 0,
 		 0, y, 0, 0,
 		 0, 0, z, 0,
 		 0, 0, 0, 1;
 
-	Eigen::Vector4d center4;
+	Vector4 center4;
 	center4 << this->center[0], this->center[1], this->center[2], 1;
 
 	center4 = m * center4;
@@ -109,28 +102,28 @@ void CircularPlane::scale(double x, double y, double z)
 }
 
 // Metodo para rotacionar o plano circular em torno do eixo X
-void  CircularPlane::rotateX(double angle)
+void  CircularPlane::rotateX(Scalar angle)
 {
 
 }
 
 // Metodo para rotacionar o plano circular em torno do eixo Y
-void  CircularPlane::rotateY(double angle)
+void  CircularPlane::rotateY(Scalar angle)
 {
 
 }
 
 
 // Metodo para rotacionar o plano circular em torno do eixo Z
-void  CircularPlane::rotateZ(double angle)
+void  CircularPlane::rotateZ(Scalar angle)
 {
 
 }
 
 // Metodo para converter o plano circular para o sistema de coordenadas da camera
-void CircularPlane::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void CircularPlane::convertToCamera(Matrix4 transformationMatrix)
 {
-	Eigen::Vector4d center4, normal4;
+	Vector4 center4, normal4;
 	center4 << this->center[0], this->center[1], this->center[2], 1;
 	normal4 << this->normal[0], this->normal[1], this->normal[2], 0;
 
@@ -139,4 +132,29 @@ void CircularPlane::convertToCamera(Eigen::Matrix4d transformationMatrix)
 
 	this->center << center4[0], center4[1], center4[2];
 	this->normal << normal4[0], normal4[1], normal4[2];
+}
+
+// Metodo para criar uma copia do plano circular
+Object* CircularPlane::clone() const
+{
+	return new CircularPlane(*this);
+}
+
+// Metodo para calcular a caixa delimitadora do disco
+bool CircularPlane::getBounds(AABB* box) const
+{
+	*box = AABB();
+	box->expandDisc(this->center, this->normal, this->radius);
+	return true;
+}
+
+// Metodo para verificar se o disco bloqueia o segmento
+bool CircularPlane::occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+{
+	Scalar s = -(this->normal.dot(origin - this->center)) / (this->normal.dot(direction));
+
+	if (!(s > 0 && s < tMax))
+		return false;
+
+	return (origin + s * direction - this->center).squaredNorm() <= this->radius * this->radius;
 }
\ No newline at end of file
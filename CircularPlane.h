@@ -1,4 +1,5 @@
 #include "Plane.h"
+#include "Scalar.h"
 
 #ifndef CircularPlane_H
 #define CircularPlane_H
@@ -12,7 +13,7 @@
 class CircularPlane : public Plane
 {
 public:
-	double radius; /**< Raio do plano circular. */
+	Scalar radius; /**< Raio do plano circular. */
 
 	/**
 	 * @brief Construtor da classe CircularPlane.
@@ -20,31 +21,30 @@ public:
 	 * @param normal Vetor normal ao plano.
 	 * @param center Centro do plano circular.
 	 * @param radius Raio do plano circular.
-	 * @param kAmbient Coeficientes de reflexão ambiente.
-	 * @param kDif Coeficientes de reflexão difusa.
-	 * @param kEsp Coeficientes de reflexão especular.
-	 * @param specularIndex Índice de reflexão especular.
+	 * @param material Índice do material na tabela de materiais da cena (Scene::materials).
 	 */
-	CircularPlane(Eigen::Vector3d normal, Eigen::Vector3d center, double radius, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex);
+	CircularPlane(Vector3 normal, Vector3 center, Scalar radius, int material);
 
 	/**
-	 * @brief Verifica se o raio intercepta o plano circular.
+	 * @brief Calcula a interseção do raio com o plano circular.
 	 * 
 	 * @param ray Raio a ser verificado.
-	 * @return Valor de t da interseção, ou -1 se não houver interseção.
+	 * @param hit Registro a ser preenchido (t e normal).
+	 * @return true se houver interseção dentro do disco, à frente do raio.
 	 */
-	double hasInterceptedRay(Ray ray);
+	bool intersect(const Ray& ray, HitRecord* hit) const;
 
 	/**
-	 * @brief Calcula a cor do ponto de interseção com o plano circular.
+	 * @brief Interseção quando a normal é ±x, ±y ou ±z (tampas de cilindros e cones alinhados aos eixos).
 	 * 
-	 * @param tInt Valor de t da interseção.
-	 * @param ray Raio de interseção.
-	 * @param sources Vetor de fontes de luz.
-	 * @param shadows Vetor de booleanos indicando se há sombra no ponto de interseção.
-	 * @return Cor do ponto de interseção.
+	 * Dá o mesmo resultado de intersect, sem os produtos escalares com a normal.
+	 * 
+	 * @param ray Raio a ser verificado.
+	 * @param axis Eixo da normal (0, 1 ou 2).
+	 * @param hit Registro a ser preenchido (t e normal).
+	 * @return true se houver interseção dentro do disco, à frente do raio.
 	 */
-	Eigen::Vector3d computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows);
+	bool intersectAxis(const Ray& ray, int axis, HitRecord* hit) const;
 
 	/**
 	 * @brief Translada o plano circular.
@@ -53,7 +53,7 @@ public:
 	 * @param y Valor de translação no eixo y.
 	 * @param z Valor de translação no eixo z.
 	 */
-	void translate(double x, double y, double z);
+	void translate(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * @brief Escala o plano circular.
@@ -62,35 +62,60 @@ public:
 	 * @param y Valor de escala no eixo y.
 	 * @param z Valor de escala no eixo z.
 	 */
-	void scale(double x, double y, double z);
+	void scale(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * @brief Rotaciona o plano circular em torno do eixo x.
 	 * 
 	 * @param angle Ângulo de rotação em radianos.
 	 */
-	void rotateX(double angle);
+	void rotateX(Scalar angle);
 
 	/**
 	 * @brief Rotaciona o plano circular em torno do eixo y.
 	 * 
 	 * @param angle Ângulo de rotação em radianos.
 	 */
-	void rotateY(double angle);
+	void rotateY(Scalar angle);
 
 	/**
 	 * @brief Rotaciona o plano circular em torno do eixo z.
 	 * 
 	 * @param angle Ângulo de rotação em radianos.
 	 */
-	void rotateZ(double angle);
+	void rotateZ(Scalar angle);
 
 	/**
 	 * @brief Converte o plano circular para o sistema de coordenadas da câmera.
 	 * 
 	 * @param transformationMatrix Matriz de transformação.
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
+
+	/**
+	 * @brief Cria uma cópia do plano circular.
+	 * 
+	 * @return Ponteiro para o novo plano circular.
+	 */
+	Object* clone() const;
+
+	/**
+	 * @brief Calcula a caixa delimitadora do disco.
+	 * 
+	 * @param box Ponteiro para armazenar a caixa.
+	 * @return true (ao contrário do plano, o disco é limitado).
+	 */
+	bool getBounds(AABB* box) const;
+
+	/**
+	 * @brief Verifica se o disco bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 * 
+	 * @param origin A origem do segmento.
+	 * @param direction A direção (unitária) do segmento.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se o segmento cruza o disco.
+	 */
+	bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const;
 };
 
 #endif
\ No newline at end of file
@@ -7,21 +7,14 @@
  * @param angle O ângulo do cone em radianos.
  * @param centerBase O centro da base do cone.
  * @param vertex O vértice do cone.
- * @param kAmbient O coeficiente de reflexão ambiente do cone.
- * @param kDif O coeficiente de reflexão difusa do cone.
- * @param kEsp O coeficiente de reflexão especular do cone.
- * @param specularIndex O índice de especularidade do cone.
+ * @param material Índice do material na tabela de materiais da cena (Scene::materials).
  */
-Cone::Cone(double angle, Eigen::Vector3d centerBase, Eigen::Vector3d vertex, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex)
+Cone::Cone(Scalar angle, Vector3 centerBase, Vector3 vertex, int material)
 {
-	this->structure = 0;
 	this->angle = angle;
 	this->centerBase = centerBase;
 	this->vertex = vertex;
-	this->kAmbient = kAmbient;
-	this->kDif = kDif;
-	this->kEsp = kEsp;
-	this->specularIndex = specularIndex;
+	this->material = material;
 
 	// calculando valor da altura atraves do vertice(vetor) e do centro da base(vetor)
 	this->height = (vertex - centerBase).norm();
@@ -29,7 +22,8 @@ Cone::Cone(double angle, Eigen::Vector3d centerBase, Eigen::Vector3d vertex, Eig
 	this->radius = this->height * tan(this->angle);
 	this->direction = (vertex - centerBase).normalized();
 	// base do cone, feita com um plano circular
-	this->bottom = new CircularPlane(-this->direction, centerBase, radius, kAmbient, kDif, kEsp, specularIndex);
+	this->bottom = new CircularPlane(-this->direction, centerBase, radius, this->material);
+	this->updateGeometry();
 }
 
 /**
@@ -39,126 +33,216 @@ Cone::Cone(double angle, Eigen::Vector3d centerBase, Eigen::Vector3d vertex, Eig
  * @param height A altura do cone.
  * @param centerBase O centro da base do cone.
  * @param direction A direção do cone.
- * @param kAmbient O coeficiente de reflexão ambiente do cone.
- * @param kDif O coeficiente de reflexão difusa do cone.
- * @param kEsp O coeficiente de reflexão especular do cone.
- * @param specularIndex O índice de especularidade do cone.
+ * @param material Índice do material na tabela de materiais da cena (Scene::materials).
  */
-Cone::Cone(double radius, double height, Eigen::Vector3d centerBase, Eigen::Vector3d direction, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex)
+Cone::Cone(Scalar radius, Scalar height, Vector3 centerBase, Vector3 direction, int material)
 {
 	this->radius = radius;
 	this->height = height;
 	this->centerBase = centerBase;
 	this->direction = direction.normalized();
-	this->kAmbient = kAmbient;
-	this->kDif = kDif;
-	this->kEsp = kEsp;
-	this->specularIndex = specularIndex;
-	this->structure = 0;
+	this->material = material;
 
 	// calculando o vertice do cone
 	this->vertex = centerBase + height * this->direction;
 	// calculando o angulo do cone pela arcotangente do raio pela altura
 	this->angle = atan(radius / height);
-	this->bottom = new CircularPlane(-this->direction, centerBase, radius, kAmbient, kDif, kEsp, specularIndex);
+	this->bottom = new CircularPlane(-this->direction, centerBase, radius, this->material);
+	this->updateGeometry();
 }
 
 /**
- * Verifica se um raio intercepta o cone e retorna a distância do ponto de interseção ao ponto inicial do raio.
+ * @brief Recalcula os termos que não dependem do raio e escolhe a variante de interseção.
+ *
+ * A variante alinhada é usada quando a direção é exatamente ±x, ±y ou ±z: nesse caso os produtos
+ * escalares com a direção são exatamente ± uma coordenada, e as duas variantes dão o mesmo resultado.
+ */
+void Cone::updateGeometry()
+{
+	Scalar cosAngle = cos(this->angle);
+	this->cos2 = cosAngle * cosAngle;
+	this->axis = -1;
+	this->axisSign = 1;
+
+	for (int k = 0; k < 3; k++)
+	{
+		if (std::abs(this->direction[k]) == 1 && this->direction[(k + 1) % 3] == 0 && this->direction[(k + 2) % 3] == 0)
+		{
+			this->axis = k;
+			this->axisSign = this->direction[k];
+		}
+	}
+}
+
+/**
+ * Calcula a interseção de um raio com o cone.
  * 
  * @param ray O raio a ser verificado.
- * @return A distância do ponto de interseção ao ponto inicial do raio. Retorna 1 se não houver interseção.
+ * @param hit O registro a ser preenchido com t, a parte atingida e a normal.
+ * @return true se houver interseção.
  */
-double Cone::hasInterceptedRay(Ray ray)
+bool Cone::intersect(const Ray& ray, HitRecord* hit) const
 {
-	Eigen::Vector3d v = (this->vertex - ray.initialPoint);
-	Eigen::Vector3d pInt(0, 0, 0);
+	if (this->axis >= 0)
+	{
+		return this->intersectAligned(ray, hit);
+	}
+
+	return this->intersectGeneral(ray, hit);
+}
+
+/**
+ * Interseção com um cone de direção qualquer.
+ */
+bool Cone::intersectGeneral(const Ray& ray, HitRecord* hit) const
+{
+	Vector3 v = (this->vertex - ray.initialPoint);
+	Scalar tSide = INFINITY;
+
+	Scalar dDotAxis = ray.direction.dot(this->direction);
+	Scalar vDotAxis = v.dot(this->direction);
 
-	double returnValue = 1;
 	// calculando os coeficientes da equacao de segundo grau
-	double a = pow((ray.direction).dot(this->direction), 2) - ((ray.direction).dot(ray.direction)) * pow(cos(this->angle), 2);
-	double b = v.dot(ray.direction) * pow(cos(this->angle), 2) - (v.dot(this->direction)) * ((ray.direction).dot(this->direction));
-	double c = pow(v.dot(this->direction), 2) - v.dot(v) * pow(cos(this->angle), 2);
+	Scalar a = dDotAxis * dDotAxis - ray.direction.dot(ray.direction) * this->cos2;
+	Scalar b = v.dot(ray.direction) * this->cos2 - vDotAxis * dDotAxis;
+	Scalar c = vDotAxis * vDotAxis - v.dot(v) * this->cos2;
 
-	double delta = b * b - a * c;
+	Scalar delta = b * b - a * c;
+
+	// A reta não atinge o cone duplo infinito, então também não atinge a base, que está dentro dele
+	if (a != 0 && delta < 0)
+	{
+		return false;
+	}
 
 	// se o delta for maior ou igual a zero, o raio intercepta o cone
-	if (a != 0 && delta >= 0)
+	if (a != 0)
 	{
-		double tInt = (-sqrt(delta) - b) / a;
-		pInt = ray.initialPoint + tInt * ray.direction;
-		double insideInterval = ((pInt - this->centerBase).dot(this->direction)) / this->direction.norm();
+		Scalar tInt = (sqrt(delta) - b) / a;
+		Vector3 pInt = ray.initialPoint + tInt * ray.direction;
+		Scalar insideInterval = (pInt - this->centerBase).dot(this->direction);
 
 		// se o ponto de intersecao estiver dentro do intervalo da altura do cone, retorna o valor de tInt
 		if (insideInterval >= 0 && insideInterval <= this->height)
 		{
-			returnValue = tInt;
+			tSide = tInt;
 		}
 	}
 
-	double base = this->bottom->hasInterceptedRay(ray);
+	// A base é sempre um CircularPlane: a chamada qualificada dispensa a busca na tabela virtual
+	HitRecord baseHit;
+	baseHit.t = this->bottom->CircularPlane::intersect(ray, &baseHit) ? baseHit.t : INFINITY;
+
+	return this->closestHit(ray, tSide, baseHit, hit);
+}
+
+/**
+ * Interseção com um cone paralelo ao eixo axis: as mesmas contas de intersectGeneral, com os
+ * produtos escalares com a direção trocados pela coordenada axis (e a norma da direção igual a 1).
+ */
+bool Cone::intersectAligned(const Ray& ray, HitRecord* hit) const
+{
+	int k = this->axis;
+	Vector3 v = (this->vertex - ray.initialPoint);
+	Scalar tSide = INFINITY;
+
+	Scalar dDotAxis = this->axisSign * ray.direction[k];
+	Scalar vDotAxis = this->axisSign * v[k];
+
+	Scalar a = dDotAxis * dDotAxis - ray.direction.dot(ray.direction) * this->cos2;
+	Scalar b = v.dot(ray.direction) * this->cos2 - vDotAxis * dDotAxis;
+	Scalar c = vDotAxis * vDotAxis - v.dot(v) * this->cos2;
+
+	Scalar delta = b * b - a * c;
+
+	if (a != 0 && delta < 0)
+	{
+		return false;
+	}
+
+	if (a != 0)
+	{
+		Scalar tInt = (sqrt(delta) - b) / a;
+		Scalar insideInterval = this->axisSign * (ray.initialPoint[k] + tInt * ray.direction[k] - this->centerBase[k]);
+
+		if (insideInterval >= 0 && insideInterval <= this->height)
+		{
+			tSide = tInt;
+		}
+	}
 
-	std::vector <double> distances = { returnValue, base };
+	HitRecord baseHit;
+	baseHit.t = this->bottom->intersectAxis(ray, k, &baseHit) ? baseHit.t : INFINITY;
 
-	double minimum = -INFINITY;
+	return this->closestHit(ray, tSide, baseHit, hit);
+}
+
+/**
+ * Escolhe a interseção mais próxima entre a lateral e a base e preenche hit.
+ *
+ * @param ray O raio.
+ * @param tSide O t da lateral (infinito se não houver).
+ * @param baseHit O registro da base (t infinito se não houver).
+ * @param hit O registro a ser preenchido.
+ * @return true se alguma parte foi atingida.
+ */
+bool Cone::closestHit(const Ray& ray, Scalar tSide, const HitRecord& baseHit, HitRecord* hit) const
+{
+	Scalar distances[2] = { tSide, baseHit.t };
+
+	Scalar minimum = INFINITY;
 	int idx = -1;
 
 	for (int i = 0; i < 2; i++)
 	{
-		if (distances[i] < 0 && distances[i] > minimum)
+		if (ray.contains(distances[i]) && distances[i] < minimum)
 		{
 			minimum = distances[i];
 			idx = i;
-			this->structure = i;
 		}
 	}
 
-	if (idx != -1)
-		return distances[idx];
+	if (idx == -1)
+		return false;
+
+	// se a base estiver mais proxima, a normal vem do plano circular
+	if (idx == 1)
+	{
+		*hit = baseHit;
+		hit->structure = 1;
+		return true;
+	}
+
+	Vector3 pInt = ray.initialPoint + minimum * ray.direction;
 
-	return 1;
+	Vector3 PI = pInt - this->vertex;
+
+	hit->t = minimum;
+	hit->structure = 0;
+	hit->normal = -((this->direction.cross(PI)).cross(PI)).normalized();
+	hit->hasUV = false;
+	return true;
 }
 
 /**
- * Calcula a cor resultante da interseção do raio com o cone.
+ * Obtém a intensidade ambiente inicial e o material no ponto de interseção do raio com o cone.
  * 
- * @param tInt O parâmetro de interseção do raio com o cone.
  * @param ray O raio que intersecta o cone.
- * @param sources Um vetor de fontes de luz.
- * @param shadows Um vetor de booleanos indicando se há sombras nas fontes de luz.
- * @return A cor resultante da interseção do raio com o cone.
+ * @param hit O registro da interseção.
+ * @param ambient Ponteiro para a intensidade ambiente inicial.
+ * @param material Ponteiro para o índice do material.
  */
-Eigen::Vector3d Cone::computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows)
+void Cone::getSurface(const Ray& ray, const HitRecord& hit, Vector3* ambient, int* material) const
 {
-	// se o cone for o plano circular inferior, retorna a cor do plano0
-	if (this->structure == 0)
+	// se o ponto estiver no plano circular inferior, usa o material do plano
+	if (hit.structure == 0)
 	{
-		Eigen::Vector3d intesityEye(0, 0, 0);
-		Eigen::Vector3d intesityAmbient(0, 0, 0);
-		Eigen::Vector3d intesityDifuse(0, 0, 0);
-		Eigen::Vector3d intesitySpecular(0, 0, 0);
-		Eigen::Vector3d singleDifuse;
-		Eigen::Vector3d singleSpecular;
-
-		Eigen::Vector3d pInt = ray.initialPoint + tInt * ray.direction;
-
-		Eigen::Vector3d PI = pInt - this->vertex;
-		Eigen::Vector3d normal = -((this->direction.cross(PI)).cross(PI)).normalized();
-
-		int idx = 0;
-		for (auto& source : sources)
-		{	
-			// calculando a intensidade difusa e especular
-			source->computeIntensity(pInt, ray, &intesityAmbient, &intesityDifuse, &intesitySpecular, normal, this->kAmbient, this->kDif, this->kEsp, this->specularIndex, shadows[idx]);
-			idx++;
-		}
-
-		intesityEye = intesityDifuse + intesitySpecular + intesityAmbient;
-		return intesityEye;
+		*ambient = Vector3(0, 0, 0);
+		*material = this->material;
 	}
 	else
 	{
-		return this->bottom->computeColor(tInt, ray, sources, shadows);
+		this->bottom->getSurface(ray, hit, ambient, material);
 	}
 }
 
@@ -169,17 +253,17 @@ Eigen::Vector3d Cone::computeColor(double tInt, Ray ray, std::vector<LightSource
  * @param y A coordenada y do vetor de translação.
  * @param z A coordenada z do vetor de translação.
  */
-void Cone::translate(double x, double y, double z)
+void Cone::translate(Scalar x, Scalar y, Scalar z)
 {
-	Eigen::Matrix4d m;
+	Matrix4 m;
 	// matriz de translacao
 	m << 1, 0, 0, x,
 		 0, 1, 0, y,
 		 0, 0, 1, z,
 		 0, 0, 0, 1;
 
-	Eigen::Vector4d centerTop4;
-	Eigen::Vector4d centerBase4;
+	Vector4 centerTop4;
+	Vector4 centerBase4;
 
 	centerTop4 << this->vertex[0], this->vertex[1], this->vertex[2], 1;
 	centerBase4 << this->centerBase[0], this->centerBase[1], this->centerBase[2], 1;
@@ -192,6 +276,7 @@ void Cone::translate(double x, double y, double z)
 
 	this->direction = (this->vertex - this->centerBase).normalized();
 	this->bottom->translate(x, y, z);
+	this->updateGeometry();
 }
 
 /**
@@ -201,7 +286,7 @@ void Cone::translate(double x, double y, double z)
  * @param y Fator de escala na direção y (altura).
  * @param z Fator de escala na direção z (não utilizado).
  */
-void Cone::scale(double x, double y, double z)
+void Cone::scale(Scalar x, Scalar y, Scalar z)
 {
 	/*
 	x -> Raio
@@ -214,7 +299,9 @@ void Cone::scale(double x, double y, double z)
 
 	// atualizando o vertice e o centro da base
 	this->vertex = this->centerBase + this->height * this->direction;
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
+	delete this->bottom;
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
 /**
@@ -222,16 +309,16 @@ void Cone::scale(double x, double y, double z)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void  Cone::rotateX(double angle)
+void  Cone::rotateX(Scalar angle)
 {
-	Eigen::Matrix4d rx;
+	Matrix4 rx;
 	// matriz de rotacao em torno do eixo x
 	rx << 1, 0, 0, 0,
 		0, cos(angle), -sin(angle), 0,
 		0, sin(angle), cos(angle), 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->direction[0], this->direction[1], this->direction[2], 0;
 	
 	// rotacionando o vetor direcao
@@ -243,7 +330,9 @@ void  Cone::rotateX(double angle)
 
 	// atualizando o vertice e o centro da base
 	this->vertex = this->centerBase + this->height * this->direction;
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
+	delete this->bottom;
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
 /**
@@ -251,16 +340,16 @@ void  Cone::rotateX(double angle)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void  Cone::rotateY(double angle)
+void  Cone::rotateY(Scalar angle)
 {
-	Eigen::Matrix4d ry;
+	Matrix4 ry;
 	// matriz de rotacao em torno do eixo y
 	ry << cos(angle), 0, sin(angle), 0,
 		0, 1, 0, 0,
 		-sin(angle), 0, cos(angle), 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->direction[0], this->direction[1], this->direction[2], 0;
 
 	// rotacionando o vetor direcao
@@ -270,7 +359,9 @@ void  Cone::rotateY(double angle)
 	
 	// atualizando o vertice e o centro da base
 	this->vertex = this->centerBase + this->height * this->direction;
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
+	delete this->bottom;
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
 /**
@@ -278,16 +369,16 @@ void  Cone::rotateY(double angle)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void  Cone::rotateZ(double angle)
+void  Cone::rotateZ(Scalar angle)
 {	
 	// matriz de rotacao em torno do eixo z
-	Eigen::Matrix4d rz;
+	Matrix4 rz;
 	rz << cos(angle), -sin(angle), 0, 0,
 		sin(angle), cos(angle), 0, 0,
 		0, 0, 1, 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->direction[0], this->direction[1], this->direction[2], 0;
 
 	// rotacionando o vetor direcao
@@ -297,7 +388,9 @@ void  Cone::rotateZ(double angle)
 
 	// atualizando o vertice e o centro da base
 	this->vertex = this->centerBase + this->height * this->direction;
-	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->kAmbient, this->kDif, this->kEsp, this->specularIndex);
+	delete this->bottom;
+	this->bottom = new CircularPlane(-this->direction, this->centerBase, this->radius, this->material);
+	this->updateGeometry();
 }
 
 /**
@@ -305,10 +398,10 @@ void  Cone::rotateZ(double angle)
  * 
  * @param transformationMatrix A matriz de transformação que será aplicada à posição do cone.
  */
-void Cone::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void Cone::convertToCamera(Matrix4 transformationMatrix)
 {
-	Eigen::Vector4d vertex;
-	Eigen::Vector4d centerBase4;
+	Vector4 vertex;
+	Vector4 base;
 
 	// convertendo o vertice e o centro da base para coordenadas homogeneas
 	vertex << this->vertex[0], this->vertex[1], this->vertex[2], 1;
@@ -325,4 +418,64 @@ void Cone::convertToCamera(Eigen::Matrix4d transformationMatrix)
 	// atualizando o vetor direcao
 	this->direction = (this->vertex - this->centerBase).normalized();
 	this->bottom->convertToCamera(transformationMatrix);
+	this->updateGeometry();
+}
+
+/**
+ * Construtor de cópia: o cone novo tem o seu próprio plano circular da base.
+ */
+Cone::Cone(const Cone& other)
+	: Object(other), radius(other.radius), height(other.height), angle(other.angle), centerBase(other.centerBase),
+	  vertex(other.vertex), direction(other.direction), bottom(new CircularPlane(*other.bottom)),
+	  cos2(other.cos2), axis(other.axis), axisSign(other.axisSign)
+{
+}
+
+/**
+ * Atribuição: o plano da base continua sendo deste cone e recebe uma cópia do plano de other.
+ */
+Cone& Cone::operator=(const Cone& other)
+{
+	if (this != &other)
+	{
+		Object::operator=(other);
+		this->radius = other.radius;
+		this->height = other.height;
+		this->angle = other.angle;
+		this->centerBase = other.centerBase;
+		this->vertex = other.vertex;
+		this->direction = other.direction;
+		*this->bottom = *other.bottom;
+		this->cos2 = other.cos2;
+		this->axis = other.axis;
+		this->axisSign = other.axisSign;
+	}
+	return *this;
+}
+
+/**
+ * Destrutor: o plano circular da base pertence ao cone.
+ */
+Cone::~Cone()
+{
+	delete this->bottom;
+}
+
+/**
+ * Cria uma cópia do cone, com uma cópia própria do plano circular da base.
+ */
+Object* Cone::clone() const
+{
+	return new Cone(*this);
+}
+
+/**
+ * Calcula a caixa delimitadora do cone: a união do disco da base com o vértice.
+ */
+bool Cone::getBounds(AABB* box) const
+{
+	*box = AABB();
+	box->expandDisc(this->centerBase, this->direction, this->radius);
+	box->expand(this->vertex);
+	return true;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "LightSource.h"
 #include "Object.h"
 #include "CircularPlane.h"
+#include "Scalar.h"
 
 #ifndef Cone_H
 #define Cone_H
@@ -13,19 +14,18 @@
  * @brief Classe que representa um cone tridimensional.
  * 
  * A classe Cone é uma subclasse da classe Object e representa um cone tridimensional.
- * Ela possui propriedades como estrutura, raio, altura, ângulo, centro da base, vértice, direção e plano circular inferior.
+ * Ela possui propriedades como raio, altura, ângulo, centro da base, vértice, direção e plano circular inferior.
  * Além disso, a classe possui métodos para realizar transformações geométricas no cone e calcular a cor do cone em um determinado ponto.
  */
 class Cone : public Object
 {
 public:
-	int structure; // Estrutura do cone
-	double radius; // Raio do cone
-	double height; // Altura do cone
-	double angle; // Ângulo do cone
-	Eigen::Vector3d centerBase; // Centro da base do cone
-	Eigen::Vector3d vertex; // Vértice do cone
-	Eigen::Vector3d direction; // Direção do cone
+	Scalar radius; // Raio do cone
+	Scalar height; // Altura do cone
+	Scalar angle; // Ângulo do cone
+	Vector3 centerBase; // Centro da base do cone
+	Vector3 vertex; // Vértice do cone
+	Vector3 direction; // Direção (unitária) do cone, da base para o vértice
 	CircularPlane* bottom; // Plano circular inferior do cone
 
 	/**
@@ -34,12 +34,9 @@ public:
 	 * @param angle O ângulo do cone.
 	 * @param centerBase O centro da base do cone.
 	 * @param vertex O vértice do cone.
-	 * @param kAmbient O coeficiente de reflexão ambiente do cone.
-	 * @param kDif O coeficiente de reflexão difusa do cone.
-	 * @param kEsp O coeficiente de reflexão especular do cone.
-	 * @param specularIndex O índice de especularidade do cone.
+	 * @param material Índice do material na tabela de materiais da cena (Scene::materials).
 	 */
-	Cone(double angle, Eigen::Vector3d centerBase, Eigen::Vector3d vertex, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex);
+	Cone(Scalar angle, Vector3 centerBase, Vector3 vertex, int material);
 
 	/**
 	 * @brief Construtor da classe Cone.
@@ -48,31 +45,28 @@ public:
 	 * @param height A altura do cone.
 	 * @param centerBase O centro da base do cone.
 	 * @param direction A direção do cone.
-	 * @param kAmbient O coeficiente de reflexão ambiente do cone.
-	 * @param kDif O coeficiente de reflexão difusa do cone.
-	 * @param kEsp O coeficiente de reflexão especular do cone.
-	 * @param specularIndex O índice de especularidade do cone.
+	 * @param material Índice do material na tabela de materiais da cena (Scene::materials).
 	 */
-	Cone(double radius, double height, Eigen::Vector3d centerBase, Eigen::Vector3d direction, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex);
+	Cone(Scalar radius, Scalar height, Vector3 centerBase, Vector3 direction, int material);
 
 	/**
-	 * @brief Verifica se um raio intercepta o cone.
+	 * @brief Calcula a interseção de um raio com o cone.
 	 * 
 	 * @param ray O raio a ser verificado.
-	 * @return O valor do parâmetro t no ponto de interseção, ou -1 se não houver interseção.
+	 * @param hit O registro a ser preenchido (structure: 0 = superfície lateral, 1 = base).
+	 * @return true se houver interseção à frente do raio.
 	 */
-	double hasInterceptedRay(Ray ray);
+	bool intersect(const Ray& ray, HitRecord* hit) const;
 
 	/**
-	 * @brief Calcula a cor do cone em um determinado ponto.
+	 * @brief Obtém a intensidade ambiente e o material do cone (ou da base) em um determinado ponto.
 	 * 
-	 * @param tInt O valor do parâmetro t no ponto de interseção.
 	 * @param ray O raio que intersectou o cone.
-	 * @param sources Um vetor de fontes de luz.
-	 * @param shadows Um vetor de booleanos indicando se há sombra no ponto de interseção.
-	 * @return A cor do cone no ponto de interseção.
+	 * @param hit O registro da interseção.
+	 * @param ambient Ponteiro para a intensidade ambiente inicial.
+	 * @param material Ponteiro para o índice do material.
 	 */
-	Eigen::Vector3d computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows);
+	void getSurface(const Ray& ray, const HitRecord& hit, Vector3* ambient, int* material) const;
 
 	/**
 	 * @brief Translada o cone nas direções x, y e z.
@@ -81,7 +75,7 @@ public:
 	 * @param y O valor de translação no eixo y.
 	 * @param z O valor de translação no eixo z.
 	 */
-	void translate(double x, double y, double z);
+	void translate(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * @brief Escala o cone nas direções x, y e z.
@@ -90,35 +84,93 @@ public:
 	 * @param y O valor de escala no eixo y.
 	 * @param z O valor de escala no eixo z.
 	 */
-	void scale(double x, double y, double z);
+	void scale(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * @brief Rotaciona o cone em torno do eixo x.
 	 * 
 	 * @param angle O ângulo de rotação em graus.
 	 */
-	void rotateX(double angle);
+	void rotateX(Scalar angle);
 
 	/**
 	 * @brief Rotaciona o cone em torno do eixo y.
 	 * 
 	 * @param angle O ângulo de rotação em graus.
 	 */
-	void rotateY(double angle);
+	void rotateY(Scalar angle);
 
 	/**
 	 * @brief Rotaciona o cone em torno do eixo z.
 	 * 
 	 * @param angle O ângulo de rotação em graus.
 	 */
-	void rotateZ(double angle);
+	void rotateZ(Scalar angle);
 
 	/**
 	 * @brief Converte as coordenadas do cone para o sistema de coordenadas da câmera.
 	 * 
 	 * @param transformationMatrix A matriz de transformação para o sistema de coordenadas da câmera.
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
+
+	/**
+	 * @brief Construtor de cópia: o plano circular da base é copiado, não compartilhado.
+	 * 
+	 * @param other O cone copiado.
+	 */
+	Cone(const Cone& other);
+
+	/**
+	 * @brief Atribuição: copia o plano circular da base de other sobre o deste cone.
+	 * 
+	 * @param other O cone copiado.
+	 * @return Este cone.
+	 */
+	Cone& operator=(const Cone& other);
+
+	/**
+	 * @brief Destrutor da classe Cone. Libera o plano circular da base.
+	 */
+	~Cone();
+
+	/**
+	 * @brief Cria uma cópia do cone.
+	 * 
+	 * O plano circular da base também é copiado.
+	 * 
+	 * @return Ponteiro para o novo cone.
+	 */
+	Object* clone() const;
+
+	/**
+	 * @brief Calcula a caixa delimitadora do cone.
+	 * 
+	 * @param box Ponteiro para armazenar a caixa.
+	 * @return true (o cone é limitado).
+	 */
+	bool getBounds(AABB* box) const;
+
+private:
+	Scalar cos2;          // Quadrado do cosseno do ângulo
+	int axis;             // Eixo (0 = x, 1 = y, 2 = z) quando a direção é paralela a um dos eixos; -1 no caso geral
+	Scalar axisSign;      // Sinal da direção ao longo de axis (+1 ou -1)
+
+	/**
+	 * @brief Recalcula os termos que não dependem do raio e escolhe a variante de interseção.
+	 * 
+	 * Chamada ao final dos construtores e de cada transformação.
+	 */
+	void updateGeometry();
+
+	// Interseção com um cone de direção qualquer
+	bool intersectGeneral(const Ray& ray, HitRecord* hit) const;
+
+	// Interseção com um cone paralelo a um eixo (os pinheiros da cena)
+	bool intersectAligned(const Ray& ray, HitRecord* hit) const;
+
+	// Escolhe entre a lateral (tSide) e a base a interseção mais próxima e preenche hit
+	bool closestHit(const Ray& ray, Scalar tSide, const HitRecord& baseHit, HitRecord* hit) const;
 };
 
 #endif
\ No newline at end of file
@@ -1,259 +1,57 @@
-#include <iostream>
 #include "Cube.h"
 
-/**
- * Construtor da classe Cube.
- * Cria um objeto Cube com base nos parâmetros fornecidos.
- *
- * @param mainVertex O vértice principal do cubo.
- * @param width A largura do cubo.
- * @param height A altura do cubo.
- * @param depth A profundidade do cubo.
- * @param kAmbient O coeficiente de reflexão ambiente do cubo.
- * @param kDif O coeficiente de reflexão difusa do cubo.
- * @param kEsp O coeficiente de reflexão especular do cubo.
- * @param specularIndex O índice de especularidade do cubo.
- */
-Cube::Cube(Eigen::Vector3d mainVertex, double width, double height, double depth, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex)
-{
-	this->structure = 0;
-	this->kAmbient = kAmbient;
-	this->kDif = kDif;
-	this->kEsp = kEsp;
-	this->specularIndex = specularIndex;
-
-	this->center = mainVertex + Eigen::Vector3d(width, height, -depth) / 2;
-
-	Eigen::Vector3d a = mainVertex + Eigen::Vector3d(width, 0, 0);
-	Eigen::Vector3d b = mainVertex + Eigen::Vector3d(width, height, 0);
-	Eigen::Vector3d c = mainVertex + Eigen::Vector3d(0, height, 0);
-	Eigen::Vector3d d = mainVertex;
-	Eigen::Vector3d e = mainVertex + Eigen::Vector3d(width, 0, -depth);
-	Eigen::Vector3d f = mainVertex + Eigen::Vector3d(width, height, -depth);
-	Eigen::Vector3d g = mainVertex + Eigen::Vector3d(0, height, -depth);
-	Eigen::Vector3d h = mainVertex + Eigen::Vector3d(0, 0, -depth);
-
-	// Frente embaixo
-	faces[0] = new TriangularFace
-	(
-		c,
-		a,
-		d,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Frente acima
-	faces[1] = new TriangularFace
-	(
-		b,
-		a,
-		c,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Fundo embaixo
-	faces[2] = new TriangularFace
-	(
-		f,
-		h,
-		e,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Fundo acima
-	faces[3] = new TriangularFace
-	(
-		g,
-		h,
-		f,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Topo embaixo
-	faces[4] = new TriangularFace
-	(
-		g,
-		b,
-		c,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Topo acima
-	faces[5] = new TriangularFace
-	(
-		f,
-		b,
-		g,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Base embaixo
-	faces[6] = new TriangularFace
-	(
-		d,
-		e,
-		h,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Base acima
-	faces[7] = new TriangularFace
-	(
-		a,
-		e,
-		d,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Esquerda embaixo
-	faces[8] = new TriangularFace
-	(
-		g,
-		d,
-		h,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Esquerda acima
-	faces[9] = new TriangularFace
-	(
-		c,
-		d,
-		g,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Direita embaixo
-	faces[10] = new TriangularFace
-	(
-		b,
-		e,
-		a,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-
-	// Direita acima
-	faces[11] = new TriangularFace
-	(
-		f,
-		e,
-		b,
-		this->kAmbient,
-		this->kDif,
-		this->kEsp,
-		this->specularIndex
-	);
-}
-
-/**
- * Verifica se o cubo intercepta um raio e retorna a distância do ponto de interseção mais próximo.
- * 
- * @param ray O raio a ser verificado.
- * @return A distância do ponto de interseção mais próximo ou 1 se não houver interseção.
- */
-double Cube::hasInterceptedRay(Ray ray)
+// Vértices do cubo: a, b, c e d na frente, e, f, g e h no fundo
+static std::vector<Vector3> cubeVertices(Vector3 mainVertex, Scalar width, Scalar height, Scalar depth)
 {
-	double distances[12];
-
-	for (int i = 0; i < 12; i++)
-	{
-		distances[i] = faces[i]->hasInterceptedRay(ray);
-	}
-
-	double minimum = -INFINITY;
-	int idx = -1;
-
-	for (int i = 0; i < 12; i++)
+	return
 	{
-		if (distances[i] < 0 && distances[i] > minimum)
-		{
-			minimum = distances[i];
-			idx = i;
-			this->structure = i;
-		}
-	}
-
-	if (idx != -1)
-		return distances[idx];
-
-	return 1;
+		mainVertex + Vector3(width, 0, 0),            // a
+		mainVertex + Vector3(width, height, 0),       // b
+		mainVertex + Vector3(0, height, 0),           // c
+		mainVertex,                                           // d
+		mainVertex + Vector3(width, 0, -depth),       // e
+		mainVertex + Vector3(width, height, -depth),  // f
+		mainVertex + Vector3(0, height, -depth),      // g
+		mainVertex + Vector3(0, 0, -depth)            // h
+	};
 }
 
-/**
- * Calcula a cor do cubo.
- * 
- * @param tInt O valor de t da interseção.
- * @param ray O raio de luz.
- * @param sources Um vetor de fontes de luz.
- * @param shadows Um vetor de booleanos indicando se há sombras.
- * @return A cor calculada.
- */
-Eigen::Vector3d Cube::computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows)
+// Triângulos do cubo, com a mesma ordem e orientação das antigas faces
+static std::vector<int> cubeIndices()
 {
-	return faces[structure]->computeColor(tInt, ray, sources, shadows);
-}
+	enum { a, b, c, d, e, f, g, h };
 
-/**
- * Translada o cubo nas coordenadas especificadas.
- * 
- * @param x A coordenada x para a translação.
- * @param y A coordenada y para a translação.
- * @param z A coordenada z para a translação.
- */
-void Cube::translate(double x, double y, double z)
-{
-	for (int i = 0; i < 12; i++)
+	return
 	{
-		faces[i]->translate(x, y, z);
-	}
+		c, a, d, // Frente embaixo
+		b, a, c, // Frente acima
+		f, h, e, // Fundo embaixo
+		g, h, f, // Fundo acima
+		g, b, c, // Topo embaixo
+		f, b, g, // Topo acima
+		d, e, h, // Base embaixo
+		a, e, d, // Base acima
+		g, d, h, // Esquerda embaixo
+		c, d, g, // Esquerda acima
+		b, e, a, // Direita embaixo
+		f, e, b  // Direita acima
+	};
 }
 
 /**
- * Função responsável por redimensionar o cubo nas direções x, y e z.
- * 
- * @param x O fator de escala na direção x.
- * @param y O fator de escala na direção y.
- * @param z O fator de escala na direção z.
+ * Construtor da classe Cube.
+ * Cria a malha de 12 triângulos do cubo com base nos parâmetros fornecidos.
+ *
+ * @param mainVertex O vértice principal do cubo.
+ * @param width A largura do cubo.
+ * @param height A altura do cubo.
+ * @param depth A profundidade do cubo.
+ * @param material Índice do material na tabela de materiais da cena (Scene::materials).
  */
-void Cube::scale(double x, double y, double z)
+Cube::Cube(Vector3 mainVertex, Scalar width, Scalar height, Scalar depth, int material)
+	: TriangleMesh(cubeVertices(mainVertex, width, height, depth), cubeIndices(), material)
 {
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->scale(x, y, z);
-	}
+	this->center = mainVertex + Vector3(width, height, -depth) / 2;
 }
 
 /**
@@ -261,33 +59,11 @@ void Cube::scale(double x, double y, double z)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void Cube::rotateX(double angle)
+void Cube::rotateX(Scalar angle)
 {
-
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->translate
-		(
-			-this->center[0],
-			-this->center[1],
-			-this->center[2]
-		);
-	}
-
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->rotateX(angle);
-	}
-
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->translate
-		(
-			this->center[0],
-			this->center[1],
-			this->center[2]
-		);
-	}
+	this->translate(-this->center[0], -this->center[1], -this->center[2]);
+	TriangleMesh::rotateX(angle);
+	this->translate(this->center[0], this->center[1], this->center[2]);
 }
 
 /**
@@ -295,32 +71,11 @@ void Cube::rotateX(double angle)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void Cube::rotateY(double angle)
+void Cube::rotateY(Scalar angle)
 {
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->translate
-		(
-			-this->center[0],
-			-this->center[1],
-			-this->center[2]
-		);
-	}
-
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->rotateY(angle);
-	}
-
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->translate
-		(
-			this->center[0],
-			this->center[1],
-			this->center[2]
-		);
-	}
+	this->translate(-this->center[0], -this->center[1], -this->center[2]);
+	TriangleMesh::rotateY(angle);
+	this->translate(this->center[0], this->center[1], this->center[2]);
 }
 
 /**
@@ -328,41 +83,17 @@ void Cube::rotateY(double angle)
  * 
  * @param angle O ângulo de rotação em radianos.
  */
-void Cube::rotateZ(double angle)
+void Cube::rotateZ(Scalar angle)
 {
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->translate
-		(
-			-this->center[0],
-			-this->center[1],
-			-this->center[2]
-		);
-	}
-
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->rotateZ(angle);
-	}
-
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->translate
-		(
-			this->center[0],
-			this->center[1],
-			this->center[2]
-		);
-	}
+	this->translate(-this->center[0], -this->center[1], -this->center[2]);
+	TriangleMesh::rotateZ(angle);
+	this->translate(this->center[0], this->center[1], this->center[2]);
 }
 
 /**
- * Converter para coordenadas de câmera.
+ * Cria uma cópia do cubo; a malha compartilha o buffer de índices com o original.
  */
-void Cube::convertToCamera(Eigen::Matrix4d transformationMatrix)
+Object* Cube::clone() const
 {
-	for (int i = 0; i < 12; i++)
-	{
-		faces[i]->convertToCamera(transformationMatrix);
-	}
+	return new Cube(*this);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
-#include "TriangularFace.h"
+#include "Scalar.h"
+#include "TriangleMesh.h"
 
 #ifndef Cube_H
 #define Cube_H
@@ -6,16 +7,15 @@
 /**
  * @brief Classe que representa um cubo tridimensional.
  * 
- * A classe Cube herda da classe Object e representa um cubo tridimensional no espaço.
- * Possui métodos para realizar transformações geométricas, calcular interseção com um raio
- * e computar a cor do cubo com base em fontes de luz e sombras.
+ * O cubo é uma TriangleMesh de 8 vértices e 12 triângulos (2 por face), então interseção,
+ * sombras, cor e caixa delimitadora vêm da malha. Em intersect, structure recebe o índice
+ * do triângulo atingido (0 e 1 na frente, 2 e 3 no fundo, 4 e 5 no topo, 6 e 7 na base,
+ * 8 e 9 na esquerda, 10 e 11 na direita).
  */
-class Cube : public Object
+class Cube : public TriangleMesh
 {
 public:
-	TriangularFace* faces[12]; // Array de faces triangulares do cubo
-	int structure; // Estrutura do cubo
-	Eigen::Vector3d center; // Centro do cubo
+	Vector3 center; // Centro do cubo, em torno do qual ele é rotacionado
 
 	/**
 	 * @brief Construtor da classe Cube.
@@ -24,77 +24,37 @@ public:
 	 * @param width A largura do cubo.
 	 * @param height A altura do cubo.
 	 * @param depth A profundidade do cubo.
-	 * @param kAmbient O coeficiente de reflexão ambiente do cubo.
-	 * @param kDif O coeficiente de reflexão difusa do cubo.
-	 * @param kEsp O coeficiente de reflexão especular do cubo.
-	 * @param specularIndex O índice de especularidade do cubo.
+	 * @param material Índice do material na tabela de materiais da cena (Scene::materials).
 	 */
-	Cube(Eigen::Vector3d mainVertex, double width, double height, double depth, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex);
+	Cube(Vector3 mainVertex, Scalar width, Scalar height, Scalar depth, int material);
 
 	/**
-	 * @brief Verifica se o cubo intercepta um raio.
-	 * 
-	 * @param ray O raio a ser verificado.
-	 * @return O valor de t da interseção, ou -1 se não houver interseção.
-	 */
-	double hasInterceptedRay(Ray ray);
-
-	/**
-	 * @brief Calcula a cor do cubo com base na interseção com um raio, fontes de luz e sombras.
-	 * 
-	 * @param tInt O valor de t da interseção.
-	 * @param ray O raio que intersectou o cubo.
-	 * @param sources As fontes de luz no ambiente.
-	 * @param shadows Vetor de booleanos indicando se há sombras para cada fonte de luz.
-	 * @return A cor resultante do cubo.
-	 */
-	Eigen::Vector3d computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows);
-
-	/**
-	 * @brief Translada o cubo nas direções x, y e z.
-	 * 
-	 * @param x O valor de translação no eixo x.
-	 * @param y O valor de translação no eixo y.
-	 * @param z O valor de translação no eixo z.
-	 */
-	void translate(double x, double y, double z);
-
-	/**
-	 * @brief Escala o cubo nas direções x, y e z.
-	 * 
-	 * @param x O valor de escala no eixo x.
-	 * @param y O valor de escala no eixo y.
-	 * @param z O valor de escala no eixo z.
-	 */
-	void scale(double x, double y, double z);
-
-	/**
-	 * @brief Rotaciona o cubo em torno do eixo x.
+	 * @brief Rotaciona o cubo em torno do eixo x que passa pelo seu centro.
 	 * 
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	void rotateX(double angle);
+	void rotateX(Scalar angle);
 
 	/**
-	 * @brief Rotaciona o cubo em torno do eixo y.
+	 * @brief Rotaciona o cubo em torno do eixo y que passa pelo seu centro.
 	 * 
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	void rotateY(double angle);
+	void rotateY(Scalar angle);
 
 	/**
-	 * @brief Rotaciona o cubo em torno do eixo z.
+	 * @brief Rotaciona o cubo em torno do eixo z que passa pelo seu centro.
 	 * 
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	void rotateZ(double angle);
+	void rotateZ(Scalar angle);
 
 	/**
-	 * @brief Converte as coordenadas do cubo para o sistema de coordenadas da câmera.
+	 * @brief Cria uma cópia do cubo.
 	 * 
-	 * @param transformationMatrix A matriz de transformação para o sistema de coordenadas da câmera.
+	 * @return Ponteiro para o novo cubo.
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	Object* clone() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "Framebuffer.h"
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Construtor da classe Framebuffer. Todos os pixels começam pretos.
+ *
+ * @param numColumns Número de colunas (largura).
+ * @param numLines Número de linhas (altura).
+ * @param format Formato dos pixels.
+ */
+Framebuffer::Framebuffer(int numColumns, int numLines, Format format)
+{
+	this->numColumns = numColumns;
+	this->numLines = numLines;
+	this->format = format;
+
+	// Cada linha ocupa um número inteiro de blocos de ALIGNMENT bytes
+	int pixelSize = format == RGB_FLOAT ? 3 * sizeof(float) : 4;
+	this->pitch = (numColumns * pixelSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+	size_t size = (size_t)this->pitch * numLines;
+	this->memory = new unsigned char[size + ALIGNMENT];
+	this->data = (unsigned char*)(((uintptr_t)this->memory + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+
+	this->clear();
+}
+
+/**
+ * @brief Libera a memória da imagem.
+ */
+Framebuffer::~Framebuffer()
+{
+	delete[] this->memory;
+}
+
+/**
+ * @brief Obtém o número de colunas (largura) da imagem.
+ */
+int Framebuffer::getNumColumns() const
+{
+	return this->numColumns;
+}
+
+/**
+ * @brief Obtém o número de linhas (altura) da imagem.
+ */
+int Framebuffer::getNumLines() const
+{
+	return this->numLines;
+}
+
+/**
+ * @brief Obtém o formato dos pixels.
+ */
+Framebuffer::Format Framebuffer::getFormat() const
+{
+	return this->format;
+}
+
+/**
+ * @brief Obtém o número de bytes entre o início de duas linhas consecutivas.
+ */
+int Framebuffer::getPitch() const
+{
+	return this->pitch;
+}
+
+/**
+ * @brief Lê a cor de um pixel.
+ *
+ * @param l Linha do pixel.
+ * @param c Coluna do pixel.
+ * @return A cor do pixel.
+ */
+Vector3 Framebuffer::getPixel(int l, int c) const
+{
+	if (this->format == RGB_FLOAT)
+	{
+		const float* pixel = this->rowRGB(l) + 3 * c;
+		return Vector3(pixel[0], pixel[1], pixel[2]);
+	}
+
+	const unsigned char* pixel = this->rowRGBA8(l) + 4 * c;
+	return Vector3(pixel[0], pixel[1], pixel[2]);
+}
+
+/**
+ * @brief Obtém uma região retangular da imagem, limitada às bordas.
+ *
+ * @param line Primeira linha.
+ * @param column Primeira coluna.
+ * @param numLines Número de linhas.
+ * @param numColumns Número de colunas.
+ * @return O bloco.
+ */
+Framebuffer::Tile Framebuffer::tile(int line, int column, int numLines, int numColumns)
+{
+	Tile tile;
+	tile.framebuffer = this;
+	tile.line = line;
+	tile.column = column;
+	tile.numLines = std::max(0, std::min(numLines, this->numLines - line));
+	tile.numColumns = std::max(0, std::min(numColumns, this->numColumns - column));
+	return tile;
+}
+
+/**
+ * @brief Pinta todos os pixels de preto (alfa 255 no formato RGBA8).
+ */
+void Framebuffer::clear()
+{
+	memset(this->data, 0, (size_t)this->pitch * this->numLines);
+
+	if (this->format == RGBA8)
+	{
+		for (int l = 0; l < this->numLines; l++)
+		{
+			unsigned char* row = this->rowRGBA8(l);
+			for (int c = 0; c < this->numColumns; c++)
+			{
+				row[4 * c + 3] = 255;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Leva as cores para [0, 255]: negativos viram 0 e a maior componente vira 255.
+ */
+void Framebuffer::normalize()
+{
+	if (this->format != RGB_FLOAT || this->numLines == 0 || this->numColumns == 0)
+	{
+		return;
+	}
+
+	// Como em Tensor::normalize, o máximo parte do vermelho do primeiro pixel
+	float maximum = this->rowRGB(0)[0];
+
+	for (int l = 0; l < this->numLines; l++)
+	{
+		float* row = this->rowRGB(l);
+		for (int i = 0; i < 3 * this->numColumns; i++)
+		{
+			if (row[i] <= 0)
+			{
+				row[i] = 0;
+			}
+			if (row[i] > maximum)
+			{
+				maximum = row[i];
+			}
+		}
+	}
+
+	for (int l = 0; l < this->numLines; l++)
+	{
+		float* row = this->rowRGB(l);
+		for (int i = 0; i < 3 * this->numColumns; i++)
+		{
+			row[i] = 255 * (row[i] / maximum);
+		}
+	}
+}
+
+/**
+ * @brief Converte a imagem para pixels RGBA de 8 bits (alfa 255), linha a linha.
+ *
+ * @param pixels Destino, com getNumLines() linhas de pelo menos 4 * getNumColumns() bytes.
+ * @param pitch Número de bytes entre o início de duas linhas consecutivas do destino.
+ */
+void Framebuffer::toRGBA(unsigned char* pixels, int pitch) const
+{
+	for (int l = 0; l < this->numLines; l++)
+	{
+		unsigned char* destination = pixels + (size_t)l * pitch;
+
+		if (this->format == RGBA8)
+		{
+			memcpy(destination, this->rowRGBA8(l), 4 * this->numColumns);
+			continue;
+		}
+
+		const float* row = this->rowRGB(l);
+		for (int c = 0; c < this->numColumns; c++)
+		{
+			destination[4 * c] = (unsigned char)std::min(255.0f, std::max(0.0f, row[3 * c]));
+			destination[4 * c + 1] = (unsigned char)std::min(255.0f, std::max(0.0f, row[3 * c + 1]));
+			destination[4 * c + 2] = (unsigned char)std::min(255.0f, std::max(0.0f, row[3 * c + 2]));
+			destination[4 * c + 3] = 255;
+		}
+	}
+}
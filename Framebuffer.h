@@ -0,0 +1,215 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <algorithm>
+
+#include "Scalar.h"
+
+#ifndef Framebuffer_H
+#define Framebuffer_H
+
+/**
+ * @brief Imagem com os canais intercalados, linha a linha, em memória alinhada.
+ *
+ * Cada pixel ocupa posições consecutivas (RGB em float ou RGBA em 8 bits) e as linhas são
+ * guardadas uma após a outra, com o início de cada linha alinhado a ALIGNMENT bytes. Assim
+ * o Canvas, que percorre a imagem com a coluna no laço interno, escreve memória contígua,
+ * e blocos cuja coluna inicial é múltipla de 16 não dividem linhas de cache entre threads.
+ *
+ * O formato RGB_FLOAT acumula as cores sem limites (normalize() as leva para [0, 255]);
+ * o formato RGBA8 limita cada canal a [0, 255] no momento da escrita e já pode ser enviado
+ * para uma textura ou gravado em disco.
+ */
+class Framebuffer
+{
+public:
+	/**
+	 * @brief Formatos de pixel suportados.
+	 */
+	enum Format
+	{
+		RGB_FLOAT, /**< 3 floats por pixel (12 bytes) */
+		RGBA8      /**< 4 bytes por pixel, alfa 255 */
+	};
+
+	static const int ALIGNMENT = 64; /**< Alinhamento, em bytes, do início de cada linha */
+
+	/**
+	 * @brief Região retangular do framebuffer, escrita por uma única thread.
+	 *
+	 * As coordenadas de setPixel são absolutas (as mesmas da imagem inteira), para que quem
+	 * renderiza o bloco não precise converter índices.
+	 */
+	struct Tile
+	{
+		Framebuffer* framebuffer; /**< Framebuffer ao qual o bloco pertence */
+		int line;                 /**< Primeira linha do bloco */
+		int column;               /**< Primeira coluna do bloco */
+		int numLines;             /**< Número de linhas do bloco */
+		int numColumns;           /**< Número de colunas do bloco */
+
+		/**
+		 * @brief Escreve a cor de um pixel do bloco.
+		 *
+		 * @param l Linha do pixel (na imagem inteira).
+		 * @param c Coluna do pixel (na imagem inteira).
+		 * @param color A cor do pixel.
+		 */
+		void setPixel(int l, int c, const Vector3& color) const
+		{
+			this->framebuffer->setPixel(l, c, color);
+		}
+	};
+
+	/**
+	 * @brief Construtor da classe Framebuffer. Todos os pixels começam pretos.
+	 *
+	 * @param numColumns Número de colunas (largura).
+	 * @param numLines Número de linhas (altura).
+	 * @param format Formato dos pixels.
+	 */
+	Framebuffer(int numColumns, int numLines, Format format);
+
+	/**
+	 * @brief Libera a memória da imagem.
+	 */
+	~Framebuffer();
+
+	Framebuffer(const Framebuffer&) = delete;
+	Framebuffer& operator=(const Framebuffer&) = delete;
+
+	/**
+	 * @brief Obtém o número de colunas (largura) da imagem.
+	 */
+	int getNumColumns() const;
+
+	/**
+	 * @brief Obtém o número de linhas (altura) da imagem.
+	 */
+	int getNumLines() const;
+
+	/**
+	 * @brief Obtém o formato dos pixels.
+	 */
+	Format getFormat() const;
+
+	/**
+	 * @brief Obtém o número de bytes entre o início de duas linhas consecutivas.
+	 */
+	int getPitch() const;
+
+	/**
+	 * @brief Obtém a linha l no formato RGB_FLOAT (3 floats por pixel).
+	 *
+	 * @param l A linha.
+	 * @return Ponteiro para o primeiro canal do primeiro pixel da linha.
+	 */
+	float* rowRGB(int l)
+	{
+		return (float*)(this->data + (size_t)l * this->pitch);
+	}
+
+	/**
+	 * @brief Obtém a linha l no formato RGB_FLOAT, somente para leitura.
+	 */
+	const float* rowRGB(int l) const
+	{
+		return (const float*)(this->data + (size_t)l * this->pitch);
+	}
+
+	/**
+	 * @brief Obtém a linha l no formato RGBA8 (4 bytes por pixel).
+	 *
+	 * @param l A linha.
+	 * @return Ponteiro para o primeiro byte da linha.
+	 */
+	unsigned char* rowRGBA8(int l)
+	{
+		return this->data + (size_t)l * this->pitch;
+	}
+
+	/**
+	 * @brief Obtém a linha l no formato RGBA8, somente para leitura.
+	 */
+	const unsigned char* rowRGBA8(int l) const
+	{
+		return this->data + (size_t)l * this->pitch;
+	}
+
+	/**
+	 * @brief Escreve a cor de um pixel. No formato RGBA8 os canais são limitados a [0, 255].
+	 *
+	 * @param l Linha do pixel.
+	 * @param c Coluna do pixel.
+	 * @param color A cor do pixel.
+	 */
+	void setPixel(int l, int c, const Vector3& color)
+	{
+		if (this->format == RGB_FLOAT)
+		{
+			float* pixel = this->rowRGB(l) + 3 * c;
+			pixel[0] = (float)color(0);
+			pixel[1] = (float)color(1);
+			pixel[2] = (float)color(2);
+		}
+		else
+		{
+			unsigned char* pixel = this->rowRGBA8(l) + 4 * c;
+			pixel[0] = (unsigned char)std::min<Scalar>(255, std::max<Scalar>(0, color(0)));
+			pixel[1] = (unsigned char)std::min<Scalar>(255, std::max<Scalar>(0, color(1)));
+			pixel[2] = (unsigned char)std::min<Scalar>(255, std::max<Scalar>(0, color(2)));
+			pixel[3] = 255;
+		}
+	}
+
+	/**
+	 * @brief Lê a cor de um pixel.
+	 *
+	 * @param l Linha do pixel.
+	 * @param c Coluna do pixel.
+	 * @return A cor do pixel.
+	 */
+	Vector3 getPixel(int l, int c) const;
+
+	/**
+	 * @brief Obtém uma região retangular da imagem, limitada às bordas.
+	 *
+	 * @param line Primeira linha.
+	 * @param column Primeira coluna.
+	 * @param numLines Número de linhas.
+	 * @param numColumns Número de colunas.
+	 * @return O bloco.
+	 */
+	Tile tile(int line, int column, int numLines, int numColumns);
+
+	/**
+	 * @brief Pinta todos os pixels de preto (alfa 255 no formato RGBA8).
+	 */
+	void clear();
+
+	/**
+	 * @brief Leva as cores para [0, 255]: negativos viram 0 e a maior componente vira 255.
+	 *
+	 * Mesma normalização de Tensor::normalize. Não faz nada no formato RGBA8, que já é limitado.
+	 */
+	void normalize();
+
+	/**
+	 * @brief Converte a imagem para pixels RGBA de 8 bits (alfa 255), linha a linha.
+	 *
+	 * Os valores são limitados ao intervalo [0, 255].
+	 *
+	 * @param pixels Destino, com getNumLines() linhas de pelo menos 4 * getNumColumns() bytes.
+	 * @param pitch Número de bytes entre o início de duas linhas consecutivas do destino.
+	 */
+	void toRGBA(unsigned char* pixels, int pitch) const;
+
+private:
+	int numColumns;
+	int numLines;
+	Format format;
+	int pitch;
+
+	unsigned char* memory; // Bloco alocado (com folga para o alinhamento)
+	unsigned char* data;   // Início alinhado da primeira linha
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "GBuffer.h"
+#include <algorithm>
+
+/**
+ * @brief Constrói um G-buffer vazio.
+ */
+GBuffer::GBuffer()
+{
+	this->observable << 0, 0, 0;
+	this->numColumns = 0;
+	this->numLines = 0;
+	this->numSources = 0;
+	this->numShadowWords = 0;
+	this->maxLights = 0;
+}
+
+/**
+ * @brief Dimensiona os vetores para numColumns x numLines pixels, numSources fontes e maxLights fontes escolhidas por pixel.
+ */
+void GBuffer::resize(int numColumns, int numLines, int numSources, int maxLights)
+{
+	this->numColumns = numColumns;
+	this->numLines = numLines;
+	this->numSources = numSources;
+	this->numShadowWords = (numSources + 31) / 32;
+	this->maxLights = maxLights;
+
+	size_t numPixels = (size_t)numColumns * numLines;
+
+	this->objects.resize(numPixels);
+	this->materials.resize(numPixels);
+	this->t.resize(numPixels);
+	this->normalX.resize(numPixels);
+	this->normalY.resize(numPixels);
+	this->normalZ.resize(numPixels);
+	this->u.resize(numPixels);
+	this->v.resize(numPixels);
+	this->structures.resize(numPixels);
+	this->hasUV.resize(numPixels);
+	this->shadowMasks.resize(numPixels * this->numShadowWords);
+	this->lightCounts.resize(maxLights > 0 ? numPixels : 0);
+	this->sampledCounts.resize(maxLights > 0 ? numPixels : 0);
+	this->lights.resize(numPixels * maxLights);
+	this->lightWeights.resize(numPixels * maxLights);
+}
+
+/**
+ * @brief Obtém o número de colunas.
+ */
+int GBuffer::getNumColumns() const
+{
+	return this->numColumns;
+}
+
+/**
+ * @brief Obtém o número de linhas.
+ */
+int GBuffer::getNumLines() const
+{
+	return this->numLines;
+}
+
+/**
+ * @brief Obtém o número de fontes de luz das máscaras de sombra.
+ */
+int GBuffer::getNumSources() const
+{
+	return this->numSources;
+}
+
+/**
+ * @brief Obtém o maior número de fontes guardadas por pixel.
+ */
+int GBuffer::getMaxLights() const
+{
+	return this->maxLights;
+}
+
+/**
+ * @brief Grava a interseção, as fontes escolhidas e as sombras de um pixel.
+ */
+void GBuffer::setHit(int i, Object* object, const HitRecord& hit, const LightIndex::Selection& lights)
+{
+	const std::vector<int>& indices = lights.indices;
+	const std::vector<bool>& shadows = lights.shadows;
+
+	this->objects[i] = object;
+	this->materials[i] = object->material;
+	this->t[i] = hit.t;
+	this->normalX[i] = hit.normal[0];
+	this->normalY[i] = hit.normal[1];
+	this->normalZ[i] = hit.normal[2];
+	this->u[i] = hit.hasUV ? hit.uv[0] : 0;
+	this->v[i] = hit.hasUV ? hit.uv[1] : 0;
+	this->structures[i] = hit.structure;
+	this->hasUV[i] = hit.hasUV;
+
+	unsigned int* mask = this->shadowMasks.data() + (size_t)i * this->numShadowWords;
+	for (int w = 0; w < this->numShadowWords; w++)
+	{
+		mask[w] = 0;
+	}
+	for (size_t k = 0; k < indices.size(); k++)
+	{
+		if (shadows[k])
+		{
+			mask[indices[k] / 32] |= 1u << (indices[k] % 32);
+		}
+	}
+
+	if (this->maxLights > 0)
+	{
+		this->lightCounts[i] = indices.size();
+		this->sampledCounts[i] = lights.weights.size();
+		std::copy(indices.begin(), indices.end(), this->lights.begin() + (size_t)i * this->maxLights);
+		std::copy(lights.weights.begin(), lights.weights.end(), this->lightWeights.begin() + (size_t)i * this->maxLights);
+	}
+}
+
+/**
+ * @brief Marca um pixel sem interseção.
+ */
+void GBuffer::setMiss(int i)
+{
+	this->objects[i] = NULL;
+	this->materials[i] = -1;
+}
+
+/**
+ * @brief Reconstrói o registro da interseção de um pixel.
+ */
+void GBuffer::getHit(int i, HitRecord* hit) const
+{
+	hit->t = this->t[i];
+	hit->structure = this->structures[i];
+	hit->normal << this->normalX[i], this->normalY[i], this->normalZ[i];
+	hit->uv << this->u[i], this->v[i];
+	hit->hasUV = this->hasUV[i] != 0;
+}
+
+/**
+ * @brief Reconstrói o vetor de sombras de um pixel.
+ */
+void GBuffer::getShadows(int i, const std::vector<int>& lights, std::vector<bool>* shadows) const
+{
+	const unsigned int* mask = this->shadowMasks.data() + (size_t)i * this->numShadowWords;
+
+	shadows->resize(lights.size());
+	for (size_t k = 0; k < lights.size(); k++)
+	{
+		(*shadows)[k] = (mask[lights[k] / 32] >> (lights[k] % 32)) & 1;
+	}
+}
+
+/**
+ * @brief Reconstrói os índices, os pesos e as sombras das fontes escolhidas num pixel.
+ */
+void GBuffer::getLights(int i, LightIndex::Selection* lights) const
+{
+	const int* indices = this->lights.data() + (size_t)i * this->maxLights;
+	const Scalar* weights = this->lightWeights.data() + (size_t)i * this->maxLights;
+
+	lights->indices.assign(indices, indices + this->lightCounts[i]);
+	lights->weights.assign(weights, weights + this->sampledCounts[i]);
+	this->getShadows(i, lights->indices, &lights->shadows);
+}
@@ -0,0 +1,153 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <vector>
+
+#include "HitRecord.h"
+#include "LightIndex.h"
+#include "Object.h"
+#include "Scalar.h"
+
+#ifndef GBuffer_H
+#define GBuffer_H
+
+/**
+ * @brief Resultado da passada de visibilidade da renderização adiada (Canvas::trace).
+ *
+ * Guarda, para cada pixel, tudo o que o sombreamento usa: o objeto atingido (NULL se o raio não
+ * atingiu nada), o índice do material, o registro da interseção, a máscara de sombras (um bit
+ * por fonte de luz) e, se a seleção de fontes varia entre pixels, as fontes escolhidas e os pesos
+ * das sorteadas. Os campos ficam em vetores separados, um elemento por pixel, linha a linha,
+ * para que a passada de sombreamento (Canvas::shade) percorra memória contígua.
+ *
+ * Depois da passada de visibilidade, mudanças que só afetam o sombreamento (intensidade das
+ * fontes, materiais com RenderScene::setMaterial, textura de um plano) só precisam de Canvas::shade.
+ * Mudanças de geometria, da câmera ou da posição das fontes (que mudam as sombras) precisam de
+ * uma nova passada de visibilidade.
+ */
+class GBuffer
+{
+public:
+	Vector3 observable; /**< Ponto de observação dos raios primários */
+
+	std::vector<Object*> objects;     /**< Objeto atingido em cada pixel (NULL se nenhum) */
+	std::vector<int> materials;       /**< Índice do material do objeto na tabela de materiais da cena */
+	std::vector<Scalar> t;            /**< Parâmetro t da interseção */
+	std::vector<Scalar> normalX;      /**< Componente x da normal */
+	std::vector<Scalar> normalY;      /**< Componente y da normal */
+	std::vector<Scalar> normalZ;      /**< Componente z da normal */
+	std::vector<Scalar> u;            /**< Coordenada u de textura (válida se hasUV) */
+	std::vector<Scalar> v;            /**< Coordenada v de textura (válida se hasUV) */
+	std::vector<int> structures;      /**< Parte do objeto atingida (HitRecord::structure) */
+	std::vector<unsigned char> hasUV; /**< Indica se u e v foram preenchidos */
+	std::vector<unsigned int> shadowMasks; /**< numShadowWords palavras por pixel; o bit i indica sombra da fonte i */
+	std::vector<int> lightCounts;          /**< Número de fontes escolhidas em cada pixel */
+	std::vector<int> sampledCounts;        /**< Quantas dessas fontes (as últimas) foram sorteadas */
+	std::vector<int> lights;               /**< getMaxLights() índices de fontes por pixel (LightIndex::Selection::indices) */
+	std::vector<Scalar> lightWeights;      /**< getMaxLights() pesos por pixel (LightIndex::Selection::weights) */
+
+	/**
+	 * @brief Constrói um G-buffer vazio; Canvas::trace o dimensiona.
+	 */
+	GBuffer();
+
+	/**
+	 * @brief Dimensiona o G-buffer. Só aloca quando o tamanho cresce.
+	 *
+	 * @param numColumns Número de colunas.
+	 * @param numLines Número de linhas.
+	 * @param numSources Número de fontes de luz da cena.
+	 * @param maxLights Maior número de fontes escolhidas num pixel (0 se todos os pixels veem todas as fontes).
+	 */
+	void resize(int numColumns, int numLines, int numSources, int maxLights);
+
+	/**
+	 * @brief Obtém o número de colunas.
+	 */
+	int getNumColumns() const;
+
+	/**
+	 * @brief Obtém o número de linhas.
+	 */
+	int getNumLines() const;
+
+	/**
+	 * @brief Obtém o número de fontes de luz das máscaras de sombra.
+	 */
+	int getNumSources() const;
+
+	/**
+	 * @brief Obtém o maior número de fontes guardadas por pixel (0 se a seleção não é guardada).
+	 */
+	int getMaxLights() const;
+
+	/**
+	 * @brief Posição do pixel (l, c) nos vetores.
+	 */
+	int index(int l, int c) const
+	{
+		return l * this->numColumns + c;
+	}
+
+	/**
+	 * @brief Grava a interseção, as fontes escolhidas e as sombras de um pixel.
+	 *
+	 * @param i Posição do pixel.
+	 * @param object O objeto atingido.
+	 * @param hit O registro da interseção.
+	 * @param lights As fontes avaliadas no pixel, com as sombras (as outras fontes ficam sem sombra).
+	 */
+	void setHit(int i, Object* object, const HitRecord& hit, const LightIndex::Selection& lights);
+
+	/**
+	 * @brief Marca um pixel cujo raio não atingiu nenhum objeto.
+	 *
+	 * @param i Posição do pixel.
+	 */
+	void setMiss(int i);
+
+	/**
+	 * @brief Reconstrói o registro da interseção de um pixel.
+	 *
+	 * @param i Posição do pixel.
+	 * @param hit Registro a ser preenchido.
+	 */
+	void getHit(int i, HitRecord* hit) const;
+
+	/**
+	 * @brief Reconstrói o vetor de sombras de um pixel (sem alocar, se já tiver o tamanho certo).
+	 *
+	 * @param i Posição do pixel.
+	 * @param lights Índice, na lista de fontes da cena, de cada fonte avaliada no pixel.
+	 * @param shadows Vetor a ser preenchido, com uma posição por fonte avaliada.
+	 */
+	void getShadows(int i, const std::vector<int>& lights, std::vector<bool>* shadows) const;
+
+	/**
+	 * @brief Reconstrói os índices, os pesos e as sombras das fontes escolhidas num pixel em Canvas::trace.
+	 *
+	 * Só vale se getMaxLights() > 0. As fontes da seleção são refeitas depois com LightIndex::restore.
+	 *
+	 * @param i Posição do pixel.
+	 * @param lights Seleção a ser preenchida.
+	 */
+	void getLights(int i, LightIndex::Selection* lights) const;
+
+	/**
+	 * @brief Verifica se uma fonte está bloqueada num pixel.
+	 *
+	 * @param i Posição do pixel.
+	 * @param light Índice da fonte na lista de fontes da cena.
+	 */
+	bool isShadowed(int i, int light) const
+	{
+		return (this->shadowMasks[(size_t)i * this->numShadowWords + light / 32] >> (light % 32)) & 1;
+	}
+
+private:
+	int numColumns;
+	int numLines;
+	int numSources;
+	int numShadowWords; // Palavras de 32 bits por pixel em shadowMasks
+	int maxLights;      // Posições por pixel em lights e lightWeights
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#ifdef CG_HAS_SDL_IMAGE
+#include <SDL_image.h>
+#endif
+
+#include "Camera.h"
+#include "Canvas.h"
+#include "Framebuffer.h"
+#include "ImageWriter.h"
+#include "RenderScene.h"
+#include "SeasonsScene.h"
+#include "Texture.h"
+
+/*
+Renderização sem janela: monta a cena das estações, renderiza com Canvas::raycast e grava
+a imagem em PPM ou PNG, sem inicializar o vídeo da SDL. Serve para renderizar em servidores
+sem tela e para medir a vazão em lote (--frames).
+*/
+
+static void printUsage(const char* program)
+{
+	fprintf(stderr,
+			"Uso: %s [opções]\n"
+			"  -o, --output ARQ      Arquivo de saída (.png ou .ppm); \"-\" grava na saída padrão (padrão: render.ppm)\n"
+			"  -f, --format FMT      ppm ou png (padrão: pela extensão do arquivo; ppm na saída padrão)\n"
+			"      --width N         Número de colunas (padrão: 500)\n"
+			"      --height N        Número de linhas (padrão: 500)\n"
+			"  -s, --season NOME     spring, summer, autumn ou winter (padrão: summer)\n"
+			"      --eye x,y,z       Posição da câmera (padrão: 0,-20,-350)\n"
+			"      --look-at x,y,z   Ponto para onde a câmera olha (padrão: 0,-20,0)\n"
+			"      --up x,y,z        Vetor de orientação da câmera (padrão: 0,1,0)\n"
+			"  -t, --threads N       Threads da renderização; 0 usa todos os núcleos (padrão: 0)\n"
+			"      --tile N          Lado dos blocos da renderização, em pixels (padrão: 16)\n"
+			"      --packet N        Traça os raios primários em pacotes de N x N pixels (4 ou 8; padrão: 0, desligado)\n"
+			"      --shadow-map N    Testa as sombras das fontes pontuais num mapa cúbico de N x N texels por face\n"
+			"                        (padrão: 0, desligado)\n"
+			"      --max-lights N    Fontes pontuais avaliadas por ponto antes de sorteá-las na árvore de fontes\n"
+			"                        (0 avalia todas; padrão: 16)\n"
+			"      --frames N        Renderiza N quadros e grava o último (padrão: 1)\n"
+			"      --textures DIR    Carrega a textura do gramado de DIR (precisa da SDL2_image)\n"
+			"  -h, --help            Mostra esta ajuda\n",
+			program);
+}
+
+// Lê um vetor no formato "x,y,z"
+static bool parseVector(const char* text, Vector3* vector)
+{
+	double x, y, z;
+	char end;
+
+	if (sscanf(text, "%lf,%lf,%lf%c", &x, &y, &z, &end) != 3)
+	{
+		return false;
+	}
+
+	*vector = Vector3(x, y, z);
+	return true;
+}
+
+// Lê um inteiro dentro de [minimum, maximum]
+static bool parseInt(const char* text, int minimum, int maximum, int* value)
+{
+	char* end;
+	long parsed = strtol(text, &end, 10);
+
+	if (*text == '\0' || *end != '\0' || parsed < minimum || parsed > maximum)
+	{
+		return false;
+	}
+
+	*value = (int)parsed;
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* output = "render.ppm";
+	const char* formatName = NULL;
+	const char* textureDir = NULL;
+	int width = 500, height = 500;
+	int numThreads = 0, tileSize = 16, numFrames = 1, packetSize = 0, shadowMapSize = 0;
+	int maxLights = LightIndex::DEFAULT_MAX_LIGHTS;
+	Season season = SUMMER;
+
+	// A câmera padrão é a mesma do main.cpp; cada opção sobrescreve só o seu vetor
+	Vector3 eye(0, -20, -350), lookAt(0, -20, 0), up(0, 1, 0);
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* option = argv[i];
+
+		if (strcmp(option, "-h") == 0 || strcmp(option, "--help") == 0)
+		{
+			printUsage(argv[0]);
+			return 0;
+		}
+
+		if (i + 1 >= argc)
+		{
+			fprintf(stderr, "Opção desconhecida ou sem valor: %s\n", option);
+			printUsage(argv[0]);
+			return 2;
+		}
+
+		const char* value = argv[++i];
+		bool valid = true;
+
+		if (strcmp(option, "-o") == 0 || strcmp(option, "--output") == 0)
+		{
+			output = value;
+		}
+		else if (strcmp(option, "-f") == 0 || strcmp(option, "--format") == 0)
+		{
+			formatName = value;
+		}
+		else if (strcmp(option, "--width") == 0)
+		{
+			valid = parseInt(value, 1, 32768, &width);
+		}
+		else if (strcmp(option, "--height") == 0)
+		{
+			valid = parseInt(value, 1, 32768, &height);
+		}
+		else if (strcmp(option, "-s") == 0 || strcmp(option, "--season") == 0)
+		{
+			valid = parseSeason(value, &season);
+		}
+		else if (strcmp(option, "--eye") == 0)
+		{
+			valid = parseVector(value, &eye);
+		}
+		else if (strcmp(option, "--look-at") == 0)
+		{
+			valid = parseVector(value, &lookAt);
+		}
+		else if (strcmp(option, "--up") == 0)
+		{
+			valid = parseVector(value, &up);
+		}
+		else if (strcmp(option, "-t") == 0 || strcmp(option, "--threads") == 0)
+		{
+			valid = parseInt(value, 0, 1024, &numThreads);
+		}
+		else if (strcmp(option, "--tile") == 0)
+		{
+			valid = parseInt(value, 1, 4096, &tileSize);
+		}
+		else if (strcmp(option, "--packet") == 0)
+		{
+			valid = parseInt(value, 0, 8, &packetSize) && (packetSize == 0 || packetSize == 4 || packetSize == 8);
+		}
+		else if (strcmp(option, "--shadow-map") == 0)
+		{
+			valid = parseInt(value, 0, 1024, &shadowMapSize);
+		}
+		else if (strcmp(option, "--max-lights") == 0)
+		{
+			valid = parseInt(value, 0, 1000000, &maxLights);
+		}
+		else if (strcmp(option, "--frames") == 0)
+		{
+			valid = parseInt(value, 1, 1000000, &numFrames);
+		}
+		else if (strcmp(option, "--textures") == 0)
+		{
+			textureDir = value;
+		}
+		else
+		{
+			fprintf(stderr, "Opção desconhecida: %s\n", option);
+			printUsage(argv[0]);
+			return 2;
+		}
+
+		if (!valid)
+		{
+			fprintf(stderr, "Valor inválido para %s: %s\n", option, value);
+			return 2;
+		}
+	}
+
+	// Formato: explícito, pela extensão ou PPM na saída padrão
+	ImageWriter::Format format = ImageWriter::PPM;
+	if (formatName != NULL)
+	{
+		if (strcmp(formatName, "png") == 0)
+		{
+			format = ImageWriter::PNG;
+		}
+		else if (strcmp(formatName, "ppm") != 0)
+		{
+			fprintf(stderr, "Formato desconhecido: %s\n", formatName);
+			return 2;
+		}
+	}
+	else if (strcmp(output, "-") != 0 && !ImageWriter::formatFromPath(output, &format))
+	{
+		fprintf(stderr, "Não foi possível deduzir o formato de %s; use --format\n", output);
+		return 2;
+	}
+
+	// Textura do gramado (opcional), decodificada uma vez; a superfície é liberada logo depois
+	Texture* grassTexture = NULL;
+	if (textureDir != NULL)
+	{
+#ifdef CG_HAS_SDL_IMAGE
+		char path[4096];
+		snprintf(path, sizeof(path), "%s/%s", textureDir, seasonTextureFile(season));
+		SDL_Surface* surface = IMG_Load(path);
+		if (surface == NULL)
+		{
+			fprintf(stderr, "Não foi possível carregar %s: %s\n", path, IMG_GetError());
+			return 1;
+		}
+		grassTexture = new Texture(surface);
+		SDL_FreeSurface(surface);
+#else
+		fprintf(stderr, "Compilado sem SDL2_image: --textures não está disponível\n");
+		return 2;
+#endif
+	}
+
+	Scene scene;
+	buildSeasonsScene(scene, season, grassTexture);
+	delete scene.camera;
+	scene.setCamera(new Camera(eye, lookAt, up));
+
+	// A janela tem largura 60 a distância 30, como no main.cpp; a altura segue a proporção da imagem
+	double windowWidth = 60;
+	double windowHeight = windowWidth * height / width;
+	Canvas canvas(30, windowWidth, windowHeight, height, width);
+	canvas.setTiling(numThreads, tileSize);
+	canvas.setPacketSize(packetSize);
+
+	auto t0 = std::chrono::steady_clock::now();
+	RenderScene frameScene(scene);
+	frameScene.buildShadowMaps(shadowMapSize);
+	frameScene.setMaxLights(maxLights);
+	auto t1 = std::chrono::steady_clock::now();
+
+	Framebuffer image(width, height, Framebuffer::RGB_FLOAT);
+	for (int f = 0; f < numFrames; f++)
+	{
+		canvas.raycast(Vector3(0, 0, 0), frameScene, &image);
+	}
+	auto t2 = std::chrono::steady_clock::now();
+
+	image.normalize();
+
+	if (!ImageWriter::write(image, output, format))
+	{
+		fprintf(stderr, "Não foi possível gravar %s\n", output);
+		return 1;
+	}
+
+	// Estatísticas vão para a saída de erro, que fica livre mesmo com -o -
+	double compileMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	double renderMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+	double rays = (double)width * height * numFrames;
+	fprintf(stderr, "%dx%d, %d quadro(s): compilação %.2f ms, %.2f ms/quadro, %.2f Mraios/s\n",
+			width, height, numFrames, compileMs, renderMs / numFrames, rays / (renderMs * 1000));
+
+	delete grassTexture;
+
+	return 0;
+}
@@ -8,7 +8,7 @@
  * @param centerBase O centro da base da HitBox.
  * @param centerTop O centro do topo da HitBox.
  */
-HitBox::HitBox(double radius, Eigen::Vector3d centerBase, Eigen::Vector3d centerTop)
+HitBox::HitBox(Scalar radius, Vector3 centerBase, Vector3 centerTop)
 {
 	this->radius = radius;
 	this->centerBase = centerBase;
@@ -44,17 +44,17 @@ int HitBox::getNumElements()
  */
 bool HitBox::hasInterceptedRay(Ray ray)
 {
-	Eigen::Vector3d w = ray.initialPoint - this->centerBase;
-	Eigen::Vector3d pInt(0, 0, 0);
+	Vector3 w = ray.initialPoint - this->centerBase;
+	Vector3 pInt(0, 0, 0);
 
-	double a = ray.direction.dot(ray.direction) - pow(ray.direction.dot(this->direction), 2);
-	double b = 2 * w.dot(ray.direction) - 2 * w.dot(this->direction) * ray.direction.dot(this->direction);
-	double c = w.dot(w) - pow(w.dot(this->direction), 2) - pow(this->radius, 2);
+	Scalar a = ray.direction.dot(ray.direction) - pow(ray.direction.dot(this->direction), 2);
+	Scalar b = 2 * w.dot(ray.direction) - 2 * w.dot(this->direction) * ray.direction.dot(this->direction);
+	Scalar c = w.dot(w) - pow(w.dot(this->direction), 2) - pow(this->radius, 2);
 
-	Eigen::Vector3d intesityEye(0, 0, 0);
-	Eigen::Vector4d intensityAndDistance(0, 0, 0, 1);
+	Vector3 intesityEye(0, 0, 0);
+	Vector4 intensityAndDistance(0, 0, 0, 1);
 
-	double delta = b * b - 4 * a * c;
+	Scalar delta = b * b - 4 * a * c;
 
 	if (a != 0 && delta >= 0)
 	{
@@ -62,13 +62,13 @@ bool HitBox::hasInterceptedRay(Ray ray)
 	}
 
 	w = ray.initialPoint - this->centerBase;
-	double tInt = -(-this->direction.dot(w)) / (-this->direction.dot(ray.direction));
+	Scalar tInt = -(-this->direction.dot(w)) / (-this->direction.dot(ray.direction));
 
-	if (tInt < 0)
+	if (ray.contains(tInt))
 	{
 		pInt = ray.initialPoint + tInt * ray.direction;
 
-		double insideInterval = pow((pInt - this->centerBase).norm(), 2);
+		Scalar insideInterval = pow((pInt - this->centerBase).norm(), 2);
 
 		if (insideInterval >= 0 && insideInterval <= pow(this->radius, 2))
 		{
@@ -79,11 +79,11 @@ bool HitBox::hasInterceptedRay(Ray ray)
 	w = ray.initialPoint - this->centerTop;
 	tInt = -(this->direction.dot(w)) / (this->direction.dot(ray.direction));
 
-	if (tInt < 0)
+	if (ray.contains(tInt))
 	{
 		pInt = ray.initialPoint + tInt * ray.direction;
 
-		double insideInterval = pow((pInt - this->centerTop).norm(), 2);
+		Scalar insideInterval = pow((pInt - this->centerTop).norm(), 2);
 
 		if (insideInterval >= 0 && insideInterval <= pow(this->radius, 2))
 		{
@@ -100,10 +100,10 @@ bool HitBox::hasInterceptedRay(Ray ray)
  *
  * @param transformationMatrix A matriz de transformação para o sistema de coordenadas da câmera.
  */
-void HitBox::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void HitBox::convertToCamera(Matrix4 transformationMatrix)
 {
-	Eigen::Vector4d centerTop4;
-	Eigen::Vector4d centerBase4;
+	Vector4 centerTop4;
+	Vector4 centerBase4;
 
 	centerTop4 << this->centerTop[0], this->centerTop[1], this->centerTop[2], 1;
 	centerBase4 << this->centerBase[0], this->centerBase[1], this->centerBase[2], 1;
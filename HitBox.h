@@ -3,21 +3,25 @@
 
 #include "Ray.h"
 #include "Object.h"
+#include "Scalar.h"
 
 #ifndef HitBox_H
 #define HitBox_H
 
 /**
  * Classe para representar uma caixa de colisão.
+ *
+ * Mantida por compatibilidade: a BVH já envolve cada objeto com a caixa calculada por
+ * Object::getBounds, então os objetos de uma hitbox são tratados como objetos comuns da cena.
  */
 class HitBox
 {
 public:
-	double radius;
-	double height;
-	Eigen::Vector3d centerBase;
-	Eigen::Vector3d centerTop;
-	Eigen::Vector3d direction;
+	Scalar radius;
+	Scalar height;
+	Vector3 centerBase;
+	Vector3 centerTop;
+	Vector3 direction;
 	std::vector<Object*> objects;
 
 	/**
@@ -26,7 +30,7 @@ public:
 	 * @param centerBase O centro da base da caixa de colisão.
 	 * @param centerTop O centro do topo da caixa de colisão.
 	 */
-	HitBox(double radius, Eigen::Vector3d centerBase, Eigen::Vector3d centerTop);
+	HitBox(Scalar radius, Vector3 centerBase, Vector3 centerTop);
 
 	/**
 	 * Adiciona um objeto à caixa de colisão.
@@ -38,7 +42,7 @@ public:
 	 * Converte a caixa de colisão para o sistema de coordenadas da câmera.
 	 * @param transformationMatrix A matriz de transformação para o sistema de coordenadas da câmera.
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
 
 	/**
 	 * Verifica se a caixa de colisão interceptou um raio.
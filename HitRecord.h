@@ -0,0 +1,23 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+
+#include "Scalar.h"
+
+#ifndef HitRecord_H
+#define HitRecord_H
+
+/**
+ * @brief Registro de uma interseção entre um raio e um objeto.
+ *
+ * Preenchido por Object::intersect e consumido por Object::shade, de forma que
+ * nenhum estado da interseção precisa ser guardado no próprio objeto.
+ */
+struct HitRecord
+{
+	Scalar t;       /**< Parâmetro t da interseção: distância ao longo de ray.direction, dentro de (ray.tMin, ray.tMax) */
+	int structure;  /**< Parte do objeto atingida (ex.: 0 = lateral, 1 = topo, 2 = base no cilindro; índice da face no cubo) */
+	Vector3 normal; /**< Normal da superfície no ponto de interseção */
+	Vector2 uv;     /**< Coordenadas de textura no ponto de interseção (válidas se hasUV) */
+	bool hasUV;     /**< Indica se uv foi preenchido */
+};
+
+#endif
@@ -0,0 +1,236 @@
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// Converte a imagem para linhas RGB de 8 bits, sem espaço entre as linhas
+static std::vector<unsigned char> toRGB(const Framebuffer& image)
+{
+	int width = image.getNumColumns(), height = image.getNumLines();
+	std::vector<unsigned char> rgba(4 * width * height);
+	std::vector<unsigned char> rgb(3 * width * height);
+
+	image.toRGBA(rgba.data(), 4 * width);
+
+	for (int i = 0; i < width * height; i++)
+	{
+		rgb[3 * i] = rgba[4 * i];
+		rgb[3 * i + 1] = rgba[4 * i + 1];
+		rgb[3 * i + 2] = rgba[4 * i + 2];
+	}
+
+	return rgb;
+}
+
+// CRC-32 (polinômio 0xEDB88320) usado nos blocos do PNG
+static unsigned long crc32(unsigned long crc, const unsigned char* data, size_t size)
+{
+	static unsigned long table[256];
+	static bool initialized = false;
+
+	if (!initialized)
+	{
+		for (unsigned long n = 0; n < 256; n++)
+		{
+			unsigned long c = n;
+			for (int k = 0; k < 8; k++)
+			{
+				c = (c & 1) ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+			}
+			table[n] = c;
+		}
+		initialized = true;
+	}
+
+	crc ^= 0xFFFFFFFFUL;
+	for (size_t i = 0; i < size; i++)
+	{
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+
+	return crc ^ 0xFFFFFFFFUL;
+}
+
+static void putUint32(std::vector<unsigned char>& out, unsigned long value)
+{
+	out.push_back((value >> 24) & 0xFF);
+	out.push_back((value >> 16) & 0xFF);
+	out.push_back((value >> 8) & 0xFF);
+	out.push_back(value & 0xFF);
+}
+
+// Grava um bloco do PNG: tamanho, tipo, dados e CRC do tipo + dados
+static bool writeChunk(FILE* file, const char* type, const std::vector<unsigned char>& data)
+{
+	std::vector<unsigned char> chunk;
+	putUint32(chunk, data.size());
+	chunk.insert(chunk.end(), type, type + 4);
+	chunk.insert(chunk.end(), data.begin(), data.end());
+	putUint32(chunk, crc32(0, chunk.data() + 4, chunk.size() - 4));
+
+	return fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size();
+}
+
+/**
+ * @brief Grava a imagem no formato PPM binário (P6).
+ *
+ * @param image A imagem.
+ * @param file O arquivo de destino, aberto em modo binário.
+ * @return true se a gravação foi concluída.
+ */
+bool ImageWriter::writePPM(const Framebuffer& image, FILE* file)
+{
+	std::vector<unsigned char> rgb = toRGB(image);
+
+	if (fprintf(file, "P6\n%d %d\n255\n", image.getNumColumns(), image.getNumLines()) < 0)
+	{
+		return false;
+	}
+
+	return fwrite(rgb.data(), 1, rgb.size(), file) == rgb.size() && fflush(file) == 0;
+}
+
+/**
+ * @brief Grava a imagem no formato PNG (RGB, 8 bits por canal, sem compressão).
+ *
+ * @param image A imagem.
+ * @param file O arquivo de destino, aberto em modo binário.
+ * @return true se a gravação foi concluída.
+ */
+bool ImageWriter::writePNG(const Framebuffer& image, FILE* file)
+{
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	int width = image.getNumColumns(), height = image.getNumLines();
+	std::vector<unsigned char> rgb = toRGB(image);
+
+	// Cabeçalho: dimensões, 8 bits, RGB, sem entrelaçamento
+	std::vector<unsigned char> header;
+	putUint32(header, width);
+	putUint32(header, height);
+	header.push_back(8);
+	header.push_back(2);
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+
+	// Linhas com o filtro 0 (nenhum) na frente de cada uma
+	size_t rowSize = 3 * width;
+	std::vector<unsigned char> raw;
+	raw.reserve((rowSize + 1) * height);
+	for (int l = 0; l < height; l++)
+	{
+		raw.push_back(0);
+		raw.insert(raw.end(), rgb.begin() + l * rowSize, rgb.begin() + (l + 1) * rowSize);
+	}
+
+	// Fluxo zlib com blocos "stored" de até 65535 bytes e o Adler-32 no fim
+	std::vector<unsigned char> zlib;
+	zlib.push_back(0x78);
+	zlib.push_back(0x01);
+
+	size_t offset = 0;
+	do
+	{
+		size_t size = std::min<size_t>(65535, raw.size() - offset);
+		bool last = offset + size == raw.size();
+
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back(size & 0xFF);
+		zlib.push_back((size >> 8) & 0xFF);
+		zlib.push_back(~size & 0xFF);
+		zlib.push_back((~size >> 8) & 0xFF);
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+
+		offset += size;
+	} while (offset < raw.size());
+
+	unsigned long a = 1, b = 0;
+	for (size_t i = 0; i < raw.size(); i++)
+	{
+		a = (a + raw[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	putUint32(zlib, (b << 16) | a);
+
+	return fwrite(signature, 1, 8, file) == 8 &&
+		   writeChunk(file, "IHDR", header) &&
+		   writeChunk(file, "IDAT", zlib) &&
+		   writeChunk(file, "IEND", std::vector<unsigned char>()) &&
+		   fflush(file) == 0;
+}
+
+/**
+ * @brief Grava a imagem em um caminho; "-" grava na saída padrão.
+ *
+ * @param image A imagem.
+ * @param path O caminho do arquivo, ou "-" para a saída padrão.
+ * @param format O formato da imagem.
+ * @return true se a gravação foi concluída.
+ */
+bool ImageWriter::write(const Framebuffer& image, const char* path, Format format)
+{
+	bool toStdout = strcmp(path, "-") == 0;
+	FILE* file;
+
+	if (toStdout)
+	{
+		file = stdout;
+#ifdef _WIN32
+		_setmode(_fileno(stdout), _O_BINARY);
+#endif
+	}
+	else
+	{
+		file = fopen(path, "wb");
+		if (file == NULL)
+		{
+			return false;
+		}
+	}
+
+	bool written = format == PNG ? writePNG(image, file) : writePPM(image, file);
+
+	if (!toStdout && fclose(file) != 0)
+	{
+		written = false;
+	}
+
+	return written;
+}
+
+/**
+ * @brief Deduz o formato pela extensão do caminho (.png ou .ppm).
+ *
+ * @param path O caminho do arquivo.
+ * @param format Ponteiro para armazenar o formato.
+ * @return true se a extensão é conhecida.
+ */
+bool ImageWriter::formatFromPath(const char* path, Format* format)
+{
+	const char* extension = strrchr(path, '.');
+
+	if (extension == NULL)
+	{
+		return false;
+	}
+
+	if (strcmp(extension, ".png") == 0 || strcmp(extension, ".PNG") == 0)
+	{
+		*format = PNG;
+		return true;
+	}
+
+	if (strcmp(extension, ".ppm") == 0 || strcmp(extension, ".PPM") == 0)
+	{
+		*format = PPM;
+		return true;
+	}
+
+	return false;
+}
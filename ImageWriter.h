@@ -0,0 +1,65 @@
+#include <cstdio>
+
+#include "Framebuffer.h"
+
+#ifndef ImageWriter_H
+#define ImageWriter_H
+
+/**
+ * @brief Grava imagens renderizadas em disco (ou em qualquer FILE*) sem depender da SDL.
+ *
+ * As cores são limitadas ao intervalo [0, 255], como em Framebuffer::toRGBA, então uma
+ * imagem RGB_FLOAT normalmente já passou por normalize(). Os PNGs são gravados sem compressão
+ * (blocos "stored" do deflate), o que é válido para qualquer leitor e não exige a zlib.
+ */
+class ImageWriter
+{
+public:
+	/**
+	 * @brief Formatos de imagem suportados.
+	 */
+	enum Format
+	{
+		PPM, /**< PPM binário (P6) */
+		PNG  /**< PNG RGB de 8 bits */
+	};
+
+	/**
+	 * @brief Grava a imagem no formato PPM binário (P6).
+	 *
+	 * @param image A imagem.
+	 * @param file O arquivo de destino, aberto em modo binário.
+	 * @return true se a gravação foi concluída.
+	 */
+	static bool writePPM(const Framebuffer& image, FILE* file);
+
+	/**
+	 * @brief Grava a imagem no formato PNG (RGB, 8 bits por canal, sem compressão).
+	 *
+	 * @param image A imagem.
+	 * @param file O arquivo de destino, aberto em modo binário.
+	 * @return true se a gravação foi concluída.
+	 */
+	static bool writePNG(const Framebuffer& image, FILE* file);
+
+	/**
+	 * @brief Grava a imagem em um caminho; "-" grava na saída padrão.
+	 *
+	 * @param image A imagem.
+	 * @param path O caminho do arquivo, ou "-" para a saída padrão.
+	 * @param format O formato da imagem.
+	 * @return true se a gravação foi concluída.
+	 */
+	static bool write(const Framebuffer& image, const char* path, Format format);
+
+	/**
+	 * @brief Deduz o formato pela extensão do caminho (.png ou .ppm).
+	 *
+	 * @param path O caminho do arquivo.
+	 * @param format Ponteiro para armazenar o formato.
+	 * @return true se a extensão é conhecida.
+	 */
+	static bool formatFromPath(const char* path, Format* format);
+};
+
+#endif
@@ -0,0 +1,22 @@
+#include "Scalar.h"
+
+#ifndef LaneMath_H
+#define LaneMath_H
+
+/**
+ * @brief Produto escalar de dois vetores 3D dados por componentes.
+ *
+ * Usado pelos laços que processam vários raios ou pontos de uma vez, em estrutura de vetores. Soma
+ * na mesma ordem do dot do Eigen (em double os dois primeiros termos primeiro, em float os dois
+ * últimos), para que esses laços deem exatamente o mesmo resultado das contas com Vector3.
+ */
+inline Scalar dot3(Scalar ax, Scalar ay, Scalar az, Scalar bx, Scalar by, Scalar bz)
+{
+#ifdef CG_SCALAR_FLOAT
+	return ax * bx + (ay * by + az * bz);
+#else
+	return (ax * bx + ay * by) + az * bz;
+#endif
+}
+
+#endif
@@ -0,0 +1,483 @@
+#include "LightIndex.h"
+#include <algorithm>
+#include <cmath>
+
+// Maior número de células por eixo da grade
+static const int MAX_GRID_SIZE = 32;
+
+// Menor distância² da estimativa de importância, para que uma fonte sobre o ponto não tenha importância infinita
+static const Scalar MIN_DISTANCE2 = (Scalar)1e-6;
+
+// Espalha os bits da semente (cada pixel tem a sua sequência)
+static unsigned int hashSeed(unsigned int x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352dU;
+	x ^= x >> 15;
+	x *= 0x846ca68bU;
+	x ^= x >> 16;
+	return x;
+}
+
+// Próximo número da sequência, em [0, 1)
+static Scalar nextRandom(unsigned int* state)
+{
+	*state = *state * 1664525U + 1013904223U;
+	return (*state >> 8) * (Scalar)(1.0 / 16777216.0);
+}
+
+/**
+ * @brief Constrói um índice vazio.
+ */
+LightIndex::LightIndex()
+{
+	this->numPoints = 0;
+	this->culling = true;
+	this->maxLights = DEFAULT_MAX_LIGHTS;
+	this->gridSize[0] = this->gridSize[1] = this->gridSize[2] = 0;
+	this->cellScale << 0, 0, 0;
+}
+
+/**
+ * @brief Constrói a grade das fontes com raio e a árvore das fontes pontuais.
+ */
+void LightIndex::build(const std::vector<LightSource*>& sources)
+{
+	this->sources = sources;
+	this->points.assign(sources.size(), NULL);
+	this->unbounded.clear();
+
+	std::vector<int> bounded, treeLights;
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		PontualSource* point = dynamic_cast<PontualSource*>(sources[i]);
+		this->points[i] = point;
+
+		if (point != NULL && point->isBounded())
+		{
+			bounded.push_back(i);
+		}
+		else
+		{
+			this->unbounded.push_back(i);
+		}
+
+		if (point != NULL)
+		{
+			treeLights.push_back(i);
+		}
+	}
+	this->numPoints = treeLights.size();
+
+	// Grade: cada fonte entra nas células que a caixa da sua esfera de influência cobre
+	this->cellOffsets.clear();
+	this->cellLights.clear();
+	if (!bounded.empty())
+	{
+		this->gridBox = AABB();
+		for (int i : bounded)
+		{
+			Vector3 reach = Vector3::Constant(this->points[i]->radius);
+			this->gridBox.expand(this->points[i]->origin - reach);
+			this->gridBox.expand(this->points[i]->origin + reach);
+		}
+
+		int n = std::min(MAX_GRID_SIZE, 2 * (int)std::ceil(std::cbrt((Scalar)bounded.size())));
+		for (int a = 0; a < 3; a++)
+		{
+			Scalar extent = this->gridBox.max[a] - this->gridBox.min[a];
+			this->gridSize[a] = n;
+			this->cellScale[a] = extent > 0 ? n / extent : 0;
+		}
+
+		auto coordinate = [&](Scalar value, int a)
+		{
+			int c = (int)std::floor((value - this->gridBox.min[a]) * this->cellScale[a]);
+			return std::min(this->gridSize[a] - 1, std::max(0, c));
+		};
+
+		// Duas passadas: conta as fontes de cada célula e depois as grava, em ordem
+		int numCells = n * n * n;
+		this->cellOffsets.assign(numCells + 1, 0);
+		for (int pass = 0; pass < 2; pass++)
+		{
+			std::vector<int> next(this->cellOffsets.begin(), this->cellOffsets.end() - 1);
+
+			for (int i : bounded)
+			{
+				Vector3 reach = Vector3::Constant(this->points[i]->radius);
+				Vector3 low = this->points[i]->origin - reach, high = this->points[i]->origin + reach;
+
+				for (int z = coordinate(low[2], 2); z <= coordinate(high[2], 2); z++)
+				{
+					for (int y = coordinate(low[1], 1); y <= coordinate(high[1], 1); y++)
+					{
+						for (int x = coordinate(low[0], 0); x <= coordinate(high[0], 0); x++)
+						{
+							int cell = (z * n + y) * n + x;
+							if (pass == 0)
+							{
+								this->cellOffsets[cell + 1]++;
+							}
+							else
+							{
+								this->cellLights[next[cell]++] = i;
+							}
+						}
+					}
+				}
+			}
+
+			if (pass == 0)
+			{
+				for (int cell = 0; cell < numCells; cell++)
+				{
+					this->cellOffsets[cell + 1] += this->cellOffsets[cell];
+				}
+				this->cellLights.resize(this->cellOffsets[numCells]);
+			}
+		}
+	}
+
+	this->nodes.clear();
+	if (!treeLights.empty())
+	{
+		this->buildNode(treeLights, 0, treeLights.size());
+	}
+}
+
+/**
+ * @brief Constrói o nó das fontes em lights[first, first + count), dividindo-as pela mediana no maior eixo.
+ */
+int LightIndex::buildNode(std::vector<int>& lights, int first, int count)
+{
+	Node node;
+	node.power = 0;
+	node.maxRadius = 0;
+	node.left = node.right = node.light = -1;
+
+	for (int k = first; k < first + count; k++)
+	{
+		const PontualSource* light = this->points[lights[k]];
+		node.box.expand(light->origin);
+		node.power += light->intensity.sum();
+		node.maxRadius = std::max(node.maxRadius, light->radius);
+	}
+
+	int index = this->nodes.size();
+	this->nodes.push_back(node);
+
+	if (count == 1)
+	{
+		this->nodes[index].light = lights[first];
+		return index;
+	}
+
+	Vector3 extent = node.box.max - node.box.min;
+	int axis = 0;
+	if (extent[1] > extent[axis])
+		axis = 1;
+	if (extent[2] > extent[axis])
+		axis = 2;
+
+	int half = count / 2;
+	std::nth_element(lights.begin() + first, lights.begin() + first + half, lights.begin() + first + count, [&](int a, int b)
+	{
+		return this->points[a]->origin[axis] < this->points[b]->origin[axis];
+	});
+
+	int left = this->buildNode(lights, first, half);
+	int right = this->buildNode(lights, first + half, count - half);
+	this->nodes[index].left = left;
+	this->nodes[index].right = right;
+
+	return index;
+}
+
+/**
+ * @brief Liga ou desliga o descarte das fontes cujo raio não alcança o ponto.
+ */
+void LightIndex::setCulling(bool culling)
+{
+	this->culling = culling;
+}
+
+/**
+ * @brief Define quantas fontes pontuais são avaliadas por ponto antes de passar ao sorteio.
+ */
+void LightIndex::setMaxLights(int maxLights)
+{
+	this->maxLights = std::max(0, maxLights);
+}
+
+/**
+ * @brief Obtém o limite de fontes pontuais por ponto.
+ */
+int LightIndex::getMaxLights() const
+{
+	return this->maxLights;
+}
+
+/**
+ * @brief Reserva a memória da seleção.
+ */
+void LightIndex::prepare(Selection* selection) const
+{
+	selection->indices.reserve(this->sources.size());
+	selection->sources.reserve(this->sources.size());
+	selection->shadows.reserve(this->sources.size());
+	selection->weights.reserve(this->maxLights);
+
+	if ((int)selection->weighted.size() < this->maxLights)
+	{
+		selection->weighted.resize(this->maxLights, PontualSource(Vector3(0, 0, 0), Vector3(0, 0, 0)));
+	}
+}
+
+/**
+ * @brief Célula da grade que contém o ponto, ou -1.
+ */
+int LightIndex::cellOf(const Vector3& point) const
+{
+	if (this->cellOffsets.empty())
+	{
+		return -1;
+	}
+
+	int cell = 0;
+	for (int a = 2; a >= 0; a--)
+	{
+		if (point[a] < this->gridBox.min[a] || point[a] > this->gridBox.max[a])
+		{
+			return -1;
+		}
+
+		int c = (int)std::floor((point[a] - this->gridBox.min[a]) * this->cellScale[a]);
+		cell = cell * this->gridSize[a] + std::min(this->gridSize[a] - 1, std::max(0, c));
+	}
+
+	return cell;
+}
+
+/**
+ * @brief Importância estimada do nó: a potência dividida pela distância² até a caixa das fontes.
+ */
+Scalar LightIndex::importance(const Node& node, const Vector3& point) const
+{
+	Vector3 closest = point.cwiseMax(node.box.min).cwiseMin(node.box.max);
+	Scalar distance2 = (closest - point).squaredNorm();
+
+	if (distance2 >= node.maxRadius * node.maxRadius)
+	{
+		return 0;
+	}
+
+	// Dentro da caixa a distância até as fontes é da ordem do tamanho da caixa
+	Scalar extent2 = (node.box.max - node.box.min).squaredNorm() * (Scalar)0.25;
+	Scalar estimate = node.power / std::max(distance2, std::max(extent2, MIN_DISTANCE2));
+
+	// A mesma janela das fontes com raio, com o maior raio do nó
+	if (std::isfinite(node.maxRadius))
+	{
+		Scalar x2 = distance2 / (node.maxRadius * node.maxRadius);
+		Scalar window = 1 - x2 * x2;
+		estimate *= window * window;
+	}
+
+	return estimate;
+}
+
+/**
+ * @brief Verifica se a seleção é a mesma em todos os pontos.
+ */
+bool LightIndex::isUniform() const
+{
+	return (!this->culling || this->cellOffsets.empty()) && (this->maxLights == 0 || this->numPoints <= this->maxLights);
+}
+
+/**
+ * @brief Fontes sem sorteio (todas, ou as que não são pontuais) mais maxLights sorteadas.
+ */
+int LightIndex::getMaxSelected() const
+{
+	if (this->maxLights == 0 || this->numPoints <= this->maxLights)
+	{
+		return this->sources.size();
+	}
+	return (int)this->sources.size() - this->numPoints + this->maxLights;
+}
+
+/**
+ * @brief Escolhe as fontes que iluminam um ponto.
+ */
+void LightIndex::select(const Vector3& point, unsigned int seed, Selection* selection) const
+{
+	std::vector<int>& indices = selection->indices;
+
+	// Sem fontes com raio e sem sorteio todas as fontes valem em qualquer ponto: se a seleção já
+	// tem exatamente as fontes da cena, em ordem, não há o que refazer
+	if (this->isUniform() && selection->sources == this->sources)
+	{
+		return;
+	}
+
+	indices.clear();
+	selection->weights.clear();
+	selection->shadows.clear();
+
+	int numReached = 0;
+
+	if (!this->culling)
+	{
+		for (size_t i = 0; i < this->sources.size(); i++)
+		{
+			indices.push_back(i);
+		}
+		numReached = this->numPoints;
+	}
+	else
+	{
+		// Junta, em ordem, as fontes sem raio e as da célula que alcançam o ponto
+		int cell = this->cellOf(point);
+		int k = cell < 0 ? 0 : this->cellOffsets[cell], end = cell < 0 ? 0 : this->cellOffsets[cell + 1];
+		size_t u = 0;
+
+		while (u < this->unbounded.size() || k < end)
+		{
+			if (k == end || (u < this->unbounded.size() && this->unbounded[u] < this->cellLights[k]))
+			{
+				int i = this->unbounded[u++];
+				indices.push_back(i);
+				numReached += this->points[i] != NULL;
+			}
+			else
+			{
+				int i = this->cellLights[k++];
+				if (this->points[i]->reaches(point))
+				{
+					indices.push_back(i);
+					numReached++;
+				}
+			}
+		}
+	}
+
+	if (this->maxLights > 0 && numReached > this->maxLights)
+	{
+		// Muitas fontes pontuais: ficam só as outras, e as pontuais são sorteadas
+		int kept = 0;
+		for (int i : indices)
+		{
+			if (this->points[i] == NULL)
+			{
+				indices[kept++] = i;
+			}
+		}
+		indices.resize(kept);
+
+		this->sample(point, seed, selection);
+	}
+
+	this->restore(selection);
+}
+
+/**
+ * @brief Aponta as fontes não sorteadas para as da cena e faz as cópias ponderadas das sorteadas.
+ */
+void LightIndex::restore(Selection* selection) const
+{
+	const std::vector<int>& indices = selection->indices;
+	const std::vector<Scalar>& weights = selection->weights;
+	int first = indices.size() - weights.size();
+
+	// A seleção pode ter sido guardada com um limite de fontes maior que o atual
+	if (selection->weighted.size() < weights.size())
+	{
+		selection->weighted.resize(weights.size(), PontualSource(Vector3(0, 0, 0), Vector3(0, 0, 0)));
+	}
+
+	selection->sources.clear();
+	for (int k = 0; k < first; k++)
+	{
+		selection->sources.push_back(this->sources[indices[k]]);
+	}
+
+	for (int k = first; k < (int)indices.size(); k++)
+	{
+		PontualSource& copy = selection->weighted[k - first];
+		copy = *this->points[indices[k]];
+		copy.intensity *= weights[k - first];
+		selection->sources.push_back(&copy);
+	}
+}
+
+/**
+ * @brief Faz maxLights sorteios na árvore e acrescenta as fontes sorteadas, com os pesos, à seleção.
+ */
+void LightIndex::sample(const Vector3& point, unsigned int seed, Selection* selection) const
+{
+	std::vector<int>& indices = selection->indices;
+	std::vector<Scalar>& weights = selection->weights;
+	int first = indices.size();
+
+	if (this->nodes.empty() || !(this->importance(this->nodes[0], point) > 0))
+	{
+		return;
+	}
+
+	unsigned int state = hashSeed(seed);
+
+	for (int s = 0; s < this->maxLights; s++)
+	{
+		int node = 0;
+		Scalar probability = 1;
+
+		// Desce escolhendo cada filho com probabilidade proporcional à importância
+		while (node >= 0 && this->nodes[node].light < 0)
+		{
+			const Node& current = this->nodes[node];
+			Scalar left = this->importance(this->nodes[current.left], point);
+			Scalar right = this->importance(this->nodes[current.right], point);
+			Scalar total = left + right;
+
+			if (!(total > 0))
+			{
+				node = -1;
+			}
+			else if (nextRandom(&state) * total < left)
+			{
+				node = current.left;
+				probability *= left / total;
+			}
+			else
+			{
+				node = current.right;
+				probability *= right / total;
+			}
+		}
+
+		if (node < 0)
+		{
+			continue;
+		}
+
+		// Uma fonte sorteada mais de uma vez soma os pesos
+		int light = this->nodes[node].light;
+		Scalar weight = 1 / (this->maxLights * probability);
+		int k = first;
+		while (k < (int)indices.size() && indices[k] != light)
+		{
+			k++;
+		}
+
+		if (k < (int)indices.size())
+		{
+			weights[k - first] += weight;
+		}
+		else
+		{
+			indices.push_back(light);
+			weights.push_back(weight);
+		}
+	}
+}
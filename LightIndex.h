@@ -0,0 +1,156 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <vector>
+
+#include "AABB.h"
+#include "LightSource.h"
+#include "PontualSource.h"
+#include "Scalar.h"
+
+#ifndef LightIndex_H
+#define LightIndex_H
+
+/**
+ * @brief Índice espacial das fontes de luz de uma cena compilada.
+ *
+ * Escolhe, para cada ponto sombreado, as fontes que precisam ser avaliadas (testes de sombra e
+ * sombreamento). As fontes pontuais com raio de influência ficam numa grade uniforme: o ponto só
+ * vê as fontes da sua célula cujo raio o alcança, e as demais (ambiente, pontuais sem raio) são
+ * sempre avaliadas. Como fora do raio a contribuição é exatamente zero, o resultado é o mesmo de
+ * avaliar todas as fontes.
+ *
+ * Se mais de maxLights fontes pontuais alcançam o ponto, elas são sorteadas numa árvore de fontes
+ * (agrupadas pela posição), descendo em cada nó para o filho com probabilidade proporcional à sua
+ * importância estimada (potência / distância²). São feitos maxLights sorteios, e cada fonte sorteada
+ * entra com a intensidade dividida pela probabilidade, o que dá, em média, a soma de todas as fontes.
+ * O sorteio depende só do ponto e da semente, e as importâncias da árvore são as das intensidades
+ * de quando o índice foi construído; por isso a renderização adiada não sorteia de novo: Canvas::trace
+ * guarda a seleção de cada pixel no G-buffer e Canvas::shade a refaz com restore.
+ *
+ * É construído junto com a RenderScene e não muda as fontes; se o raio ou a posição de uma fonte
+ * mudar, o índice deve ser construído de novo.
+ */
+class LightIndex
+{
+public:
+	static const int DEFAULT_MAX_LIGHTS = 16; /**< Fontes pontuais avaliadas por ponto antes do sorteio */
+
+	/**
+	 * @brief Fontes escolhidas para um ponto. Cada thread tem a sua, reaproveitada entre pixels.
+	 */
+	struct Selection
+	{
+		std::vector<int> indices;            /**< Índice de cada fonte escolhida na lista de fontes da cena */
+		std::vector<LightSource*> sources;   /**< A fonte (ou a cópia com a intensidade ponderada pelo sorteio) */
+		std::vector<bool> shadows;           /**< Se cada fonte escolhida está bloqueada no ponto */
+		std::vector<PontualSource> weighted; /**< Cópias ponderadas das fontes sorteadas */
+		std::vector<Scalar> weights;         /**< Peso de cada fonte sorteada (as últimas de indices) */
+	};
+
+	/**
+	 * @brief Constrói um índice vazio, com a seleção por distância ligada e DEFAULT_MAX_LIGHTS.
+	 */
+	LightIndex();
+
+	/**
+	 * @brief Constrói a grade e a árvore sobre as fontes (em coordenadas de câmera).
+	 *
+	 * @param sources As fontes da cena; o índice guarda os ponteiros, que devem continuar válidos.
+	 */
+	void build(const std::vector<LightSource*>& sources);
+
+	/**
+	 * @brief Liga ou desliga o descarte das fontes cujo raio não alcança o ponto.
+	 */
+	void setCulling(bool culling);
+
+	/**
+	 * @brief Define quantas fontes pontuais são avaliadas por ponto antes de passar ao sorteio (0 = sem limite).
+	 */
+	void setMaxLights(int maxLights);
+
+	/**
+	 * @brief Obtém o limite de fontes pontuais por ponto (0 = sem limite).
+	 */
+	int getMaxLights() const;
+
+	/**
+	 * @brief Verifica se todos os pontos veem as mesmas fontes: sem fontes com raio (ou sem descarte) e sem sorteio.
+	 *
+	 * Nesse caso select sempre dá todas as fontes da cena, em ordem.
+	 */
+	bool isUniform() const;
+
+	/**
+	 * @brief Obtém o maior número de fontes que select pode escolher num ponto.
+	 */
+	int getMaxSelected() const;
+
+	/**
+	 * @brief Reserva a memória da seleção, para que select não aloque.
+	 */
+	void prepare(Selection* selection) const;
+
+	/**
+	 * @brief Escolhe as fontes que iluminam um ponto.
+	 *
+	 * Sem sorteio, as fontes ficam na ordem da lista da cena e sources aponta para elas.
+	 *
+	 * @param point O ponto sombreado, em coordenadas de câmera.
+	 * @param seed Semente do sorteio (a mesma para o mesmo pixel em todas as passadas).
+	 * @param selection A seleção a ser preenchida (o conteúdo de shadows não é definido).
+	 */
+	void select(const Vector3& point, unsigned int seed, Selection* selection) const;
+
+	/**
+	 * @brief Refaz as fontes de uma seleção a partir dos índices e dos pesos (por exemplo, os guardados no G-buffer).
+	 *
+	 * As últimas weights.size() fontes de indices são as sorteadas: são copiadas com a intensidade atual
+	 * multiplicada pelo peso. As outras apontam para as fontes da cena.
+	 *
+	 * @param selection A seleção, com indices e weights preenchidos.
+	 */
+	void restore(Selection* selection) const;
+
+private:
+	// Nó da árvore de fontes pontuais
+	struct Node
+	{
+		AABB box;         // Caixa das posições das fontes do nó
+		Scalar power;     // Soma das intensidades
+		Scalar maxRadius; // Maior raio de influência (INFINITY se alguma fonte não tem raio)
+		int left;         // Filhos (-1 numa folha)
+		int right;
+		int light;        // Fonte da folha (-1 nos nós internos)
+	};
+
+	std::vector<LightSource*> sources;
+	std::vector<PontualSource*> points; // Cada fonte como fonte pontual, ou NULL
+	std::vector<int> unbounded;         // Fontes avaliadas em qualquer ponto, em ordem
+	int numPoints;
+
+	bool culling;
+	int maxLights;
+
+	// Grade das fontes pontuais com raio: as fontes da célula i ficam em [cellOffsets[i], cellOffsets[i + 1]), em ordem
+	AABB gridBox;
+	int gridSize[3];
+	Vector3 cellScale; // Células por unidade de comprimento em cada eixo
+	std::vector<int> cellOffsets;
+	std::vector<int> cellLights;
+
+	std::vector<Node> nodes; // A raiz é o nó 0
+
+	// Constrói o nó das fontes em lights[first, first + count) e devolve o seu índice
+	int buildNode(std::vector<int>& lights, int first, int count);
+
+	// Célula do ponto, ou -1 se ele está fora da grade
+	int cellOf(const Vector3& point) const;
+
+	// Importância estimada do nó no ponto (zero se nenhuma fonte do nó o alcança)
+	Scalar importance(const Node& node, const Vector3& point) const;
+
+	// Sorteia fontes pontuais na árvore e acrescenta os seus índices e pesos à seleção
+	void sample(const Vector3& point, unsigned int seed, Selection* selection) const;
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "../eigen-3.4.0/Eigen/Dense"
 
 #include "Ray.h"
+#include "Scalar.h"
 
 #ifndef LightSource_H
 #define LightSource_H
@@ -11,15 +12,28 @@
 class LightSource
 {
 public:
-	Eigen::Vector3d intensity; /**< Intensidade da luz */
-	Eigen::Vector3d origin; /**< Origem da luz */
+	/**
+	 * @brief Tipo da fonte, para que o sombreamento em lote (PhongBatch) dispense as chamadas virtuais.
+	 */
+	enum Type
+	{
+		AMBIENT, /**< AmbientSource */
+		PONTUAL, /**< PontualSource */
+		OTHER    /**< Outras fontes: o sombreamento usa computeIntensity */
+	};
+
+	Vector3 intensity; /**< Intensidade da luz */
+	Vector3 origin; /**< Origem da luz */
+	Type type; /**< Tipo da fonte */
+
+	LightSource() : type(OTHER) {}
 
 	/**
 	 * @brief Retorna a direção da luz em relação a um ponto de interesse.
 	 * @param pInt Ponto de interesse
 	 * @return Direção da luz
 	 */
-	virtual Eigen::Vector3d getDirection(Eigen::Vector3d pInt) = 0;
+	virtual Vector3 getDirection(Vector3 pInt) = 0;
 
 	/**
 	 * @brief Calcula a intensidade da luz em um ponto de interesse.
@@ -35,14 +49,22 @@ public:
 	 * @param specularIndex Índice de especularidade
 	 * @param shadowed Indica se o ponto está em sombra
 	 */
-	virtual void computeIntensity(Eigen::Vector3d pInt, Ray ray, Eigen::Vector3d* ptrIntesityAmbient, Eigen::Vector3d* ptrIntesityDifuse, Eigen::Vector3d* ptrIntesitySpecular,
-								  Eigen::Vector3d normal, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex, bool shadowed) = 0;
+	virtual void computeIntensity(Vector3 pInt, const Ray& ray, Vector3* ptrIntesityAmbient, Vector3* ptrIntesityDifuse, Vector3* ptrIntesitySpecular,
+								  Vector3 normal, Vector3 kAmbient, Vector3 kDif, Vector3 kEsp, int specularIndex, bool shadowed) = 0;
 
 	/**
 	 * @brief Converte a posição da luz para o sistema de coordenadas da câmera.
 	 * @param transformationMatrix Matriz de transformação
 	 */
-	virtual void convertToCamera(Eigen::Matrix4d transformationMatrix) = 0;
+	virtual void convertToCamera(Matrix4 transformationMatrix) = 0;
+
+	/**
+	 * @brief Cria uma cópia da fonte de luz.
+	 * @return Ponteiro para a cópia alocada
+	 */
+	virtual LightSource* clone() const = 0;
+
+	virtual ~LightSource() {}
 };
 
 #endif
\ No newline at end of file
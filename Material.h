@@ -0,0 +1,32 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+
+#include "Scalar.h"
+
+#ifndef Material_H
+#define Material_H
+
+/**
+ * @brief Coeficientes de reflexão de uma superfície (modelo de Phong).
+ *
+ * Os objetos não guardam os coeficientes: guardam o índice do material na MaterialTable da cena,
+ * de forma que objetos construídos com o mesmo índice compartilham uma única entrada.
+ */
+struct Material
+{
+	Vector3 kAmbient;  /**< Coeficiente de reflexão de luz ambiente */
+	Vector3 kDif;      /**< Coeficiente de reflexão de luz difusa */
+	Vector3 kEsp;      /**< Coeficiente de reflexão de luz especular */
+	int specularIndex; /**< Índice especular */
+
+	Material() : kAmbient(0, 0, 0), kDif(0, 0, 0), kEsp(0, 0, 0), specularIndex(0) {}
+
+	Material(Vector3 kAmbient, Vector3 kDif, Vector3 kEsp, int specularIndex)
+		: kAmbient(kAmbient), kDif(kDif), kEsp(kEsp), specularIndex(specularIndex) {}
+
+	bool operator==(const Material& other) const
+	{
+		return this->kAmbient == other.kAmbient && this->kDif == other.kDif && this->kEsp == other.kEsp && this->specularIndex == other.specularIndex;
+	}
+};
+
+#endif
@@ -0,0 +1,32 @@
+#include "MaterialTable.h"
+
+/**
+ * @brief Acrescenta um material, mesmo que já exista um igual.
+ *
+ * @param material O material.
+ * @return O índice do material.
+ */
+int MaterialTable::add(const Material& material)
+{
+	this->materials.push_back(material);
+	return (int)this->materials.size() - 1;
+}
+
+/**
+ * @brief Altera o material de um índice.
+ *
+ * @param index O índice.
+ * @param material Os novos coeficientes.
+ */
+void MaterialTable::set(int index, const Material& material)
+{
+	this->materials[index] = material;
+}
+
+/**
+ * @brief Obtém o número de materiais da tabela.
+ */
+int MaterialTable::size() const
+{
+	return this->materials.size();
+}
@@ -0,0 +1,58 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <vector>
+
+#include "Material.h"
+#include "Scalar.h"
+
+#ifndef MaterialTable_H
+#define MaterialTable_H
+
+/**
+ * @brief Tabela de materiais de uma cena, que os objetos referenciam por índice.
+ *
+ * Cada Scene tem a sua (Scene::materials), e a RenderScene guarda uma cópia. Os objetos recebem o
+ * índice no construtor, então o compartilhamento é explícito: objetos construídos com o mesmo índice
+ * (as folhas de uma estação, os troncos, as pernas da mesa) usam a mesma entrada, e alterá-la com
+ * set() altera todos eles de uma vez; dois materiais acrescentados separadamente nunca se confundem,
+ * mesmo com coeficientes iguais.
+ *
+ * Os índices nunca mudam. A tabela só deve ser alterada fora da renderização; durante ela as
+ * threads apenas leem.
+ */
+class MaterialTable
+{
+public:
+	/**
+	 * @brief Acrescenta um material.
+	 *
+	 * @param material O material.
+	 * @return O índice do material.
+	 */
+	int add(const Material& material);
+
+	/**
+	 * @brief Obtém uma cópia do material de um índice (que continua válida se a tabela crescer).
+	 */
+	Material get(int index) const
+	{
+		return this->materials[index];
+	}
+
+	/**
+	 * @brief Altera o material de um índice (e portanto de todos os objetos que o usam).
+	 *
+	 * @param index O índice.
+	 * @param material Os novos coeficientes.
+	 */
+	void set(int index, const Material& material);
+
+	/**
+	 * @brief Obtém o número de materiais da tabela.
+	 */
+	int size() const;
+
+private:
+	std::vector<Material> materials;
+};
+
+#endif
@@ -3,6 +3,11 @@
 
 #include "Ray.h"
 #include "LightSource.h"
+#include "HitRecord.h"
+#include "AABB.h"
+#include "MaterialTable.h"
+#include "PhongBatch.h"
+#include "Scalar.h"
 
 #ifndef Object_H
 #define Object_H
@@ -11,37 +16,112 @@
  * @brief Classe abstrata que representa um objeto gráfico.
  * 
  * A classe Object define as propriedades e métodos básicos que um objeto gráfico deve ter.
- * Ela possui propriedades para os coeficientes de reflexão de luz ambiente, difusa e especular,
- * bem como um índice especular. Além disso, ela define métodos virtuais puros para verificar
- * se um raio intercepta o objeto, calcular a cor do objeto em um ponto de interseção e realizar
- * transformações geométricas no objeto.
+ * Os coeficientes de reflexão (ambiente, difusa, especular e índice especular) ficam na
+ * MaterialTable da cena, e o objeto guarda só o índice do seu material. Além disso, ela define métodos virtuais puros para verificar
+ * se um raio intercepta o objeto e realizar transformações geométricas no objeto. A cor num ponto de
+ * interseção é calculada pelo mesmo núcleo de Phong (PhongBatch) para todos os objetos; cada objeto só
+ * informa, em getSurface, o material e a intensidade ambiente inicial do ponto.
  */
 class Object
 {
 public:
-	Eigen::Vector3d kAmbient; /**< Coeficiente de reflexão de luz ambiente */
-	Eigen::Vector3d kDif; /**< Coeficiente de reflexão de luz difusa */
-	Eigen::Vector3d kEsp; /**< Coeficiente de reflexão de luz especular */
-	int specularIndex; /**< Índice especular */
+	int material; /**< Índice do material na tabela de materiais da cena */
+
+	virtual ~Object() {}
 
 	/**
-	 * @brief Verifica se um raio intercepta o objeto.
+	 * @brief Calcula a interseção mais próxima de um raio com o objeto.
+	 * 
+	 * Não altera o objeto, então pode ser chamado por várias threads ao mesmo tempo.
 	 * 
 	 * @param ray O raio a ser verificado.
-	 * @return double O valor do parâmetro t no ponto de interseção, ou um valor negativo caso não haja interseção.
+	 * @param hit Registro preenchido com t, parte atingida, normal e (se houver) uv.
+	 * @return true se o raio intercepta o objeto com t dentro de (ray.tMin, ray.tMax).
+	 */
+	virtual bool intersect(const Ray& ray, HitRecord* hit) const = 0;
+
+	/**
+	 * @brief Obtém o material e a intensidade ambiente inicial num ponto de interseção.
+	 * 
+	 * Por padrão, o material do objeto e ambiente zero; objetos com textura ou com partes de
+	 * materiais diferentes (tampas) sobrescrevem.
+	 * 
+	 * @param ray O raio que intersectou o objeto.
+	 * @param hit O registro da interseção retornado por intersect.
+	 * @param ambient Ponteiro para a intensidade ambiente inicial (a cor da textura, quando houver).
+	 * @param material Ponteiro para o índice do material na tabela de materiais da cena.
 	 */
-	virtual double hasInterceptedRay(Ray ray) = 0;
+	virtual void getSurface(const Ray& ray, const HitRecord& hit, Vector3* ambient, int* material) const
+	{
+		*ambient = Vector3(0, 0, 0);
+		*material = this->material;
+	}
 
 	/**
 	 * @brief Calcula a cor do objeto em um ponto de interseção.
 	 * 
-	 * @param tInt O valor do parâmetro t no ponto de interseção.
+	 * Sombreia o ponto como um lote de um elemento do PhongBatch, com as mesmas contas da passada
+	 * de sombreamento em lote (Canvas::shade).
+	 * 
 	 * @param ray O raio que intersectou o objeto.
+	 * @param hit O registro da interseção retornado por intersect.
 	 * @param sources Vetor de fontes de luz.
 	 * @param shadows Vetor de booleanos indicando se há sombra no ponto de interseção.
-	 * @return Eigen::Vector3d A cor do objeto no ponto de interseção.
+	 * @param materials A tabela de materiais da cena (RenderScene::getMaterials).
+	 * @return Vector3 A cor do objeto no ponto de interseção.
 	 */
-	virtual Eigen::Vector3d computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows) = 0;
+	virtual Vector3 shade(const Ray& ray, const HitRecord& hit, const std::vector<LightSource*>& sources, const std::vector<bool>& shadows,
+						  const MaterialTable& materials) const
+	{
+		Vector3 ambient;
+		int material;
+		this->getSurface(ray, hit, &ambient, &material);
+
+		PhongBatch<1> batch;
+		batch.add(ray.initialPoint + hit.t * ray.direction, hit.normal, ray.direction, ambient, materials.get(material));
+		batch.shade(sources, [&shadows](int source, int i)
+		{
+			return (bool)shadows[source];
+		});
+
+		return batch.getColor(0);
+	}
+
+	/**
+	 * @brief Verifica se um raio intercepta o objeto.
+	 * 
+	 * Mantido por compatibilidade com a convenção antiga, em que o raio apontava para trás e as
+	 * interseções à frente tinham t negativo; apenas repassa para intersect e troca o sinal.
+	 * 
+	 * @param ray O raio a ser verificado.
+	 * @return Scalar O valor do parâmetro t no ponto de interseção (negativo), ou 1 caso não haja interseção.
+	 */
+	Scalar hasInterceptedRay(Ray ray) const
+	{
+		HitRecord hit;
+		if (this->intersect(ray, &hit))
+		{
+			return -hit.t;
+		}
+		return 1;
+	}
+
+	/**
+	 * @brief Verifica se o objeto bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 * 
+	 * Equivale a intersect com o raio (origin, direction) restrito ao intervalo (0, tMax). Não preenche
+	 * normal nem coordenadas de textura, então as subclasses podem sobrescrever com um teste mais barato.
+	 * 
+	 * @param origin A origem do segmento.
+	 * @param direction A direção (unitária) do segmento.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se houver alguma interseção dentro do segmento.
+	 */
+	virtual bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+	{
+		HitRecord hit;
+		return this->intersect(Ray::fromDirection(origin, direction, 0, tMax), &hit);
+	}
 
 	/**
 	 * @brief Translada o objeto nas direções x, y e z.
@@ -50,7 +130,7 @@ public:
 	 * @param y O valor de translação no eixo y.
 	 * @param z O valor de translação no eixo z.
 	 */
-	virtual void translate(double x, double y, double z) = 0;
+	virtual void translate(Scalar x, Scalar y, Scalar z) = 0;
 
 	/**
 	 * @brief Escala o objeto nas direções x, y e z.
@@ -59,35 +139,56 @@ public:
 	 * @param y O valor de escala no eixo y.
 	 * @param z O valor de escala no eixo z.
 	 */
-	virtual void scale(double x, double y, double z) = 0;
+	virtual void scale(Scalar x, Scalar y, Scalar z) = 0;
 
 	/**
 	 * @brief Rotaciona o objeto no eixo x.
 	 * 
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	virtual void rotateX(double angle) = 0;
+	virtual void rotateX(Scalar angle) = 0;
 
 	/**
 	 * @brief Rotaciona o objeto no eixo y.
 	 * 
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	virtual void rotateY(double angle) = 0;
+	virtual void rotateY(Scalar angle) = 0;
 
 	/**
 	 * @brief Rotaciona o objeto no eixo z.
 	 * 
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	virtual void rotateZ(double angle) = 0;
+	virtual void rotateZ(Scalar angle) = 0;
 
 	/**
 	 * @brief Converte as coordenadas do objeto para o sistema de coordenadas da câmera.
 	 * 
 	 * @param transformationMatrix A matriz de transformação para o sistema de coordenadas da câmera.
 	 */
-	virtual void convertToCamera(Eigen::Matrix4d transformationMatrix) = 0;
+	virtual void convertToCamera(Matrix4 transformationMatrix) = 0;
+
+	/**
+	 * @brief Cria uma cópia do objeto.
+	 * 
+	 * A cópia é independente: subestruturas (tampas, faces) também são copiadas, de forma que
+	 * transformar a cópia não altera o original.
+	 * 
+	 * @return Object* Ponteiro para a cópia alocada.
+	 */
+	virtual Object* clone() const = 0;
+
+	/**
+	 * @brief Calcula a caixa delimitadora do objeto nas suas coordenadas atuais.
+	 * 
+	 * @param box Ponteiro para armazenar a caixa.
+	 * @return true se o objeto é limitado; false para objetos infinitos, que as estruturas de aceleração tratam à parte.
+	 */
+	virtual bool getBounds(AABB* box) const
+	{
+		return false;
+	}
 };
 
 #endif
\ No newline at end of file
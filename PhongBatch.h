@@ -0,0 +1,363 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <cmath>
+#include <vector>
+
+#include "LaneMath.h"
+#include "LightSource.h"
+#include "Material.h"
+#include "PontualSource.h"
+#include "Ray.h"
+#include "Scalar.h"
+
+#ifndef PhongBatch_H
+#define PhongBatch_H
+
+/**
+ * @brief Potência com expoente inteiro por exponenciação rápida (quadrados sucessivos).
+ *
+ * @param base A base.
+ * @param exponent O expoente (negativo dá 1 / base^-exponent).
+ */
+inline Scalar powInt(Scalar base, int exponent)
+{
+	unsigned int e = exponent < 0 ? -(unsigned int)exponent : exponent;
+	Scalar result = 1;
+
+	while (e != 0)
+	{
+		if (e & 1)
+		{
+			result *= base;
+		}
+		e >>= 1;
+		if (e != 0)
+		{
+			base *= base;
+		}
+	}
+
+	return exponent < 0 ? 1 / result : result;
+}
+
+/**
+ * @brief Lote de até N pontos sombreados pelo modelo de Phong, em estrutura de vetores (SoA).
+ *
+ * Cada ponto tem posição, normal, direção do raio que o atingiu, intensidade ambiente inicial (a
+ * cor da textura, quando houver) e material. shade percorre as fontes uma vez e, para cada fonte,
+ * todos os pontos do lote num laço sem desvios, que o compilador pode vetorizar. As fontes ambiente
+ * e pontuais são tratadas direto pelo tipo, sem chamadas virtuais; as outras usam computeIntensity.
+ * O expoente especular inteiro é calculado por exponenciação rápida.
+ *
+ * Object::shade usa um lote de um ponto, e a passada de sombreamento da renderização adiada usa
+ * lotes de uma linha da imagem, com as mesmas contas, então as duas dão a mesma cor.
+ */
+template <int N>
+class PhongBatch
+{
+public:
+	int count; /**< Número de pontos no lote */
+
+	Scalar px[N], py[N], pz[N];                /**< Posições */
+	Scalar nx[N], ny[N], nz[N];                /**< Normais (unitárias) */
+	Scalar dx[N], dy[N], dz[N];                /**< Direções dos raios que atingiram os pontos */
+	Scalar ambientR[N], ambientG[N], ambientB[N]; /**< Intensidade ambiente inicial */
+	Scalar kAmbientR[N], kAmbientG[N], kAmbientB[N];
+	Scalar kDifR[N], kDifG[N], kDifB[N];
+	Scalar kEspR[N], kEspG[N], kEspB[N];
+	int exponents[N];                          /**< Índices especulares */
+
+	Scalar r[N], g[N], b[N]; /**< Cor de cada ponto, calculada por shade */
+
+	// Os vetores começam zerados: os laços vão até count, que o compilador não sabe limitar pelos pontos já acrescentados
+	PhongBatch()
+		: count(0), px(), py(), pz(), nx(), ny(), nz(), dx(), dy(), dz(), ambientR(), ambientG(), ambientB(),
+		  kAmbientR(), kAmbientG(), kAmbientB(), kDifR(), kDifG(), kDifB(), kEspR(), kEspG(), kEspB(), exponents(),
+		  r(), g(), b(), maxExponent(0), negativeExponents(false) {}
+
+	/**
+	 * @brief Esvazia o lote.
+	 */
+	void clear()
+	{
+		this->count = 0;
+		this->maxExponent = 0;
+		this->negativeExponents = false;
+	}
+
+	/**
+	 * @brief Verifica se o lote está cheio.
+	 */
+	bool full() const
+	{
+		return this->count == N;
+	}
+
+	/**
+	 * @brief Acrescenta um ponto ao lote (que não pode estar cheio).
+	 *
+	 * @param point O ponto sombreado.
+	 * @param normal A normal da superfície no ponto.
+	 * @param direction A direção do raio que atingiu o ponto.
+	 * @param ambient A intensidade ambiente inicial.
+	 * @param material O material da superfície.
+	 * @return A posição do ponto no lote.
+	 */
+	int add(const Vector3& point, const Vector3& normal, const Vector3& direction, const Vector3& ambient, const Material& material)
+	{
+		int i = this->count++;
+
+		this->px[i] = point[0];
+		this->py[i] = point[1];
+		this->pz[i] = point[2];
+		this->nx[i] = normal[0];
+		this->ny[i] = normal[1];
+		this->nz[i] = normal[2];
+		this->dx[i] = direction[0];
+		this->dy[i] = direction[1];
+		this->dz[i] = direction[2];
+		this->ambientR[i] = ambient[0];
+		this->ambientG[i] = ambient[1];
+		this->ambientB[i] = ambient[2];
+		this->kAmbientR[i] = material.kAmbient[0];
+		this->kAmbientG[i] = material.kAmbient[1];
+		this->kAmbientB[i] = material.kAmbient[2];
+		this->kDifR[i] = material.kDif[0];
+		this->kDifG[i] = material.kDif[1];
+		this->kDifB[i] = material.kDif[2];
+		this->kEspR[i] = material.kEsp[0];
+		this->kEspG[i] = material.kEsp[1];
+		this->kEspB[i] = material.kEsp[2];
+		this->exponents[i] = material.specularIndex;
+
+		int magnitude = material.specularIndex < 0 ? -material.specularIndex : material.specularIndex;
+		this->maxExponent = magnitude > this->maxExponent ? magnitude : this->maxExponent;
+		this->negativeExponents = this->negativeExponents || material.specularIndex < 0;
+
+		return i;
+	}
+
+	/**
+	 * @brief Obtém a cor calculada de um ponto.
+	 */
+	Vector3 getColor(int i) const
+	{
+		return Vector3(this->r[i], this->g[i], this->b[i]);
+	}
+
+	/**
+	 * @brief Soma as contribuições das fontes em todos os pontos do lote (difusa + especular + ambiente).
+	 *
+	 * @param sources As fontes de luz.
+	 * @param shadowed Chamada como shadowed(j, i): se a fonte j está bloqueada no ponto i.
+	 */
+	template <typename Shadowed>
+	void shade(const std::vector<LightSource*>& sources, Shadowed shadowed)
+	{
+		Scalar difR[N], difG[N], difB[N];
+		Scalar specR[N], specG[N], specB[N];
+		Scalar ambR[N], ambG[N], ambB[N];
+		Scalar ln[N], lr[N], distance[N], power[N], square[N], factor[N];
+		Scalar lit[N]; // 1 se a fonte ilumina o ponto, 0 se não (em Scalar, para vetorizar junto com as contas)
+
+		int n = this->count;
+		for (int i = 0; i < n; i++)
+		{
+			difR[i] = difG[i] = difB[i] = 0;
+			specR[i] = specG[i] = specB[i] = 0;
+			ambR[i] = this->ambientR[i];
+			ambG[i] = this->ambientG[i];
+			ambB[i] = this->ambientB[i];
+		}
+
+		// Bits do maior expoente: todos os pontos fazem o mesmo número de passos da exponenciação
+		int bits = 0;
+		while ((this->maxExponent >> bits) != 0)
+		{
+			bits++;
+		}
+
+		for (size_t j = 0; j < sources.size(); j++)
+		{
+			const LightSource* source = sources[j];
+
+			if (source->type == LightSource::AMBIENT)
+			{
+				Scalar iR = source->intensity[0], iG = source->intensity[1], iB = source->intensity[2];
+
+				for (int i = 0; i < n; i++)
+				{
+					Scalar tR = iR * this->kAmbientR[i], tG = iG * this->kAmbientG[i], tB = iB * this->kAmbientB[i];
+					ambR[i] += tR > 0 ? tR : 0;
+					ambG[i] += tG > 0 ? tG : 0;
+					ambB[i] += tB > 0 ? tB : 0;
+				}
+				continue;
+			}
+
+			Scalar numLit = 0;
+			for (int i = 0; i < n; i++)
+			{
+				lit[i] = shadowed(j, i) ? 0 : 1;
+				numLit += lit[i];
+			}
+			if (numLit == 0)
+			{
+				continue;
+			}
+
+			if (source->type == LightSource::OTHER)
+			{
+				this->shadeVirtual(source, lit, difR, difG, difB, specR, specG, specB, ambR, ambG, ambB);
+				continue;
+			}
+
+			const PontualSource* light = static_cast<const PontualSource*>(source);
+			Scalar ox = light->origin[0], oy = light->origin[1], oz = light->origin[2];
+			Scalar iR = light->intensity[0], iG = light->intensity[1], iB = light->intensity[2];
+			bool attenuated = light->attenuation != Vector3(1, 0, 0) || light->isBounded();
+			bool bounded = light->isBounded();
+			Scalar a0 = light->attenuation[0], a1 = light->attenuation[1], a2 = light->attenuation[2];
+			Scalar radius = light->radius, radius2 = radius * radius;
+
+			// Geometria: cosseno com a normal, cosseno do reflexo com a direção do observador e distância
+			for (int i = 0; i < n; i++)
+			{
+				// Direção unitária do ponto para a fonte (como Vector3::normalized: divide pelo comprimento)
+				Scalar lx = ox - this->px[i], ly = oy - this->py[i], lz = oz - this->pz[i];
+				Scalar d2 = dot3(lx, ly, lz, lx, ly, lz);
+				Scalar d = std::sqrt(d2);
+				lx /= d;
+				ly /= d;
+				lz /= d;
+
+				Scalar cosine = dot3(lx, ly, lz, this->nx[i], this->ny[i], this->nz[i]);
+
+				// Reflexo da direção da fonte em torno da normal
+				Scalar twice = 2 * cosine;
+				Scalar rx = twice * this->nx[i] - lx, ry = twice * this->ny[i] - ly, rz = twice * this->nz[i] - lz;
+
+				ln[i] = cosine;
+				lr[i] = dot3(rx, ry, rz, -this->dx[i], -this->dy[i], -this->dz[i]);
+				distance[i] = d;
+
+				// Só conta se o ponto não está na sombra, está dentro do raio e está de frente para a fonte
+				lit[i] = ((lit[i] != 0) & (d2 < radius2) & (cosine > 0)) ? 1 : 0;
+			}
+
+			// Nenhum ponto do lote recebe luz desta fonte (comum nos lotes pequenos, como o de Object::shade)
+			numLit = 0;
+			for (int i = 0; i < n; i++)
+			{
+				numLit += lit[i];
+			}
+			if (numLit == 0)
+			{
+				continue;
+			}
+
+			// Exponenciação rápida, um bit do expoente por vez em todos os pontos
+			for (int i = 0; i < n; i++)
+			{
+				power[i] = 1;
+				square[i] = lr[i];
+			}
+			for (int k = 0; k < bits; k++)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					int e = this->exponents[i] < 0 ? -this->exponents[i] : this->exponents[i];
+					power[i] *= ((e >> k) & 1) ? square[i] : 1;
+					square[i] *= square[i];
+				}
+			}
+			if (this->negativeExponents)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					power[i] = this->exponents[i] < 0 ? 1 / power[i] : power[i];
+				}
+			}
+
+			// Atenuação com as mesmas contas de PontualSource::getAttenuation; sem ela o fator é 1, que não muda nada
+			if (attenuated)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					Scalar attenuation = 1 / (a0 + (a1 + a2 * distance[i]) * distance[i]);
+					Scalar x = distance[i] / radius;
+					Scalar x4 = (x * x) * (x * x);
+					Scalar window = x4 < 1 ? 1 - x4 : 0;
+					factor[i] = bounded ? attenuation * (window * window) : attenuation;
+				}
+			}
+			else
+			{
+				for (int i = 0; i < n; i++)
+				{
+					factor[i] = 1;
+				}
+			}
+
+			for (int i = 0; i < n; i++)
+			{
+				Scalar specular = lr[i] >= 0 ? power[i] : 0;
+
+				Scalar dR = ((iR * this->kDifR[i]) * ln[i]) * factor[i];
+				Scalar dG = ((iG * this->kDifG[i]) * ln[i]) * factor[i];
+				Scalar dB = ((iB * this->kDifB[i]) * ln[i]) * factor[i];
+				Scalar sR = ((iR * this->kEspR[i]) * specular) * factor[i];
+				Scalar sG = ((iG * this->kEspG[i]) * specular) * factor[i];
+				Scalar sB = ((iB * this->kEspB[i]) * specular) * factor[i];
+
+				difR[i] += ((lit[i] != 0) & (dR > 0)) ? dR : 0;
+				difG[i] += ((lit[i] != 0) & (dG > 0)) ? dG : 0;
+				difB[i] += ((lit[i] != 0) & (dB > 0)) ? dB : 0;
+				specR[i] += ((lit[i] != 0) & (sR > 0)) ? sR : 0;
+				specG[i] += ((lit[i] != 0) & (sG > 0)) ? sG : 0;
+				specB[i] += ((lit[i] != 0) & (sB > 0)) ? sB : 0;
+			}
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			this->r[i] = difR[i] + specR[i] + ambR[i];
+			this->g[i] = difG[i] + specG[i] + ambG[i];
+			this->b[i] = difB[i] + specB[i] + ambB[i];
+		}
+	}
+
+private:
+	int maxExponent;         // Maior |índice especular| do lote
+	bool negativeExponents;  // Se algum índice especular é negativo (a potência é invertida)
+
+	// Fonte de tipo desconhecido: computeIntensity ponto a ponto, com um raio que passa pelo ponto na mesma direção
+	void shadeVirtual(const LightSource* source, const Scalar* lit, Scalar* difR, Scalar* difG, Scalar* difB,
+					  Scalar* specR, Scalar* specG, Scalar* specB, Scalar* ambR, Scalar* ambG, Scalar* ambB)
+	{
+		LightSource* mutableSource = const_cast<LightSource*>(source);
+
+		for (int i = 0; i < this->count; i++)
+		{
+			Vector3 point(this->px[i], this->py[i], this->pz[i]);
+			Ray ray = Ray::fromDirection(point, Vector3(this->dx[i], this->dy[i], this->dz[i]), 0, INFINITY);
+			Vector3 ambient(ambR[i], ambG[i], ambB[i]), difuse(difR[i], difG[i], difB[i]), specular(specR[i], specG[i], specB[i]);
+
+			mutableSource->computeIntensity(point, ray, &ambient, &difuse, &specular, Vector3(this->nx[i], this->ny[i], this->nz[i]),
+											Vector3(this->kAmbientR[i], this->kAmbientG[i], this->kAmbientB[i]),
+											Vector3(this->kDifR[i], this->kDifG[i], this->kDifB[i]),
+											Vector3(this->kEspR[i], this->kEspG[i], this->kEspB[i]), this->exponents[i], lit[i] == 0);
+
+			ambR[i] = ambient[0];
+			ambG[i] = ambient[1];
+			ambB[i] = ambient[2];
+			difR[i] = difuse[0];
+			difG[i] = difuse[1];
+			difB[i] = difuse[2];
+			specR[i] = specular[0];
+			specG[i] = specular[1];
+			specB[i] = specular[2];
+		}
+	}
+};
+
+#endif
@@ -1,61 +1,25 @@
 #include "Plane.h"
 #include <iostream>
+#include <algorithm>
 #include <cmath>
 
-/**
- * Retorna a cor de um pixel específico em uma superfície SDL(Textura).
- *
- * @param pSurface A superfície SDL da qual obter a cor do pixel.
- * @param X A coordenada X do pixel.
- * @param Y A coordenada Y do pixel.
- * @return A cor do pixel na forma de uma estrutura SDL_Color.
- */
-SDL_Color GetPixelColor(const SDL_Surface* pSurface, const int X, const int Y)
-{
-	// Bytes per pixel
-	const Uint8 Bpp = pSurface->format->BytesPerPixel;
-
-	/*
-	Retrieve the address to a specific pixel
-	pSurface->pixels	= an array containing the SDL_Surface' pixels
-	pSurface->pitch		= the length of a row of pixels (in bytes)
-	X and Y				= the offset on where on the image to retrieve the pixel, (0, 0) is in the upper left corner of the image
-	*/
-	Uint8* pPixel = (Uint8*)pSurface->pixels + Y * pSurface->pitch + X * Bpp;
-
-	Uint32 PixelData = *(Uint32*)pPixel;
-
-	SDL_Color Color = { 0x00, 0x00, 0x00, SDL_ALPHA_OPAQUE };
-
-	// Retrieve the RGB values of the specific pixel
-	SDL_GetRGB(PixelData, pSurface->format, &Color.r, &Color.g, &Color.b);
-
-	return Color;
-}
-
 /**
  * @brief Construtor da classe Plane.
  * 
- * @param texture Superfície SDL que representa a textura do plano.
+ * @param texture Textura decodificada do plano (NULL se não houver).
  * @param normal Vetor 3D que representa a normal do plano.
  * @param center Vetor 3D que representa o centro do plano.
- * @param kAmbient Vetor 3D que representa o coeficiente de reflexão ambiente do plano.
- * @param kDif Vetor 3D que representa o coeficiente de reflexão difusa do plano.
- * @param kEsp Vetor 3D que representa o coeficiente de reflexão especular do plano.
- * @param specularIndex Índice de especularidade do plano.
+ * @param material Índice do material na tabela de materiais da cena.
  */
-Plane::Plane(SDL_Surface* texture, Eigen::Vector3d normal, Eigen::Vector3d center, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, double specularIndex)
+Plane::Plane(const Texture* texture, Vector3 normal, Vector3 center, int material)
 {
 	this->texture = texture;
 	this->normal = normal.normalized();
 	this->center = center;
-	this->kAmbient = kAmbient;
-	this->kDif = kDif;
-	this->kEsp = kEsp;
-	this->specularIndex = specularIndex;
+	this->material = material;
 
 	int menor;
-	double menorValor = INFINITY;
+	Scalar menorValor = INFINITY;
 	for (int i = 1; i < 3; i++)
 	{
 		if (std::abs(normal[i]) < menorValor)
@@ -83,46 +47,41 @@ Plane::Plane(SDL_Surface* texture, Eigen::Vector3d normal, Eigen::Vector3d cente
 }
 
 /**
- * @brief Verifica se um raio intercepta o plano.
+ * @brief Calcula a interseção de um raio com o plano.
  *
  * @param ray Raio a ser verificado.
+ * @param hit Registro a ser preenchido.
  */
-double Plane::hasInterceptedRay(Ray ray)
+bool Plane::intersect(const Ray& ray, HitRecord* hit) const
 {
-	Eigen::Vector3d w = ray.initialPoint - this->center;
-	double tInt = -(this->normal.dot(w)) / (this->normal.dot(ray.direction));
+	Vector3 w = ray.initialPoint - this->center;
+	Scalar tInt = -(this->normal.dot(w)) / (this->normal.dot(ray.direction));
 
-	if (tInt < 0)
-		return tInt;
+	if (!ray.contains(tInt))
+		return false;
 
-	return 1;
+	Vector3 pInt = ray.initialPoint + tInt * ray.direction;
+
+	hit->t = tInt;
+	hit->structure = 0;
+	hit->normal = this->normal;
+	hit->uv << this->axis1.dot(pInt - this->center), this->axis2.dot(pInt - this->center);
+	hit->hasUV = true;
+	return true;
 }
 
 
 /**
- * @brief Calcula a cor do plano no ponto de interseção com um raio.
+ * @brief Obtém a intensidade ambiente inicial do plano no ponto de interseção: a cor da textura, se houver.
  *
- * @param tInt Valor do parâmetro t no ponto de interseção.
  * @param ray Raio de interseção.
- * @param sources Vetor de fontes de luz.
- * @param shadows Vetor de booleanos indicando se há sombra no ponto de interseção.
- * @return Cor do plano no ponto de interseção.
+ * @param hit Registro da interseção.
+ * @param ambient Ponteiro para a intensidade ambiente inicial.
+ * @param material Ponteiro para o índice do material.
  */
-Eigen::Vector3d Plane::computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows)
+void Plane::getSurface(const Ray& ray, const HitRecord& hit, Vector3* ambient, int* material) const
 {
-	Eigen::Vector3d intesityEye(0, 0, 0);
-
-	Eigen::Vector3d pInt = ray.initialPoint + tInt * ray.direction;
-
-	Eigen::Vector2d pIntBase;
-	pIntBase << abs(((int)(this->axis1.dot(pInt - this->center))) % 256), abs(((int)(this->axis2.dot(pInt - this->center))) % 256);
-
-	Eigen::Vector3d intesityAmbient;
-	Eigen::Vector3d intesityDifuse(0, 0, 0);
-	Eigen::Vector3d intesitySpecular(0, 0, 0);
-	Eigen::Vector3d singleDifuse;
-	Eigen::Vector3d singleSpecular;
-	Eigen::Vector3d normal = this->normal;
+	Vector3 intesityAmbient;
 
 	if (this->texture == NULL)
 	{
@@ -130,31 +89,26 @@ Eigen::Vector3d Plane::computeColor(double tInt, Ray ray, std::vector<LightSourc
 	}
 	else
 	{
-		SDL_Color colorToPaint = GetPixelColor(this->texture, pIntBase[0], pIntBase[1]);
-		intesityAmbient << (int)colorToPaint.r, (int)colorToPaint.g, (int)colorToPaint.b;
-	}
+		// Largura do pixel no ponto, esticada pela inclinação do plano em relação ao raio
+		Scalar cosine = std::max(std::abs(this->normal.dot(ray.direction)), (Scalar)1e-3);
+		Scalar footprint = hit.t * ray.spread / cosine;
 
-	int idx = 0;
-	for (auto& source : sources)
-	{
-		source->computeIntensity(pInt, ray, &intesityAmbient, &intesityDifuse, &intesitySpecular, normal, this->kAmbient, this->kDif, this->kEsp, this->specularIndex, shadows[idx]);
-		idx++;
+		intesityAmbient = this->texture->sample(hit.uv[0], hit.uv[1], footprint, this->sampler);
 	}
 
-	intesityEye = intesityDifuse + intesitySpecular + intesityAmbient;
-
-	return intesityEye;
+	*ambient = intesityAmbient;
+	*material = this->material;
 }
 
-void Plane::translate(double x, double y, double z)
+void Plane::translate(Scalar x, Scalar y, Scalar z)
 {
-	Eigen::Matrix4d m;
+	Matrix4 m;
 	m << 1, 0, 0, x,
 		 0, 1, 0, y,
 		 0, 0, 1, z,
 		 0, 0, 0, 1;
 
-	Eigen::Vector4d center4;
+	Vector4 center4;
 	center4 << this->center[0], this->center[1], this->center[2], 1;
 
 	center4 = m * center4;
@@ -162,20 +116,20 @@ void Plane::translate(double x, double y, double z)
 	this->center << center4[0], center4[1], center4[2];
 }
 
-void Plane::scale(double x, double y, double z)
+void Plane::scale(Scalar x, Scalar y, Scalar z)
 {
 
 }
 
-void  Plane::rotateX(double angle)
+void  Plane::rotateX(Scalar angle)
 {
-	Eigen::Matrix4d rx;
+	Matrix4 rx;
 	rx << 1, 0, 0, 0,
 		0, cos(angle), -sin(angle), 0,
 		0, sin(angle), cos(angle), 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->normal[0], this->normal[1], this->normal[2], 0;
 
 	newDir = rx * newDir;
@@ -209,15 +163,15 @@ void  Plane::rotateX(double angle)
 	this->axis2 = (normal.cross(this->axis1)).normalized();
 }
 
-void  Plane::rotateY(double angle)
+void  Plane::rotateY(Scalar angle)
 {
-	Eigen::Matrix4d rx;
+	Matrix4 rx;
 	rx << cos(angle), 0, sin(angle), 0,
 		0, 1, 0, 0,
 		-sin(angle), 0, cos(angle), 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->normal[0], this->normal[1], this->normal[2], 0;
 
 	newDir = rx * newDir;
@@ -251,15 +205,15 @@ void  Plane::rotateY(double angle)
 	this->axis2 = (normal.cross(this->axis1)).normalized();
 }
 
-void  Plane::rotateZ(double angle)
+void  Plane::rotateZ(Scalar angle)
 {
-	Eigen::Matrix4d rx;
+	Matrix4 rx;
 	rx << cos(angle), -sin(angle), 0, 0,
 		sin(angle), cos(angle), 0, 0,
 		0, 0, 1, 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d newDir;
+	Vector4 newDir;
 	newDir << this->normal[0], this->normal[1], this->normal[2], 0;
 
 	newDir = rx * newDir;
@@ -293,9 +247,9 @@ void  Plane::rotateZ(double angle)
 	this->axis2 = (normal.cross(this->axis1)).normalized();
 }
 
-void Plane::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void Plane::convertToCamera(Matrix4 transformationMatrix)
 {
-	Eigen::Vector4d center4, normal4;
+	Vector4 center4, normal4;
 	center4 << this->center[0], this->center[1], this->center[2], 1;
 	normal4 << this->normal[0], this->normal[1], this->normal[2], 0;
 
@@ -304,4 +258,30 @@ void Plane::convertToCamera(Eigen::Matrix4d transformationMatrix)
 
 	this->center << center4[0], center4[1], center4[2];
 	this->normal << normal4[0], normal4[1], normal4[2];
+}
+
+/**
+ * @brief Cria uma cópia do plano. A textura é compartilhada com o original.
+ */
+Object* Plane::clone() const
+{
+	return new Plane(*this);
+}
+
+/**
+ * @brief O plano é infinito: não há caixa delimitadora.
+ */
+bool Plane::getBounds(AABB* box) const
+{
+	return false;
+}
+
+/**
+ * @brief Verifica se o plano cruza o segmento (sem calcular as coordenadas de textura).
+ */
+bool Plane::occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+{
+	Scalar s = -(this->normal.dot(origin - this->center)) / (this->normal.dot(direction));
+
+	return s > 0 && s < tMax;
 }
\ No newline at end of file
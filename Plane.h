@@ -1,6 +1,6 @@
 #include "Object.h"
-// #include "../SDL/SDL2.dll"
-#include <SDL.h>
+#include "Scalar.h"
+#include "Texture.h"
 
 #ifndef Plane_H
 #define Plane_H
@@ -11,42 +11,43 @@
 class Plane : public Object
 {
 public:
-	Eigen::Vector3d normal; /**< Vetor normal ao plano */
-	Eigen::Vector3d center; /**< Ponto central do plano */
+	Vector3 normal; /**< Vetor normal ao plano */
+	Vector3 center; /**< Ponto central do plano */
 
-	SDL_Surface* texture; /**< Textura do plano */
+	const Texture* texture;   /**< Textura do plano (NULL se não houver), compartilhada com as cópias */
+	Texture::Sampler sampler; /**< Modo de amostragem da textura (trilinear e repetida, por padrão) */
 
-	Eigen::Vector3d axis1; /**< Primeiro eixo do plano */
-	Eigen::Vector3d axis2; /**< Segundo eixo do plano */
+	Vector3 axis1; /**< Primeiro eixo do plano */
+	Vector3 axis2; /**< Segundo eixo do plano */
 
 	/**
 	 * @brief Construtor da classe Plane.
-	 * @param texture Textura do plano.
+	 * @param texture Textura do plano (NULL se não houver); deve existir enquanto o plano existir.
 	 * @param normal Vetor normal ao plano.
 	 * @param center Ponto central do plano.
-	 * @param kAmbient Coeficiente de reflexão ambiente.
-	 * @param kDif Coeficiente de reflexão difusa.
-	 * @param kEsp Coeficiente de reflexão especular.
-	 * @param specularIndex Índice de reflexão especular.
+	 * @param material Índice do material na tabela de materiais da cena (Scene::materials).
 	 */
-	Plane(SDL_Surface* texture, Eigen::Vector3d normal, Eigen::Vector3d center, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, double specularIndex);
+	Plane(const Texture* texture, Vector3 normal, Vector3 center, int material);
 
 	/**
-	 * @brief Verifica se um raio intercepta o plano.
+	 * @brief Calcula a interseção de um raio com o plano.
 	 * @param ray Raio a ser verificado.
-	 * @return Valor do parâmetro t no ponto de interseção, ou -1 se não houver interseção.
+	 * @param hit Registro a ser preenchido (t, normal e coordenadas uv nos eixos do plano).
+	 * @return true se houver interseção à frente do raio.
 	 */
-	double hasInterceptedRay(Ray ray);
+	bool intersect(const Ray& ray, HitRecord* hit) const;
 
 	/**
-	 * @brief Calcula a cor do plano no ponto de interseção com um raio.
-	 * @param tInt Valor do parâmetro t no ponto de interseção.
+	 * @brief Obtém a intensidade ambiente (a cor da textura, se houver) e o material no ponto de interseção.
+	 *
+	 * As coordenadas uv do ponto, em unidades da cena, são as coordenadas em texels da textura, e o
+	 * nível de mipmap é escolhido pela largura do pixel (ray.spread) projetada no plano.
 	 * @param ray Raio de interseção.
-	 * @param sources Vetor de fontes de luz.
-	 * @param shadows Vetor de booleanos indicando se há sombra no ponto de interseção.
-	 * @return Cor do plano no ponto de interseção.
+	 * @param hit Registro da interseção.
+	 * @param ambient Ponteiro para a intensidade ambiente inicial.
+	 * @param material Ponteiro para o índice do material.
 	 */
-	Eigen::Vector3d computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows);
+	void getSurface(const Ray& ray, const HitRecord& hit, Vector3* ambient, int* material) const;
 
 	/**
 	 * @brief Translada o plano nas direções x, y e z.
@@ -54,7 +55,7 @@ public:
 	 * @param y Valor de translação no eixo y.
 	 * @param z Valor de translação no eixo z.
 	 */
-	void translate(double x, double y, double z);
+	void translate(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * @brief Escala o plano nas direções x, y e z.
@@ -62,31 +63,53 @@ public:
 	 * @param y Valor de escala no eixo y.
 	 * @param z Valor de escala no eixo z.
 	 */
-	void scale(double x, double y, double z);
+	void scale(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * @brief Rotaciona o plano em torno do eixo x.
 	 * @param angle Ângulo de rotação em radianos.
 	 */
-	void rotateX(double angle);
+	void rotateX(Scalar angle);
 
 	/**
 	 * @brief Rotaciona o plano em torno do eixo y.
 	 * @param angle Ângulo de rotação em radianos.
 	 */
-	void rotateY(double angle);
+	void rotateY(Scalar angle);
 
 	/**
 	 * @brief Rotaciona o plano em torno do eixo z.
 	 * @param angle Ângulo de rotação em radianos.
 	 */
-	void rotateZ(double angle);
+	void rotateZ(Scalar angle);
 
 	/**
 	 * @brief Converte as coordenadas do plano para o sistema de coordenadas da câmera.
 	 * @param transformationMatrix Matriz de transformação para o sistema de coordenadas da câmera.
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
+
+	/**
+	 * @brief Cria uma cópia do plano.
+	 * @return Ponteiro para o novo plano (a textura é compartilhada).
+	 */
+	Object* clone() const;
+
+	/**
+	 * @brief O plano é infinito e não tem caixa delimitadora.
+	 * @param box Não utilizado.
+	 * @return false (as estruturas de aceleração testam o plano à parte).
+	 */
+	bool getBounds(AABB* box) const;
+
+	/**
+	 * @brief Verifica se o plano bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 * @param origin A origem do segmento.
+	 * @param direction A direção (unitária) do segmento.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se o plano cruza o segmento.
+	 */
+	bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const;
 };
 
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "PontualSource.h"
+#include "PhongBatch.h"
 
 
 /**
@@ -6,16 +7,55 @@
  * @param origin A posição da fonte de luz pontual.
  * @param intensity A intensidade da luz emitida pela fonte pontual.
  */
-PontualSource::PontualSource(Eigen::Vector3d origin, Eigen::Vector3d intensity)
+PontualSource::PontualSource(Vector3 origin, Vector3 intensity)
 {
 	this->origin = origin;
 	this->intensity = intensity;
+	this->attenuation = Vector3(1, 0, 0);
+	this->radius = INFINITY;
+	this->type = PONTUAL;
+}
+
+/**
+ * @brief Construtor de uma fonte pontual com atenuação e raio de influência.
+ * @param origin A posição da fonte de luz pontual.
+ * @param intensity A intensidade da luz emitida pela fonte pontual.
+ * @param attenuation Os coeficientes constante, linear e quadrático da atenuação.
+ * @param radius O raio de influência (INFINITY para não limitar).
+ */
+PontualSource::PontualSource(Vector3 origin, Vector3 intensity, Vector3 attenuation, Scalar radius)
+{
+	this->origin = origin;
+	this->intensity = intensity;
+	this->attenuation = attenuation;
+	this->radius = radius;
+	this->type = PONTUAL;
+}
+
+/**
+ * @brief Fator de atenuação a uma distância da fonte.
+ * @param distance A distância até a fonte.
+ */
+Scalar PontualSource::getAttenuation(Scalar distance) const
+{
+	Scalar factor = 1 / (this->attenuation[0] + (this->attenuation[1] + this->attenuation[2] * distance) * distance);
+
+	if (this->isBounded())
+	{
+		// Janela que vai suavemente a zero no raio de influência
+		Scalar x = distance / this->radius;
+		Scalar x4 = (x * x) * (x * x);
+		Scalar window = x4 < 1 ? 1 - x4 : 0;
+		factor *= window * window;
+	}
+
+	return factor;
 }
 
 /**
  * @brief Obtém a direção da luz emitida pela fonte pontual em um determinado ponto. 
  */
-Eigen::Vector3d PontualSource::getDirection(Eigen::Vector3d pInt)
+Vector3 PontualSource::getDirection(Vector3 pInt)
 {
 	return (pInt - this->origin).normalized();
 }
@@ -34,35 +74,44 @@ Eigen::Vector3d PontualSource::getDirection(Eigen::Vector3d pInt)
  * @param specularIndex O índice de especularidade.
  * @param shadowed Indica se o ponto de interesse está em sombra.
  */
-void PontualSource::computeIntensity(Eigen::Vector3d pInt, Ray ray, Eigen::Vector3d* ptrIntesityAmbient, Eigen::Vector3d* ptrIntesityDifuse, Eigen::Vector3d* ptrIntesitySpecular, 
-	Eigen::Vector3d normal, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex, bool shadowed)
+void PontualSource::computeIntensity(Vector3 pInt, const Ray& ray, Vector3* ptrIntesityAmbient, Vector3* ptrIntesityDifuse, Vector3* ptrIntesitySpecular, 
+	Vector3 normal, Vector3 kAmbient, Vector3 kDif, Vector3 kEsp, int specularIndex, bool shadowed)
 {
-	if (shadowed == false)
+	if (shadowed == false && this->reaches(pInt))
 	{
-		Eigen::Vector3d directionToSource = (this->origin - pInt).normalized();
+		Vector3 directionToSource = (this->origin - pInt).normalized();
 		if (directionToSource.dot(normal) > 0)
 		{
-			Eigen::Vector3d directionToSourceReflex = (2 * directionToSource.dot(normal) * normal) - directionToSource;
-			Eigen::Vector3d rayDirectionReflex = ray.direction;
+			Vector3 directionToSourceReflex = (2 * directionToSource.dot(normal) * normal) - directionToSource;
+			// Vetor do ponto para o observador
+			Vector3 rayDirectionReflex = -ray.direction;
 
-			Eigen::Vector3d tempDifuse = ((this->intensity).cwiseProduct(kDif)) * normal.dot(directionToSource);
-			double lr = directionToSourceReflex.dot(rayDirectionReflex);
+			Vector3 tempDifuse = ((this->intensity).cwiseProduct(kDif)) * normal.dot(directionToSource);
+			Scalar lr = directionToSourceReflex.dot(rayDirectionReflex);
 
-			Eigen::Vector3d tempSpecular;
+			Vector3 tempSpecular;
 
 			if (lr >= 0)
 			{
-				tempSpecular = ((this->intensity).cwiseProduct(kEsp)) * pow(directionToSourceReflex.dot(rayDirectionReflex), specularIndex);
+				tempSpecular = ((this->intensity).cwiseProduct(kEsp)) * powInt(lr, specularIndex);
 			}
 			else
 			{
-				tempSpecular = Eigen::Vector3d(0, 0, 0);
+				tempSpecular = Vector3(0, 0, 0);
+			}
+
+			// Sem atenuação (o padrão) o fator seria 1: a conta é pulada para não mudar o resultado
+			if (this->attenuation != Vector3(1, 0, 0) || this->isBounded())
+			{
+				Scalar factor = this->getAttenuation((this->origin - pInt).norm());
+				tempDifuse *= factor;
+				tempSpecular *= factor;
 			}
 
 			// Monkey code
 
-			Eigen::Vector3d intesityDifuse = *ptrIntesityDifuse;
-			Eigen::Vector3d intesitySpecular = *ptrIntesitySpecular;
+			Vector3 intesityDifuse = *ptrIntesityDifuse;
+			Vector3 intesitySpecular = *ptrIntesitySpecular;
 
 			if (tempDifuse[0] > 0)
 			{
@@ -100,10 +149,18 @@ void PontualSource::computeIntensity(Eigen::Vector3d pInt, Ray ray, Eigen::Vecto
  * @brief Converte a posição da fonte pontual para o sistema de coordenadas da câmera.
  * @param transformationMatrix A matriz de transformação da câmera.
  */
-void PontualSource::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void PontualSource::convertToCamera(Matrix4 transformationMatrix)
 {
-	Eigen::Vector4d origin4;
+	Vector4 origin4;
 	origin4 << origin[0], origin[1], origin[2], 1;
 	origin4 = transformationMatrix * origin4;
 	origin << origin4[0], origin4[1], origin4[2];
+}
+
+/**
+ * @brief Cria uma cópia da fonte pontual.
+ */
+LightSource* PontualSource::clone() const
+{
+	return new PontualSource(*this);
 }
\ No newline at end of file
@@ -1,29 +1,72 @@
 #include "../eigen-3.4.0/Eigen/Dense"
+#include <cmath>
 
 #include "LightSource.h"
+#include "Scalar.h"
 
 #ifndef PontualSource_H
 #define PontualSource_H
 
 /**
  * Classe para representar uma fonte de luz pontual.
+ *
+ * Opcionalmente a intensidade cai com a distância d até a fonte, pelo fator
+ * 1 / (attenuation[0] + attenuation[1] * d + attenuation[2] * d²), e a fonte tem um raio de
+ * influência: o fator é multiplicado por (1 - (d / radius)^4)², que chega a zero no raio, e além
+ * dele a fonte não ilumina. Sem atenuação e com raio infinito (o padrão) a fonte é a de sempre.
  */
 class PontualSource : public LightSource
 {
 public:
+	Vector3 attenuation; /**< Coeficientes constante, linear e quadrático da atenuação (padrão: 1, 0, 0) */
+	Scalar radius; /**< Raio de influência (padrão: INFINITY, sem limite) */
+
 	/**
 	 * Construtor da classe PontualSource.
 	 * @param origin A posição da fonte de luz pontual.
 	 * @param intensity A intensidade da luz emitida pela fonte pontual.
 	 */
-	PontualSource(Eigen::Vector3d origin, Eigen::Vector3d intensity);
-};
+	PontualSource(Vector3 origin, Vector3 intensity);
+
+	/**
+	 * Construtor de uma fonte pontual com atenuação e raio de influência.
+	 * @param origin A posição da fonte de luz pontual.
+	 * @param intensity A intensidade da luz emitida pela fonte pontual.
+	 * @param attenuation Os coeficientes constante, linear e quadrático da atenuação.
+	 * @param radius O raio de influência (INFINITY para não limitar).
+	 */
+	PontualSource(Vector3 origin, Vector3 intensity, Vector3 attenuation, Scalar radius);
+
+	/**
+	 * Verifica se a fonte tem raio de influência finito.
+	 */
+	bool isBounded() const
+	{
+		return std::isfinite(this->radius);
+	}
+
+	/**
+	 * Verifica se o ponto está dentro do raio de influência (fora dele a contribuição é zero).
+	 * @param point O ponto de interesse.
+	 */
+	bool reaches(const Vector3& point) const
+	{
+		return !this->isBounded() || (point - this->origin).squaredNorm() < this->radius * this->radius;
+	}
+
+	/**
+	 * Fator de atenuação a uma distância da fonte (1 sem atenuação nem raio).
+	 * @param distance A distância até a fonte.
+	 * @return O fator que multiplica a intensidade.
+	 */
+	Scalar getAttenuation(Scalar distance) const;
+
 	/**
 	 * Obtém a direção da luz emitida pela fonte pontual em um determinado ponto.
 	 * @param pInt O ponto de interesse.
 	 * @return A direção da luz.
 	 */
-	Eigen::Vector3d getDirection(Eigen::Vector3d pInt);
+	Vector3 getDirection(Vector3 pInt);
 
 	/**
 	 * Calcula a intensidade da luz emitida pela fonte pontual em um determinado ponto.
@@ -39,14 +82,20 @@ public:
 	 * @param specularIndex O índice de especularidade.
 	 * @param shadowed Indica se o ponto de interesse está em sombra.
 	 */
-	void computeIntensity(Eigen::Vector3d pInt, Ray ray, Eigen::Vector3d* ptrIntesityAmbient, Eigen::Vector3d* ptrIntesityDifuse, Eigen::Vector3d* ptrIntesitySpecular, 
-		Eigen::Vector3d normal, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex, bool shadowed);
+	void computeIntensity(Vector3 pInt, const Ray& ray, Vector3* ptrIntesityAmbient, Vector3* ptrIntesityDifuse, Vector3* ptrIntesitySpecular, 
+		Vector3 normal, Vector3 kAmbient, Vector3 kDif, Vector3 kEsp, int specularIndex, bool shadowed);
 
 	/**
 	 * Converte a posição da fonte pontual para o sistema de coordenadas da câmera.
 	 * @param transformationMatrix A matriz de transformação da câmera.
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
 
+	/**
+	 * Cria uma cópia da fonte pontual.
+	 * @return Ponteiro para a cópia.
+	 */
+	LightSource* clone() const;
+};
 
 #endif
\ No newline at end of file
@@ -0,0 +1,695 @@
+#include "PrimitiveStore.h"
+#include "CircularPlane.h"
+#include "LaneMath.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include "TriangularFace.h"
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <typeinfo>
+
+/**
+ * @brief Começa sem interseção, limitada por tMax.
+ */
+PrimitiveStore::Closest::Closest(Scalar tMax)
+{
+	this->t = tMax;
+	this->index = INT_MAX;
+	this->object = NULL;
+	this->pending = false;
+}
+
+/**
+ * @brief Indica se algum objeto foi atingido.
+ */
+bool PrimitiveStore::Closest::found() const
+{
+	return this->index != INT_MAX;
+}
+
+/**
+ * @brief Copia o resultado; um objeto escolhido por um núcleo refaz a própria interseção para preencher o registro.
+ *
+ * Os núcleos repetem as contas dos objetos, então o objeto sempre confirma a interseção. Se não
+ * confirmar (um núcleo que deixou de concordar com a classe), o raio fica sem interseção, em vez
+ * de devolver um registro que o objeto não preencheu.
+ */
+bool PrimitiveStore::Closest::finish(const Ray& ray, HitRecord* hit, Object** object)
+{
+	if (!this->found())
+	{
+		return false;
+	}
+
+	if (this->pending)
+	{
+		if (!this->object->intersect(ray, &this->hit))
+		{
+			this->index = INT_MAX;
+			this->object = NULL;
+			this->pending = false;
+			return false;
+		}
+		this->pending = false;
+	}
+
+	*hit = this->hit;
+	*object = this->object;
+	return true;
+}
+
+/**
+ * @brief Um valor um pouco maior que t (no máximo dois ulps), sem a chamada de std::nextafter.
+ */
+static inline Scalar slightlyAfter(Scalar t)
+{
+	return t + std::abs(t) * std::numeric_limits<Scalar>::epsilon();
+}
+
+/**
+ * @brief Indica se a interseção em t do objeto index é melhor que a atual (desempate pela ordem original).
+ */
+static inline bool isCloser(const PrimitiveStore::Closest* closest, Scalar t, int index)
+{
+	return t < closest->t || (t == closest->t && index < closest->index);
+}
+
+/**
+ * @brief Guarda uma interseção mais próxima encontrada por um núcleo e encurta o intervalo do raio.
+ *
+ * O fim do intervalo fica logo depois de t, e não em t, para que um empate com um objeto de índice
+ * menor ainda apareça.
+ */
+static inline void accept(PrimitiveStore::Closest* closest, Ray* ray, Scalar t, int index, Object* object)
+{
+	closest->t = t;
+	closest->index = index;
+	closest->object = object;
+	closest->pending = true;
+	ray->tMax = slightlyAfter(t);
+}
+
+/**
+ * @brief Raios ativos de um pacote em estrutura de vetores, para que os laços sobre os raios vetorizem.
+ */
+struct PrimitiveStore::RayLanes
+{
+	int count;
+	int rays[MAX_PACKET]; // Posição de cada raio no pacote
+	Scalar ox[MAX_PACKET], oy[MAX_PACKET], oz[MAX_PACKET];
+	Scalar dx[MAX_PACKET], dy[MAX_PACKET], dz[MAX_PACKET];
+	Scalar tMin[MAX_PACKET], tMax[MAX_PACKET];
+};
+
+/**
+ * @brief Tipo usado para guardar o objeto.
+ *
+ * Usa o tipo dinâmico exato: uma subclasse de Sphere ou de Plane pode mudar a interseção, então
+ * só as próprias classes usam os núcleos.
+ */
+PrimitiveStore::Kind PrimitiveStore::classify(const Object* object)
+{
+	const std::type_info& type = typeid(*object);
+
+	if (type == typeid(Sphere))
+	{
+		return SPHERE;
+	}
+	if (type == typeid(Plane))
+	{
+		return PLANE;
+	}
+	if (type == typeid(CircularPlane))
+	{
+		return DISC;
+	}
+	if (type == typeid(TriangularFace))
+	{
+		return TRIANGLE;
+	}
+	return OTHER;
+}
+
+/**
+ * @brief Remove todas as entradas.
+ */
+void PrimitiveStore::clear()
+{
+	this->objects.clear();
+	this->indices.clear();
+	this->kinds.clear();
+	this->slots.clear();
+	this->spheres.clear();
+	this->planes.clear();
+	this->discs.clear();
+	this->triangles.clear();
+}
+
+/**
+ * @brief Adiciona um objeto ao final, copiando os dados da interseção para o vetor do seu tipo.
+ *
+ * @param object O objeto.
+ * @param index O índice original do objeto.
+ */
+void PrimitiveStore::add(Object* object, int index)
+{
+	Kind kind = classify(object);
+	int slot;
+
+	switch (kind)
+	{
+	case SPHERE:
+	{
+		const Sphere* sphere = static_cast<const Sphere*>(object);
+		slot = this->spheres.size();
+		this->spheres.push_back({ sphere->center, sphere->radius * sphere->radius });
+		break;
+	}
+	case PLANE:
+	{
+		const Plane* plane = static_cast<const Plane*>(object);
+		slot = this->planes.size();
+		this->planes.push_back({ plane->normal, plane->center });
+		break;
+	}
+	case DISC:
+	{
+		const CircularPlane* disc = static_cast<const CircularPlane*>(object);
+		slot = this->discs.size();
+		this->discs.push_back({ disc->normal, disc->center, disc->radius * disc->radius });
+		break;
+	}
+	case TRIANGLE:
+	{
+		const TriangularFace* face = static_cast<const TriangularFace*>(object);
+		slot = this->triangles.size();
+		this->triangles.push_back({ face->vertexes[0], face->edge1, face->edge2 });
+		break;
+	}
+	default:
+		slot = this->objects.size();
+		break;
+	}
+
+	this->objects.push_back(object);
+	this->indices.push_back(index);
+	this->kinds.push_back(kind);
+	this->slots.push_back(slot);
+}
+
+/**
+ * @brief Obtém o número de entradas.
+ */
+int PrimitiveStore::size() const
+{
+	return this->objects.size();
+}
+
+/**
+ * @brief Obtém o objeto da entrada i.
+ */
+Object* PrimitiveStore::get(int i) const
+{
+	return this->objects[i];
+}
+
+/**
+ * @brief Testa um intervalo de entradas, um lote de entradas consecutivas do mesmo tipo por vez.
+ */
+void PrimitiveStore::intersect(int first, int count, Ray* ray, Closest* closest) const
+{
+	int end = first + count;
+	int begin = first;
+
+	while (begin < end)
+	{
+		unsigned char kind = this->kinds[begin];
+		int batchEnd = begin + 1;
+		while (batchEnd < end && this->kinds[batchEnd] == kind)
+		{
+			batchEnd++;
+		}
+
+		switch (kind)
+		{
+		case SPHERE:
+			this->intersectSpheres(begin, batchEnd, ray, closest);
+			break;
+		case PLANE:
+			this->intersectPlanes(begin, batchEnd, ray, closest);
+			break;
+		case DISC:
+			this->intersectDiscs(begin, batchEnd, ray, closest);
+			break;
+		case TRIANGLE:
+			this->intersectTriangles(begin, batchEnd, ray, closest);
+			break;
+		default:
+			this->intersectOthers(begin, batchEnd, ray, closest);
+			break;
+		}
+
+		begin = batchEnd;
+	}
+}
+
+/**
+ * @brief Verifica se alguma entrada do intervalo bloqueia o segmento, um lote do mesmo tipo por vez.
+ */
+bool PrimitiveStore::occluded(int first, int count, const Ray& segment) const
+{
+	int end = first + count;
+	int begin = first;
+
+	while (begin < end)
+	{
+		unsigned char kind = this->kinds[begin];
+		int batchEnd = begin + 1;
+		while (batchEnd < end && this->kinds[batchEnd] == kind)
+		{
+			batchEnd++;
+		}
+
+		bool blocked;
+		switch (kind)
+		{
+		case SPHERE:
+			blocked = this->occludedSpheres(begin, batchEnd, segment);
+			break;
+		case PLANE:
+			blocked = this->occludedPlanes(begin, batchEnd, segment);
+			break;
+		case DISC:
+			blocked = this->occludedDiscs(begin, batchEnd, segment);
+			break;
+		case TRIANGLE:
+			blocked = this->occludedTriangles(begin, batchEnd, segment);
+			break;
+		default:
+			blocked = this->occludedOthers(begin, batchEnd, segment);
+			break;
+		}
+
+		if (blocked)
+		{
+			return true;
+		}
+
+		begin = batchEnd;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Testa um intervalo de entradas contra os raios ativos de um pacote, um lote do mesmo tipo por vez.
+ *
+ * Os raios ativos são copiados uma vez para RayLanes, e o fim do intervalo de cada um é mantido
+ * igual ao do Ray correspondente.
+ */
+void PrimitiveStore::intersectPacket(int first, int count, const unsigned char* mask, int numRays, Ray* rays, Closest* closest) const
+{
+	RayLanes lanes;
+	lanes.count = 0;
+	for (int r = 0; r < numRays; r++)
+	{
+		if (!mask[r])
+		{
+			continue;
+		}
+
+		int k = lanes.count++;
+		lanes.rays[k] = r;
+		lanes.ox[k] = rays[r].initialPoint[0];
+		lanes.oy[k] = rays[r].initialPoint[1];
+		lanes.oz[k] = rays[r].initialPoint[2];
+		lanes.dx[k] = rays[r].direction[0];
+		lanes.dy[k] = rays[r].direction[1];
+		lanes.dz[k] = rays[r].direction[2];
+		lanes.tMin[k] = rays[r].tMin;
+		lanes.tMax[k] = rays[r].tMax;
+	}
+
+	int end = first + count;
+	int begin = first;
+
+	while (begin < end)
+	{
+		unsigned char kind = this->kinds[begin];
+		int batchEnd = begin + 1;
+		while (batchEnd < end && this->kinds[batchEnd] == kind)
+		{
+			batchEnd++;
+		}
+
+		switch (kind)
+		{
+		case SPHERE:
+			this->intersectSpheresLanes(begin, batchEnd, &lanes, rays, closest);
+			break;
+		case PLANE:
+			this->intersectPlanesLanes(begin, batchEnd, &lanes, rays, closest);
+			break;
+		case DISC:
+			this->intersectDiscsLanes(begin, batchEnd, &lanes, rays, closest);
+			break;
+		case TRIANGLE:
+			this->intersectTrianglesLanes(begin, batchEnd, &lanes, rays, closest);
+			break;
+		default:
+			this->intersectOthersLanes(begin, batchEnd, &lanes, rays, closest);
+			break;
+		}
+
+		begin = batchEnd;
+	}
+}
+
+// As entradas de um lote foram adicionadas em sequência, então os dados do lote também são
+// consecutivos no vetor do tipo, a partir de slots[begin]. Cada núcleo repete as contas de
+// intersect e occluded da classe correspondente.
+
+void PrimitiveStore::intersectSpheres(int begin, int end, Ray* ray, Closest* closest) const
+{
+	const SphereData* data = &this->spheres[this->slots[begin]];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		Vector3 w = ray->initialPoint - data->center;
+
+		Scalar b = w.dot(ray->direction);
+		Scalar c = w.dot(w) - data->radius2;
+
+		Scalar delta = b * b - c;
+
+		if (delta < 0)
+			continue;
+
+		Scalar tInt = -b - sqrt(delta);
+
+		if (ray->contains(tInt) && isCloser(closest, tInt, this->indices[i]))
+		{
+			accept(closest, ray, tInt, this->indices[i], this->objects[i]);
+		}
+	}
+}
+
+void PrimitiveStore::intersectPlanes(int begin, int end, Ray* ray, Closest* closest) const
+{
+	const PlaneData* data = &this->planes[this->slots[begin]];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		Vector3 w = ray->initialPoint - data->center;
+		Scalar tInt = -(data->normal.dot(w)) / (data->normal.dot(ray->direction));
+
+		if (ray->contains(tInt) && isCloser(closest, tInt, this->indices[i]))
+		{
+			accept(closest, ray, tInt, this->indices[i], this->objects[i]);
+		}
+	}
+}
+
+void PrimitiveStore::intersectDiscs(int begin, int end, Ray* ray, Closest* closest) const
+{
+	const DiscData* data = &this->discs[this->slots[begin]];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		Vector3 w = ray->initialPoint - data->center;
+		Scalar tInt = -(data->normal.dot(w)) / (data->normal.dot(ray->direction));
+
+		if (!ray->contains(tInt) || !isCloser(closest, tInt, this->indices[i]))
+			continue;
+
+		Vector3 pInt = ray->initialPoint + tInt * ray->direction;
+
+		if ((pInt - data->center).squaredNorm() <= data->radius2)
+		{
+			accept(closest, ray, tInt, this->indices[i], this->objects[i]);
+		}
+	}
+}
+
+void PrimitiveStore::intersectTriangles(int begin, int end, Ray* ray, Closest* closest) const
+{
+	const TriangleData* data = &this->triangles[this->slots[begin]];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		Scalar tInt;
+
+		if (TriangularFace::mollerTrumbore(ray->initialPoint, ray->direction, data->v0, data->edge1, data->edge2, &tInt) &&
+			ray->contains(tInt) && isCloser(closest, tInt, this->indices[i]))
+		{
+			accept(closest, ray, tInt, this->indices[i], this->objects[i]);
+		}
+	}
+}
+
+void PrimitiveStore::intersectOthers(int begin, int end, Ray* ray, Closest* closest) const
+{
+	HitRecord candidate;
+
+	for (int i = begin; i < end; i++)
+	{
+		if (this->objects[i]->intersect(*ray, &candidate) && isCloser(closest, candidate.t, this->indices[i]))
+		{
+			closest->t = candidate.t;
+			closest->index = this->indices[i];
+			closest->object = this->objects[i];
+			closest->hit = candidate;
+			closest->pending = false;
+			ray->tMax = slightlyAfter(candidate.t);
+		}
+	}
+}
+
+bool PrimitiveStore::occludedSpheres(int begin, int end, const Ray& segment) const
+{
+	const SphereData* data = &this->spheres[this->slots[begin]];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		Vector3 w = segment.initialPoint - data->center;
+		Scalar b = w.dot(segment.direction);
+		Scalar c = w.dot(w) - data->radius2;
+
+		Scalar delta = b * b - c;
+
+		if (delta < 0)
+			continue;
+
+		Scalar s = -b - sqrt(delta);
+
+		if (s > 0 && s < segment.tMax)
+			return true;
+	}
+
+	return false;
+}
+
+bool PrimitiveStore::occludedPlanes(int begin, int end, const Ray& segment) const
+{
+	const PlaneData* data = &this->planes[this->slots[begin]];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		Scalar s = -(data->normal.dot(segment.initialPoint - data->center)) / (data->normal.dot(segment.direction));
+
+		if (s > 0 && s < segment.tMax)
+			return true;
+	}
+
+	return false;
+}
+
+bool PrimitiveStore::occludedDiscs(int begin, int end, const Ray& segment) const
+{
+	const DiscData* data = &this->discs[this->slots[begin]];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		Scalar s = -(data->normal.dot(segment.initialPoint - data->center)) / (data->normal.dot(segment.direction));
+
+		if (!(s > 0 && s < segment.tMax))
+			continue;
+
+		if ((segment.initialPoint + s * segment.direction - data->center).squaredNorm() <= data->radius2)
+			return true;
+	}
+
+	return false;
+}
+
+bool PrimitiveStore::occludedTriangles(int begin, int end, const Ray& segment) const
+{
+	const TriangleData* data = &this->triangles[this->slots[begin]];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		Scalar s;
+
+		if (TriangularFace::mollerTrumbore(segment.initialPoint, segment.direction, data->v0, data->edge1, data->edge2, &s) &&
+			s > 0 && s < segment.tMax)
+			return true;
+	}
+
+	return false;
+}
+
+bool PrimitiveStore::occludedOthers(int begin, int end, const Ray& segment) const
+{
+	for (int i = begin; i < end; i++)
+	{
+		if (this->objects[i]->occluded(segment.initialPoint, segment.direction, segment.tMax))
+			return true;
+	}
+
+	return false;
+}
+
+// Núcleos de pacotes: o primeiro laço calcula, sem desvios, o t da entrada i para cada raio ativo
+// (INFINITY quando não há interseção, que nenhum intervalo contém); acceptLanes escolhe depois os
+// raios em que ela é a mais próxima, com as mesmas regras dos núcleos de um raio. Os produtos
+// escalares usam dot3, na ordem de somas do Eigen, para chegar exatamente aos mesmos t.
+
+void PrimitiveStore::acceptLanes(int i, const Scalar* t, RayLanes* lanes, Ray* rays, Closest* closest) const
+{
+	for (int k = 0; k < lanes->count; k++)
+	{
+		if (!(t[k] > lanes->tMin[k] && t[k] < lanes->tMax[k]))
+			continue;
+
+		int r = lanes->rays[k];
+		if (isCloser(&closest[r], t[k], this->indices[i]))
+		{
+			accept(&closest[r], &rays[r], t[k], this->indices[i], this->objects[i]);
+			lanes->tMax[k] = rays[r].tMax;
+		}
+	}
+}
+
+void PrimitiveStore::intersectSpheresLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const
+{
+	const SphereData* data = &this->spheres[this->slots[begin]];
+	const int count = lanes->count;
+	Scalar t[MAX_PACKET];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		const Scalar cx = data->center[0], cy = data->center[1], cz = data->center[2];
+		const Scalar radius2 = data->radius2;
+
+		for (int k = 0; k < count; k++)
+		{
+			Scalar wx = lanes->ox[k] - cx, wy = lanes->oy[k] - cy, wz = lanes->oz[k] - cz;
+
+			Scalar b = dot3(wx, wy, wz, lanes->dx[k], lanes->dy[k], lanes->dz[k]);
+			Scalar c = dot3(wx, wy, wz, wx, wy, wz) - radius2;
+
+			Scalar delta = b * b - c;
+			t[k] = delta < 0 ? INFINITY : -b - std::sqrt(delta);
+		}
+
+		this->acceptLanes(i, t, lanes, rays, closest);
+	}
+}
+
+void PrimitiveStore::intersectPlanesLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const
+{
+	const PlaneData* data = &this->planes[this->slots[begin]];
+	const int count = lanes->count;
+	Scalar t[MAX_PACKET];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		const Scalar nx = data->normal[0], ny = data->normal[1], nz = data->normal[2];
+		const Scalar cx = data->center[0], cy = data->center[1], cz = data->center[2];
+
+		for (int k = 0; k < count; k++)
+		{
+			Scalar wx = lanes->ox[k] - cx, wy = lanes->oy[k] - cy, wz = lanes->oz[k] - cz;
+			t[k] = -dot3(nx, ny, nz, wx, wy, wz) / dot3(nx, ny, nz, lanes->dx[k], lanes->dy[k], lanes->dz[k]);
+		}
+
+		this->acceptLanes(i, t, lanes, rays, closest);
+	}
+}
+
+void PrimitiveStore::intersectDiscsLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const
+{
+	const DiscData* data = &this->discs[this->slots[begin]];
+	const int count = lanes->count;
+	Scalar t[MAX_PACKET];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		const Scalar nx = data->normal[0], ny = data->normal[1], nz = data->normal[2];
+		const Scalar cx = data->center[0], cy = data->center[1], cz = data->center[2];
+		const Scalar radius2 = data->radius2;
+
+		for (int k = 0; k < count; k++)
+		{
+			Scalar wx = lanes->ox[k] - cx, wy = lanes->oy[k] - cy, wz = lanes->oz[k] - cz;
+			Scalar tInt = -dot3(nx, ny, nz, wx, wy, wz) / dot3(nx, ny, nz, lanes->dx[k], lanes->dy[k], lanes->dz[k]);
+
+			// Distância ao centro do ponto no plano
+			Scalar px = lanes->ox[k] + tInt * lanes->dx[k] - cx;
+			Scalar py = lanes->oy[k] + tInt * lanes->dy[k] - cy;
+			Scalar pz = lanes->oz[k] + tInt * lanes->dz[k] - cz;
+
+			t[k] = dot3(px, py, pz, px, py, pz) <= radius2 ? tInt : INFINITY;
+		}
+
+		this->acceptLanes(i, t, lanes, rays, closest);
+	}
+}
+
+void PrimitiveStore::intersectTrianglesLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const
+{
+	const TriangleData* data = &this->triangles[this->slots[begin]];
+	const int count = lanes->count;
+	Scalar t[MAX_PACKET];
+
+	for (int i = begin; i < end; i++, data++)
+	{
+		const Scalar v0x = data->v0[0], v0y = data->v0[1], v0z = data->v0[2];
+		const Scalar e1x = data->edge1[0], e1y = data->edge1[1], e1z = data->edge1[2];
+		const Scalar e2x = data->edge2[0], e2y = data->edge2[1], e2z = data->edge2[2];
+
+		// TriangularFace::mollerTrumbore, com as saídas antecipadas trocadas por uma condição final
+		for (int k = 0; k < count; k++)
+		{
+			Scalar dx = lanes->dx[k], dy = lanes->dy[k], dz = lanes->dz[k];
+
+			Scalar px = dy * e2z - dz * e2y, py = dz * e2x - dx * e2z, pz = dx * e2y - dy * e2x;
+			Scalar det = dot3(e1x, e1y, e1z, px, py, pz);
+			Scalar invDet = 1 / det;
+
+			Scalar sx = lanes->ox[k] - v0x, sy = lanes->oy[k] - v0y, sz = lanes->oz[k] - v0z;
+			Scalar u = dot3(sx, sy, sz, px, py, pz) * invDet;
+
+			Scalar qx = sy * e1z - sz * e1y, qy = sz * e1x - sx * e1z, qz = sx * e1y - sy * e1x;
+			Scalar v = dot3(dx, dy, dz, qx, qy, qz) * invDet;
+
+			Scalar tInt = dot3(e2x, e2y, e2z, qx, qy, qz) * invDet;
+
+			bool inside = det != 0 && !(u < 0 || u > 1) && !(v < 0 || u + v > 1);
+			t[k] = inside ? tInt : INFINITY;
+		}
+
+		this->acceptLanes(i, t, lanes, rays, closest);
+	}
+}
+
+void PrimitiveStore::intersectOthersLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const
+{
+	for (int k = 0; k < lanes->count; k++)
+	{
+		int r = lanes->rays[k];
+		this->intersectOthers(begin, end, &rays[r], &closest[r]);
+		lanes->tMax[k] = rays[r].tMax;
+	}
+}
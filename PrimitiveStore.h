@@ -0,0 +1,212 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <vector>
+
+#include "HitRecord.h"
+#include "Object.h"
+#include "Ray.h"
+#include "Scalar.h"
+
+#ifndef PrimitiveStore_H
+#define PrimitiveStore_H
+
+/**
+ * @brief Objetos compilados agrupados pelo tipo concreto, em vetores contíguos.
+ *
+ * Esferas, planos, discos e faces triangulares têm os dados da interseção copiados para um vetor
+ * por tipo e são testados por núcleos sem chamadas virtuais, expandidos no próprio laço. Os demais
+ * objetos (cilindros, cones, malhas e qualquer outra subclasse de Object) continuam sendo testados
+ * pelas funções virtuais.
+ *
+ * As entradas são usadas em intervalos (as folhas da BVH e a lista de objetos infinitos), e o
+ * chamador as adiciona ordenadas por tipo dentro de cada intervalo: o teste de um intervalo é um
+ * laço por lote de objetos do mesmo tipo, e não uma chamada por objeto. Os núcleos repetem as
+ * contas de cada classe, então escolhem exatamente os mesmos acertos; o registro do vencedor é
+ * preenchido no final pelo próprio objeto, como no SphereSet.
+ *
+ * Para os pacotes de raios da BVH há também intersectPacket, em que cada objeto é testado contra
+ * todos os raios ativos num laço sem desvios, com as mesmas contas dos núcleos de um raio.
+ *
+ * Os dados são copiados em add(), então os objetos não devem ser transformados depois disso.
+ */
+class PrimitiveStore
+{
+public:
+	static const int MAX_PACKET = 64; /**< Maior número de raios de intersectPacket */
+
+	/**
+	 * @brief Tipos com núcleo próprio; OTHER usa as funções virtuais.
+	 */
+	enum Kind
+	{
+		SPHERE = 0,
+		PLANE = 1,
+		DISC = 2,
+		TRIANGLE = 3,
+		OTHER = 4
+	};
+
+	/**
+	 * @brief Interseção mais próxima de um raio durante a busca.
+	 *
+	 * Em caso de empate em t vence o menor índice (a ordem original dos objetos).
+	 */
+	struct Closest
+	{
+		Scalar t;       /**< Parâmetro da interseção mais próxima */
+		int index;      /**< Índice original do objeto (INT_MAX enquanto nenhum foi atingido) */
+		Object* object; /**< Objeto atingido */
+		HitRecord hit;  /**< Registro da interseção (só vale se pending for false) */
+		bool pending;   /**< O objeto foi escolhido por um núcleo e ainda precisa preencher hit */
+
+		/**
+		 * @brief Começa sem interseção, limitada por tMax.
+		 */
+		explicit Closest(Scalar tMax = INFINITY);
+
+		/**
+		 * @brief Indica se algum objeto foi atingido.
+		 */
+		bool found() const;
+
+		/**
+		 * @brief Copia o resultado, pedindo ao objeto que preencha o registro se necessário.
+		 *
+		 * @param ray O raio da busca (com o intervalo original).
+		 * @param hit Registro a ser preenchido.
+		 * @param object Ponteiro para armazenar o objeto atingido.
+		 * @return true se algum objeto foi atingido e confirmou a interseção.
+		 */
+		bool finish(const Ray& ray, HitRecord* hit, Object** object);
+	};
+
+	/**
+	 * @brief Tipo usado para guardar o objeto (pelo tipo dinâmico exato).
+	 *
+	 * @param object O objeto.
+	 */
+	static Kind classify(const Object* object);
+
+	/**
+	 * @brief Remove todas as entradas.
+	 */
+	void clear();
+
+	/**
+	 * @brief Adiciona um objeto ao final.
+	 *
+	 * @param object O objeto (nas suas coordenadas atuais).
+	 * @param index O índice original do objeto, usado no desempate.
+	 */
+	void add(Object* object, int index);
+
+	/**
+	 * @brief Obtém o número de entradas.
+	 */
+	int size() const;
+
+	/**
+	 * @brief Obtém o objeto da entrada i.
+	 */
+	Object* get(int i) const;
+
+	/**
+	 * @brief Testa as entradas [first, first + count) e atualiza a interseção mais próxima.
+	 *
+	 * Cada nova interseção encurta o intervalo do raio até logo depois dela, para que os objetos
+	 * seguintes descartem o que fica atrás; um empate com um objeto de índice menor ainda aparece.
+	 *
+	 * @param first A primeira entrada.
+	 * @param count O número de entradas.
+	 * @param ray O raio (o fim do intervalo é atualizado).
+	 * @param closest A interseção mais próxima até aqui.
+	 */
+	void intersect(int first, int count, Ray* ray, Closest* closest) const;
+
+	/**
+	 * @brief Testa as entradas [first, first + count) contra os raios de um pacote com mask[i] = 1.
+	 *
+	 * Esferas, planos, discos e faces triangulares são testados contra todos esses raios de uma vez;
+	 * os demais objetos, raio a raio. O resultado de cada raio é o mesmo de intersect.
+	 *
+	 * @param first A primeira entrada.
+	 * @param count O número de entradas.
+	 * @param mask Os raios a testar, um valor 0 ou 1 por raio.
+	 * @param numRays O número de raios do pacote (até MAX_PACKET).
+	 * @param rays Os raios (o fim do intervalo é atualizado).
+	 * @param closest A interseção mais próxima de cada raio até aqui.
+	 */
+	void intersectPacket(int first, int count, const unsigned char* mask, int numRays, Ray* rays, Closest* closest) const;
+
+	/**
+	 * @brief Verifica se alguma das entradas [first, first + count) bloqueia o segmento.
+	 *
+	 * @param first A primeira entrada.
+	 * @param count O número de entradas.
+	 * @param segment O segmento, com t em (0, tMax).
+	 * @return true se alguma entrada bloqueia o segmento.
+	 */
+	bool occluded(int first, int count, const Ray& segment) const;
+
+private:
+	struct SphereData
+	{
+		Vector3 center;
+		Scalar radius2;
+	};
+
+	struct PlaneData
+	{
+		Vector3 normal;
+		Vector3 center;
+	};
+
+	struct DiscData
+	{
+		Vector3 normal;
+		Vector3 center;
+		Scalar radius2;
+	};
+
+	struct TriangleData
+	{
+		Vector3 v0;
+		Vector3 edge1;
+		Vector3 edge2;
+	};
+
+	// Uma posição por entrada
+	std::vector<Object*> objects;
+	std::vector<int> indices;
+	std::vector<unsigned char> kinds;
+	std::vector<int> slots; // Posição nos dados do tipo (ou em objects, para OTHER)
+
+	// Dados por tipo, na ordem das entradas
+	std::vector<SphereData> spheres;
+	std::vector<PlaneData> planes;
+	std::vector<DiscData> discs;
+	std::vector<TriangleData> triangles;
+
+	// Núcleos de um lote de entradas consecutivas do mesmo tipo, [begin, end)
+	void intersectSpheres(int begin, int end, Ray* ray, Closest* closest) const;
+	void intersectPlanes(int begin, int end, Ray* ray, Closest* closest) const;
+	void intersectDiscs(int begin, int end, Ray* ray, Closest* closest) const;
+	void intersectTriangles(int begin, int end, Ray* ray, Closest* closest) const;
+	void intersectOthers(int begin, int end, Ray* ray, Closest* closest) const;
+
+	// Núcleos de intersectPacket: um objeto por vez contra todos os raios ativos
+	struct RayLanes;
+	void acceptLanes(int i, const Scalar* t, RayLanes* lanes, Ray* rays, Closest* closest) const;
+	void intersectSpheresLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const;
+	void intersectPlanesLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const;
+	void intersectDiscsLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const;
+	void intersectTrianglesLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const;
+	void intersectOthersLanes(int begin, int end, RayLanes* lanes, Ray* rays, Closest* closest) const;
+
+	bool occludedSpheres(int begin, int end, const Ray& segment) const;
+	bool occludedPlanes(int begin, int end, const Ray& segment) const;
+	bool occludedDiscs(int begin, int end, const Ray& segment) const;
+	bool occludedTriangles(int begin, int end, const Ray& segment) const;
+	bool occludedOthers(int begin, int end, const Ray& segment) const;
+};
+
+#endif
@@ -3,11 +3,54 @@
 /**
  * Construtor da classe Ray.
  * @param initialPoint Ponto inicial do raio.
- * @param direction Direção do raio.
+ * @param point Ponto pelo qual o raio passa.
  */
-Ray::Ray(Eigen::Vector3d initialPoint, Eigen::Vector3d direction)
+Ray::Ray(Vector3 initialPoint, Vector3 point)
 {
 	this->initialPoint = initialPoint;
-	// (ponto inicial - ponto final)/||ponto inicial - ponto final||
-	this->direction = (initialPoint - direction).normalized(); 
+	// (ponto final - ponto inicial)/||ponto final - ponto inicial||
+	this->direction = (point - initialPoint).normalized();
+	this->tMin = 0;
+	this->tMax = INFINITY;
+	this->spread = 0;
+	this->updateInverse();
+}
+
+/**
+ * Construtor vazio: o raio não é inicializado.
+ */
+Ray::Ray()
+{
+}
+
+/**
+ * Cria um raio a partir da origem e de uma direção unitária.
+ * @param initialPoint Ponto inicial do raio.
+ * @param direction Direção unitária do raio.
+ * @param tMin Início do intervalo de interesse.
+ * @param tMax Fim do intervalo de interesse.
+ * @return O raio.
+ */
+Ray Ray::fromDirection(const Vector3& initialPoint, const Vector3& direction, Scalar tMin, Scalar tMax)
+{
+	Ray ray;
+	ray.initialPoint = initialPoint;
+	ray.direction = direction;
+	ray.tMin = tMin;
+	ray.tMax = tMax;
+	ray.spread = 0;
+	ray.updateInverse();
+	return ray;
+}
+
+/**
+ * Calcula o inverso da direção e os sinais usados pelo teste de slabs.
+ */
+void Ray::updateInverse()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		this->invDirection[i] = 1 / this->direction[i];
+		this->sign[i] = this->invDirection[i] < 0;
+	}
 }
\ No newline at end of file
@@ -1,23 +1,64 @@
 #include "../eigen-3.4.0/Eigen/Dense"
+#include <cmath>
+
+#include "Scalar.h"
 
 #ifndef Ray_H
 #define Ray_H
 
 /**
  * Classe para representar os raios de visão.
+ *
+ * O raio é o conjunto dos pontos initialPoint + t * direction com tMin < t < tMax, e as
+ * interseções só são aceitas dentro desse intervalo. O inverso da direção e os sinais
+ * dos seus componentes ficam pré-calculados para os testes de slabs das caixas.
  */
 class Ray
 {
 public:
-	Eigen::Vector3d initialPoint; /**< Ponto inicial do raio. */
-	Eigen::Vector3d direction;   /**< Direção do raio. */
+	Vector3 initialPoint; /**< Ponto inicial do raio. */
+	Vector3 direction;    /**< Direção (unitária) do raio: t cresce à frente. */
+	Vector3 invDirection; /**< Inverso, componente a componente, da direção. */
+	int sign[3];          /**< 1 se o componente correspondente de invDirection é negativo, 0 caso contrário. */
+	Scalar tMin;          /**< Início do intervalo de interesse (exclusivo). */
+	Scalar tMax;          /**< Fim do intervalo de interesse (exclusivo). */
+	Scalar spread;        /**< Largura do feixe do pixel a cada unidade de t (0 nos raios que não vêm de um pixel). */
+
+	/**
+	 * Construtor da classe Ray: raio de initialPoint passando por point, com t em (0, infinito).
+	 * @param initialPoint Ponto inicial do raio.
+	 * @param point Ponto pelo qual o raio passa.
+	 */
+	Ray(Vector3 initialPoint, Vector3 point);
+
+	/**
+	 * Construtor vazio, para vetores de raios preenchidos depois (como os pacotes do Canvas).
+	 */
+	Ray();
 
 	/**
-	 * Construtor da classe Ray.
+	 * Cria um raio a partir da origem e de uma direção já unitária (sem normalizar de novo).
 	 * @param initialPoint Ponto inicial do raio.
-	 * @param direction Direção do raio.
+	 * @param direction Direção unitária do raio.
+	 * @param tMin Início do intervalo de interesse.
+	 * @param tMax Fim do intervalo de interesse.
+	 * @return O raio.
+	 */
+	static Ray fromDirection(const Vector3& initialPoint, const Vector3& direction, Scalar tMin = 0, Scalar tMax = INFINITY);
+
+	/**
+	 * Verifica se o parâmetro t está dentro do intervalo do raio.
+	 * @param t O parâmetro.
+	 * @return true se tMin < t < tMax.
 	 */
-	Ray(Eigen::Vector3d initialPoint, Eigen::Vector3d direction);
+	bool contains(Scalar t) const
+	{
+		return t > this->tMin && t < this->tMax;
+	}
+
+private:
+	// Calcula invDirection e sign a partir de direction
+	void updateInverse();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "RenderScene.h"
+#include "PontualSource.h"
+#include <algorithm>
+
+/**
+ * @brief Compila a cena para a câmera da própria cena.
+ *
+ * @param scene A cena de autoria.
+ */
+RenderScene::RenderScene(const Scene& scene)
+{
+	Matrix4 toCamera = Matrix4::Identity();
+	if (scene.camera != NULL)
+	{
+		toCamera = scene.camera->getTransformationMatrix();
+	}
+
+	for (auto& o : scene.getAllObjects())
+	{
+		Object* copy = o->clone();
+		copy->convertToCamera(toCamera);
+		this->objects.push_back(copy);
+		this->originals.push_back(o);
+	}
+
+	for (auto& s : scene.sources)
+	{
+		LightSource* copy = s->clone();
+		copy->convertToCamera(toCamera);
+		this->sources.push_back(copy);
+	}
+	this->lights.build(this->sources);
+
+	this->materials = scene.materials;
+
+	// Poucas esferas: um teste vetorial de todas sai mais barato que percorrê-las na BVH
+	std::vector<Object*> others;
+	std::vector<Sphere*> sphereList;
+	for (auto& o : this->objects)
+	{
+		Sphere* sphere = dynamic_cast<Sphere*>(o);
+		if (sphere != NULL)
+		{
+			sphereList.push_back(sphere);
+		}
+		else
+		{
+			others.push_back(o);
+		}
+	}
+
+	if ((int)sphereList.size() <= SPHERE_SET_LIMIT)
+	{
+		for (auto& sphere : sphereList)
+		{
+			this->spheres.add(sphere);
+		}
+		this->bvhObjects = others;
+	}
+	else
+	{
+		this->bvhObjects = this->objects;
+	}
+	this->bvh.build(this->bvhObjects);
+}
+
+/**
+ * @brief Libera as cópias dos objetos e das fontes de luz.
+ */
+RenderScene::~RenderScene()
+{
+	for (auto& o : this->objects)
+	{
+		delete o;
+	}
+	for (auto& s : this->sources)
+	{
+		delete s;
+	}
+	for (auto& map : this->shadowMaps)
+	{
+		delete map;
+	}
+}
+
+/**
+ * @brief Obtém as fontes de luz em coordenadas de câmera.
+ */
+const std::vector<LightSource*>& RenderScene::getSources() const
+{
+	return this->sources;
+}
+
+/**
+ * @brief Obtém a tabela de materiais.
+ */
+const MaterialTable& RenderScene::getMaterials() const
+{
+	return this->materials;
+}
+
+/**
+ * @brief Altera um material da cena compilada.
+ */
+void RenderScene::setMaterial(int index, const Material& material)
+{
+	this->materials.set(index, material);
+}
+
+/**
+ * @brief Obtém o índice que escolhe as fontes avaliadas em cada ponto.
+ */
+const LightIndex& RenderScene::getLightIndex() const
+{
+	return this->lights;
+}
+
+/**
+ * @brief Liga ou desliga o descarte das fontes pelo raio de influência.
+ */
+void RenderScene::setLightCulling(bool culling)
+{
+	this->lights.setCulling(culling);
+}
+
+/**
+ * @brief Define quantas fontes pontuais são avaliadas por ponto antes do sorteio.
+ */
+void RenderScene::setMaxLights(int maxLights)
+{
+	this->lights.setMaxLights(maxLights);
+}
+
+/**
+ * @brief Obtém o número de objetos compilados.
+ */
+int RenderScene::getNumObjects() const
+{
+	return this->objects.size();
+}
+
+/**
+ * @brief Encontra o objeto mais próximo atingido pelo raio.
+ */
+bool RenderScene::intersect(const Ray& ray, HitRecord* hit, Object** object) const
+{
+	bool found = this->bvh.intersect(ray, hit, object);
+
+	// As esferas só interessam antes da interseção da BVH (que vence os empates)
+	Ray segment = ray;
+	if (found)
+	{
+		segment.tMax = hit->t;
+	}
+
+	HitRecord sphereHit;
+	int index;
+	if (this->spheres.size() > 0 && this->spheres.intersect(segment, &sphereHit, &index))
+	{
+		*hit = sphereHit;
+		*object = this->spheres.get(index);
+		found = true;
+	}
+
+	return found;
+}
+
+/**
+ * @brief Encontra o objeto mais próximo atingido por cada raio do pacote.
+ *
+ * A BVH trata o pacote inteiro; as esferas do SphereSet são testadas raio a raio, com a mesma
+ * regra de intersect para escolher entre as duas.
+ */
+void RenderScene::intersectPacket(const Ray* rays, int count, HitRecord* hits, Object** objects, bool* found) const
+{
+	this->bvh.intersectPacket(rays, count, hits, objects, found);
+
+	if (this->spheres.size() == 0)
+	{
+		return;
+	}
+
+	HitRecord sphereHit;
+	int index;
+	for (int i = 0; i < count; i++)
+	{
+		Ray segment = rays[i];
+		if (found[i])
+		{
+			segment.tMax = hits[i].t;
+		}
+
+		if (this->spheres.intersect(segment, &sphereHit, &index))
+		{
+			hits[i] = sphereHit;
+			objects[i] = this->spheres.get(index);
+			found[i] = true;
+		}
+	}
+}
+
+/**
+ * @brief Verifica se algum objeto bloqueia o segmento.
+ */
+bool RenderScene::occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+{
+	return (this->spheres.size() > 0 && this->spheres.occluded(origin, direction, tMax)) || this->bvh.occluded(origin, direction, tMax);
+}
+
+/**
+ * @brief Constrói um mapa cúbico de oclusão para cada fonte pontual.
+ */
+void RenderScene::buildShadowMaps(int resolution)
+{
+	for (auto& map : this->shadowMaps)
+	{
+		delete map;
+	}
+	this->shadowMaps.clear();
+
+	if (resolution <= 0)
+	{
+		return;
+	}
+
+	// As outras fontes não têm uma origem única para os raios de sombra
+	for (auto& s : this->sources)
+	{
+		ShadowCubeMap* map = NULL;
+		if (dynamic_cast<PontualSource*>(s) != NULL)
+		{
+			map = new ShadowCubeMap();
+			map->build(s->origin, this->bvhObjects, resolution);
+		}
+		this->shadowMaps.push_back(map);
+	}
+}
+
+/**
+ * @brief Verifica se algum objeto bloqueia o segmento que sai da fonte.
+ */
+bool RenderScene::sourceOccluded(int source, const Vector3& direction, Scalar tMax) const
+{
+	if (source < (int)this->shadowMaps.size() && this->shadowMaps[source] != NULL)
+	{
+		const Vector3& origin = this->sources[source]->origin;
+		return (this->spheres.size() > 0 && this->spheres.occluded(origin, direction, tMax)) || this->shadowMaps[source]->occluded(direction, tMax);
+	}
+
+	return this->occluded(this->sources[source]->origin, direction, tMax);
+}
+
+/**
+ * @brief Encontra o objeto de autoria mais próximo atingido pelo raio.
+ */
+const Object* RenderScene::pick(const Ray& ray) const
+{
+	HitRecord hit;
+	Object* object;
+
+	if (!this->intersect(ray, &hit, &object))
+	{
+		return NULL;
+	}
+
+	int index = std::find(this->objects.begin(), this->objects.end(), object) - this->objects.begin();
+	return this->originals[index];
+}
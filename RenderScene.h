@@ -0,0 +1,178 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <vector>
+
+#include "BVH.h"
+#include "LightIndex.h"
+#include "LightSource.h"
+#include "MaterialTable.h"
+#include "Object.h"
+#include "Ray.h"
+#include "Scalar.h"
+#include "Scene.h"
+#include "ShadowCubeMap.h"
+#include "SphereSet.h"
+
+#ifndef RenderScene_H
+#define RenderScene_H
+
+/**
+ * @brief Cena compilada para renderização.
+ *
+ * É construída a partir de uma Scene e da sua câmera: cada objeto e cada fonte de luz é copiado
+ * e a cópia é convertida para coordenadas de câmera, e a BVH é construída sobre as cópias.
+ * Em cenas com poucas esferas (até SPHERE_SET_LIMIT) elas ficam fora da BVH, num SphereSet,
+ * que as testa todas de uma vez com instruções vetoriais.
+ * Os objetos da Scene (de autoria) não são alterados, então a câmera pode se mover e a cena pode
+ * ser compilada de novo a qualquer momento. Depois de construída, a RenderScene não muda e pode
+ * ser lida por várias threads ao mesmo tempo.
+ *
+ * Opcionalmente, buildShadowMaps constrói um ShadowCubeMap para cada fonte pontual sobre os objetos
+ * da BVH, e os testes de sombra dessas fontes (sourceOccluded) passam a consultar o mapa em vez da
+ * BVH. As esferas do SphereSet continuam no SphereSet, que é quem define a aritmética do teste delas.
+ *
+ * As fontes de luz ficam num LightIndex, que escolhe as fontes avaliadas em cada ponto sombreado.
+ * Os materiais são uma cópia da tabela da Scene: editar a cena depois da compilação não altera a
+ * RenderScene, e setMaterial altera só a cópia.
+ */
+class RenderScene
+{
+public:
+	static const int SPHERE_SET_LIMIT = 64; /**< Acima disso as esferas ficam na BVH, que escala melhor */
+
+	/**
+	 * @brief Compila a cena para a câmera da própria cena.
+	 *
+	 * @param scene A cena de autoria. Sem câmera, os objetos ficam nas coordenadas do mundo.
+	 */
+	RenderScene(const Scene& scene);
+
+	/**
+	 * @brief Libera as cópias dos objetos e das fontes de luz.
+	 */
+	~RenderScene();
+
+	RenderScene(const RenderScene&) = delete;
+	RenderScene& operator=(const RenderScene&) = delete;
+
+	/**
+	 * @brief Obtém as fontes de luz em coordenadas de câmera.
+	 */
+	const std::vector<LightSource*>& getSources() const;
+
+	/**
+	 * @brief Obtém o índice que escolhe as fontes avaliadas em cada ponto.
+	 */
+	const LightIndex& getLightIndex() const;
+
+	/**
+	 * @brief Obtém a tabela de materiais (cópia da tabela da cena de autoria).
+	 */
+	const MaterialTable& getMaterials() const;
+
+	/**
+	 * @brief Altera um material da cena compilada (e de todos os objetos que o usam).
+	 *
+	 * Só muda o sombreamento: um G-buffer já traçado continua valendo. Não pode ser chamado durante uma renderização.
+	 *
+	 * @param index O índice do material.
+	 * @param material Os novos coeficientes.
+	 */
+	void setMaterial(int index, const Material& material);
+
+	/**
+	 * @brief Liga ou desliga o descarte das fontes cujo raio de influência não alcança o ponto.
+	 *
+	 * Não muda a imagem, só o custo. Não pode ser chamado durante uma renderização.
+	 */
+	void setLightCulling(bool culling);
+
+	/**
+	 * @brief Define quantas fontes pontuais são avaliadas por ponto antes de passar ao sorteio na árvore de fontes.
+	 *
+	 * Não pode ser chamado durante uma renderização.
+	 *
+	 * @param maxLights O limite (0 = avaliar sempre todas).
+	 */
+	void setMaxLights(int maxLights);
+
+	/**
+	 * @brief Obtém o número de objetos compilados (os das hitboxes inclusive).
+	 */
+	int getNumObjects() const;
+
+	/**
+	 * @brief Encontra o objeto mais próximo atingido pelo raio.
+	 *
+	 * @param ray O raio, em coordenadas de câmera.
+	 * @param hit Registro a ser preenchido com a interseção mais próxima.
+	 * @param object Ponteiro para armazenar o objeto (compilado) atingido.
+	 * @return true se algum objeto foi atingido.
+	 */
+	bool intersect(const Ray& ray, HitRecord* hit, Object** object) const;
+
+	/**
+	 * @brief Encontra o objeto mais próximo atingido por cada raio de um pacote (até BVH::MAX_PACKET raios).
+	 *
+	 * Dá o mesmo resultado de intersect em cada raio; os raios percorrem a BVH juntos.
+	 *
+	 * @param rays Os raios, em coordenadas de câmera.
+	 * @param count O número de raios.
+	 * @param hits Registros a serem preenchidos, um por raio.
+	 * @param objects Objetos (compilados) atingidos, um por raio.
+	 * @param found Indica, para cada raio, se algum objeto foi atingido.
+	 */
+	void intersectPacket(const Ray* rays, int count, HitRecord* hits, Object** objects, bool* found) const;
+
+	/**
+	 * @brief Verifica se algum objeto bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 *
+	 * @param origin A origem do segmento, em coordenadas de câmera.
+	 * @param direction A direção (unitária) do segmento.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se o segmento estiver bloqueado.
+	 */
+	bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const;
+
+	/**
+	 * @brief Constrói um mapa cúbico de oclusão para cada fonte pontual (e descarta os anteriores).
+	 *
+	 * Não pode ser chamado durante uma renderização. Os mapas valem para as posições atuais
+	 * das fontes; se uma fonte for movida, os mapas devem ser construídos de novo.
+	 *
+	 * @param resolution Texels por lado de cada face (0 só descarta os mapas).
+	 */
+	void buildShadowMaps(int resolution = ShadowCubeMap::DEFAULT_RESOLUTION);
+
+	/**
+	 * @brief Verifica se algum objeto bloqueia o segmento que sai da fonte source na direção direction.
+	 *
+	 * Usa o mapa cúbico da fonte, se houver, e senão occluded. O resultado é o mesmo nos dois casos.
+	 *
+	 * @param source O índice da fonte em getSources().
+	 * @param direction A direção (unitária) do segmento, a partir da fonte.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se o segmento estiver bloqueado.
+	 */
+	bool sourceOccluded(int source, const Vector3& direction, Scalar tMax) const;
+
+	/**
+	 * @brief Encontra o objeto de autoria mais próximo atingido pelo raio (para seleção com o mouse).
+	 *
+	 * @param ray O raio, em coordenadas de câmera.
+	 * @return O objeto da Scene original atingido, ou NULL.
+	 */
+	const Object* pick(const Ray& ray) const;
+
+private:
+	std::vector<Object*> objects;         // Cópias em coordenadas de câmera
+	std::vector<const Object*> originals; // Objeto de autoria correspondente a cada cópia
+	std::vector<LightSource*> sources;    // Cópias das fontes em coordenadas de câmera
+	LightIndex lights;                    // Grade e árvore das fontes
+	MaterialTable materials;              // Cópia da tabela de materiais da cena
+	std::vector<Object*> bvhObjects;      // Objetos da BVH (todos, menos as esferas do SphereSet)
+	BVH bvh;                              // Todos os objetos, menos as esferas do SphereSet
+	SphereSet spheres;                    // Esferas testadas de uma vez (vazio em cenas com muitas esferas)
+	std::vector<ShadowCubeMap*> shadowMaps; // Mapa de cada fonte (NULL se não for pontual ou sem buildShadowMaps)
+};
+
+#endif
@@ -0,0 +1,27 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+
+#ifndef Scalar_H
+#define Scalar_H
+
+/**
+ * @brief Tipo de ponto flutuante da geometria, dos raios e do sombreamento.
+ *
+ * É escolhido na compilação: double por padrão e float com CG_SCALAR_FLOAT (no CMake,
+ * -DCG_SCALAR=float). Em float os vetores ocupam metade da memória e cabem o dobro de
+ * componentes em cada registrador SIMD, ao custo de precisão nas interseções; os dois
+ * builds renderizam as mesmas cenas, para comparar vazão e diferença nas imagens.
+ */
+#ifdef CG_SCALAR_FLOAT
+typedef float Scalar;
+#else
+typedef double Scalar;
+#endif
+
+typedef Eigen::Matrix<Scalar, 2, 1> Vector2;                          /**< Vetor 2D (coordenadas de textura) */
+typedef Eigen::Matrix<Scalar, 3, 1> Vector3;                          /**< Ponto, direção ou cor */
+typedef Eigen::Matrix<Scalar, 4, 1> Vector4;                          /**< Ponto em coordenadas homogêneas */
+typedef Eigen::Matrix<Scalar, 4, 4> Matrix4;                          /**< Transformação em coordenadas homogêneas */
+typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> MatrixX; /**< Matriz de tamanho dinâmico */
+typedef Eigen::Array<Scalar, Eigen::Dynamic, Eigen::Dynamic> ArrayXX;  /**< Canal de imagem do Tensor */
+
+#endif
@@ -4,11 +4,29 @@
 /**
  * @brief Construtor da classe Scene.
  */
+Scene::Scene()
+{
+	this->camera = NULL;
+}
+
+/**
+ * @brief Adiciona um objeto à cena.
+ */
 void Scene::addObject(Object* object)
 {
 	this->objects.push_back(object);
 }
 
+/**
+ * @brief Acrescenta um material à cena.
+ * @param material O material.
+ * @return O índice do material.
+ */
+int Scene::addMaterial(const Material& material)
+{
+	return this->materials.add(material);
+}
+
 /**
  * @brief Obtém o objeto da cena que é atingido pelo raio.
  * @param ray O raio que atinge o objeto.
@@ -120,4 +138,18 @@ int Scene::getNumElements()
 int Scene::getNumHitBoxes()
 {
 	return (this->hitboxes).size();
+}
+
+/**
+ * @brief Obtém todos os objetos da cena, incluindo os que estão dentro das hitboxes.
+ * @return Os objetos da cena.
+ */
+std::vector<Object*> Scene::getAllObjects() const
+{
+	std::vector<Object*> all(this->objects);
+	for (auto& h : this->hitboxes)
+	{
+		all.insert(all.end(), h->objects.begin(), h->objects.end());
+	}
+	return all;
 }
\ No newline at end of file
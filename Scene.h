@@ -3,6 +3,7 @@
 #include "HitBox.h"
 #include "LightSource.h"
 #include "Camera.h"
+#include "MaterialTable.h"
 
 #ifndef Scene_H
 #define Scene_H
@@ -21,6 +22,22 @@ public:
 	std::vector<HitBox*> hitboxes;      ///< Vetor de hitboxes da cena.
 	std::vector<LightSource*> sources;  ///< Vetor de fontes de luz da cena.
 	Camera* camera;                     ///< Ponteiro para a câmera da cena.
+	MaterialTable materials;            ///< Materiais referenciados pelos objetos da cena.
+
+	/**
+	 * @brief Acrescenta um material à cena.
+	 * 
+	 * Os objetos construídos com o índice devolvido compartilham o material.
+	 * 
+	 * @param material O material.
+	 * @return O índice do material em materials.
+	 */
+	int addMaterial(const Material& material);
+
+	/**
+	 * @brief Cria uma cena vazia, sem câmera (os objetos ficam nas coordenadas do mundo).
+	 */
+	Scene();
 
 	/**
 	 * @brief Adiciona um objeto à cena.
@@ -33,6 +50,9 @@ public:
 	/**
 	 * @brief Adiciona uma hitbox à cena.
 	 * 
+	 * Não é mais necessário: os objetos são envolvidos automaticamente por caixas delimitadoras.
+	 * Os objetos da hitbox são tratados como se tivessem sido adicionados com addObject.
+	 * 
 	 * @param hitbox Ponteiro para a hitbox a ser adicionada.
 	 */
 	void addHitBox(HitBox* hitbox);
@@ -76,6 +96,15 @@ public:
 	 * @return O número de hitboxes da cena.
 	 */
 	int getNumHitBoxes();
+
+	/**
+	 * @brief Obtém todos os objetos da cena, incluindo os que estão dentro das hitboxes.
+	 * 
+	 * Os objetos soltos vêm primeiro, seguidos pelos objetos de cada hitbox, na ordem em que foram adicionados.
+	 * 
+	 * @return Os objetos da cena.
+	 */
+	std::vector<Object*> getAllObjects() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "SeasonsScene.h"
+
+#include <cstring>
+
+#include "AmbientSource.h"
+#include "Camera.h"
+#include "Cilinder.h"
+#include "Cone.h"
+#include "Cube.h"
+#include "Plane.h"
+#include "PontualSource.h"
+#include "Sphere.h"
+
+/**
+ * @brief Monta a cena das estações: céu, gramado, pinheiros, carvalhos, mesa e botões.
+ *
+ * @param scene A cena a ser preenchida.
+ * @param season A estação (SPRING, SUMMER, AUTUMN ou WINTER).
+ * @param grassTexture Textura do gramado, ou NULL para usar só a cor difusa.
+ */
+void buildSeasonsScene(Scene& scene, Season season, const Texture* grassTexture)
+{
+	// Cor das folhas dos carvalhos em cada estação
+	Vector3 leafColors[4] = { Vector3(255, 72, 132), Vector3(12, 242, 0), Vector3(240, 104, 4), Vector3(255, 255, 255) };
+	// Cor de cada botão de estação
+	Vector3 buttonColors[4] = { Vector3(255, 72, 132), Vector3(12, 242, 0), Vector3(240, 104, 4), Vector3(44, 157, 201) };
+
+	Vector3 sky(32, 116, 219), black(0, 0, 0), brown(50, 31, 20), green(10, 156, 53), leaves = leafColors[season];
+	Scalar z[3] = { -230, -300, -160 };
+
+	// Materiais: os objetos que recebem o mesmo índice compartilham os coeficientes
+	int skyMaterial = scene.addMaterial(Material(sky, sky, black, 0));
+	int grassMaterial = scene.addMaterial(Material(black, Vector3(100, 100, 100), black, 0));
+	int pineMaterial = scene.addMaterial(Material(green, green, black, 0));
+	int woodMaterial = scene.addMaterial(Material(brown, brown, black, 0));
+	int leafMaterial = scene.addMaterial(Material(leaves, leaves, black, 0));
+	int tableMaterial = scene.addMaterial(Material(brown, brown, Vector3(0.3, 0.3, 0.3), 10));
+
+	scene.addObject(new Plane(NULL, Vector3(0, 0, 1), Vector3(0, 0, -1000), skyMaterial));
+	scene.addObject(new Plane(NULL, Vector3(1, 0, 0), Vector3(-1000, 0, 0), skyMaterial));
+	scene.addObject(new Plane(NULL, Vector3(-1, 0, 0), Vector3(1000, 0, 0), skyMaterial));
+	scene.addObject(new Plane(NULL, Vector3(0, -1, 0), Vector3(0, 1000, 0), skyMaterial));
+	scene.addObject(new Plane(grassTexture, Vector3(0, 1, 0), Vector3(0, -100, 0), grassMaterial));
+
+	for (int i = 0; i < 3; i++)
+	{
+		scene.addObject(new Cone(30, 50, Vector3(-130, -40, z[i]), Vector3(0, 1, 0), pineMaterial));
+		scene.addObject(new Cilinder(10, 60, Vector3(-130, -100, z[i]), Vector3(0, 1, 0), woodMaterial));
+		scene.addObject(new Sphere(30, Vector3(130, -30, z[i]), leafMaterial));
+		scene.addObject(new Sphere(22, Vector3(130, 0, z[i]), leafMaterial));
+		scene.addObject(new Cilinder(10, 60, Vector3(130, -100, z[i]), Vector3(0, 1, 0), woodMaterial));
+	}
+
+	scene.addObject(new Cube(Vector3(-50, -80, -180), 100, 10, 100, tableMaterial));
+	scene.addObject(new Cube(Vector3(-50, -100, -180), 10, 20, 10, tableMaterial));
+	scene.addObject(new Cube(Vector3(40, -100, -180), 10, 20, 10, tableMaterial));
+	scene.addObject(new Cube(Vector3(-50, -100, -265), 10, 20, 10, tableMaterial));
+	scene.addObject(new Cube(Vector3(40, -100, -265), 10, 20, 10, tableMaterial));
+
+	// Boneco de neve (Roger), só no inverno
+	if (season == WINTER)
+	{
+		Vector3 white(255, 255, 255);
+		int snowMaterial = scene.addMaterial(Material(white, white, black, 0));
+		int eyeMaterial = scene.addMaterial(Material(brown, brown, black, 0));
+		scene.addObject(new Sphere(30, Vector3(0, -70, -380), snowMaterial));
+		scene.addObject(new Sphere(20, Vector3(0, -30, -380), snowMaterial));
+		scene.addObject(new Sphere(5, Vector3(-10, -20, -365), eyeMaterial));
+		scene.addObject(new Sphere(5, Vector3(10, -20, -365), eyeMaterial));
+	}
+
+	// Botões das estações, cada um com o seu material
+	Vector3 buttonSpecular(40, 40, 40);
+	Scalar buttonX[4] = { -40, -13.3, 13.3, 40 };
+	for (int i = 0; i < 4; i++)
+	{
+		int buttonMaterial = scene.addMaterial(Material(buttonColors[i], buttonColors[i], buttonSpecular, 6));
+		scene.addObject(new Sphere(10, Vector3(buttonX[i], -60, -230), buttonMaterial));
+	}
+
+	scene.addSource(new PontualSource(Vector3(-30, 60, 0), Vector3(0.7, 0.7, 0.7)));
+	scene.addSource(new AmbientSource(Vector3(0.3, 0.3, 0.3)));
+	scene.setCamera(new Camera(Vector3(0, -20, -350), Vector3(0, -20, 0), Vector3(0, 1, 0)));
+}
+
+/**
+ * @brief Converte o nome de uma estação ("spring", "summer", "autumn"/"fall", "winter").
+ *
+ * @param name O nome da estação.
+ * @param season Ponteiro para armazenar a estação.
+ * @return true se o nome é válido.
+ */
+bool parseSeason(const char* name, Season* season)
+{
+	if (strcmp(name, "spring") == 0)
+	{
+		*season = SPRING;
+	}
+	else if (strcmp(name, "summer") == 0)
+	{
+		*season = SUMMER;
+	}
+	else if (strcmp(name, "autumn") == 0 || strcmp(name, "fall") == 0)
+	{
+		*season = AUTUMN;
+	}
+	else if (strcmp(name, "winter") == 0)
+	{
+		*season = WINTER;
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Nome do arquivo de textura do gramado de cada estação.
+ *
+ * @param season A estação.
+ * @return O nome do arquivo, relativo à raiz do repositório.
+ */
+const char* seasonTextureFile(Season season)
+{
+	const char* files[4] = { "spring.png", "summer.png", "fall.png", "winter.png" };
+	return files[season];
+}
@@ -0,0 +1,47 @@
+#include "Scene.h"
+#include "Texture.h"
+
+#ifndef SeasonsScene_H
+#define SeasonsScene_H
+
+/**
+ * @brief Estações da cena (mesma numeração do main.cpp).
+ */
+enum Season
+{
+	SPRING = 0,
+	SUMMER = 1,
+	AUTUMN = 2,
+	WINTER = 3
+};
+
+/**
+ * @brief Monta a cena das estações: céu, gramado, pinheiros, carvalhos, mesa e botões.
+ *
+ * Mesma geometria, materiais, fontes de luz e câmera do main.cpp. A estação muda a cor das
+ * folhas dos carvalhos e, no inverno, acrescenta o boneco de neve.
+ *
+ * @param scene A cena a ser preenchida.
+ * @param season A estação (SPRING, SUMMER, AUTUMN ou WINTER).
+ * @param grassTexture Textura do gramado, ou NULL para usar só a cor difusa; deve existir enquanto a cena existir.
+ */
+void buildSeasonsScene(Scene& scene, Season season = SUMMER, const Texture* grassTexture = NULL);
+
+/**
+ * @brief Converte o nome de uma estação ("spring", "summer", "autumn"/"fall", "winter").
+ *
+ * @param name O nome da estação.
+ * @param season Ponteiro para armazenar a estação.
+ * @return true se o nome é válido.
+ */
+bool parseSeason(const char* name, Season* season);
+
+/**
+ * @brief Nome do arquivo de textura do gramado de cada estação (ex.: "summer.png").
+ *
+ * @param season A estação.
+ * @return O nome do arquivo, relativo à raiz do repositório.
+ */
+const char* seasonTextureFile(Season season);
+
+#endif
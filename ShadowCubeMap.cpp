@@ -0,0 +1,348 @@
+#include "ShadowCubeMap.h"
+#include "Plane.h"
+#include <algorithm>
+#include <cmath>
+#include <typeinfo>
+
+// Folga relativa do limite inferior de distância, maior que o erro de arredondamento das interseções
+static const Scalar DISTANCE_SLACK = (Scalar)1e-4;
+
+/**
+ * @brief Constrói um mapa vazio.
+ */
+ShadowCubeMap::ShadowCubeMap()
+{
+	this->origin << 0, 0, 0;
+	this->resolution = 1;
+	this->offsets.assign(6 + 1, 0);
+}
+
+/**
+ * @brief Direção do ponto (u, v) da face. A face 2 * eixo aponta para +eixo e a face 2 * eixo + 1 para -eixo;
+ * u e v são as coordenadas dos dois eixos seguintes, em ordem cíclica.
+ */
+Vector3 ShadowCubeMap::faceDirection(int face, Scalar u, Scalar v)
+{
+	int a = face / 2;
+	Vector3 d;
+	d[a] = face % 2 == 0 ? 1 : -1;
+	d[(a + 1) % 3] = u;
+	d[(a + 2) % 3] = v;
+	return d;
+}
+
+/**
+ * @brief Índice do texel da direção d: a face do eixo de maior módulo e a posição na face.
+ */
+int ShadowCubeMap::texelOf(const Vector3& d) const
+{
+	int a = 0;
+	if (std::abs(d[1]) > std::abs(d[a]))
+		a = 1;
+	if (std::abs(d[2]) > std::abs(d[a]))
+		a = 2;
+
+	Scalar major = std::abs(d[a]);
+	int face = 2 * a + (d[a] < 0 ? 1 : 0);
+
+	Scalar x = (d[(a + 1) % 3] / major + 1) * (Scalar)0.5 * this->resolution;
+	Scalar y = (d[(a + 2) % 3] / major + 1) * (Scalar)0.5 * this->resolution;
+
+	// Os limites também mandam NaN para o primeiro texel
+	int column = !(x > 0) ? 0 : x >= this->resolution ? this->resolution - 1 : (int)x;
+	int line = !(y > 0) ? 0 : y >= this->resolution ? this->resolution - 1 : (int)y;
+
+	return (face * this->resolution + line) * this->resolution + column;
+}
+
+/**
+ * @brief Marca os texels da face que a caixa (em coordenadas relativas à origem) pode cobrir.
+ *
+ * Se a caixa está toda à frente da face, o retângulo que contém a projeção dos seus cantos,
+ * aumentado em um texel de cada lado, é marcado. Senão cada texel, aumentado em um texel, é
+ * testado como uma pirâmide com vértice na origem contra a caixa.
+ */
+void ShadowCubeMap::rasterizeBox(const AABB& box, int face, std::vector<int>* texels) const
+{
+	int a = face / 2, b = (a + 1) % 3, c = (a + 2) % 3;
+	Scalar sign = face % 2 == 0 ? 1 : -1;
+	int n = this->resolution;
+	Scalar texel = (Scalar)2 / n;
+
+	// Menor valor da coordenada da face entre os cantos
+	Scalar nearest = std::min(sign * box.min[a], sign * box.max[a]);
+
+	if (nearest > 0)
+	{
+		Scalar uMin = INFINITY, uMax = -INFINITY, vMin = INFINITY, vMax = -INFINITY;
+		for (int k = 0; k < 8; k++)
+		{
+			Vector3 p((k & 1) ? box.max[0] : box.min[0], (k & 2) ? box.max[1] : box.min[1], (k & 4) ? box.max[2] : box.min[2]);
+			Scalar m = sign * p[a];
+			uMin = std::min(uMin, p[b] / m);
+			uMax = std::max(uMax, p[b] / m);
+			vMin = std::min(vMin, p[c] / m);
+			vMax = std::max(vMax, p[c] / m);
+		}
+
+		if (uMax < -1 - texel || uMin > 1 + texel || vMax < -1 - texel || vMin > 1 + texel)
+		{
+			return;
+		}
+
+		int columnMin = std::max(0, (int)std::floor((uMin + 1) / texel) - 1);
+		int columnMax = std::min(n - 1, (int)std::floor((uMax + 1) / texel) + 1);
+		int lineMin = std::max(0, (int)std::floor((vMin + 1) / texel) - 1);
+		int lineMax = std::min(n - 1, (int)std::floor((vMax + 1) / texel) + 1);
+
+		for (int line = lineMin; line <= lineMax; line++)
+		{
+			for (int column = columnMin; column <= columnMax; column++)
+			{
+				texels->push_back((face * n + line) * n + column);
+			}
+		}
+		return;
+	}
+
+	// Maior valor de normal . p sobre a caixa
+	auto maxOver = [&](const Vector3& normal)
+	{
+		Scalar sum = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			sum += std::max(normal[i] * box.min[i], normal[i] * box.max[i]);
+		}
+		return sum;
+	};
+
+	for (int line = 0; line < n; line++)
+	{
+		Scalar v0 = -1 + (line - 1) * texel, v1 = -1 + (line + 2) * texel;
+
+		for (int column = 0; column < n; column++)
+		{
+			Scalar u0 = -1 + (column - 1) * texel, u1 = -1 + (column + 2) * texel;
+
+			// Os quatro semiespaços da pirâmide: u0 <= p[b] / m <= u1 e v0 <= p[c] / m <= v1, com m = sign * p[a]
+			Vector3 planes[4];
+			for (auto& plane : planes)
+			{
+				plane << 0, 0, 0;
+			}
+			planes[0][b] = 1;
+			planes[0][a] = -u0 * sign;
+			planes[1][b] = -1;
+			planes[1][a] = u1 * sign;
+			planes[2][c] = 1;
+			planes[2][a] = -v0 * sign;
+			planes[3][c] = -1;
+			planes[3][a] = v1 * sign;
+
+			bool inside = true;
+			for (auto& plane : planes)
+			{
+				if (maxOver(plane) < 0)
+				{
+					inside = false;
+					break;
+				}
+			}
+
+			if (inside)
+			{
+				texels->push_back((face * n + line) * n + column);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Marca os texels da face em que o plano pode ser atingido.
+ *
+ * Plane::occluded só aceita s > 0, ou seja, normal . direction com sinal oposto a normal . (origem - centro).
+ * Como normal . direction é linear, basta que um dos cantos do texel (aumentado em um texel) tenha esse sinal.
+ */
+void ShadowCubeMap::rasterizePlane(const Vector3& normal, const Vector3& center, int face, std::vector<int>* texels) const
+{
+	Scalar side = normal.dot(this->origin - center);
+	int n = this->resolution;
+	Scalar texel = (Scalar)2 / n;
+
+	// A fonte está no plano: s nunca é positivo
+	if (side == 0)
+	{
+		return;
+	}
+
+	for (int line = 0; line < n; line++)
+	{
+		Scalar v0 = -1 + (line - 1) * texel, v1 = -1 + (line + 2) * texel;
+
+		for (int column = 0; column < n; column++)
+		{
+			Scalar u0 = -1 + (column - 1) * texel, u1 = -1 + (column + 2) * texel;
+
+			Scalar corners[4] = {
+				normal.dot(faceDirection(face, u0, v0)), normal.dot(faceDirection(face, u1, v0)),
+				normal.dot(faceDirection(face, u0, v1)), normal.dot(faceDirection(face, u1, v1))
+			};
+
+			for (Scalar corner : corners)
+			{
+				if (side * corner < 0)
+				{
+					texels->push_back((face * n + line) * n + column);
+					break;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief Constrói o mapa: projeta cada objeto nas seis faces e monta as listas de candidatos.
+ */
+void ShadowCubeMap::build(const Vector3& origin, const std::vector<Object*>& objects, int resolution)
+{
+	this->origin = origin;
+	this->resolution = std::max(1, resolution);
+
+	int n = this->resolution;
+	int numTexels = 6 * n * n;
+
+	// Limite inferior da distância de cada objeto e os texels que ele cobre
+	struct Entry
+	{
+		Object* object;
+		Scalar distance;
+		std::vector<int> texels;
+	};
+
+	std::vector<Entry> entries(objects.size());
+
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		Entry& entry = entries[i];
+		entry.object = objects[i];
+
+		AABB box;
+		if (objects[i]->getBounds(&box))
+		{
+			AABB relative;
+			relative.min = box.min - origin;
+			relative.max = box.max - origin;
+
+			// Distância da origem até a caixa (zero se a origem está dentro)
+			Vector3 closest = Vector3::Zero().cwiseMax(relative.min).cwiseMin(relative.max);
+			entry.distance = closest.norm() * (1 - DISTANCE_SLACK);
+
+			for (int face = 0; face < 6; face++)
+			{
+				this->rasterizeBox(relative, face, &entry.texels);
+			}
+		}
+		else if (typeid(*objects[i]) == typeid(Plane))
+		{
+			const Plane* plane = static_cast<const Plane*>(objects[i]);
+
+			// |normal . d| <= |normal| para d unitário
+			entry.distance = std::abs(plane->normal.dot(origin - plane->center)) / plane->normal.norm() * (1 - DISTANCE_SLACK);
+
+			for (int face = 0; face < 6; face++)
+			{
+				this->rasterizePlane(plane->normal, plane->center, face, &entry.texels);
+			}
+		}
+		else
+		{
+			// Objeto infinito desconhecido: candidato em todas as direções
+			entry.distance = 0;
+			for (int t = 0; t < numTexels; t++)
+			{
+				entry.texels.push_back(t);
+			}
+		}
+	}
+
+	// Do mais próximo para o mais distante, para que a lista de cada texel já saia ordenada
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry& x, const Entry& y)
+	{
+		return x.distance < y.distance;
+	});
+
+	this->offsets.assign(numTexels + 1, 0);
+	for (auto& entry : entries)
+	{
+		for (int t : entry.texels)
+		{
+			this->offsets[t + 1]++;
+		}
+	}
+	for (int t = 0; t < numTexels; t++)
+	{
+		this->offsets[t + 1] += this->offsets[t];
+	}
+
+	this->candidates.resize(this->offsets[numTexels]);
+	this->distances.resize(this->offsets[numTexels]);
+
+	std::vector<int> next(this->offsets.begin(), this->offsets.end() - 1);
+	for (auto& entry : entries)
+	{
+		for (int t : entry.texels)
+		{
+			this->candidates[next[t]] = entry.object;
+			this->distances[next[t]] = entry.distance;
+			next[t]++;
+		}
+	}
+}
+
+/**
+ * @brief Testa os candidatos do texel da direção, do mais próximo para o mais distante, até passar de tMax.
+ */
+bool ShadowCubeMap::occluded(const Vector3& direction, Scalar tMax) const
+{
+	int texel = this->texelOf(direction);
+	int end = this->offsets[texel + 1];
+
+	for (int k = this->offsets[texel]; k < end; k++)
+	{
+		if (this->distances[k] >= tMax)
+		{
+			return false;
+		}
+
+		if (this->candidates[k]->occluded(this->origin, direction, tMax))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Obtém a posição da fonte.
+ */
+const Vector3& ShadowCubeMap::getOrigin() const
+{
+	return this->origin;
+}
+
+/**
+ * @brief Obtém o número de texels por lado de cada face.
+ */
+int ShadowCubeMap::getResolution() const
+{
+	return this->resolution;
+}
+
+/**
+ * @brief Obtém o número total de candidatos em todos os texels.
+ */
+int ShadowCubeMap::getNumCandidates() const
+{
+	return this->candidates.size();
+}
@@ -0,0 +1,90 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <vector>
+
+#include "AABB.h"
+#include "Object.h"
+#include "Scalar.h"
+
+#ifndef ShadowCubeMap_H
+#define ShadowCubeMap_H
+
+/**
+ * @brief Mapa cúbico de oclusão visto de uma fonte pontual.
+ *
+ * Todos os raios de sombra de uma fonte pontual saem da mesma origem. O mapa divide as direções
+ * em torno dela nas seis faces de um cubo, com resolution x resolution texels por face, e guarda
+ * em cada texel a lista dos objetos que podem ser atingidos por alguma direção do texel, ordenada
+ * por um limite inferior da distância até a origem. O teste de sombra consulta o texel da direção
+ * e testa, com Object::occluded, só os candidatos mais próximos que o ponto.
+ *
+ * A lista de cada texel é conservadora: a caixa de cada objeto é projetada na face com a margem
+ * de um texel, então um objeto que bloqueia o segmento sempre está na lista do texel da direção,
+ * e o resultado é o mesmo de testar todos os objetos com Object::occluded. O mapa vale enquanto
+ * a fonte e os objetos não se moverem.
+ */
+class ShadowCubeMap
+{
+public:
+	static const int DEFAULT_RESOLUTION = 64; /**< Texels por lado de cada face */
+
+	/**
+	 * @brief Constrói um mapa vazio (sem candidatos).
+	 */
+	ShadowCubeMap();
+
+	/**
+	 * @brief Constrói o mapa a partir da origem da fonte.
+	 *
+	 * @param origin A posição da fonte.
+	 * @param objects Os objetos da cena (nas suas coordenadas atuais).
+	 * @param resolution Texels por lado de cada face.
+	 */
+	void build(const Vector3& origin, const std::vector<Object*>& objects, int resolution = DEFAULT_RESOLUTION);
+
+	/**
+	 * @brief Verifica se algum objeto bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 *
+	 * @param direction A direção (unitária) do segmento, a partir da origem do mapa.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se o segmento estiver bloqueado.
+	 */
+	bool occluded(const Vector3& direction, Scalar tMax) const;
+
+	/**
+	 * @brief Obtém a posição da fonte.
+	 */
+	const Vector3& getOrigin() const;
+
+	/**
+	 * @brief Obtém o número de texels por lado de cada face.
+	 */
+	int getResolution() const;
+
+	/**
+	 * @brief Obtém o número total de candidatos guardados em todos os texels.
+	 */
+	int getNumCandidates() const;
+
+private:
+	Vector3 origin;
+	int resolution;
+
+	// Candidatos do texel i em [offsets[i], offsets[i + 1]), do mais próximo para o mais distante
+	std::vector<int> offsets;
+	std::vector<Object*> candidates;
+	std::vector<Scalar> distances; // Limite inferior da distância de cada candidato até a origem
+
+	// Índice do texel da direção d (face * resolution² + linha * resolution + coluna)
+	int texelOf(const Vector3& d) const;
+
+	// Marca em texels os texels da face em que a caixa (relativa à origem) pode aparecer
+	void rasterizeBox(const AABB& box, int face, std::vector<int>* texels) const;
+
+	// Marca em texels os texels da face em que o plano infinito pode ser atingido
+	void rasterizePlane(const Vector3& normal, const Vector3& center, int face, std::vector<int>* texels) const;
+
+	// Direção (não unitária) do canto (u, v) da face, com u e v em [-1, 1]
+	static Vector3 faceDirection(int face, Scalar u, Scalar v);
+};
+
+#endif
@@ -1,69 +1,50 @@
 #include "Sphere.h"
 
 // Construtor da classe Sphere.
-Sphere::Sphere(double radius, Eigen::Vector3d center, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex)
+Sphere::Sphere(Scalar radius, Vector3 center, int material)
 {
 	this->radius = radius;
 	this->center = center;
-	this->kAmbient = kAmbient;
-	this->kDif = kDif;
-	this->kEsp = kEsp;
-	this->specularIndex = specularIndex;
+	this->material = material;
 }
 
-// Verifica se um raio intercepta a esfera.
-double Sphere::hasInterceptedRay(Ray ray)
+// Calcula a interseção de um raio com a esfera.
+bool Sphere::intersect(const Ray& ray, HitRecord* hit) const
 {
-	Eigen::Vector3d w = ray.initialPoint - this->center;
+	Vector3 w = ray.initialPoint - this->center;
 
-	double b = w.dot(ray.direction);
-	double c = w.dot(w) - this->radius * this->radius;
+	Scalar b = w.dot(ray.direction);
+	Scalar c = w.dot(w) - this->radius * this->radius;
 
-	double delta = b * b - c;
+	Scalar delta = b * b - c;
 
-	if (delta >= 0)
-		return (sqrt(delta) - b);
+	if (delta < 0)
+		return false;
 
-	return 1;
-}
-
-// Calcula a cor do ponto de interseção da esfera.
-Eigen::Vector3d Sphere::computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows)
-{
-	Eigen::Vector3d pInt(0, 0, 0);
-	Eigen::Vector3d intesityEye(0, 0, 0);
-
-	pInt = ray.initialPoint + tInt * ray.direction;
-
-	Eigen::Vector3d intesityAmbient(0, 0, 0);
-	Eigen::Vector3d intesityDifuse(0, 0, 0);
-	Eigen::Vector3d intesitySpecular(0, 0, 0);
-	Eigen::Vector3d singleDifuse;
-	Eigen::Vector3d singleSpecular;
-	Eigen::Vector3d normal = (pInt - this->center).normalized();
+	Scalar tInt = -b - sqrt(delta);
 
-	int idx = 0;
-	for (auto& source : sources)
-	{
-		source->computeIntensity(pInt, ray, &intesityAmbient, &intesityDifuse, &intesitySpecular, normal, this->kAmbient, this->kDif, this->kEsp, this->specularIndex, shadows[idx]);
-		idx++;
-	}
+	if (!ray.contains(tInt))
+		return false;
 
-	intesityEye = intesityDifuse + intesitySpecular + intesityAmbient;
+	Vector3 pInt = ray.initialPoint + tInt * ray.direction;
 
-	return intesityEye;
+	hit->t = tInt;
+	hit->structure = 0;
+	hit->normal = (pInt - this->center).normalized();
+	hit->hasUV = false;
+	return true;
 }
 
 // Translada a esfera nas direções x, y e z.
-void Sphere::translate(double x, double y, double z)
+void Sphere::translate(Scalar x, Scalar y, Scalar z)
 {
-	Eigen::Matrix4d m;
+	Matrix4 m;
 	m << 1, 0, 0, x,
 		 0, 1, 0, y,
 		 0, 0, 1, z,
 		 0, 0, 0, 1;
 
-	Eigen::Vector4d center4;
+	Vector4 center4;
 	center4 << this->center[0], this->center[1], this->center[2], 1;
 
 	center4 = m * center4;
@@ -72,33 +53,64 @@ void Sphere::translate(double x, double y, double z)
 }
 
 // Escala a esfera nas direções x, y e z.
-void  Sphere::scale(double x, double y, double z)
+void  Sphere::scale(Scalar x, Scalar y, Scalar z)
 {
 	this->radius *= x;
 }
 
 
-void  Sphere::rotateX(double angle)
+void  Sphere::rotateX(Scalar angle)
 {
 	// nao tem sentido rotacionar uma esfera com cor "chapada"
 }
 
-void  Sphere::rotateY(double angle)
+void  Sphere::rotateY(Scalar angle)
 {
 	// nao tem sentido rotacionar uma esfera com cor "chapada"
 }
-void  Sphere::rotateZ(double angle)
+void  Sphere::rotateZ(Scalar angle)
 {
 	// nao tem sentido rotacionar uma esfera com cor "chapada"
 }
 
 // Converte a esfera para o sistema de coordenadas da câmera.
-void Sphere::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void Sphere::convertToCamera(Matrix4 transformationMatrix)
 {
-	Eigen::Vector4d center4;
+	Vector4 center4;
 	center4 << this->center[0], this->center[1], this->center[2], 1;
 
 	center4 = transformationMatrix * center4;
 
 	this->center << center4[0], center4[1], center4[2];
 }
+
+// Cria uma cópia da esfera.
+Object* Sphere::clone() const
+{
+	return new Sphere(*this);
+}
+
+// Calcula a caixa delimitadora da esfera.
+bool Sphere::getBounds(AABB* box) const
+{
+	Vector3 r(this->radius, this->radius, this->radius);
+	*box = AABB(this->center - r, this->center + r);
+	return true;
+}
+
+// Verifica se a esfera bloqueia o segmento (mesma raiz usada por intersect, sem calcular a normal).
+bool Sphere::occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+{
+	Vector3 w = origin - this->center;
+	Scalar b = w.dot(direction);
+	Scalar c = w.dot(w) - this->radius * this->radius;
+
+	Scalar delta = b * b - c;
+
+	if (delta < 0)
+		return false;
+
+	Scalar s = -b - sqrt(delta);
+
+	return s > 0 && s < tMax;
+}
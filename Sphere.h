@@ -4,6 +4,7 @@
 #include "Ray.h"
 #include "LightSource.h"
 #include "Object.h"
+#include "Scalar.h"
 
 #ifndef Sphere_H
 #define Sphere_H
@@ -14,36 +15,24 @@
 class Sphere : public Object
 {
 public:
-	double radius; // raio da esfera
-	Eigen::Vector3d center; // centro da esfera
+	Scalar radius; // raio da esfera
+	Vector3 center; // centro da esfera
 
 	/**
 	 * Construtor da classe Sphere.
 	 * @param radius O raio da esfera.
 	 * @param center O centro da esfera.
-	 * @param kAmbient O coeficiente de reflexão ambiente da esfera.
-	 * @param kDif O coeficiente de reflexão difusa da esfera.
-	 * @param kEsp O coeficiente de reflexão especular da esfera.
-	 * @param specularIndex O índice de especularidade da esfera.
+	 * @param material Índice do material na tabela de materiais da cena (Scene::materials).
 	 */
-	Sphere(double radius, Eigen::Vector3d center, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex);
+	Sphere(Scalar radius, Vector3 center, int material);
 
 	/**
-	 * Verifica se um raio intercepta a esfera.
+	 * Calcula a interseção de um raio com a esfera.
 	 * @param ray O raio a ser verificado.
-	 * @return A distância do ponto de interseção mais próximo ou -1 se não houver interseção.
+	 * @param hit O registro a ser preenchido (t e normal).
+	 * @return true se houver interseção à frente do raio.
 	 */
-	double hasInterceptedRay(Ray ray);
-
-	/**
-	 * Calcula a cor do ponto de interseção da esfera.
-	 * @param tInt A distância do ponto de interseção.
-	 * @param ray O raio que intersectou a esfera.
-	 * @param sources As fontes de luz no ambiente.
-	 * @param shadows Um vetor de booleanos indicando se cada fonte de luz está bloqueada por uma sombra.
-	 * @return A cor do ponto de interseção.
-	 */
-	Eigen::Vector3d computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows);
+	bool intersect(const Ray& ray, HitRecord* hit) const;
 
 	/**
 	 * Translada a esfera nas direções x, y e z.
@@ -51,7 +40,7 @@ public:
 	 * @param y A quantidade a ser transladada no eixo y.
 	 * @param z A quantidade a ser transladada no eixo z.
 	 */
-	void translate(double x, double y, double z);
+	void translate(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * Escala a esfera nas direções x, y e z.
@@ -59,31 +48,53 @@ public:
 	 * @param y O fator de escala no eixo y.
 	 * @param z O fator de escala no eixo z.
 	 */
-	void scale(double x, double y, double z);
+	void scale(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * Rotaciona a esfera em torno do eixo x.
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	void rotateX(double angle);
+	void rotateX(Scalar angle);
 
 	/**
 	 * Rotaciona a esfera em torno do eixo y.
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	void rotateY(double angle);
+	void rotateY(Scalar angle);
 
 	/**
 	 * Rotaciona a esfera em torno do eixo z.
 	 * @param angle O ângulo de rotação em radianos.
 	 */
-	void rotateZ(double angle);
+	void rotateZ(Scalar angle);
 
 	/**
 	 * Converte a esfera para o sistema de coordenadas da câmera.
 	 * @param transformationMatrix A matriz de transformação para o sistema de coordenadas da câmera.
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
+
+	/**
+	 * Cria uma cópia da esfera.
+	 * @return Ponteiro para a nova esfera.
+	 */
+	Object* clone() const;
+
+	/**
+	 * Calcula a caixa delimitadora da esfera.
+	 * @param box Ponteiro para armazenar a caixa.
+	 * @return true (a esfera é limitada).
+	 */
+	bool getBounds(AABB* box) const;
+
+	/**
+	 * Verifica se a esfera bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 * @param origin A origem do segmento.
+	 * @param direction A direção (unitária) do segmento.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se a esfera for atingida dentro do segmento.
+	 */
+	bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const;
 };
 
 #endif
\ No newline at end of file
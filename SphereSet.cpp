@@ -0,0 +1,421 @@
+#include "SphereSet.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SPHERESET_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// No GCC e no Clang cada núcleo é compilado para o seu conjunto de instruções, sem exigir -mavx2
+// no resto do programa; o MSVC aceita os intrínsecos sem opções extras.
+#if defined(__GNUC__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define TARGET_AVX2
+#define TARGET_SSE2
+#endif
+
+// Número de esferas por bloco; os vetores são completados até um múltiplo dele
+static const int LANES = 4;
+
+/**
+ * @brief Laço escalar: índice da esfera com o menor t em (tMin, tMax), ou -1.
+ *
+ * As contas seguem a mesma ordem dos núcleos vetoriais, para que todos escolham a mesma esfera.
+ */
+static int nearestScalar(const double* cx, const double* cy, const double* cz, const double* r2, int count,
+						 const double* o, const double* d, double tMin, double tMax)
+{
+	double best = tMax;
+	int index = -1;
+
+	for (int i = 0; i < count; i++)
+	{
+		double wx = o[0] - cx[i], wy = o[1] - cy[i], wz = o[2] - cz[i];
+		double b = wx * d[0] + wy * d[1] + wz * d[2];
+		double c = wx * wx + wy * wy + wz * wz - r2[i];
+		double delta = b * b - c;
+
+		if (delta < 0)
+		{
+			continue;
+		}
+
+		double t = -b - sqrt(delta);
+		if (t > tMin && t < best)
+		{
+			best = t;
+			index = i;
+		}
+	}
+
+	return index;
+}
+
+// Laço escalar do teste de sombra (parâmetro s crescente, como em Sphere::occluded)
+static bool occludedScalar(const double* cx, const double* cy, const double* cz, const double* r2, int count,
+						   const double* o, const double* d, double tMax)
+{
+	for (int i = 0; i < count; i++)
+	{
+		double wx = o[0] - cx[i], wy = o[1] - cy[i], wz = o[2] - cz[i];
+		double b = wx * d[0] + wy * d[1] + wz * d[2];
+		double c = wx * wx + wy * wy + wz * wz - r2[i];
+		double delta = b * b - c;
+
+		if (delta < 0)
+		{
+			continue;
+		}
+
+		double s = -b - sqrt(delta);
+		if (s > 0 && s < tMax)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Escolhe, entre as pistas, o menor t; em caso de empate, o menor índice
+static int reduceLanes(const double* t, const double* index, int lanes)
+{
+	double best = INFINITY;
+	int result = -1;
+
+	for (int k = 0; k < lanes; k++)
+	{
+		if (index[k] >= 0 && (t[k] < best || (t[k] == best && (int)index[k] < result)))
+		{
+			best = t[k];
+			result = (int)index[k];
+		}
+	}
+
+	return result;
+}
+
+#ifdef SPHERESET_X86
+
+// 4 esferas por instrução. Raízes de discriminante negativo viram NaN e falham nas comparações.
+TARGET_AVX2 static int nearestAVX2(const double* cx, const double* cy, const double* cz, const double* r2, int count,
+								   const double* o, const double* d, double tMin, double tMax)
+{
+	__m256d ox = _mm256_set1_pd(o[0]), oy = _mm256_set1_pd(o[1]), oz = _mm256_set1_pd(o[2]);
+	__m256d dx = _mm256_set1_pd(d[0]), dy = _mm256_set1_pd(d[1]), dz = _mm256_set1_pd(d[2]);
+	__m256d zero = _mm256_setzero_pd();
+	__m256d lower = _mm256_set1_pd(tMin);
+	__m256d best = _mm256_set1_pd(tMax);
+	__m256d bestIndex = _mm256_set1_pd(-1);
+	__m256d index = _mm256_set_pd(3, 2, 1, 0);
+	__m256d step = _mm256_set1_pd(4);
+
+	for (int i = 0; i < count; i += 4)
+	{
+		__m256d wx = _mm256_sub_pd(ox, _mm256_loadu_pd(cx + i));
+		__m256d wy = _mm256_sub_pd(oy, _mm256_loadu_pd(cy + i));
+		__m256d wz = _mm256_sub_pd(oz, _mm256_loadu_pd(cz + i));
+
+		__m256d b = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(wx, dx), _mm256_mul_pd(wy, dy)), _mm256_mul_pd(wz, dz));
+		__m256d c = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(wx, wx), _mm256_mul_pd(wy, wy)), _mm256_mul_pd(wz, wz)), _mm256_loadu_pd(r2 + i));
+		__m256d delta = _mm256_sub_pd(_mm256_mul_pd(b, b), c);
+		__m256d t = _mm256_sub_pd(_mm256_sub_pd(zero, b), _mm256_sqrt_pd(delta));
+
+		__m256d closer = _mm256_and_pd(_mm256_cmp_pd(t, lower, _CMP_GT_OQ), _mm256_cmp_pd(t, best, _CMP_LT_OQ));
+		best = _mm256_blendv_pd(best, t, closer);
+		bestIndex = _mm256_blendv_pd(bestIndex, index, closer);
+		index = _mm256_add_pd(index, step);
+	}
+
+	double lanesT[4], lanesIndex[4];
+	_mm256_storeu_pd(lanesT, best);
+	_mm256_storeu_pd(lanesIndex, bestIndex);
+	return reduceLanes(lanesT, lanesIndex, 4);
+}
+
+TARGET_AVX2 static bool occludedAVX2(const double* cx, const double* cy, const double* cz, const double* r2, int count,
+									 const double* o, const double* d, double tMax)
+{
+	__m256d ox = _mm256_set1_pd(o[0]), oy = _mm256_set1_pd(o[1]), oz = _mm256_set1_pd(o[2]);
+	__m256d dx = _mm256_set1_pd(d[0]), dy = _mm256_set1_pd(d[1]), dz = _mm256_set1_pd(d[2]);
+	__m256d zero = _mm256_setzero_pd();
+	__m256d limit = _mm256_set1_pd(tMax);
+
+	for (int i = 0; i < count; i += 4)
+	{
+		__m256d wx = _mm256_sub_pd(ox, _mm256_loadu_pd(cx + i));
+		__m256d wy = _mm256_sub_pd(oy, _mm256_loadu_pd(cy + i));
+		__m256d wz = _mm256_sub_pd(oz, _mm256_loadu_pd(cz + i));
+
+		__m256d b = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(wx, dx), _mm256_mul_pd(wy, dy)), _mm256_mul_pd(wz, dz));
+		__m256d c = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(wx, wx), _mm256_mul_pd(wy, wy)), _mm256_mul_pd(wz, wz)), _mm256_loadu_pd(r2 + i));
+		__m256d delta = _mm256_sub_pd(_mm256_mul_pd(b, b), c);
+		__m256d s = _mm256_sub_pd(_mm256_sub_pd(zero, b), _mm256_sqrt_pd(delta));
+
+		__m256d blocks = _mm256_and_pd(_mm256_cmp_pd(s, zero, _CMP_GT_OQ), _mm256_cmp_pd(s, limit, _CMP_LT_OQ));
+		if (_mm256_movemask_pd(blocks) != 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// 2 esferas por instrução (sem blendv, que só existe a partir do SSE4.1)
+TARGET_SSE2 static int nearestSSE2(const double* cx, const double* cy, const double* cz, const double* r2, int count,
+								   const double* o, const double* d, double tMin, double tMax)
+{
+	__m128d ox = _mm_set1_pd(o[0]), oy = _mm_set1_pd(o[1]), oz = _mm_set1_pd(o[2]);
+	__m128d dx = _mm_set1_pd(d[0]), dy = _mm_set1_pd(d[1]), dz = _mm_set1_pd(d[2]);
+	__m128d zero = _mm_setzero_pd();
+	__m128d lower = _mm_set1_pd(tMin);
+	__m128d best = _mm_set1_pd(tMax);
+	__m128d bestIndex = _mm_set1_pd(-1);
+	__m128d index = _mm_set_pd(1, 0);
+	__m128d step = _mm_set1_pd(2);
+
+	for (int i = 0; i < count; i += 2)
+	{
+		__m128d wx = _mm_sub_pd(ox, _mm_loadu_pd(cx + i));
+		__m128d wy = _mm_sub_pd(oy, _mm_loadu_pd(cy + i));
+		__m128d wz = _mm_sub_pd(oz, _mm_loadu_pd(cz + i));
+
+		__m128d b = _mm_add_pd(_mm_add_pd(_mm_mul_pd(wx, dx), _mm_mul_pd(wy, dy)), _mm_mul_pd(wz, dz));
+		__m128d c = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(wx, wx), _mm_mul_pd(wy, wy)), _mm_mul_pd(wz, wz)), _mm_loadu_pd(r2 + i));
+		__m128d delta = _mm_sub_pd(_mm_mul_pd(b, b), c);
+		__m128d t = _mm_sub_pd(_mm_sub_pd(zero, b), _mm_sqrt_pd(delta));
+
+		__m128d closer = _mm_and_pd(_mm_cmpgt_pd(t, lower), _mm_cmplt_pd(t, best));
+		best = _mm_or_pd(_mm_and_pd(closer, t), _mm_andnot_pd(closer, best));
+		bestIndex = _mm_or_pd(_mm_and_pd(closer, index), _mm_andnot_pd(closer, bestIndex));
+		index = _mm_add_pd(index, step);
+	}
+
+	double lanesT[2], lanesIndex[2];
+	_mm_storeu_pd(lanesT, best);
+	_mm_storeu_pd(lanesIndex, bestIndex);
+	return reduceLanes(lanesT, lanesIndex, 2);
+}
+
+TARGET_SSE2 static bool occludedSSE2(const double* cx, const double* cy, const double* cz, const double* r2, int count,
+									 const double* o, const double* d, double tMax)
+{
+	__m128d ox = _mm_set1_pd(o[0]), oy = _mm_set1_pd(o[1]), oz = _mm_set1_pd(o[2]);
+	__m128d dx = _mm_set1_pd(d[0]), dy = _mm_set1_pd(d[1]), dz = _mm_set1_pd(d[2]);
+	__m128d zero = _mm_setzero_pd();
+	__m128d limit = _mm_set1_pd(tMax);
+
+	for (int i = 0; i < count; i += 2)
+	{
+		__m128d wx = _mm_sub_pd(ox, _mm_loadu_pd(cx + i));
+		__m128d wy = _mm_sub_pd(oy, _mm_loadu_pd(cy + i));
+		__m128d wz = _mm_sub_pd(oz, _mm_loadu_pd(cz + i));
+
+		__m128d b = _mm_add_pd(_mm_add_pd(_mm_mul_pd(wx, dx), _mm_mul_pd(wy, dy)), _mm_mul_pd(wz, dz));
+		__m128d c = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(wx, wx), _mm_mul_pd(wy, wy)), _mm_mul_pd(wz, wz)), _mm_loadu_pd(r2 + i));
+		__m128d delta = _mm_sub_pd(_mm_mul_pd(b, b), c);
+		__m128d s = _mm_sub_pd(_mm_sub_pd(zero, b), _mm_sqrt_pd(delta));
+
+		__m128d blocks = _mm_and_pd(_mm_cmpgt_pd(s, zero), _mm_cmplt_pd(s, limit));
+		if (_mm_movemask_pd(blocks) != 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#endif
+
+/**
+ * @brief Cria um conjunto vazio que usa o melhor núcleo suportado pela CPU.
+ */
+SphereSet::SphereSet()
+{
+	this->kernel = detectKernel();
+}
+
+/**
+ * @brief Adiciona uma esfera ao conjunto (nas suas coordenadas atuais).
+ *
+ * @param sphere A esfera.
+ */
+void SphereSet::add(Sphere* sphere)
+{
+	int i = this->spheres.size();
+	this->spheres.push_back(sphere);
+
+	// Abre um novo bloco de LANES esferas que nunca são atingidas (r2 = -infinito)
+	if (i % LANES == 0)
+	{
+		this->cx.resize(i + LANES, 0);
+		this->cy.resize(i + LANES, 0);
+		this->cz.resize(i + LANES, 0);
+		this->r2.resize(i + LANES, -INFINITY);
+	}
+
+	this->cx[i] = sphere->center(0);
+	this->cy[i] = sphere->center(1);
+	this->cz[i] = sphere->center(2);
+	this->r2[i] = sphere->radius * sphere->radius;
+}
+
+/**
+ * @brief Obtém o número de esferas do conjunto.
+ */
+int SphereSet::size() const
+{
+	return this->spheres.size();
+}
+
+/**
+ * @brief Obtém a esfera de índice i (na ordem de add()).
+ */
+Sphere* SphereSet::get(int i) const
+{
+	return this->spheres[i];
+}
+
+/**
+ * @brief Índice da esfera com o menor t no intervalo do raio (a mais próxima à frente dele), ou -1.
+ */
+int SphereSet::nearest(const Ray& ray) const
+{
+	double o[3] = { ray.initialPoint(0), ray.initialPoint(1), ray.initialPoint(2) };
+	double d[3] = { ray.direction(0), ray.direction(1), ray.direction(2) };
+	int count = this->cx.size();
+
+#ifdef SPHERESET_X86
+	if (this->kernel == AVX2)
+	{
+		return nearestAVX2(this->cx.data(), this->cy.data(), this->cz.data(), this->r2.data(), count, o, d, ray.tMin, ray.tMax);
+	}
+	if (this->kernel == SSE2)
+	{
+		return nearestSSE2(this->cx.data(), this->cy.data(), this->cz.data(), this->r2.data(), count, o, d, ray.tMin, ray.tMax);
+	}
+#endif
+
+	return nearestScalar(this->cx.data(), this->cy.data(), this->cz.data(), this->r2.data(), this->spheres.size(), o, d, ray.tMin, ray.tMax);
+}
+
+/**
+ * @brief Encontra a esfera mais próxima atingida pelo raio.
+ *
+ * O núcleo só escolhe a esfera; o registro (t e normal) é preenchido pela própria esfera.
+ *
+ * @param ray O raio.
+ * @param hit Registro preenchido pela esfera atingida.
+ * @param index Ponteiro para armazenar o índice da esfera atingida.
+ * @return true se alguma esfera foi atingida.
+ */
+bool SphereSet::intersect(const Ray& ray, HitRecord* hit, int* index) const
+{
+	int i = this->nearest(ray);
+
+	if (i < 0 || !this->spheres[i]->intersect(ray, hit))
+	{
+		return false;
+	}
+
+	*index = i;
+	return true;
+}
+
+/**
+ * @brief Verifica se alguma esfera bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+ *
+ * @param origin A origem do segmento.
+ * @param direction A direção (unitária) do segmento.
+ * @param tMax O comprimento do segmento.
+ * @return true se alguma esfera bloqueia o segmento.
+ */
+bool SphereSet::occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+{
+	double o[3] = { origin(0), origin(1), origin(2) };
+	double d[3] = { direction(0), direction(1), direction(2) };
+	int count = this->cx.size();
+
+#ifdef SPHERESET_X86
+	if (this->kernel == AVX2)
+	{
+		return occludedAVX2(this->cx.data(), this->cy.data(), this->cz.data(), this->r2.data(), count, o, d, tMax);
+	}
+	if (this->kernel == SSE2)
+	{
+		return occludedSSE2(this->cx.data(), this->cy.data(), this->cz.data(), this->r2.data(), count, o, d, tMax);
+	}
+#endif
+
+	return occludedScalar(this->cx.data(), this->cy.data(), this->cz.data(), this->r2.data(), this->spheres.size(), o, d, tMax);
+}
+
+/**
+ * @brief Obtém o núcleo em uso.
+ */
+SphereSet::Kernel SphereSet::getKernel() const
+{
+	return this->kernel;
+}
+
+/**
+ * @brief Escolhe o núcleo; núcleos que a CPU não suporta viram o melhor suportado.
+ *
+ * @param kernel O núcleo desejado.
+ */
+void SphereSet::setKernel(Kernel kernel)
+{
+	Kernel supported = detectKernel();
+	this->kernel = kernel > supported ? supported : kernel;
+}
+
+/**
+ * @brief Detecta o melhor núcleo suportado pela CPU (e pelo sistema, no caso dos registradores AVX).
+ *
+ * @return AVX2, SSE2 ou SCALAR.
+ */
+SphereSet::Kernel SphereSet::detectKernel()
+{
+#if defined(SPHERESET_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return AVX2;
+	}
+	if (__builtin_cpu_supports("sse2"))
+	{
+		return SSE2;
+	}
+#elif defined(SPHERESET_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse2 = (info[3] & (1 << 26)) != 0;
+	bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+
+	if (osAvx && maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		if ((info[1] & (1 << 5)) != 0)
+		{
+			return AVX2;
+		}
+	}
+	if (sse2)
+	{
+		return SSE2;
+	}
+#endif
+
+	return SCALAR;
+}
@@ -0,0 +1,117 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <vector>
+
+#include "HitRecord.h"
+#include "Ray.h"
+#include "Scalar.h"
+#include "Sphere.h"
+
+#ifndef SphereSet_H
+#define SphereSet_H
+
+/**
+ * @brief Conjunto de esferas guardado como estrutura de vetores (cx[], cy[], cz[], r2[]).
+ *
+ * Testa um raio contra todas as esferas sem chamadas virtuais. Com AVX2 o núcleo testa 4 esferas
+ * por instrução e com SSE2 testa 2 (em double, para dar exatamente os mesmos acertos de
+ * Sphere::intersect); sem nenhum dos dois usa o laço escalar. O núcleo é escolhido em tempo de
+ * execução pela CPU, então o mesmo binário roda em qualquer máquina x86 (ou não x86).
+ *
+ * As esferas não são copiadas: o conjunto guarda ponteiros para elas e só lê centro e raio
+ * no momento de add(), então elas não devem ser transformadas depois disso.
+ */
+class SphereSet
+{
+public:
+	/**
+	 * @brief Núcleos de interseção disponíveis.
+	 */
+	enum Kernel
+	{
+		SCALAR = 0, /**< Laço escalar, em qualquer CPU */
+		SSE2 = 1,   /**< 2 esferas por instrução */
+		AVX2 = 2    /**< 4 esferas por instrução */
+	};
+
+	/**
+	 * @brief Cria um conjunto vazio que usa o melhor núcleo suportado pela CPU.
+	 */
+	SphereSet();
+
+	/**
+	 * @brief Adiciona uma esfera ao conjunto (nas suas coordenadas atuais).
+	 *
+	 * @param sphere A esfera.
+	 */
+	void add(Sphere* sphere);
+
+	/**
+	 * @brief Obtém o número de esferas do conjunto.
+	 */
+	int size() const;
+
+	/**
+	 * @brief Obtém a esfera de índice i (na ordem de add()).
+	 */
+	Sphere* get(int i) const;
+
+	/**
+	 * @brief Encontra a esfera mais próxima atingida pelo raio.
+	 *
+	 * Mesma convenção de Sphere::intersect (só valem interseções no intervalo do raio). Em caso
+	 * de empate vence a esfera adicionada primeiro.
+	 *
+	 * @param ray O raio.
+	 * @param hit Registro preenchido pela esfera atingida.
+	 * @param index Ponteiro para armazenar o índice da esfera atingida.
+	 * @return true se alguma esfera foi atingida.
+	 */
+	bool intersect(const Ray& ray, HitRecord* hit, int* index) const;
+
+	/**
+	 * @brief Verifica se alguma esfera bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 *
+	 * @param origin A origem do segmento.
+	 * @param direction A direção (unitária) do segmento.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se alguma esfera bloqueia o segmento.
+	 */
+	bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const;
+
+	/**
+	 * @brief Obtém o núcleo em uso.
+	 */
+	Kernel getKernel() const;
+
+	/**
+	 * @brief Escolhe o núcleo (para comparações); núcleos que a CPU não suporta viram o melhor suportado.
+	 *
+	 * @param kernel O núcleo desejado.
+	 */
+	void setKernel(Kernel kernel);
+
+	/**
+	 * @brief Detecta o melhor núcleo suportado pela CPU.
+	 *
+	 * @return AVX2, SSE2 ou SCALAR.
+	 */
+	static Kernel detectKernel();
+
+private:
+	std::vector<Sphere*> spheres;
+
+	// Centros e raios ao quadrado, completados até um múltiplo de 4 com esferas que nunca são atingidas.
+	// Ficam em double também no build em float (os núcleos são de double); a esfera escolhida
+	// preenche o registro na precisão do build.
+	std::vector<double> cx;
+	std::vector<double> cy;
+	std::vector<double> cz;
+	std::vector<double> r2;
+
+	Kernel kernel;
+
+	// Índice da esfera mais próxima dentro do intervalo do raio, ou -1
+	int nearest(const Ray& ray) const;
+};
+
+#endif
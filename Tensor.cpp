@@ -1,4 +1,5 @@
 #include "Tensor.h"
+#include <algorithm>
 
 
 // Construtor da classe Tensor.
@@ -7,9 +8,31 @@ Tensor::Tensor(int numColumns, int numLines)
 	this->numLines = numLines;
 	this->numColumns = numColumns;
 
-	this->red = Eigen::ArrayXXd::Zero(this->numLines, this->numColumns);
-	this->green = Eigen::ArrayXXd::Zero(this->numLines, this->numColumns);
-	this->blue = Eigen::ArrayXXd::Zero(this->numLines, this->numColumns);
+	this->red = ArrayXX::Zero(this->numLines, this->numColumns);
+	this->green = ArrayXX::Zero(this->numLines, this->numColumns);
+	this->blue = ArrayXX::Zero(this->numLines, this->numColumns);
+}
+
+// Constrói o tensor a partir de um framebuffer.
+Tensor::Tensor(const Framebuffer& image)
+{
+	this->numLines = image.getNumLines();
+	this->numColumns = image.getNumColumns();
+
+	this->red = ArrayXX(this->numLines, this->numColumns);
+	this->green = ArrayXX(this->numLines, this->numColumns);
+	this->blue = ArrayXX(this->numLines, this->numColumns);
+
+	for (int l = 0; l < this->numLines; l++)
+	{
+		for (int c = 0; c < this->numColumns; c++)
+		{
+			Vector3 color = image.getPixel(l, c);
+			this->red(l, c) = color(0);
+			this->green(l, c) = color(1);
+			this->blue(l, c) = color(2);
+		}
+	}
 }
 
 // Normaliza os valores das matrizes de cores.
@@ -21,7 +44,7 @@ void Tensor::normalize()
 	desenvolvi essa fun��o para
 	normalizar as matrizes nesse intervalo.
 	*/
-	double  maximum = this->red(0, 0);
+	Scalar  maximum = this->red(0, 0);
 
 	for (int c = 0; c < this->numColumns; c++)
 	{
@@ -60,4 +83,21 @@ void Tensor::normalize()
 	this->red = 255 * (this->red / maximum);
 	this->green = 255 * (this->green / maximum);
 	this->blue = 255 * (this->blue / maximum);
+}
+
+// Converte as matrizes de cores para pixels RGBA de 8 bits.
+void Tensor::toRGBA(unsigned char* pixels, int pitch) const
+{
+	for (int l = 0; l < this->numLines; l++)
+	{
+		unsigned char* row = pixels + l * pitch;
+
+		for (int c = 0; c < this->numColumns; c++)
+		{
+			row[4 * c] = (unsigned char)std::min<Scalar>(255, std::max<Scalar>(0, this->red(l, c)));
+			row[4 * c + 1] = (unsigned char)std::min<Scalar>(255, std::max<Scalar>(0, this->green(l, c)));
+			row[4 * c + 2] = (unsigned char)std::min<Scalar>(255, std::max<Scalar>(0, this->blue(l, c)));
+			row[4 * c + 3] = 255;
+		}
+	}
 }
\ No newline at end of file
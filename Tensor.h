@@ -1,5 +1,8 @@
 #include "../eigen-3.4.0/Eigen/Dense"
 
+#include "Framebuffer.h"
+#include "Scalar.h"
+
 #ifndef Tensor_H
 #define Tensor_H
 
@@ -11,9 +14,9 @@
 class Tensor
 {
 public:
-	Eigen::ArrayXXd red;    /**< Matriz de cores vermelhas. */
-	Eigen::ArrayXXd green;  /**< Matriz de cores verdes. */
-	Eigen::ArrayXXd blue;   /**< Matriz de cores azuis. */
+	ArrayXX red;    /**< Matriz de cores vermelhas. */
+	ArrayXX green;  /**< Matriz de cores verdes. */
+	ArrayXX blue;   /**< Matriz de cores azuis. */
 	int numColumns;         /**< Número de colunas da matriz. */
 	int numLines;           /**< Número de linhas da matriz. */
 
@@ -24,10 +27,24 @@ public:
 	 */
 	Tensor(int numColumns, int numLines);
 
+	/**
+	 * Constrói o tensor a partir de um framebuffer (adaptador para o código que ainda usa Tensor).
+	 * @param image A imagem a ser copiada.
+	 */
+	Tensor(const Framebuffer& image);
+
 	/**
 	 * Normaliza os valores das matrizes de cores.
 	 */
 	void normalize();
+
+	/**
+	 * Converte as matrizes de cores para pixels RGBA de 8 bits (alfa 255), linha a linha.
+	 * Os valores são limitados ao intervalo [0, 255]; normalmente é chamada após normalize().
+	 * @param pixels Destino, com numLines linhas de pelo menos 4 * numColumns bytes.
+	 * @param pitch Número de bytes entre o início de duas linhas consecutivas do destino.
+	 */
+	void toRGBA(unsigned char* pixels, int pitch) const;
 };
 
 
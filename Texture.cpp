@@ -0,0 +1,242 @@
+#include "Texture.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Decodifica a superfície: converte para RGBA32 (bytes R, G, B, A) com a SDL e empacota os texels.
+ */
+Texture::Texture(SDL_Surface* surface)
+{
+	Level level;
+	level.width = 1;
+	level.height = 1;
+	level.texels.assign(1, pack(0, 0, 0, 255));
+
+	SDL_Surface* converted = surface == NULL ? NULL : SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+
+	if (converted != NULL)
+	{
+		level.width = converted->w;
+		level.height = converted->h;
+		level.texels.resize((size_t)level.width * level.height);
+
+		SDL_LockSurface(converted);
+		for (int y = 0; y < level.height; y++)
+		{
+			const uint8_t* row = (const uint8_t*)converted->pixels + (size_t)y * converted->pitch;
+			for (int x = 0; x < level.width; x++)
+			{
+				const uint8_t* p = row + 4 * x;
+				level.texels[(size_t)y * level.width + x] = pack(p[0], p[1], p[2], p[3]);
+			}
+		}
+		SDL_UnlockSurface(converted);
+
+		SDL_FreeSurface(converted);
+	}
+
+	this->addLevel(level);
+	this->generateMipmaps();
+}
+
+/**
+ * @brief Constrói a textura a partir de texels RGBA8 já empacotados.
+ */
+Texture::Texture(int width, int height, const std::vector<uint32_t>& texels)
+{
+	Level level;
+	level.width = width;
+	level.height = height;
+	level.texels = texels;
+
+	this->addLevel(level);
+	this->generateMipmaps();
+}
+
+/**
+ * @brief Acrescenta um nível, com a escala em relação ao nível 0 e os inversos do tamanho.
+ */
+void Texture::addLevel(Level& level)
+{
+	int width0 = this->levels.empty() ? level.width : this->levels[0].width;
+	int height0 = this->levels.empty() ? level.height : this->levels[0].height;
+
+	level.scaleX = (Scalar)level.width / width0;
+	level.scaleY = (Scalar)level.height / height0;
+
+	this->levels.push_back(level);
+}
+
+/**
+ * @brief Gera os mipmaps: cada texel é a média (arredondada) do bloco de 2x2 texels do nível anterior.
+ *
+ * Com largura ou altura ímpar o último bloco repete a última coluna ou linha.
+ */
+void Texture::generateMipmaps()
+{
+	while (this->levels.back().width > 1 || this->levels.back().height > 1)
+	{
+		const Level& source = this->levels.back();
+		Level level;
+		level.width = std::max(1, source.width / 2);
+		level.height = std::max(1, source.height / 2);
+		level.texels.resize((size_t)level.width * level.height);
+
+		for (int y = 0; y < level.height; y++)
+		{
+			int y0 = std::min(2 * y, source.height - 1), y1 = std::min(2 * y + 1, source.height - 1);
+
+			for (int x = 0; x < level.width; x++)
+			{
+				int x0 = std::min(2 * x, source.width - 1), x1 = std::min(2 * x + 1, source.width - 1);
+
+				uint32_t a = source.texels[(size_t)y0 * source.width + x0];
+				uint32_t b = source.texels[(size_t)y0 * source.width + x1];
+				uint32_t c = source.texels[(size_t)y1 * source.width + x0];
+				uint32_t d = source.texels[(size_t)y1 * source.width + x1];
+
+				uint32_t texel = 0;
+				for (int shift = 0; shift < 32; shift += 8)
+				{
+					uint32_t sum = ((a >> shift) & 0xff) + ((b >> shift) & 0xff) + ((c >> shift) & 0xff) + ((d >> shift) & 0xff);
+					texel |= ((sum + 2) / 4) << shift;
+				}
+				level.texels[(size_t)y * level.width + x] = texel;
+			}
+		}
+
+		this->addLevel(level);
+	}
+}
+
+/**
+ * @brief Obtém a largura de um nível.
+ */
+int Texture::getWidth(int level) const
+{
+	return this->levels[level].width;
+}
+
+/**
+ * @brief Obtém a altura de um nível.
+ */
+int Texture::getHeight(int level) const
+{
+	return this->levels[level].height;
+}
+
+/**
+ * @brief Obtém o número de níveis.
+ */
+int Texture::getNumLevels() const
+{
+	return this->levels.size();
+}
+
+/**
+ * @brief Índice, dentro do nível, da coluna ou linha i (qualquer inteiro).
+ *
+ * Nos tamanhos potência de 2, que são a maioria das texturas e dos seus mipmaps, a repetição é só uma
+ * máscara; nos outros é um resto de divisão.
+ */
+int Texture::wrapIndex(long long i, int size, Wrap wrap)
+{
+	if (wrap == CLAMP_TO_EDGE)
+	{
+		return (int)std::min(std::max(i, 0LL), (long long)size - 1);
+	}
+
+	// Um período da repetição: a imagem, ou a imagem e o seu reflexo
+	long long period = wrap == REPEAT ? size : 2 * (long long)size;
+	if ((period & (period - 1)) == 0)
+	{
+		i &= period - 1;
+	}
+	else
+	{
+		i %= period;
+		i = i < 0 ? i + period : i;
+	}
+
+	return (int)(i < size ? i : period - 1 - i);
+}
+
+/**
+ * @brief Amostra um nível: o texel que contém o ponto, ou a interpolação entre os quatro centros mais próximos.
+ */
+Vector3 Texture::sampleLevel(Scalar u, Scalar v, int level, const Sampler& sampler) const
+{
+	const Level& l = this->levels[level];
+
+	// Coordenadas em texels do nível
+	Scalar x = limit(u * l.scaleX);
+	Scalar y = limit(v * l.scaleY);
+
+	if (sampler.filter == NEAREST)
+	{
+		int column = wrapIndex(floorIndex(x), l.width, sampler.wrap);
+		int line = wrapIndex(floorIndex(y), l.height, sampler.wrap);
+		return unpack(l.texels[(size_t)line * l.width + column]);
+	}
+
+	// Os centros dos texels estão em i + 0.5
+	x -= (Scalar)0.5;
+	y -= (Scalar)0.5;
+
+	long long x0 = floorIndex(x), y0 = floorIndex(y);
+	Scalar fx = x - (Scalar)x0, fy = y - (Scalar)y0;
+
+	int c0 = wrapIndex(x0, l.width, sampler.wrap), c1 = wrapIndex(x0 + 1, l.width, sampler.wrap);
+	int r0 = wrapIndex(y0, l.height, sampler.wrap), r1 = wrapIndex(y0 + 1, l.height, sampler.wrap);
+
+	const uint32_t* row0 = l.texels.data() + (size_t)r0 * l.width;
+	const uint32_t* row1 = l.texels.data() + (size_t)r1 * l.width;
+
+	Vector3 top = (1 - fx) * unpack(row0[c0]) + fx * unpack(row0[c1]);
+	Vector3 bottom = (1 - fx) * unpack(row1[c0]) + fx * unpack(row1[c1]);
+	return (1 - fy) * top + fy * bottom;
+}
+
+/**
+ * @brief Amostra a textura, escolhendo o nível pela largura da área vista pelo pixel.
+ *
+ * O nível é log2(footprint): nele um texel tem mais ou menos a largura do pixel. Com NEAREST é usado o
+ * nível mais próximo; com BILINEAR, a interpolação entre os dois níveis vizinhos (trilinear). A parte
+ * fracionária do nível é aproximada por uma reta entre as potências de 2, como nas GPUs, em vez de chamar log2.
+ */
+Vector3 Texture::sample(Scalar u, Scalar v, Scalar footprint, const Sampler& sampler) const
+{
+	int lastLevel = (int)this->levels.size() - 1;
+
+	if (!sampler.mipmaps || !(footprint > 1) || lastLevel == 0)
+	{
+		return this->sampleLevel(u, v, 0, sampler);
+	}
+
+	// footprint = 2^level * f, com f em [1, 2) (ou maior, no último nível)
+	int level = 0;
+	while (footprint >= 2 && level < lastLevel)
+	{
+		footprint *= (Scalar)0.5;
+		level++;
+	}
+
+	if (sampler.filter == NEAREST)
+	{
+		// log2(f) >= 0.5
+		if (footprint >= (Scalar)1.41421356 && level < lastLevel)
+		{
+			level++;
+		}
+		return this->sampleLevel(u, v, level, sampler);
+	}
+
+	Scalar fraction = footprint - 1;
+
+	if (level == lastLevel || fraction == 0)
+	{
+		return this->sampleLevel(u, v, level, sampler);
+	}
+
+	return (1 - fraction) * this->sampleLevel(u, v, level, sampler) + fraction * this->sampleLevel(u, v, level + 1, sampler);
+}
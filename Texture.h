@@ -0,0 +1,176 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <SDL.h>
+
+#include "Scalar.h"
+
+#ifndef Texture_H
+#define Texture_H
+
+/**
+ * @brief Textura decodificada uma vez, em RGBA8, com a cadeia de mipmaps.
+ *
+ * A imagem (normalmente uma SDL_Surface carregada com IMG_Load, em qualquer formato) é convertida
+ * na construção para um vetor de texels RGBA8 empacotados (vermelho no byte menos significativo),
+ * de forma que a amostragem é só uma leitura alinhada de 32 bits, sem o formato da SDL. A textura
+ * não depende da superfície depois de construída e pode ter qualquer tamanho.
+ *
+ * Os níveis de mipmap são gerados na construção, cada um com metade da largura e da altura do
+ * anterior (média de 2x2 texels), até 1x1. sample escolhe o nível pela largura, em texels, da área
+ * vista pelo pixel: num plano visto de lado, os pixels distantes leem os níveis pequenos, que cabem
+ * na cache, em vez de saltar pela imagem inteira.
+ *
+ * As coordenadas u e v estão em texels do nível 0 (u cresce para a direita, v para baixo). Os
+ * métodos são const e podem ser chamados por várias threads ao mesmo tempo.
+ */
+class Texture
+{
+public:
+	/**
+	 * @brief Filtro dentro de um nível.
+	 */
+	enum Filter
+	{
+		NEAREST, /**< Texel mais próximo */
+		BILINEAR /**< Interpolação entre os quatro texels mais próximos */
+	};
+
+	/**
+	 * @brief Tratamento das coordenadas fora da imagem.
+	 */
+	enum Wrap
+	{
+		REPEAT,          /**< A imagem se repete */
+		MIRRORED_REPEAT, /**< A imagem se repete, espelhada a cada repetição */
+		CLAMP_TO_EDGE    /**< Fora da imagem vale o texel da borda */
+	};
+
+	/**
+	 * @brief Modo de amostragem: filtro, repetição e uso dos mipmaps.
+	 */
+	struct Sampler
+	{
+		Filter filter; /**< Filtro dentro de um nível */
+		Wrap wrap;     /**< Repetição nos dois eixos */
+		bool mipmaps;  /**< Se escolhe o nível pela área do pixel (com BILINEAR, interpola também entre dois níveis) */
+
+		Sampler(Filter filter = BILINEAR, Wrap wrap = REPEAT, bool mipmaps = true)
+			: filter(filter), wrap(wrap), mipmaps(mipmaps) {}
+	};
+
+	/**
+	 * @brief Decodifica uma superfície SDL, em qualquer formato de pixel.
+	 *
+	 * @param surface A superfície; não é alterada e pode ser liberada depois.
+	 */
+	Texture(SDL_Surface* surface);
+
+	/**
+	 * @brief Constrói a textura a partir de texels RGBA8 já empacotados.
+	 *
+	 * @param width Largura em texels.
+	 * @param height Altura em texels.
+	 * @param texels width * height texels, linha a linha, no formato de pack.
+	 */
+	Texture(int width, int height, const std::vector<uint32_t>& texels);
+
+	/**
+	 * @brief Obtém a largura de um nível.
+	 */
+	int getWidth(int level = 0) const;
+
+	/**
+	 * @brief Obtém a altura de um nível.
+	 */
+	int getHeight(int level = 0) const;
+
+	/**
+	 * @brief Obtém o número de níveis (o nível 0 é a imagem original).
+	 */
+	int getNumLevels() const;
+
+	/**
+	 * @brief Obtém um texel de um nível (x e y devem estar dentro do nível).
+	 */
+	uint32_t getTexel(int level, int x, int y) const
+	{
+		const Level& l = this->levels[level];
+		return l.texels[(size_t)y * l.width + x];
+	}
+
+	/**
+	 * @brief Amostra a textura.
+	 *
+	 * @param u Coordenada horizontal, em texels do nível 0.
+	 * @param v Coordenada vertical, em texels do nível 0.
+	 * @param footprint Largura, em texels do nível 0, da área vista pelo pixel (0 = só o nível 0).
+	 * @param sampler O modo de amostragem.
+	 * @return A cor, com os componentes de 0 a 255.
+	 */
+	Vector3 sample(Scalar u, Scalar v, Scalar footprint, const Sampler& sampler) const;
+
+	/**
+	 * @brief Amostra um nível da textura.
+	 *
+	 * @param u Coordenada horizontal, em texels do nível 0.
+	 * @param v Coordenada vertical, em texels do nível 0.
+	 * @param level O nível.
+	 * @param sampler O modo de amostragem (mipmaps é ignorado).
+	 * @return A cor, com os componentes de 0 a 255.
+	 */
+	Vector3 sampleLevel(Scalar u, Scalar v, int level, const Sampler& sampler) const;
+
+	/**
+	 * @brief Empacota uma cor RGBA8 num texel.
+	 */
+	static uint32_t pack(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+	{
+		return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | ((uint32_t)a << 24);
+	}
+
+	/**
+	 * @brief Obtém o RGB de um texel, de 0 a 255.
+	 */
+	static Vector3 unpack(uint32_t texel)
+	{
+		return Vector3((Scalar)(texel & 0xff), (Scalar)((texel >> 8) & 0xff), (Scalar)((texel >> 16) & 0xff));
+	}
+
+private:
+	struct Level
+	{
+		int width;
+		int height;
+		Scalar scaleX; // Texels deste nível por texel do nível 0, na horizontal
+		Scalar scaleY; // e na vertical
+		std::vector<uint32_t> texels; // width * height texels, linha a linha
+	};
+
+	std::vector<Level> levels; // levels[0] é a imagem original
+
+	// Gera os níveis 1 em diante a partir do nível 0
+	void generateMipmaps();
+
+	// Acrescenta um nível e calcula as suas escalas
+	void addLevel(Level& level);
+
+	// Limita a coordenada (em texels) à faixa em que floorIndex é válido; infinito e NaN viram 0
+	static Scalar limit(Scalar x)
+	{
+		return std::abs(x) < (Scalar)1e18 ? x : 0;
+	}
+
+	// floor(x) como inteiro, para |x| < 1e18
+	static long long floorIndex(Scalar x)
+	{
+		long long i = (long long)x;
+		return i - (x < (Scalar)i);
+	}
+
+	// Índice, dentro do nível, da coluna ou linha i
+	static int wrapIndex(long long i, int size, Wrap wrap);
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "ThreadPool.h"
+
+/**
+ * @brief Construtor da classe ThreadPool.
+ *
+ * @param numThreads Número de threads do pool (no mínimo 1).
+ */
+ThreadPool::ThreadPool(int numThreads)
+{
+	if (numThreads < 1)
+	{
+		numThreads = 1;
+	}
+
+	this->job = NULL;
+	this->pending = 0;
+	this->generation = 0;
+	this->stopping = false;
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		WorkQueue* queue = new WorkQueue();
+		queue->front = 0;
+		queue->back = 0;
+		this->queues.push_back(queue);
+	}
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		this->threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+	}
+}
+
+/**
+ * @brief Encerra e aguarda todas as threads do pool.
+ */
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->wakeUp.notify_all();
+
+	for (auto& t : this->threads)
+	{
+		t.join();
+	}
+
+	for (auto& q : this->queues)
+	{
+		delete q;
+	}
+}
+
+/**
+ * @brief Obtém o número de threads do pool.
+ */
+int ThreadPool::getNumThreads()
+{
+	return (this->threads).size();
+}
+
+/**
+ * @brief Executa as tarefas 0..numTasks-1 e bloqueia até que todas terminem.
+ *
+ * As tarefas são distribuídas em blocos contíguos entre as filas das threads,
+ * o que mantém tarefas vizinhas (blocos vizinhos da imagem) na mesma thread.
+ *
+ * @param numTasks Número de tarefas.
+ * @param job Função chamada como job(tarefa, thread).
+ */
+void ThreadPool::run(int numTasks, const std::function<void(int, int)>& job)
+{
+	if (numTasks <= 0)
+	{
+		return;
+	}
+
+	int numQueues = this->queues.size();
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+
+	this->job = &job;
+	this->pending = numTasks;
+
+	for (int w = 0; w < numQueues; w++)
+	{
+		int first = (int)((long long)numTasks * w / numQueues);
+		int last = (int)((long long)numTasks * (w + 1) / numQueues);
+
+		std::lock_guard<std::mutex> queueLock(this->queues[w]->mutex);
+		this->queues[w]->front = first;
+		this->queues[w]->back = last;
+	}
+
+	this->generation++;
+	this->wakeUp.notify_all();
+
+	// Espera a última tarefa terminar
+	this->finished.wait(lock, [this] { return this->pending == 0; });
+	this->job = NULL;
+}
+
+/**
+ * @brief Retira uma tarefa da própria fila ou rouba do fim da fila de outra thread.
+ *
+ * @param worker Índice da thread.
+ * @param task Ponteiro para armazenar a tarefa obtida.
+ * @return true se alguma tarefa foi obtida.
+ */
+bool ThreadPool::nextTask(int worker, int* task)
+{
+	int numQueues = this->queues.size();
+
+	{
+		WorkQueue* own = this->queues[worker];
+		std::lock_guard<std::mutex> lock(own->mutex);
+		if (own->front < own->back)
+		{
+			*task = own->front++;
+			return true;
+		}
+	}
+
+	for (int i = 1; i < numQueues; i++)
+	{
+		WorkQueue* victim = this->queues[(worker + i) % numQueues];
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		if (victim->front < victim->back)
+		{
+			*task = --victim->back;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Laço principal de cada thread: dorme até um novo lote de tarefas e o consome.
+ *
+ * @param worker Índice da thread.
+ */
+void ThreadPool::workerLoop(int worker)
+{
+	unsigned long seen = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->wakeUp.wait(lock, [&] { return this->stopping || this->generation != seen; });
+
+			if (this->stopping)
+			{
+				return;
+			}
+			seen = this->generation;
+		}
+
+		int task;
+		while (this->nextTask(worker, &task))
+		{
+			(*this->job)(task, worker);
+
+			// A última tarefa acorda quem chamou run()
+			if (this->pending.fetch_sub(1) == 1)
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->finished.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef ThreadPool_H
+#define ThreadPool_H
+
+/**
+ * @brief Pool de threads persistente com roubo de tarefas.
+ *
+ * As threads são criadas uma única vez e ficam dormindo entre as chamadas de run(),
+ * de forma que cada renderização não paga o custo de criar threads de novo.
+ * Cada thread possui sua própria fila de tarefas; quando a fila de uma thread esvazia,
+ * ela rouba tarefas do fim da fila de outra thread.
+ */
+class ThreadPool
+{
+public:
+	/**
+	 * @brief Construtor da classe ThreadPool.
+	 *
+	 * @param numThreads Número de threads do pool (no mínimo 1).
+	 */
+	ThreadPool(int numThreads);
+
+	/**
+	 * @brief Encerra e aguarda todas as threads do pool.
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * @brief Obtém o número de threads do pool.
+	 *
+	 * @return O número de threads do pool.
+	 */
+	int getNumThreads();
+
+	/**
+	 * @brief Executa as tarefas 0..numTasks-1 e bloqueia até que todas terminem.
+	 *
+	 * @param numTasks Número de tarefas.
+	 * @param job Função chamada como job(tarefa, thread), onde thread é o índice da thread que a executa.
+	 */
+	void run(int numTasks, const std::function<void(int, int)>& job);
+
+private:
+	/**
+	 * Fila de tarefas de uma thread: o intervalo contíguo [front, back). O dono consome pela
+	 * frente, os ladrões consomem pelo fim. Guardar só os limites evita alocar a cada run().
+	 */
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		int front;
+		int back;
+	};
+
+	std::vector<std::thread> threads;
+	std::vector<WorkQueue*> queues;
+
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::condition_variable finished;
+
+	const std::function<void(int, int)>* job;
+	std::atomic<int> pending;
+	unsigned long generation;
+	bool stopping;
+
+	// Laço principal de cada thread
+	void workerLoop(int worker);
+
+	// Retira uma tarefa da própria fila ou rouba de outra thread
+	bool nextTask(int worker, int* task);
+};
+
+#endif
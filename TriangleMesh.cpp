@@ -0,0 +1,392 @@
+#include "TriangleMesh.h"
+#include "TriangularFace.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Constrói a malha e a sua BVH.
+ */
+TriangleMesh::TriangleMesh(const std::vector<Vector3>& vertices, const std::vector<int>& indices, int material)
+{
+	this->material = material;
+
+	this->vertices = vertices;
+	this->indices = std::make_shared<const std::vector<int>>(indices);
+
+	int numTriangles = indices.size() / 3;
+	std::vector<BuildEntry> entries(numTriangles);
+	for (int i = 0; i < numTriangles; i++)
+	{
+		entries[i].box = this->triangleBox(i);
+		entries[i].centroid = entries[i].box.centroid();
+		entries[i].triangle = i;
+	}
+
+	std::vector<int> leafOrder;
+	if (numTriangles > 0)
+	{
+		this->nodes.reserve(2 * numTriangles / BVHBuilder::MAX_LEAF_SIZE + 1);
+		BVHBuilder::build(entries, &this->nodes);
+
+		leafOrder.reserve(numTriangles);
+		for (auto& entry : entries)
+		{
+			leafOrder.push_back(entry.triangle);
+		}
+	}
+
+	this->order = std::make_shared<const std::vector<int>>(std::move(leafOrder));
+}
+
+/**
+ * @brief Obtém o número de triângulos.
+ */
+int TriangleMesh::getNumTriangles() const
+{
+	return this->indices->size() / 3;
+}
+
+/**
+ * @brief Obtém o número de vértices.
+ */
+int TriangleMesh::getNumVertices() const
+{
+	return this->vertices.size();
+}
+
+/**
+ * @brief Obtém o número de nós da BVH da malha.
+ */
+int TriangleMesh::getNumNodes() const
+{
+	return this->nodes.size();
+}
+
+/**
+ * @brief Normal de um triângulo, com a mesma fórmula (e o mesmo sentido) da TriangularFace.
+ */
+Vector3 TriangleMesh::getNormal(int triangle) const
+{
+	const int* index = &(*this->indices)[3 * triangle];
+	Vector3 r1 = this->vertices[index[1]] - this->vertices[index[0]];
+	Vector3 r2 = this->vertices[index[2]] - this->vertices[index[1]];
+	return (r2.cross(r1)).normalized();
+}
+
+/**
+ * @brief Caixa dos três vértices de um triângulo.
+ */
+AABB TriangleMesh::triangleBox(int triangle) const
+{
+	const int* index = &(*this->indices)[3 * triangle];
+	AABB box;
+	for (int k = 0; k < 3; k++)
+	{
+		box.expand(this->vertices[index[k]]);
+	}
+	return box;
+}
+
+/**
+ * @brief Möller–Trumbore com as arestas calculadas a partir do buffer de vértices.
+ */
+bool TriangleMesh::intersectTriangle(int triangle, const Vector3& origin, const Vector3& direction, Scalar* t) const
+{
+	const int* index = &(*this->indices)[3 * triangle];
+	const Vector3& v0 = this->vertices[index[0]];
+	return TriangularFace::mollerTrumbore(origin, direction, v0, this->vertices[index[1]] - v0, this->vertices[index[2]] - v0, t);
+}
+
+/**
+ * @brief Recalcula as caixas da árvore depois que os vértices mudam.
+ *
+ * Os filhos são sempre criados depois do pai, então percorrer os nós de trás para frente
+ * visita os filhos antes. A forma da árvore é mantida: depois de transformações afins ela
+ * continua agrupando triângulos vizinhos.
+ */
+void TriangleMesh::refit()
+{
+	const std::vector<int>& leafOrder = *this->order;
+
+	for (int n = (int)this->nodes.size() - 1; n >= 0; n--)
+	{
+		Node& node = this->nodes[n];
+		node.box = AABB();
+
+		if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				node.box.expand(this->triangleBox(leafOrder[i]));
+			}
+		}
+		else
+		{
+			node.box.expand(this->nodes[node.first].box);
+			node.box.expand(this->nodes[node.first + 1].box);
+		}
+	}
+}
+
+/**
+ * @brief Encontra o triângulo mais próximo pela BVH da malha.
+ *
+ * Só são aceitos triângulos dentro do intervalo do raio, e a busca já começa limitada por ray.tMax.
+ */
+bool TriangleMesh::intersect(const Ray& ray, HitRecord* hit) const
+{
+	if (this->nodes.empty())
+	{
+		return false;
+	}
+
+	const std::vector<int>& leafOrder = *this->order;
+	Scalar best = ray.tMax;
+	int bestTriangle = INT_MAX;
+
+	// Poda com folga: um nó que começa exatamente em best (raio rente a uma aresta) ainda pode
+	// ter um triângulo de índice menor empatado com o melhor, e o erro da caixa não deve descartá-lo
+	const Scalar slack = 1 + 16 * std::numeric_limits<Scalar>::epsilon();
+	Scalar limit = best * slack;
+
+	int stack[BVHBuilder::MAX_DEPTH + 2];
+	Scalar stackNear[BVHBuilder::MAX_DEPTH + 2];
+	int top = 0;
+
+	Scalar sNear;
+	if (this->nodes[0].box.intersect(ray, limit, &sNear))
+	{
+		stack[top] = 0;
+		stackNear[top] = sNear;
+		top++;
+	}
+
+	while (top > 0)
+	{
+		top--;
+
+		if (stackNear[top] > limit)
+		{
+			continue;
+		}
+
+		const Node& node = this->nodes[stack[top]];
+
+		if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				int triangle = leafOrder[i];
+				Scalar t;
+				if (this->intersectTriangle(triangle, ray.initialPoint, ray.direction, &t) && ray.contains(t))
+				{
+					if (t < best || (t == best && triangle < bestTriangle))
+					{
+						best = t;
+						bestTriangle = triangle;
+						limit = best * slack;
+					}
+				}
+			}
+			continue;
+		}
+
+		Scalar nearLeft, nearRight;
+		bool hitLeft = this->nodes[node.first].box.intersect(ray, limit, &nearLeft);
+		bool hitRight = this->nodes[node.first + 1].box.intersect(ray, limit, &nearRight);
+
+		if (hitLeft && hitRight)
+		{
+			bool leftFirst = nearLeft <= nearRight;
+			stack[top] = leftFirst ? node.first + 1 : node.first;
+			stackNear[top] = leftFirst ? nearRight : nearLeft;
+			top++;
+			stack[top] = leftFirst ? node.first : node.first + 1;
+			stackNear[top] = leftFirst ? nearLeft : nearRight;
+			top++;
+		}
+		else if (hitLeft)
+		{
+			stack[top] = node.first;
+			stackNear[top] = nearLeft;
+			top++;
+		}
+		else if (hitRight)
+		{
+			stack[top] = node.first + 1;
+			stackNear[top] = nearRight;
+			top++;
+		}
+	}
+
+	if (bestTriangle == INT_MAX)
+	{
+		return false;
+	}
+
+	// A normal só é calculada para o triângulo vencedor
+	hit->t = best;
+	hit->structure = bestTriangle;
+	hit->normal = this->getNormal(bestTriangle);
+	hit->hasUV = false;
+	return true;
+}
+
+/**
+ * @brief Verifica se algum triângulo bloqueia o segmento, parando no primeiro.
+ */
+bool TriangleMesh::occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+{
+	if (this->nodes.empty())
+	{
+		return false;
+	}
+
+	const std::vector<int>& leafOrder = *this->order;
+	Ray ray = Ray::fromDirection(origin, direction, 0, tMax);
+
+	int stack[BVHBuilder::MAX_DEPTH + 2];
+	int top = 0;
+	stack[top++] = 0;
+
+	Scalar sNear;
+	while (top > 0)
+	{
+		const Node& node = this->nodes[stack[--top]];
+
+		if (!node.box.intersect(ray, tMax, &sNear))
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				Scalar s;
+				if (this->intersectTriangle(leafOrder[i], origin, direction, &s) && ray.contains(s))
+				{
+					return true;
+				}
+			}
+			continue;
+		}
+
+		stack[top++] = node.first + 1;
+		stack[top++] = node.first;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Aplica a transformação a todos os vértices e reajusta a árvore.
+ */
+void TriangleMesh::transform(const Matrix4& m)
+{
+	for (auto& v : this->vertices)
+	{
+		Vector4 v4(v[0], v[1], v[2], 1);
+		v4 = m * v4;
+		v << v4[0], v4[1], v4[2];
+	}
+
+	this->refit();
+}
+
+/**
+ * @brief Translada a malha nas direções x, y e z.
+ */
+void TriangleMesh::translate(Scalar x, Scalar y, Scalar z)
+{
+	Matrix4 m;
+	m << 1, 0, 0, x,
+		0, 1, 0, y,
+		0, 0, 1, z,
+		0, 0, 0, 1;
+
+	this->transform(m);
+}
+
+/**
+ * @brief Escala a malha nas direções x, y e z.
+ */
+void TriangleMesh::scale(Scalar x, Scalar y, Scalar z)
+{
+	Matrix4 m;
+	m << x, 0, 0, 0,
+		0, y, 0, 0,
+		0, 0, z, 0,
+		0, 0, 0, 1;
+
+	this->transform(m);
+}
+
+/**
+ * @brief Rotaciona a malha em torno do eixo x.
+ */
+void TriangleMesh::rotateX(Scalar angle)
+{
+	Matrix4 m;
+	m << 1, 0, 0, 0,
+		0, cos(angle), -sin(angle), 0,
+		0, sin(angle), cos(angle), 0,
+		0, 0, 0, 1;
+
+	this->transform(m);
+}
+
+/**
+ * @brief Rotaciona a malha em torno do eixo y.
+ */
+void TriangleMesh::rotateY(Scalar angle)
+{
+	Matrix4 m;
+	m << cos(angle), 0, sin(angle), 0,
+		0, 1, 0, 0,
+		-sin(angle), 0, cos(angle), 0,
+		0, 0, 0, 1;
+
+	this->transform(m);
+}
+
+/**
+ * @brief Rotaciona a malha em torno do eixo z.
+ */
+void TriangleMesh::rotateZ(Scalar angle)
+{
+	Matrix4 m;
+	m << cos(angle), -sin(angle), 0, 0,
+		sin(angle), cos(angle), 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1;
+
+	this->transform(m);
+}
+
+/**
+ * @brief Converte os vértices para coordenadas de câmera.
+ */
+void TriangleMesh::convertToCamera(Matrix4 transformationMatrix)
+{
+	this->transform(transformationMatrix);
+}
+
+/**
+ * @brief Cria uma cópia da malha; os buffers de índices e a ordem da árvore são compartilhados.
+ */
+Object* TriangleMesh::clone() const
+{
+	return new TriangleMesh(*this);
+}
+
+/**
+ * @brief Obtém a caixa delimitadora da malha.
+ */
+bool TriangleMesh::getBounds(AABB* box) const
+{
+	*box = this->nodes.empty() ? AABB() : this->nodes[0].box;
+	return true;
+}
@@ -0,0 +1,172 @@
+#include "../eigen-3.4.0/Eigen/Dense"
+#include <memory>
+#include <vector>
+
+#include "AABB.h"
+#include "BVHBuilder.h"
+#include "Object.h"
+#include "Scalar.h"
+
+#ifndef TriangleMesh_H
+#define TriangleMesh_H
+
+/**
+ * @brief Malha de triângulos com buffers de vértices e de índices compartilhados.
+ *
+ * Cada vértice é guardado uma única vez e os triângulos o referenciam por índice; todos os
+ * triângulos usam o material da malha. A malha tem a sua própria BVH (SAH, pelo mesmo BVHBuilder da cena)
+ * sobre os triângulos, então uma malha com milhões de triângulos é um único objeto da cena
+ * e um raio visita só O(log n) deles.
+ *
+ * O buffer de índices e a ordem dos triângulos na árvore não mudam depois da construção e são
+ * compartilhados entre as cópias feitas por clone(); cada cópia tem os seus vértices, e as
+ * transformações só reajustam as caixas da árvore, sem reconstruí-la.
+ *
+ * Em intersect, structure recebe o índice do triângulo atingido.
+ */
+class TriangleMesh : public Object
+{
+public:
+	/**
+	 * @brief Constrói a malha e a sua BVH.
+	 *
+	 * @param vertices Os vértices.
+	 * @param indices Três índices de vértices por triângulo. A normal de (a, b, c) é (c - b) x (b - a), como na TriangularFace.
+	 * @param material Índice do material na tabela de materiais da cena (Scene::materials).
+	 */
+	TriangleMesh(const std::vector<Vector3>& vertices, const std::vector<int>& indices, int material);
+
+	/**
+	 * @brief Obtém o número de triângulos.
+	 */
+	int getNumTriangles() const;
+
+	/**
+	 * @brief Obtém o número de vértices.
+	 */
+	int getNumVertices() const;
+
+	/**
+	 * @brief Obtém o número de nós da BVH da malha.
+	 */
+	int getNumNodes() const;
+
+	/**
+	 * @brief Obtém a normal (unitária) de um triângulo nas coordenadas atuais.
+	 *
+	 * @param triangle O índice do triângulo.
+	 */
+	Vector3 getNormal(int triangle) const;
+
+	/**
+	 * @brief Calcula o triângulo mais próximo atingido pelo raio.
+	 *
+	 * Em caso de empate na distância vence o triângulo de menor índice, como na busca linear.
+	 *
+	 * @param ray O raio a ser verificado.
+	 * @param hit O registro a ser preenchido (structure = índice do triângulo atingido).
+	 * @return true se houver interseção.
+	 */
+	bool intersect(const Ray& ray, HitRecord* hit) const;
+
+	/**
+	 * @brief Verifica se algum triângulo bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 *
+	 * @param origin A origem do segmento.
+	 * @param direction A direção (unitária) do segmento.
+	 * @param tMax O comprimento do segmento.
+	 * @return true se o segmento estiver bloqueado.
+	 */
+	bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const;
+
+	/**
+	 * @brief Translada a malha nas direções x, y e z.
+	 */
+	void translate(Scalar x, Scalar y, Scalar z);
+
+	/**
+	 * @brief Escala a malha nas direções x, y e z (em relação à origem).
+	 */
+	void scale(Scalar x, Scalar y, Scalar z);
+
+	/**
+	 * @brief Rotaciona a malha em torno do eixo x (que passa pela origem).
+	 *
+	 * @param angle O ângulo de rotação em radianos.
+	 */
+	void rotateX(Scalar angle);
+
+	/**
+	 * @brief Rotaciona a malha em torno do eixo y (que passa pela origem).
+	 *
+	 * @param angle O ângulo de rotação em radianos.
+	 */
+	void rotateY(Scalar angle);
+
+	/**
+	 * @brief Rotaciona a malha em torno do eixo z (que passa pela origem).
+	 *
+	 * @param angle O ângulo de rotação em radianos.
+	 */
+	void rotateZ(Scalar angle);
+
+	/**
+	 * @brief Converte os vértices para o sistema de coordenadas da câmera.
+	 *
+	 * @param transformationMatrix A matriz de transformação para o sistema de coordenadas da câmera.
+	 */
+	void convertToCamera(Matrix4 transformationMatrix);
+
+	/**
+	 * @brief Cria uma cópia da malha (vértices e caixas próprios; índices compartilhados).
+	 *
+	 * @return Ponteiro para a nova malha.
+	 */
+	Object* clone() const;
+
+	/**
+	 * @brief Obtém a caixa delimitadora da malha (a caixa da raiz da árvore).
+	 *
+	 * @param box Ponteiro para armazenar a caixa.
+	 * @return true (a malha é limitada).
+	 */
+	bool getBounds(AABB* box) const;
+
+protected:
+	/**
+	 * @brief Aplica uma transformação afim a todos os vértices e reajusta as caixas da árvore.
+	 *
+	 * @param m A matriz da transformação.
+	 */
+	void transform(const Matrix4& m);
+
+private:
+	// Nó da árvore; nas folhas, first e count são um intervalo de posições em order
+	typedef BVHNode Node;
+
+	/**
+	 * Triângulo durante a construção: caixa, centro da caixa e índice.
+	 */
+	struct BuildEntry
+	{
+		AABB box;
+		Vector3 centroid;
+		int triangle;
+	};
+
+	std::vector<Vector3> vertices;                   // Vértices nas coordenadas atuais
+	std::shared_ptr<const std::vector<int>> indices; // Três índices por triângulo (compartilhado entre cópias)
+	std::shared_ptr<const std::vector<int>> order;   // Triângulos na ordem das folhas (compartilhado entre cópias)
+	std::vector<Node> nodes;                         // Nós da árvore; os filhos vêm sempre depois do pai
+
+	// Recalcula as caixas de baixo para cima depois que os vértices mudam
+	void refit();
+
+	// Caixa de um triângulo
+	AABB triangleBox(int triangle) const;
+
+	// Teste de um triângulo; t no parâmetro de direction (de qualquer sinal)
+	bool intersectTriangle(int triangle, const Vector3& origin, const Vector3& direction, Scalar* t) const;
+};
+
+#endif
@@ -3,78 +3,55 @@
 
 
 // Construtor da classe TriangularFace.
-TriangularFace::TriangularFace(Eigen::Vector3d v1, Eigen::Vector3d v2, Eigen::Vector3d v3, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex)
+TriangularFace::TriangularFace(Vector3 v1, Vector3 v2, Vector3 v3, int material)
 {
 	this->vertexes[0] = v1;
 	this->vertexes[1] = v2;
 	this->vertexes[2] = v3;
 
-	this->r1 = this->vertexes[1] - this->vertexes[0];
-	this->r2 = this->vertexes[2] - this->vertexes[1];
-	this->normal = (r2.cross(r1)).normalized();
+	this->updateGeometry();
 
-	this->kAmbient = kAmbient;
-	this->kDif = kDif;
-	this->kEsp = kEsp;
-	this->specularIndex = specularIndex;
+	this->material = material;
 }
 
-// Verifica se um raio intercepta a face triangular.
-double TriangularFace::hasInterceptedRay(Ray ray)
+// Recalcula as arestas e a normal depois que os vértices mudam.
+void TriangularFace::updateGeometry()
 {
-	double tInt = -((ray.initialPoint - this->vertexes[0]).dot(this->normal)) / (ray.direction.dot(this->normal));
-	Eigen::Vector3d pInt = ray.initialPoint + tInt * ray.direction;
-
-	double c1 = (((this->vertexes[2] - pInt).cross(this->vertexes[0] - pInt)).dot(this->normal)) / ((this->r1.cross(this->r2)).dot(this->normal));
-	double c2 = (((this->vertexes[0] - pInt).cross(this->vertexes[1] - pInt)).dot(this->normal)) / ((this->r1.cross(this->r2)).dot(this->normal));
-	double c3 = 1 - c1 - c2;
+	this->r1 = this->vertexes[1] - this->vertexes[0];
+	this->r2 = this->vertexes[2] - this->vertexes[1];
+	this->normal = (r2.cross(r1)).normalized();
 
-	if (c1 < 0 || c2 < 0 || c3 < 0)
-	{
-		return 1;
-	}
-	else
-	{
-		return tInt;
-	}
+	this->edge1 = this->vertexes[1] - this->vertexes[0];
+	this->edge2 = this->vertexes[2] - this->vertexes[0];
 }
 
-// Calcula a cor do ponto de interseção da face triangular.
-Eigen::Vector3d TriangularFace::computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows)
+// Calcula a interseção de um raio com a face triangular.
+bool TriangularFace::intersect(const Ray& ray, HitRecord* hit) const
 {
-	Eigen::Vector3d intesityEye(0, 0, 0);
+	Scalar tInt;
 
-	Eigen::Vector3d pInt = ray.initialPoint + tInt * ray.direction;
-
-	Eigen::Vector3d intesityAmbient(0, 0, 0);
-	Eigen::Vector3d intesityDifuse(0, 0, 0);
-	Eigen::Vector3d intesitySpecular(0, 0, 0);
-	Eigen::Vector3d singleDifuse;
-	Eigen::Vector3d singleSpecular;
-	Eigen::Vector3d normal = this->normal;
-
-	int idx = 0;
-	for (auto& source : sources)
+	if (!mollerTrumbore(ray.initialPoint, ray.direction, this->vertexes[0], this->edge1, this->edge2, &tInt) || !ray.contains(tInt))
 	{
-		source->computeIntensity(pInt, ray, &intesityAmbient, &intesityDifuse, &intesitySpecular, normal, this->kAmbient, this->kDif, this->kEsp, this->specularIndex, shadows[idx]);
-		idx++;
+		return false;
 	}
 
-	intesityEye = intesityDifuse + intesitySpecular + intesityAmbient;
-
-	return intesityEye;
+	hit->t = tInt;
+	hit->structure = 0;
+	hit->normal = this->normal;
+	hit->hasUV = false;
+	return true;
 }
 
 // Translada a face triangular nos eixos x, y e z.
-void TriangularFace::translate(double x, double y, double z)
+void TriangularFace::translate(Scalar x, Scalar y, Scalar z)
 {
-	Eigen::Matrix4d m;
+	Matrix4 m;
 	m << 1, 0, 0, x,
 		0, 1, 0, y,
 		0, 0, 1, z,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d vertexes4[3];
+	Vector4 vertexes4[3];
 	for (int i = 0; i < 3; i++)
 	{
 		vertexes4[i] << vertexes[i][0], vertexes[i][1], vertexes[i][2], 1;
@@ -82,21 +59,19 @@ void TriangularFace::translate(double x, double y, double z)
 		vertexes[i] << vertexes4[i][0], vertexes4[i][1], vertexes4[i][2];
 	}
 
-	this->r1 = this->vertexes[1] - this->vertexes[0];
-	this->r2 = this->vertexes[2] - this->vertexes[1];
-	this->normal = (r2.cross(r1)).normalized();
+	this->updateGeometry();
 }
 
 // Escala a face triangular nos eixos x, y e z.
-void TriangularFace::scale(double x, double y, double z)
+void TriangularFace::scale(Scalar x, Scalar y, Scalar z)
 {
-	Eigen::MatrixXd m(4, 4);
+	MatrixX m(4, 4);
 	m << x, 0, 0, 0,
 		0, y, 0, 0,
 		0, 0, z, 0,
 		0, 0, 0, 1;
 
-	Eigen::MatrixXd n(4, 3);
+	MatrixX n(4, 3);
 	n << vertexes[0][0], vertexes[1][0], vertexes[2][0],
 		vertexes[0][1], vertexes[1][1], vertexes[2][1],
 		vertexes[0][2], vertexes[1][2], vertexes[2][2],
@@ -110,21 +85,19 @@ void TriangularFace::scale(double x, double y, double z)
 		vertexes[i] << mn(0, i), mn(1, i), mn(2, i);
 	}
 
-	this->r1 = this->vertexes[1] - this->vertexes[0];
-	this->r2 = this->vertexes[2] - this->vertexes[1];
-	this->normal = (r2.cross(r1)).normalized();
+	this->updateGeometry();
 }
 
 // Rotaciona a face triangular no eixo x.
-void TriangularFace::rotateX(double angle)
+void TriangularFace::rotateX(Scalar angle)
 {
-	Eigen::Matrix4d rx;
+	Matrix4 rx;
 	rx << 1, 0, 0, 0,
 		0, cos(angle), -sin(angle), 0,
 		0, sin(angle), cos(angle), 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d vertexes4[3];
+	Vector4 vertexes4[3];
 	for (int i = 0; i < 3; i++)
 	{
 		vertexes4[i] << vertexes[i][0], vertexes[i][1], vertexes[i][2], 1;
@@ -132,21 +105,19 @@ void TriangularFace::rotateX(double angle)
 		vertexes[i] << vertexes4[i][0], vertexes4[i][1], vertexes4[i][2];
 	}
 
-	this->r1 = this->vertexes[1] - this->vertexes[0];
-	this->r2 = this->vertexes[2] - this->vertexes[1];
-	this->normal = (r2.cross(r1)).normalized();
+	this->updateGeometry();
 }
 
 // Rotaciona a face triangular no eixo y.
-void TriangularFace::rotateY(double angle)
+void TriangularFace::rotateY(Scalar angle)
 {
-	Eigen::Matrix4d rx;
+	Matrix4 rx;
 	rx << cos(angle), 0, sin(angle), 0,
 		0, 1, 0, 0,
 		-sin(angle), 0, cos(angle), 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d vertexes4[3];
+	Vector4 vertexes4[3];
 	for (int i = 0; i < 3; i++)
 	{
 		vertexes4[i] << vertexes[i][0], vertexes[i][1], vertexes[i][2], 1;
@@ -154,22 +125,20 @@ void TriangularFace::rotateY(double angle)
 		vertexes[i] << vertexes4[i][0], vertexes4[i][1], vertexes4[i][2];
 	}
 
-	this->r1 = this->vertexes[1] - this->vertexes[0];
-	this->r2 = this->vertexes[2] - this->vertexes[1];
-	this->normal = (r2.cross(r1)).normalized();
+	this->updateGeometry();
 }
 
 
 // Rotaciona a face triangular no eixo z.
-void TriangularFace::rotateZ(double angle)
+void TriangularFace::rotateZ(Scalar angle)
 {
-	Eigen::Matrix4d rx;
+	Matrix4 rx;
 	rx << cos(angle), -sin(angle), 0, 0,
 		sin(angle), cos(angle), 0, 0,
 		0, 0, 1, 0,
 		0, 0, 0, 1;
 
-	Eigen::Vector4d vertexes4[3];
+	Vector4 vertexes4[3];
 	for (int i = 0; i < 3; i++)
 	{
 		vertexes4[i] << vertexes[i][0], vertexes[i][1], vertexes[i][2], 1;
@@ -177,16 +146,14 @@ void TriangularFace::rotateZ(double angle)
 		vertexes[i] << vertexes4[i][0], vertexes4[i][1], vertexes4[i][2];
 	}
 
-	this->r1 = this->vertexes[1] - this->vertexes[0];
-	this->r2 = this->vertexes[2] - this->vertexes[1];
-	this->normal = (r2.cross(r1)).normalized();
+	this->updateGeometry();
 }
 
 
 // Converte a face triangular para o sistema de coordenadas da câmera.	
-void TriangularFace::convertToCamera(Eigen::Matrix4d transformationMatrix)
+void TriangularFace::convertToCamera(Matrix4 transformationMatrix)
 {
-	Eigen::Vector4d vertexes4[3];
+	Vector4 vertexes4[3];
 	for (int i = 0; i < 3; i++)
 	{
 		vertexes4[i] << vertexes[i][0], vertexes[i][1], vertexes[i][2], 1;
@@ -194,7 +161,29 @@ void TriangularFace::convertToCamera(Eigen::Matrix4d transformationMatrix)
 		vertexes[i] << vertexes4[i][0], vertexes4[i][1], vertexes4[i][2];
 	}
 
-	this->r1 = this->vertexes[1] - this->vertexes[0];
-	this->r2 = this->vertexes[2] - this->vertexes[1];
-	this->normal = (r2.cross(r1)).normalized();
+	this->updateGeometry();
+}
+
+// Verifica se a face bloqueia o segmento (mesmo teste de intersect, sem preencher o registro).
+bool TriangularFace::occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const
+{
+	Scalar s;
+	return mollerTrumbore(origin, direction, this->vertexes[0], this->edge1, this->edge2, &s) && s > 0 && s < tMax;
+}
+
+// Cria uma cópia da face triangular.
+Object* TriangularFace::clone() const
+{
+	return new TriangularFace(*this);
+}
+
+// Calcula a caixa delimitadora da face triangular.
+bool TriangularFace::getBounds(AABB* box) const
+{
+	*box = AABB();
+	for (int i = 0; i < 3; i++)
+	{
+		box->expand(this->vertexes[i]);
+	}
+	return true;
 }
\ No newline at end of file
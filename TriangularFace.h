@@ -1,4 +1,5 @@
 #include "Object.h"
+#include "Scalar.h"
 
 #ifndef TriangularFace_H
 #define TriangularFace_H
@@ -10,40 +11,40 @@
 class TriangularFace : public Object
 {
 public:
-	Eigen::Vector3d vertexes[3]; /**< Vetor de vértices da face triangular */
-	Eigen::Vector3d normal; /**< Vetor normal da face triangular */
+	Vector3 vertexes[3]; /**< Vetor de vértices da face triangular */
+	Vector3 normal; /**< Vetor normal da face triangular */
 
-	Eigen::Vector3d r1; /**< Vetor r1 da face triangular */
-	Eigen::Vector3d r2; /**< Vetor r2 da face triangular */
+	Vector3 r1; /**< Vetor r1 da face triangular */
+	Vector3 r2; /**< Vetor r2 da face triangular */
+
+	Vector3 edge1; /**< Aresta v2 - v1, pré-calculada para o teste de Möller–Trumbore */
+	Vector3 edge2; /**< Aresta v3 - v1, pré-calculada para o teste de Möller–Trumbore */
 
 	/**
 	 * Construtor da classe TriangularFace.
 	 * @param v1 Vértice 1 da face triangular
 	 * @param v2 Vértice 2 da face triangular
 	 * @param v3 Vértice 3 da face triangular
-	 * @param kAmbient Coeficiente de reflexão ambiente
-	 * @param kDif Coeficiente de reflexão difusa
-	 * @param kEsp Coeficiente de reflexão especular
-	 * @param specularIndex Índice especular
+	 * @param material Índice do material na tabela de materiais da cena (Scene::materials).
 	 */
-	TriangularFace(Eigen::Vector3d v1, Eigen::Vector3d v2, Eigen::Vector3d v3, Eigen::Vector3d kAmbient, Eigen::Vector3d kDif, Eigen::Vector3d kEsp, int specularIndex);
+	TriangularFace(Vector3 v1, Vector3 v2, Vector3 v3, int material);
 
 	/**
-	 * Verifica se um raio intercepta a face triangular.
+	 * Calcula a interseção de um raio com a face triangular (Möller–Trumbore com as arestas pré-calculadas).
 	 * @param ray Raio a ser verificado
+	 * @param hit Registro a ser preenchido (t e normal)
 	 * @return Valor booleano indicando se houve interceptação
 	 */
-	double hasInterceptedRay(Ray ray);
+	bool intersect(const Ray& ray, HitRecord* hit) const;
 
 	/**
-	 * Calcula a cor da face triangular com base no raio interceptado.
-	 * @param tInt Valor de interceptação do raio
-	 * @param ray Raio interceptado
-	 * @param sources Vetor de fontes de luz
-	 * @param shadows Vetor de sombras
-	 * @return Vetor de cor calculada
+	 * Verifica se a face bloqueia o segmento origin + s * direction, com 0 < s < tMax.
+	 * @param origin Origem do segmento
+	 * @param direction Direção (unitária) do segmento
+	 * @param tMax Comprimento do segmento
+	 * @return true se o segmento atravessa a face
 	 */
-	Eigen::Vector3d computeColor(double tInt, Ray ray, std::vector<LightSource*> sources, std::vector<bool> shadows);
+	bool occluded(const Vector3& origin, const Vector3& direction, Scalar tMax) const;
 
 	/**
 	 * Translada a face triangular nos eixos x, y e z.
@@ -51,7 +52,7 @@ public:
 	 * @param y Valor de translação no eixo y
 	 * @param z Valor de translação no eixo z
 	 */
-	void translate(double x, double y, double z);
+	void translate(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * Escala a face triangular nos eixos x, y e z.
@@ -59,31 +60,100 @@ public:
 	 * @param y Valor de escala no eixo y
 	 * @param z Valor de escala no eixo z
 	 */
-	void scale(double x, double y, double z);
+	void scale(Scalar x, Scalar y, Scalar z);
 
 	/**
 	 * Rotaciona a face triangular no eixo x.
 	 * @param angle Ângulo de rotação em radianos
 	 */
-	void rotateX(double angle);
+	void rotateX(Scalar angle);
 
 	/**
 	 * Rotaciona a face triangular no eixo y.
 	 * @param angle Ângulo de rotação em radianos
 	 */
-	void rotateY(double angle);
+	void rotateY(Scalar angle);
 
 	/**
 	 * Rotaciona a face triangular no eixo z.
 	 * @param angle Ângulo de rotação em radianos
 	 */
-	void rotateZ(double angle);
+	void rotateZ(Scalar angle);
 
 	/**
 	 * Converte a face triangular para o sistema de coordenadas da câmera.
 	 * @param transformationMatrix Matriz de transformação
 	 */
-	void convertToCamera(Eigen::Matrix4d transformationMatrix);
+	void convertToCamera(Matrix4 transformationMatrix);
+
+	/**
+	 * Cria uma cópia da face triangular.
+	 * @return Ponteiro para a nova face
+	 */
+	Object* clone() const;
+
+	/**
+	 * Calcula a caixa delimitadora da face triangular a partir dos vértices.
+	 * @param box Ponteiro para armazenar a caixa
+	 * @return true (a face é limitada)
+	 */
+	bool getBounds(AABB* box) const;
+
+	/**
+	 * Teste de Möller–Trumbore do raio origin + t * direction contra o triângulo v0, v0 + edge1, v0 + edge2.
+	 * Também usado pela TriangleMesh, que calcula as arestas a partir do seu buffer de vértices.
+	 * @param origin Origem do raio
+	 * @param direction Direção do raio
+	 * @param v0 Primeiro vértice
+	 * @param edge1 Aresta v1 - v0
+	 * @param edge2 Aresta v2 - v0
+	 * @param t Ponteiro para armazenar o parâmetro da interseção (de qualquer sinal)
+	 * @return true se a reta do raio atravessa o triângulo
+	 */
+	static bool mollerTrumbore(const Vector3& origin, const Vector3& direction, const Vector3& v0,
+							   const Vector3& edge1, const Vector3& edge2, Scalar* t);
+
+private:
+	/**
+	 * Recalcula r1, r2, a normal e as arestas do teste de interseção a partir dos vértices.
+	 * Chamado só quando os vértices mudam (construtor, transformações e convertToCamera).
+	 */
+	void updateGeometry();
 };
 
+// Möller–Trumbore: resolve origin + t * direction = v0 + u * edge1 + v * edge2 e devolve false
+// assim que uma coordenada baricêntrica sai do triângulo.
+inline bool TriangularFace::mollerTrumbore(const Vector3& origin, const Vector3& direction, const Vector3& v0,
+									const Vector3& edge1, const Vector3& edge2, Scalar* t)
+{
+	Vector3 p = direction.cross(edge2);
+	Scalar det = edge1.dot(p);
+
+	// Raio paralelo ao plano da face
+	if (det == 0)
+	{
+		return false;
+	}
+
+	Scalar invDet = 1 / det;
+	Vector3 s = origin - v0;
+
+	Scalar u = s.dot(p) * invDet;
+	if (u < 0 || u > 1)
+	{
+		return false;
+	}
+
+	Vector3 q = s.cross(edge1);
+
+	Scalar v = direction.dot(q) * invDet;
+	if (v < 0 || u + v > 1)
+	{
+		return false;
+	}
+
+	*t = edge2.dot(q) * invDet;
+	return true;
+}
+
 #endif
\ No newline at end of file
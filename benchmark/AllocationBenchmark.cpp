@@ -0,0 +1,158 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "../Canvas.h"
+#include "../Framebuffer.h"
+#include "../GBuffer.h"
+#include "../PontualSource.h"
+#include "../RenderScene.h"
+#include "../SeasonsScene.h"
+
+/*
+Conta as chamadas de operator new durante a renderização da cena das estações. Cada configuração
+(um raio por vez ou em pacotes, com e sem threads, por raycast ou pela renderização adiada)
+renderiza um quadro de aquecimento, que pode alocar os buffers do Canvas, o G-buffer e o pool de
+threads, e depois mais quadros contados. A cena de inverno também é renderizada com uma grade de
+postes (fontes com raio de influência, escolhidas pelo LightIndex, com sorteio acima de 4 por ponto).
+Termina com código 1 se algum quadro depois do aquecimento alocou memória.
+*/
+
+static std::atomic<bool> counting(false);
+static std::atomic<long> allocations(0);
+
+static void* countedAlloc(std::size_t size)
+{
+	if (counting.load(std::memory_order_relaxed))
+	{
+		allocations.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void* p = std::malloc(size == 0 ? 1 : size);
+	if (p == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new(std::size_t size)
+{
+	return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return countedAlloc(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+int main()
+{
+	const int side = 200;
+	const int frames = 3;
+	struct Configuration
+	{
+		Season season;
+		bool lamps;
+	};
+	Configuration configurations[] = { { SUMMER, false }, { WINTER, false }, { WINTER, true } };
+	int threads[] = { 1, 4 };
+	int packets[] = { 0, 4, 8 };
+	bool failed = false;
+
+	printf("%8s %8s %8s %8s %9s %12s\n", "estação", "postes", "threads", "pacote", "adiada", "alocações");
+
+	for (const Configuration& configuration : configurations)
+	{
+		Season season = configuration.season;
+		Scene authoring;
+		buildSeasonsScene(authoring, season);
+
+		if (configuration.lamps)
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				Vector3 position(-150 + 100 * (i % 4), -50, -420 + 100 * (i / 4));
+				authoring.addSource(new PontualSource(position, Vector3(0.5, 0.5, 0.4), Vector3(1, 0.01, 0.0005), 120));
+			}
+		}
+
+		RenderScene scene(authoring);
+		scene.setMaxLights(4);
+		Framebuffer image(side, side, Framebuffer::RGB_FLOAT);
+		GBuffer gbuffer;
+
+		for (int numThreads : threads)
+		{
+			for (int packet : packets)
+			{
+				for (bool deferred : { false, true })
+				{
+					Canvas canvas(30, 60, 60, side, side);
+					canvas.setTiling(numThreads, 8);
+					canvas.setPacketSize(packet);
+
+					auto render = [&]()
+					{
+						if (deferred)
+						{
+							canvas.trace(Vector3(0, 0, 0), scene, &gbuffer);
+							canvas.shade(scene, gbuffer, &image);
+						}
+						else
+						{
+							canvas.raycast(Vector3(0, 0, 0), scene, &image);
+						}
+					};
+
+					// Aquecimento: buffers por thread, G-buffer e pool de threads
+					render();
+
+					allocations = 0;
+					counting = true;
+					for (int f = 0; f < frames; f++)
+					{
+						render();
+					}
+					counting = false;
+
+					long count = allocations.load();
+					printf("%8s %8s %8d %8d %9s %12ld\n", season == SUMMER ? "summer" : "winter", configuration.lamps ? "sim" : "não",
+						   numThreads, packet, deferred ? "sim" : "não", count);
+					failed = failed || count != 0;
+				}
+			}
+		}
+	}
+
+	if (failed)
+	{
+		printf("FALHA: a renderização alocou memória depois do aquecimento\n");
+		return 1;
+	}
+
+	printf("OK: nenhuma alocação por raio\n");
+	return 0;
+}
@@ -0,0 +1,141 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../BVH.h"
+#include "../Sphere.h"
+
+/*
+Compara a busca linear com a BVH na interseção mais próxima de raios primários
+contra cenas de esferas aleatórias, de 20 a 100 mil objetos. Imprime o tempo médio
+por raio (ns/raio) de cada método e o ganho da BVH.
+*/
+
+// Busca linear, como o Canvas fazia antes da BVH
+static bool closestLinear(const std::vector<Object*>& objects, const Ray& ray, HitRecord* closest, Object** object)
+{
+	HitRecord hit;
+	double minimum = INFINITY;
+	bool found = false;
+
+	for (auto& o : objects)
+	{
+		if (o->intersect(ray, &hit) && hit.t < minimum)
+		{
+			minimum = hit.t;
+			*closest = hit;
+			*object = o;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+// Raios da câmera na origem através de uma janela de lado 60 a distância 30
+static std::vector<Ray> makeRays(int side)
+{
+	std::vector<Ray> rays;
+	Vector3 observable(0, 0, 0);
+
+	for (int l = 0; l < side; l++)
+	{
+		for (int c = 0; c < side; c++)
+		{
+			Vector3 pJ(-30 + (c + 0.5) * 60 / side, 30 - (l + 0.5) * 60 / side, -30);
+			rays.push_back(Ray(observable, pJ));
+		}
+	}
+
+	return rays;
+}
+
+// Executa method para todos os raios e devolve ns/raio (e o número de acertos em hits)
+template <typename Method>
+static double measure(const std::vector<Ray>& rays, Method method, int* hits)
+{
+	HitRecord hit;
+	Object* object;
+	*hits = 0;
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (auto& ray : rays)
+	{
+		if (method(ray, &hit, &object))
+		{
+			(*hits)++;
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / rays.size();
+}
+
+int main()
+{
+	int sizes[] = { 20, 100, 1000, 10000, 100000 };
+	// Só interseção: nenhum objeto é sombreado, então o índice do material não é usado
+	int material = 0;
+
+	printf("%10s %12s %14s %14s %10s\n", "objetos", "build (ms)", "linear ns/raio", "BVH ns/raio", "ganho");
+
+	for (int n : sizes)
+	{
+		std::mt19937 random(n);
+		std::uniform_real_distribution<double> xy(-300, 300), z(-1300, -200);
+
+		// Raio escolhido para manter a fração da cena ocupada parecida entre os tamanhos
+		double radius = 250 / std::cbrt((double)n);
+
+		std::vector<Object*> objects;
+		for (int i = 0; i < n; i++)
+		{
+			objects.push_back(new Sphere(radius, Vector3(xy(random), xy(random), z(random)), material));
+		}
+
+		BVH bvh;
+		auto b0 = std::chrono::steady_clock::now();
+		bvh.build(objects);
+		auto b1 = std::chrono::steady_clock::now();
+
+		// A busca linear fica lenta demais em cenas grandes, então usa menos raios
+		std::vector<Ray> rays = makeRays(256);
+		std::vector<Ray> linearRays = makeRays(n > 10000 ? 32 : (n > 1000 ? 64 : 256));
+
+		int linearHits, bvhHits;
+		double linear = measure(linearRays, [&](const Ray& r, HitRecord* h, Object** o) { return closestLinear(objects, r, h, o); }, &linearHits);
+		double accelerated = measure(rays, [&](const Ray& r, HitRecord* h, Object** o) { return bvh.intersect(r, h, o); }, &bvhHits);
+
+		// Confere se os dois métodos encontram o mesmo objeto nos raios da busca linear
+		int mismatches = 0;
+		for (auto& ray : linearRays)
+		{
+			HitRecord h1, h2;
+			Object* o1 = NULL;
+			Object* o2 = NULL;
+			closestLinear(objects, ray, &h1, &o1);
+			bvh.intersect(ray, &h2, &o2);
+			if (o1 != o2)
+			{
+				mismatches++;
+			}
+		}
+
+		printf("%10d %12.2f %14.1f %14.1f %9.1fx", n, std::chrono::duration<double, std::milli>(b1 - b0).count(), linear, accelerated, linear / accelerated);
+		if (mismatches > 0)
+		{
+			printf("  (%d raios divergentes!)", mismatches);
+		}
+		printf("\n");
+
+		for (auto& o : objects)
+		{
+			delete o;
+		}
+	}
+
+	return 0;
+}
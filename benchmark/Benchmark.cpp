@@ -0,0 +1,261 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../AmbientSource.h"
+#include "../Canvas.h"
+#include "../Cilinder.h"
+#include "../CircularPlane.h"
+#include "../Cone.h"
+#include "../Cube.h"
+#include "../Framebuffer.h"
+#include "../Plane.h"
+#include "../PontualSource.h"
+#include "../RenderScene.h"
+#include "../SeasonsScene.h"
+#include "../Sphere.h"
+#include "../TriangleMesh.h"
+#include "../TriangularFace.h"
+
+/*
+Benchmark dos kernels de interseção e de quadros completos.
+
+Micro: para cada primitiva, mede intersect (o kernel de hasInterceptedRay), occluded e
+shade (o antigo computeColor) com raios aleatórios que acertam cerca de metade das vezes.
+Macro: renderiza a cena das estações em várias resoluções pelo Canvas e mede o tempo por
+quadro, incluindo a compilação da RenderScene.
+
+Uso: benchmark [threads] [quadros]
+  threads  Threads da renderização por blocos (padrão 1; 0 = todos os núcleos).
+  quadros  Quadros medidos por resolução (padrão 3).
+*/
+
+// Evita que o compilador descarte os resultados dos kernels
+static volatile double sink;
+
+// Raios da origem em direção a pontos aleatórios de uma caixa em torno do objeto
+static std::vector<Ray> makeRays(const Vector3& center, double halfSide, int count)
+{
+	std::mt19937 random(42);
+	std::uniform_real_distribution<double> offset(-halfSide, halfSide);
+	std::vector<Ray> rays;
+	Vector3 observable(0, 0, 0);
+
+	for (int i = 0; i < count; i++)
+	{
+		Vector3 target = center + Vector3(offset(random), offset(random), offset(random));
+		rays.push_back(Ray(observable, target));
+	}
+
+	return rays;
+}
+
+static double elapsedNs(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1)
+{
+	return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+// Esfera triangulada com rings * segments * 2 triângulos (menos os das pontas)
+static TriangleMesh* makeSphereMesh(const Vector3& center, double radius, int rings, int segments, int material)
+{
+	std::vector<Vector3> vertices;
+	std::vector<int> indices;
+
+	for (int r = 0; r <= rings; r++)
+	{
+		double theta = M_PI * r / rings;
+		for (int s = 0; s < segments; s++)
+		{
+			double phi = 2 * M_PI * s / segments;
+			vertices.push_back(center + radius * Vector3(sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi)));
+		}
+	}
+
+	for (int r = 0; r < rings; r++)
+	{
+		for (int s = 0; s < segments; s++)
+		{
+			int a = r * segments + s, b = r * segments + (s + 1) % segments;
+			int c = a + segments, d = b + segments;
+			if (r > 0)
+			{
+				indices.insert(indices.end(), { a, b, c });
+			}
+			if (r < rings - 1)
+			{
+				indices.insert(indices.end(), { b, d, c });
+			}
+		}
+	}
+
+	return new TriangleMesh(vertices, indices, material);
+}
+
+// Mede os três kernels de uma primitiva e imprime uma linha da tabela
+static void benchPrimitive(const char* name, Object* object, const Vector3& center, double halfSide, const std::vector<LightSource*>& sources,
+						   const MaterialTable& materials)
+{
+	const int numRays = 200000;
+	std::vector<Ray> rays = makeRays(center, halfSide, numRays);
+	std::vector<bool> shadows(sources.size(), false);
+	HitRecord hit;
+	double checksum = 0;
+	int hits = 0;
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (auto& ray : rays)
+	{
+		if (object->intersect(ray, &hit))
+		{
+			checksum += hit.t;
+			hits++;
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	// Segmentos da origem até a distância do centro, na direção de cada raio
+	double tMax = center.norm();
+	int blocked = 0;
+	auto t2 = std::chrono::steady_clock::now();
+	for (auto& ray : rays)
+	{
+		if (object->occluded(ray.initialPoint, ray.direction, tMax))
+		{
+			blocked++;
+		}
+	}
+	auto t3 = std::chrono::steady_clock::now();
+
+	// Sombreamento só dos raios que acertam, como no Canvas
+	std::vector<Ray> hitRays;
+	std::vector<HitRecord> records;
+	for (auto& ray : rays)
+	{
+		if (object->intersect(ray, &hit))
+		{
+			hitRays.push_back(ray);
+			records.push_back(hit);
+		}
+	}
+
+	auto t4 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < hitRays.size(); i++)
+	{
+		checksum += object->shade(hitRays[i], records[i], sources, shadows, materials).sum();
+	}
+	auto t5 = std::chrono::steady_clock::now();
+
+	sink = checksum + blocked;
+
+	double intersectNs = elapsedNs(t0, t1) / numRays;
+	double occludedNs = elapsedNs(t2, t3) / numRays;
+	double shadeNs = hitRays.empty() ? 0 : elapsedNs(t4, t5) / hitRays.size();
+
+	printf("%-15s %7.1f%% %10.1f %10.2f %10.1f %10.2f %10.1f %10.2f\n", name, 100.0 * hits / numRays,
+		   intersectNs, 1000 / intersectNs, occludedNs, 1000 / occludedNs, shadeNs, shadeNs > 0 ? 1000 / shadeNs : 0);
+}
+
+static void runMicro()
+{
+	Vector3 color(100, 100, 100), specular(40, 40, 40);
+	Vector3 center(0, 0, -200);
+
+	MaterialTable materials;
+	int material = materials.add(Material(color, color, specular, 6));
+
+	std::vector<LightSource*> sources;
+	sources.push_back(new PontualSource(Vector3(-30, 60, 0), Vector3(0.7, 0.7, 0.7)));
+	sources.push_back(new AmbientSource(Vector3(0.3, 0.3, 0.3)));
+
+	struct Primitive
+	{
+		const char* name;
+		Object* object;
+		double halfSide;
+	};
+
+	// Caixas de amostragem escolhidas para que cerca de metade dos raios acerte o objeto
+	std::vector<Primitive> primitives;
+	primitives.push_back({ "Sphere", new Sphere(30, center, material), 45 });
+	primitives.push_back({ "Plane", new Plane(NULL, Vector3(0, 1, 0), center - Vector3(0, 5, 0), material), 30 });
+	primitives.push_back({ "CircularPlane", new CircularPlane(Vector3(0, 0, 1), center, 30, material), 42 });
+	primitives.push_back({ "Cilinder", new Cilinder(20, 60, center - Vector3(0, 30, 0), Vector3(0, 1, 0), material), 40 });
+	primitives.push_back({ "Cone", new Cone(30, 60, center - Vector3(0, 30, 0), Vector3(0, 1, 0), material), 40 });
+	primitives.push_back({ "Cilinder incl.", new Cilinder(20, 60, center - Vector3(15, 25, 0), Vector3(1, 2, 0), material), 40 });
+	primitives.push_back({ "Cone incl.", new Cone(30, 60, center - Vector3(15, 25, 0), Vector3(1, 2, 0), material), 40 });
+	primitives.push_back({ "TriangularFace", new TriangularFace(center + Vector3(-30, -30, 0), center + Vector3(30, -30, 0), center + Vector3(0, 30, 0), material), 35 });
+	primitives.push_back({ "Cube", new Cube(center - Vector3(20, 20, -20), 40, 40, 40, material), 40 });
+	primitives.push_back({ "Mesh 10k", makeSphereMesh(center, 30, 50, 100, material), 45 });
+	primitives.push_back({ "Mesh 1M", makeSphereMesh(center, 30, 500, 1000, material), 45 });
+
+	printf("Kernels por primitiva (200000 raios cada)\n");
+	printf("%-15s %8s %10s %10s %10s %10s %10s %10s\n", "primitiva", "acertos", "inter ns", "Mraios/s", "oclus ns", "Mraios/s", "shade ns", "Mraios/s");
+
+	for (auto& p : primitives)
+	{
+		benchPrimitive(p.name, p.object, center, p.halfSide, sources, materials);
+		delete p.object;
+	}
+
+	for (auto& s : sources)
+	{
+		delete s;
+	}
+}
+
+static void runFrames(int numThreads, int numFrames)
+{
+	int resolutions[] = { 125, 250, 500, 1000 };
+
+	Scene authoring;
+	buildSeasonsScene(authoring);
+
+	printf("\nQuadros da cena das estações (%d objetos, %d quadros por resolução, %d threads)\n", (int)authoring.getAllObjects().size(), numFrames, numThreads);
+	printf("%10s %14s %12s %12s %12s\n", "resolução", "compilar (ms)", "ms/quadro", "Mraios/s", "ns/raio");
+
+	for (int n : resolutions)
+	{
+		Canvas canvas(30, 60, 60, n, n);
+		canvas.setTiling(numThreads, 16);
+
+		auto c0 = std::chrono::steady_clock::now();
+		RenderScene scene(authoring);
+		auto c1 = std::chrono::steady_clock::now();
+
+		// Um quadro de aquecimento cria o pool de threads e carrega os caches
+		Framebuffer image(n, n, Framebuffer::RGB_FLOAT);
+		canvas.raycast(Vector3(0, 0, 0), scene, &image);
+
+		auto t0 = std::chrono::steady_clock::now();
+		for (int f = 0; f < numFrames; f++)
+		{
+			canvas.raycast(Vector3(0, 0, 0), scene, &image);
+		}
+		auto t1 = std::chrono::steady_clock::now();
+
+		double frameNs = elapsedNs(t0, t1) / numFrames;
+		double rayNs = frameNs / ((double)n * n);
+
+		printf("%10d %14.3f %12.2f %12.2f %12.1f\n", n, elapsedNs(c0, c1) / 1e6, frameNs / 1e6, 1000 / rayNs, rayNs);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int numThreads = argc > 1 ? atoi(argv[1]) : 1;
+	int numFrames = argc > 2 ? atoi(argv[2]) : 3;
+
+	if (numFrames < 1)
+	{
+		numFrames = 1;
+	}
+
+	runMicro();
+	runFrames(numThreads, numFrames);
+
+	return 0;
+}
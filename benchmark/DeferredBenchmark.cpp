@@ -0,0 +1,128 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "../Canvas.h"
+#include "../Framebuffer.h"
+#include "../GBuffer.h"
+#include "../MaterialTable.h"
+#include "../RenderScene.h"
+#include "../SeasonsScene.h"
+
+/*
+Compara a renderização adiada (Canvas::trace seguido de Canvas::shade) com Canvas::raycast na
+cena das estações. Confere se as imagens são idênticas e mede quanto custa cada passada. Depois
+altera só o sombreamento (a intensidade das fontes e um material) e confere se refazer apenas
+Canvas::shade dá a mesma imagem que um raycast completo com a alteração.
+
+Termina com código 1 se alguma imagem for diferente.
+*/
+
+static double elapsedMs(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1)
+{
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// Número de pixels diferentes entre duas imagens RGB_FLOAT do mesmo tamanho
+static int countDifferences(const Framebuffer& a, const Framebuffer& b)
+{
+	int differences = 0;
+
+	for (int l = 0; l < a.getNumLines(); l++)
+	{
+		const float* rowA = a.rowRGB(l);
+		const float* rowB = b.rowRGB(l);
+
+		for (int c = 0; c < a.getNumColumns(); c++)
+		{
+			if (memcmp(rowA + 3 * c, rowB + 3 * c, 3 * sizeof(float)) != 0)
+			{
+				differences++;
+			}
+		}
+	}
+
+	return differences;
+}
+
+int main()
+{
+	const int side = 500;
+	const int repetitions = 3;
+	Season seasons[] = { SUMMER, WINTER };
+	int packets[] = { 0, 8 };
+	bool failed = false;
+
+	printf("Renderização adiada, %dx%d, 1 thread (melhor de %d)\n", side, side, repetitions);
+	printf("%8s %8s %12s %10s %10s %12s %12s\n", "estação", "pacote", "raycast ms", "trace ms", "shade ms", "diferentes", "após edição");
+
+	for (Season season : seasons)
+	{
+		Scene authoring;
+		buildSeasonsScene(authoring, season);
+
+		for (int packet : packets)
+		{
+			// Cada configuração compila a cena de novo, para que as edições da anterior não valham aqui
+			RenderScene scene(authoring);
+			Canvas canvas(30, 60, 60, side, side);
+			canvas.setPacketSize(packet);
+
+			Framebuffer reference(side, side, Framebuffer::RGB_FLOAT);
+			Framebuffer deferred(side, side, Framebuffer::RGB_FLOAT);
+			GBuffer gbuffer;
+
+			double raycastMs = 1e30, traceMs = 1e30, shadeMs = 1e30;
+			for (int r = 0; r < repetitions; r++)
+			{
+				auto t0 = std::chrono::steady_clock::now();
+				canvas.raycast(Vector3(0, 0, 0), scene, &reference);
+				auto t1 = std::chrono::steady_clock::now();
+				canvas.trace(Vector3(0, 0, 0), scene, &gbuffer);
+				auto t2 = std::chrono::steady_clock::now();
+				canvas.shade(scene, gbuffer, &deferred);
+				auto t3 = std::chrono::steady_clock::now();
+
+				raycastMs = std::min(raycastMs, elapsedMs(t0, t1));
+				traceMs = std::min(traceMs, elapsedMs(t1, t2));
+				shadeMs = std::min(shadeMs, elapsedMs(t2, t3));
+			}
+
+			int differences = countDifferences(reference, deferred);
+
+			// Edição só de sombreamento: fontes mais fracas e o material do primeiro objeto atingido trocado
+			for (LightSource* source : scene.getSources())
+			{
+				source->intensity *= 0.5;
+			}
+
+			int material = -1;
+			for (size_t i = 0; i < gbuffer.objects.size() && material < 0; i++)
+			{
+				material = gbuffer.materials[i];
+			}
+
+			Material edited = scene.getMaterials().get(material);
+			edited.kDif = Vector3(10, 200, 10);
+			scene.setMaterial(material, edited);
+
+			canvas.shade(scene, gbuffer, &deferred);
+			canvas.raycast(Vector3(0, 0, 0), scene, &reference);
+			int editedDifferences = countDifferences(reference, deferred);
+
+			printf("%8s %8d %12.2f %10.2f %10.2f %12d %12d\n", season == SUMMER ? "summer" : "winter", packet,
+				   raycastMs, traceMs, shadeMs, differences, editedDifferences);
+			failed = failed || differences != 0 || editedDifferences != 0;
+		}
+	}
+
+	if (failed)
+	{
+		printf("FALHA: a renderização adiada difere de raycast\n");
+		return 1;
+	}
+
+	printf("OK: trace + shade é idêntico a raycast\n");
+	return 0;
+}
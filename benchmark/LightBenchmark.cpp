@@ -0,0 +1,157 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include "../Canvas.h"
+#include "../Framebuffer.h"
+#include "../PontualSource.h"
+#include "../RenderScene.h"
+#include "../SeasonsScene.h"
+
+/*
+Mede o custo de muitas fontes de luz numa versão noturna da cena de inverno: a fonte pontual da
+cena fica fraca e é acrescentada uma grade de postes (fontes pontuais com atenuação e raio de
+influência). Compara avaliar todas as fontes em todos os pixels com a grade de fontes do
+LightIndex, que deve dar a mesma imagem, e com o sorteio na árvore de fontes, que troca um pouco
+de ruído por menos fontes por pixel. Por fim confere que a renderização adiada com sorteio
+(trace, mudança de intensidade das fontes, shade) dá a mesma imagem de raycast.
+
+Termina com código 1 se a grade de fontes ou a renderização adiada mudar a imagem.
+*/
+
+static double elapsedMs(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1)
+{
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// Renderiza o melhor de repetitions vezes e devolve o tempo em ms
+static double render(Canvas& canvas, const RenderScene& scene, Framebuffer* image, int repetitions)
+{
+	double best = 1e30;
+	for (int r = 0; r < repetitions; r++)
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		canvas.raycast(Vector3(0, 0, 0), scene, image);
+		auto t1 = std::chrono::steady_clock::now();
+		best = std::min(best, elapsedMs(t0, t1));
+	}
+	return best;
+}
+
+// Número de pixels diferentes e erro médio relativo (soma de |a - b| sobre a soma de |a|)
+static int compare(const Framebuffer& a, const Framebuffer& b, double* error)
+{
+	int differences = 0;
+	double sumDifference = 0, sum = 0;
+
+	for (int l = 0; l < a.getNumLines(); l++)
+	{
+		const float* rowA = a.rowRGB(l);
+		const float* rowB = b.rowRGB(l);
+
+		for (int k = 0; k < 3 * a.getNumColumns(); k++)
+		{
+			differences += rowA[k] != rowB[k];
+			sumDifference += std::abs(rowA[k] - rowB[k]);
+			sum += std::abs(rowA[k]);
+		}
+	}
+
+	*error = sum > 0 ? sumDifference / sum : 0;
+	return differences;
+}
+
+int main()
+{
+	const int side = 300;
+	const int repetitions = 3;
+	const int lampsPerSide = 8;
+
+	Scene authoring;
+	buildSeasonsScene(authoring, WINTER);
+	authoring.sources[0]->intensity = Vector3(0.05, 0.05, 0.08);
+
+	// Postes sobre o gramado, de x = -150 a 150 e z = -420 a -100
+	for (int i = 0; i < lampsPerSide; i++)
+	{
+		for (int j = 0; j < lampsPerSide; j++)
+		{
+			Vector3 position(-150 + 300.0 * i / (lampsPerSide - 1), -50, -420 + 320.0 * j / (lampsPerSide - 1));
+			authoring.addSource(new PontualSource(position, Vector3(0.6, 0.55, 0.4), Vector3(1, 0.01, 0.0005), 90));
+		}
+	}
+
+	RenderScene scene(authoring);
+	Canvas canvas(30, 60, 60, side, side);
+
+	Framebuffer all(side, side, Framebuffer::RGB_FLOAT);
+	Framebuffer culled(side, side, Framebuffer::RGB_FLOAT);
+
+	// Todas as fontes em todos os pixels
+	scene.setLightCulling(false);
+	scene.setMaxLights(0);
+	double allMs = render(canvas, scene, &all, repetitions);
+
+	// Só as fontes cujo raio alcança o ponto
+	scene.setLightCulling(true);
+	double culledMs = render(canvas, scene, &culled, repetitions);
+
+	double culledError;
+	int culledDifferences = compare(all, culled, &culledError);
+
+	printf("Muitas fontes: inverno à noite com %d postes, %dx%d, 1 thread (melhor de %d)\n",
+		   lampsPerSide * lampsPerSide, side, side, repetitions);
+	printf("%-26s %10s %10s %12s %10s\n", "fontes por ponto", "ms", "speedup", "diferentes", "erro");
+	printf("%-26s %10.2f %10.2fx %12s %10s\n", "todas", allMs, 1.0, "-", "-");
+	printf("%-26s %10.2f %10.2fx %12d %9.4f%%\n", "grade (raio de influência)", culledMs, allMs / culledMs, culledDifferences, 100 * culledError);
+
+	// Sorteio na árvore acima de maxLights fontes por ponto
+	int limits[] = { 8, 4 };
+	for (int maxLights : limits)
+	{
+		Framebuffer sampled(side, side, Framebuffer::RGB_FLOAT);
+		scene.setMaxLights(maxLights);
+		double sampledMs = render(canvas, scene, &sampled, repetitions);
+
+		double sampledError;
+		int sampledDifferences = compare(all, sampled, &sampledError);
+
+		char name[32];
+		snprintf(name, sizeof(name), "grade + árvore (%d)", maxLights);
+		printf("%-26s %10.2f %10.2fx %12d %9.4f%%\n", name, sampledMs, allMs / sampledMs, sampledDifferences, 100 * sampledError);
+	}
+
+	// Renderização adiada com sorteio: shade usa as fontes sorteadas em trace, com as intensidades atuais
+	Framebuffer reference(side, side, Framebuffer::RGB_FLOAT);
+	Framebuffer deferred(side, side, Framebuffer::RGB_FLOAT);
+	GBuffer gbuffer;
+
+	scene.setMaxLights(4);
+	canvas.trace(Vector3(0, 0, 0), scene, &gbuffer);
+	for (size_t source = 1; source < scene.getSources().size(); source += 2)
+	{
+		scene.getSources()[source]->intensity *= 3;
+	}
+	canvas.shade(scene, gbuffer, &deferred);
+	canvas.raycast(Vector3(0, 0, 0), scene, &reference);
+
+	double deferredError;
+	int deferredDifferences = compare(reference, deferred, &deferredError);
+	printf("%-26s %10s %10s %12d %9.4f%%\n", "adiada (intensidade)", "-", "-", deferredDifferences, 100 * deferredError);
+
+	if (culledDifferences != 0)
+	{
+		printf("FALHA: a grade de fontes mudou a imagem\n");
+		return 1;
+	}
+
+	if (deferredDifferences != 0)
+	{
+		printf("FALHA: trace + shade com sorteio difere de raycast\n");
+		return 1;
+	}
+
+	printf("OK: a grade de fontes e a renderização adiada dão a mesma imagem\n");
+	return 0;
+}
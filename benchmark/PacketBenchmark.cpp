@@ -0,0 +1,258 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../Camera.h"
+#include "../Canvas.h"
+#include "../CircularPlane.h"
+#include "../Framebuffer.h"
+#include "../Plane.h"
+#include "../RenderScene.h"
+#include "../SeasonsScene.h"
+#include "../Sphere.h"
+#include "../TriangularFace.h"
+
+/*
+Compara o traçado de raios primários em pacotes (4x4 e 8x8) com o traçado de um raio por vez.
+Primeiro só a visibilidade (RenderScene::intersect contra intersectPacket), conferindo se cada
+pixel atinge o mesmo objeto com o mesmo t, na cena das estações e numa cena aleatória de esferas,
+discos e faces triangulares, grande o bastante para que as esferas fiquem nas folhas da BVH;
+depois quadros completos da cena das estações pelo Canvas, em que sombras e sombreamento
+continuam raio a raio. Termina com código 1 se algum pixel divergir.
+
+Na cena das estações as esferas ficam no SphereSet e as folhas da BVH só têm cilindros, cones e
+malhas, testados raio a raio; lá os pacotes compartilham só os testes de caixas e dos planos.
+*/
+
+static double elapsedMs(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1)
+{
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// Raios primários de uma imagem side x side, na mesma janela do Canvas (largura 60 a distância 30)
+static std::vector<Ray> makeRays(int side)
+{
+	std::vector<Ray> rays;
+	Vector3 observable(0, 0, 0);
+	Scalar delta = (Scalar)60 / side;
+
+	for (int l = 0; l < side; l++)
+	{
+		for (int c = 0; c < side; c++)
+		{
+			Vector3 pJ(-30 + c * delta + delta / 2, 30 - l * delta - delta / 2, -30);
+			rays.push_back(Ray(observable, pJ));
+		}
+	}
+
+	return rays;
+}
+
+// Visibilidade de todos os pixels, um raio por vez
+static double traceSingle(const RenderScene& scene, const std::vector<Ray>& rays, std::vector<HitRecord>* hits, std::vector<Object*>* objects)
+{
+	auto t0 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < rays.size(); i++)
+	{
+		if (!scene.intersect(rays[i], &(*hits)[i], &(*objects)[i]))
+		{
+			(*objects)[i] = NULL;
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	return elapsedMs(t0, t1);
+}
+
+// Visibilidade de todos os pixels em pacotes de packet x packet
+static double tracePackets(const RenderScene& scene, const std::vector<Ray>& rays, int side, int packet, std::vector<HitRecord>* hits, std::vector<Object*>* objects)
+{
+	Ray block[BVH::MAX_PACKET];
+	HitRecord blockHits[BVH::MAX_PACKET];
+	Object* blockObjects[BVH::MAX_PACKET];
+	bool found[BVH::MAX_PACKET];
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (int line = 0; line < side; line += packet)
+	{
+		for (int column = 0; column < side; column += packet)
+		{
+			int count = 0;
+			for (int l = line; l < line + packet && l < side; l++)
+			{
+				for (int c = column; c < column + packet && c < side; c++)
+				{
+					block[count++] = rays[l * side + c];
+				}
+			}
+
+			scene.intersectPacket(block, count, blockHits, blockObjects, found);
+
+			int i = 0;
+			for (int l = line; l < line + packet && l < side; l++)
+			{
+				for (int c = column; c < column + packet && c < side; c++, i++)
+				{
+					(*hits)[l * side + c] = blockHits[i];
+					(*objects)[l * side + c] = found[i] ? blockObjects[i] : NULL;
+				}
+			}
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	return elapsedMs(t0, t1);
+}
+
+// Esferas, discos e faces triangulares aleatórios à frente da câmera, sobre um plano de fundo
+static void buildRandomScene(Scene& scene)
+{
+	// Só interseção: nenhum objeto é sombreado, então o índice do material não é usado
+	int material = 0;
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<double> xy(-40, 40), z(-120, -40), offset(-4, 4), radius(0.5, 3);
+
+	scene.addObject(new Plane(NULL, Vector3(0, 0, 1), Vector3(0, 0, -150), material));
+
+	for (int i = 0; i < 300; i++)
+	{
+		scene.addObject(new Sphere(radius(random), Vector3(xy(random), xy(random), z(random)), material));
+	}
+
+	for (int i = 0; i < 200; i++)
+	{
+		Vector3 v0(xy(random), xy(random), z(random));
+		Vector3 v1 = v0 + Vector3(offset(random), offset(random), offset(random));
+		Vector3 v2 = v0 + Vector3(offset(random), offset(random), offset(random));
+		scene.addObject(new TriangularFace(v0, v1, v2, material));
+	}
+
+	for (int i = 0; i < 100; i++)
+	{
+		Vector3 normal(offset(random), offset(random), 4);
+		scene.addObject(new CircularPlane(normal.normalized(), Vector3(xy(random), xy(random), z(random)), radius(random), material));
+	}
+}
+
+// Imprime a visibilidade de um raio por vez e em pacotes e devolve o número de pixels divergentes
+static int compareVisibility(const RenderScene& scene, const int* sides, int numSides, int repetitions)
+{
+	int packets[] = { 4, 8 };
+	int total = 0;
+
+	printf("%8s %8s %12s %10s %10s %12s\n", "lado", "pacote", "ms", "ns/raio", "ganho", "divergentes");
+
+	for (int s = 0; s < numSides; s++)
+	{
+		int side = sides[s];
+
+		std::vector<Ray> rays = makeRays(side);
+		std::vector<HitRecord> reference(rays.size()), hits(rays.size());
+		std::vector<Object*> referenceObjects(rays.size()), objects(rays.size());
+
+		double singleMs = 1e30;
+		for (int r = 0; r < repetitions; r++)
+		{
+			singleMs = std::min(singleMs, traceSingle(scene, rays, &reference, &referenceObjects));
+		}
+		printf("%8d %8s %12.2f %10.1f %10s %12s\n", side, "1", singleMs, 1e6 * singleMs / rays.size(), "-", "-");
+
+		for (int packet : packets)
+		{
+			double packetMs = 1e30;
+			for (int r = 0; r < repetitions; r++)
+			{
+				packetMs = std::min(packetMs, tracePackets(scene, rays, side, packet, &hits, &objects));
+			}
+
+			int mismatches = 0;
+			for (size_t i = 0; i < rays.size(); i++)
+			{
+				if (objects[i] != referenceObjects[i] || (objects[i] != NULL && hits[i].t != reference[i].t))
+				{
+					mismatches++;
+				}
+			}
+
+			char label[16];
+			snprintf(label, sizeof(label), "%dx%d", packet, packet);
+			printf("%8d %8s %12.2f %10.1f %9.2fx %12d\n", side, label, packetMs, 1e6 * packetMs / rays.size(), singleMs / packetMs, mismatches);
+			total += mismatches;
+		}
+	}
+
+	return total;
+}
+
+int main()
+{
+	int sides[] = { 500, 1000 };
+	const int repetitions = 3;
+	int mismatches = 0;
+
+	Scene authoring;
+	buildSeasonsScene(authoring);
+	RenderScene scene(authoring);
+
+	printf("Visibilidade dos raios primários, cena das estações (melhor de %d execuções)\n", repetitions);
+	mismatches += compareVisibility(scene, sides, 2, repetitions);
+
+	{
+		// Câmera na origem olhando para -z: a matriz da câmera é a identidade, como nos raios de makeRays
+		Camera camera(Vector3(0, 0, 0), Vector3(0, 0, -1), Vector3(0, 1, 0));
+		Scene randomAuthoring;
+		randomAuthoring.setCamera(&camera);
+		buildRandomScene(randomAuthoring);
+		RenderScene randomScene(randomAuthoring);
+
+		printf("\nVisibilidade dos raios primários, esferas, discos e faces aleatórios (melhor de %d)\n", repetitions);
+		mismatches += compareVisibility(randomScene, sides, 2, repetitions);
+	}
+
+	printf("\nQuadros completos pelo Canvas (1 thread, melhor de %d)\n", repetitions);
+	printf("%8s %8s %12s %10s\n", "lado", "pacote", "ms/quadro", "ganho");
+
+	for (int side : sides)
+	{
+		Canvas canvas(30, 60, 60, side, side);
+		Framebuffer image(side, side, Framebuffer::RGB_FLOAT);
+		double singleMs = 0;
+
+		for (int packet : { 0, 4, 8 })
+		{
+			canvas.setPacketSize(packet);
+
+			double frameMs = 1e30;
+			for (int r = 0; r < repetitions; r++)
+			{
+				auto t0 = std::chrono::steady_clock::now();
+				canvas.raycast(Vector3(0, 0, 0), scene, &image);
+				auto t1 = std::chrono::steady_clock::now();
+				frameMs = std::min(frameMs, elapsedMs(t0, t1));
+			}
+
+			if (packet == 0)
+			{
+				singleMs = frameMs;
+				printf("%8d %8s %12.2f %10s\n", side, "1", frameMs, "-");
+			}
+			else
+			{
+				char label[16];
+				snprintf(label, sizeof(label), "%dx%d", packet, packet);
+				printf("%8d %8s %12.2f %9.2fx\n", side, label, frameMs, singleMs / frameMs);
+			}
+		}
+	}
+
+	if (mismatches > 0)
+	{
+		printf("\nERRO: %d pixels divergentes entre pacotes e raios isolados\n", mismatches);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,277 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../AmbientSource.h"
+#include "../MaterialTable.h"
+#include "../PhongBatch.h"
+#include "../PontualSource.h"
+#include "../Ray.h"
+
+/*
+Mede o núcleo de sombreamento de Phong sobre pontos aleatórios de uma esfera, com 1, 4 e 16 fontes
+pontuais (metade com atenuação e raio de influência) mais uma fonte ambiente, e uma em cada quatro
+fontes bloqueada em cada ponto. Compara:
+
+  computeIntensity  uma chamada virtual por fonte e por ponto, com Vector3 (o sombreamento antigo)
+  lote de 1         PhongBatch<1>, o que Object::shade faz em cada ponto
+  lote de 64        PhongBatch<64>, o que Canvas::shade faz em cada linha de um bloco
+
+Os três devem dar exatamente a mesma cor. Também compara std::pow com powInt (exponenciação
+rápida) nos expoentes especulares dos materiais.
+
+Termina com código 1 se algum lote der uma cor diferente de computeIntensity.
+*/
+
+static const int BATCH = 64;
+
+// Evita que o compilador descarte os resultados
+static volatile double sink;
+
+static double elapsedNs(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1)
+{
+	return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+// Pontos sombreados: posição, normal, direção do raio e material
+struct Samples
+{
+	std::vector<Vector3> points;
+	std::vector<Vector3> normals;
+	std::vector<Vector3> directions;
+	std::vector<int> materials;            // Índices em table
+	std::vector<unsigned int> shadowMasks; // Bit j: fonte j bloqueada no ponto
+	MaterialTable table;
+};
+
+static Samples makeSamples(int count, const MaterialTable& materials, int numSources)
+{
+	std::mt19937 random(42);
+	std::normal_distribution<double> gaussian(0, 1);
+	std::uniform_int_distribution<int> material(0, materials.size() - 1);
+	std::uniform_int_distribution<int> quarter(0, 3);
+	Vector3 center(0, 0, -200);
+	Samples samples;
+	samples.table = materials;
+
+	for (int i = 0; i < count; i++)
+	{
+		Vector3 normal = Vector3(gaussian(random), gaussian(random), gaussian(random)).normalized();
+		Vector3 point = center + 30 * normal;
+
+		samples.points.push_back(point);
+		samples.normals.push_back(normal);
+		samples.directions.push_back(point.normalized());
+		samples.materials.push_back(material(random));
+
+		unsigned int mask = 0;
+		for (int j = 0; j < numSources; j++)
+		{
+			mask |= (quarter(random) == 0 ? 1u : 0u) << j;
+		}
+		samples.shadowMasks.push_back(mask);
+	}
+
+	return samples;
+}
+
+// Sombreamento antigo: computeIntensity de cada fonte, como fazia o Object::computeLighting
+static void shadeVirtual(const Samples& samples, const std::vector<LightSource*>& sources, std::vector<Vector3>* colors)
+{
+	for (size_t i = 0; i < samples.points.size(); i++)
+	{
+		Material material = samples.table.get(samples.materials[i]);
+		Ray ray = Ray::fromDirection(Vector3(0, 0, 0), samples.directions[i], 0, INFINITY);
+		Vector3 ambient(0, 0, 0), difuse(0, 0, 0), specular(0, 0, 0);
+
+		for (size_t j = 0; j < sources.size(); j++)
+		{
+			bool shadowed = (samples.shadowMasks[i] >> j) & 1;
+			sources[j]->computeIntensity(samples.points[i], ray, &ambient, &difuse, &specular, samples.normals[i],
+										 material.kAmbient, material.kDif, material.kEsp, material.specularIndex, shadowed);
+		}
+
+		(*colors)[i] = difuse + specular + ambient;
+	}
+}
+
+// Sombreamento em lotes de N pontos
+template <int N>
+static void shadeBatch(const Samples& samples, const std::vector<LightSource*>& sources, std::vector<Vector3>* colors)
+{
+	PhongBatch<N> batch;
+	int count = (int)samples.points.size();
+
+	for (int first = 0; first < count; first += N)
+	{
+		int last = std::min(first + N, count);
+		batch.clear();
+
+		for (int i = first; i < last; i++)
+		{
+			batch.add(samples.points[i], samples.normals[i], samples.directions[i], Vector3(0, 0, 0), samples.table.get(samples.materials[i]));
+		}
+
+		batch.shade(sources, [&](int source, int k)
+		{
+			return ((samples.shadowMasks[first + k] >> source) & 1) != 0;
+		});
+
+		for (int k = 0; k < batch.count; k++)
+		{
+			(*colors)[first + k] = batch.getColor(k);
+		}
+	}
+}
+
+// Melhor tempo de repetitions execuções, em ns por ponto
+template <typename Shade>
+static double measure(int count, int repetitions, Shade shade)
+{
+	double best = 1e30;
+	for (int r = 0; r < repetitions; r++)
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		shade();
+		auto t1 = std::chrono::steady_clock::now();
+		best = std::min(best, elapsedNs(t0, t1) / count);
+	}
+	return best;
+}
+
+static int countDifferences(const std::vector<Vector3>& a, const std::vector<Vector3>& b)
+{
+	int differences = 0;
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		differences += a[i] != b[i];
+	}
+	return differences;
+}
+
+int main()
+{
+	const int count = 1 << 16;
+	const int repetitions = 5;
+	int lightCounts[] = { 1, 4, 16 };
+
+	MaterialTable materials;
+	int exponents[] = { 1, 6, 10, 50 };
+	for (int e : exponents)
+	{
+		materials.add(Material(Vector3(0.3, 0.3, 0.3), Vector3(0.7, 0.6, 0.5), Vector3(0.5, 0.5, 0.5), e));
+	}
+
+	int failures = 0;
+
+	printf("Sombreamento de Phong, %d pontos (melhor de %d)\n", count, repetitions);
+	printf("%7s %-18s %12s %14s %12s\n", "fontes", "método", "ns/ponto", "ns/ponto/fonte", "diferentes");
+
+	for (int numLights : lightCounts)
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<double> offset(-120, 120);
+
+		std::vector<LightSource*> sources;
+		for (int j = 0; j < numLights; j++)
+		{
+			Vector3 position(offset(random), 60 + offset(random) / 2, -200 + offset(random));
+			if (j % 2 == 0)
+			{
+				sources.push_back(new PontualSource(position, Vector3(0.7, 0.7, 0.7)));
+			}
+			else
+			{
+				sources.push_back(new PontualSource(position, Vector3(0.7, 0.6, 0.5), Vector3(1, 0.01, 0.0005), 250));
+			}
+		}
+		sources.push_back(new AmbientSource(Vector3(0.3, 0.3, 0.3)));
+
+		Samples samples = makeSamples(count, materials, (int)sources.size());
+		std::vector<Vector3> reference(count), colors(count);
+
+		double virtualNs = measure(count, repetitions, [&]() { shadeVirtual(samples, sources, &reference); });
+		printf("%7d %-18s %12.1f %14.2f %12s\n", numLights, "computeIntensity", virtualNs, virtualNs / sources.size(), "-");
+
+		double singleNs = measure(count, repetitions, [&]() { shadeBatch<1>(samples, sources, &colors); });
+		int singleDifferences = countDifferences(reference, colors);
+		printf("%7d %-18s %12.1f %14.2f %12d\n", numLights, "lote de 1", singleNs, singleNs / sources.size(), singleDifferences);
+
+		double batchNs = measure(count, repetitions, [&]() { shadeBatch<BATCH>(samples, sources, &colors); });
+		int batchDifferences = countDifferences(reference, colors);
+		printf("%7d %-18s %12.1f %14.2f %12d   (%.2fx)\n", numLights, "lote de 64", batchNs, batchNs / sources.size(), batchDifferences, virtualNs / batchNs);
+
+		failures += singleDifferences + batchDifferences;
+
+		double checksum = 0;
+		for (auto& color : colors)
+		{
+			checksum += color.sum();
+		}
+		sink = checksum;
+
+		for (auto& source : sources)
+		{
+			delete source;
+		}
+	}
+
+	// std::pow contra exponenciação rápida, nos cossenos em [0, 1]
+	std::vector<Scalar> bases(count);
+	std::mt19937 random(3);
+	std::uniform_real_distribution<double> unit(0, 1);
+	for (auto& base : bases)
+	{
+		base = (Scalar)unit(random);
+	}
+
+	printf("\nPotência especular (%d bases em [0, 1])\n", count);
+	printf("%9s %12s %12s %16s\n", "expoente", "pow ns", "powInt ns", "maior erro rel.");
+
+	for (int e : exponents)
+	{
+		double checksum = 0;
+		double powNs = measure(count, repetitions, [&]()
+		{
+			for (Scalar base : bases)
+			{
+				checksum += std::pow(base, e);
+			}
+		});
+		double powIntNs = measure(count, repetitions, [&]()
+		{
+			for (Scalar base : bases)
+			{
+				checksum += powInt(base, e);
+			}
+		});
+		sink = checksum;
+
+		double maxError = 0;
+		for (Scalar base : bases)
+		{
+			// Só onde o resultado é um número normal de Scalar (abaixo disso os dois dão zero ou subnormais)
+			double exact = std::pow((double)base, e);
+			if (exact >= std::numeric_limits<Scalar>::min())
+			{
+				maxError = std::max(maxError, std::abs(powInt(base, e) - exact) / exact);
+			}
+		}
+
+		printf("%9d %12.2f %12.2f %16.3g\n", e, powNs, powIntNs, maxError);
+	}
+
+	if (failures > 0)
+	{
+		printf("\nERRO: o sombreamento em lote mudou a cor de %d pontos\n", failures);
+		return 1;
+	}
+
+	printf("\nOK: os lotes dão a mesma cor que computeIntensity\n");
+	return 0;
+}
@@ -0,0 +1,163 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "../RenderScene.h"
+#include "../SeasonsScene.h"
+
+/*
+Mede a vazão dos raios de sombra na cena das estações (verão, 500x500, fonte pontual).
+Compara o teste antigo, que procura o objeto mais próximo visto pela fonte e o compara com o
+objeto atingido pelo raio primário (busca linear e com a BVH), com a consulta occluded, que
+para no primeiro objeto entre a fonte e o ponto, e com a mesma consulta no mapa cúbico de oclusão
+da fonte (RenderScene::buildShadowMaps), que deve dar exatamente o mesmo resultado.
+
+Termina com código 1 se o mapa cúbico discordar de occluded em algum raio.
+*/
+
+// Um raio de sombra: da fonte até o ponto atingido pelo raio primário
+struct ShadowQuery
+{
+	Vector3 point;
+	Object* object;           // Objeto compilado atingido
+	const Object* original;   // Objeto de autoria correspondente
+};
+
+// Executa test para todas as consultas e devolve ns/raio (e o número de pontos na sombra em shadowed)
+template <typename Test>
+static double measure(const std::vector<ShadowQuery>& queries, int repetitions, Test test, int* shadowed)
+{
+	*shadowed = 0;
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (int r = 0; r < repetitions; r++)
+	{
+		for (auto& q : queries)
+		{
+			if (test(q))
+			{
+				(*shadowed)++;
+			}
+		}
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	*shadowed /= repetitions;
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / (queries.size() * repetitions);
+}
+
+int main()
+{
+	Scene authoring;
+	buildSeasonsScene(authoring);
+	RenderScene scene(authoring);
+
+	// Cópias em coordenadas de câmera para a busca linear, na mesma ordem de getAllObjects
+	Matrix4 toCamera = authoring.camera->getTransformationMatrix();
+	std::vector<Object*> originals = authoring.getAllObjects();
+	std::vector<Object*> objects;
+	for (auto& o : originals)
+	{
+		objects.push_back(o->clone());
+		objects.back()->convertToCamera(toCamera);
+	}
+	Vector3 light = scene.getSources()[0]->origin;
+
+	// Pontos atingidos pelos raios primários de uma imagem 500x500
+	int n = 500;
+	std::vector<ShadowQuery> queries;
+	for (int l = 0; l < n; l++)
+	{
+		for (int c = 0; c < n; c++)
+		{
+			Vector3 pJ(-30 + (c + 0.5) * 60 / n, 30 - (l + 0.5) * 60 / n, -30);
+			Ray ray(Vector3(0, 0, 0), pJ);
+			HitRecord hit;
+			ShadowQuery q;
+
+			if (scene.intersect(ray, &hit, &q.object))
+			{
+				q.point = ray.initialPoint + hit.t * ray.direction;
+				q.original = scene.pick(ray);
+				queries.push_back(q);
+			}
+		}
+	}
+
+	int repetitions = 5;
+	int shadowedLinear, shadowedClosest, shadowedOccluded;
+
+	// Antes: objeto mais próximo visto pela fonte, por busca linear
+	double linear = measure(queries, 1, [&](const ShadowQuery& q)
+	{
+		Ray sourceRay(light, q.point);
+		HitRecord hit;
+		double minimum = INFINITY;
+		const Object* first = NULL;
+		for (int i = 0; i < (int)objects.size(); i++)
+		{
+			if (objects[i]->intersect(sourceRay, &hit) && hit.t < minimum)
+			{
+				minimum = hit.t;
+				first = originals[i];
+			}
+		}
+		return first != q.original;
+	}, &shadowedLinear);
+
+	// Antes: objeto mais próximo visto pela fonte, pela BVH
+	double closest = measure(queries, repetitions, [&](const ShadowQuery& q)
+	{
+		Ray sourceRay(light, q.point);
+		HitRecord hit;
+		Object* first = NULL;
+		return !scene.intersect(sourceRay, &hit, &first) || first != q.object;
+	}, &shadowedClosest);
+
+	// Depois: qualquer objeto no segmento entre a fonte e o ponto
+	double occluded = measure(queries, repetitions, [&](const ShadowQuery& q)
+	{
+		Vector3 direction = q.point - light;
+		double distance = direction.norm();
+		return scene.occluded(light, direction / distance, distance * (1 - 1e-6));
+	}, &shadowedOccluded);
+
+	// Depois: o mesmo teste pelo mapa cúbico da fonte
+	auto t0 = std::chrono::steady_clock::now();
+	scene.buildShadowMaps();
+	auto t1 = std::chrono::steady_clock::now();
+	double buildMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+	int shadowedCube;
+	double cube = measure(queries, repetitions, [&](const ShadowQuery& q)
+	{
+		Vector3 direction = q.point - light;
+		double distance = direction.norm();
+		return scene.sourceOccluded(0, direction / distance, distance * (1 - 1e-6));
+	}, &shadowedCube);
+
+	int mismatches = 0;
+	for (auto& q : queries)
+	{
+		Vector3 direction = q.point - light;
+		double distance = direction.norm();
+		bool expected = scene.occluded(light, direction / distance, distance * (1 - 1e-6));
+		if (scene.sourceOccluded(0, direction / distance, distance * (1 - 1e-6)) != expected)
+		{
+			mismatches++;
+		}
+	}
+
+	printf("%d raios de sombra\n", (int)queries.size());
+	printf("%-28s %10s %12s %10s\n", "metodo", "ns/raio", "Mraios/s", "na sombra");
+	printf("%-28s %10.1f %12.2f %10d\n", "mais proximo (linear)", linear, 1e3 / linear, shadowedLinear);
+	printf("%-28s %10.1f %12.2f %10d\n", "mais proximo (BVH)", closest, 1e3 / closest, shadowedClosest);
+	printf("%-28s %10.1f %12.2f %10d\n", "occluded (BVH)", occluded, 1e3 / occluded, shadowedOccluded);
+	printf("%-28s %10.1f %12.2f %10d\n", "occluded (mapa cubico)", cube, 1e3 / cube, shadowedCube);
+	printf("\nmapa cubico %dx%d por face: construcao %.2f ms, speedup %.2fx sobre a BVH, %d divergencias\n",
+		   ShadowCubeMap::DEFAULT_RESOLUTION, ShadowCubeMap::DEFAULT_RESOLUTION, buildMs, occluded / cube, mismatches);
+
+	return mismatches == 0 ? 0 : 1;
+}
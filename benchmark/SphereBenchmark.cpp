@@ -0,0 +1,142 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../Sphere.h"
+#include "../SphereSet.h"
+
+/*
+Compara a interseção mais próxima de raios primários contra esferas aleatórias (10, 1000 e
+100 mil) pelo caminho antigo, uma chamada virtual de intersect por objeto, com o SphereSet
+em cada núcleo suportado pela CPU (escalar, SSE2 e AVX2). Imprime ns/raio de cada método,
+o ganho sobre o caminho virtual e confere se todos escolhem a mesma esfera.
+*/
+
+static const char* kernelNames[3] = { "escalar", "SSE2", "AVX2" };
+
+// Caminho virtual: intersect em cada objeto, guardando o menor t
+static int closestVirtual(const std::vector<Object*>& objects, const Ray& ray, HitRecord* closest)
+{
+	HitRecord hit;
+	double minimum = INFINITY;
+	int index = -1;
+
+	for (int i = 0; i < (int)objects.size(); i++)
+	{
+		if (objects[i]->intersect(ray, &hit) && hit.t < minimum)
+		{
+			minimum = hit.t;
+			*closest = hit;
+			index = i;
+		}
+	}
+
+	return index;
+}
+
+// Raios da câmera na origem através de uma janela de lado 60 a distância 30
+static std::vector<Ray> makeRays(int side)
+{
+	std::vector<Ray> rays;
+	Vector3 observable(0, 0, 0);
+
+	for (int l = 0; l < side; l++)
+	{
+		for (int c = 0; c < side; c++)
+		{
+			Vector3 pJ(-30 + (c + 0.5) * 60 / side, 30 - (l + 0.5) * 60 / side, -30);
+			rays.push_back(Ray(observable, pJ));
+		}
+	}
+
+	return rays;
+}
+
+// Executa method para todos os raios; devolve ns/raio e guarda o índice escolhido em cada raio
+template <typename Method>
+static double measure(const std::vector<Ray>& rays, Method method, std::vector<int>* chosen)
+{
+	chosen->assign(rays.size(), -1);
+
+	auto t0 = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < rays.size(); r++)
+	{
+		(*chosen)[r] = method(rays[r]);
+	}
+	auto t1 = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / rays.size();
+}
+
+int main()
+{
+	int sizes[] = { 10, 1000, 100000 };
+	// Só interseção: nenhum objeto é sombreado, então o índice do material não é usado
+	int material = 0;
+	SphereSet::Kernel best = SphereSet::detectKernel();
+
+	printf("Melhor núcleo desta CPU: %s\n", kernelNames[best]);
+	printf("%10s %14s", "esferas", "virtual ns");
+	for (int k = 0; k <= best; k++)
+	{
+		printf(" %12s ns %7s", kernelNames[k], "ganho");
+	}
+	printf("\n");
+
+	for (int n : sizes)
+	{
+		std::mt19937 random(n);
+		std::uniform_real_distribution<double> xy(-300, 300), z(-1300, -200);
+
+		// Raio escolhido para manter a fração da cena ocupada parecida entre os tamanhos
+		double radius = 250 / std::cbrt((double)n);
+
+		std::vector<Object*> objects;
+		SphereSet set;
+		for (int i = 0; i < n; i++)
+		{
+			Sphere* sphere = new Sphere(radius, Vector3(xy(random), xy(random), z(random)), material);
+			objects.push_back(sphere);
+			set.add(sphere);
+		}
+
+		// Os dois caminhos são lineares, então cenas grandes usam menos raios
+		std::vector<Ray> rays = makeRays(n > 10000 ? 32 : (n > 100 ? 128 : 256));
+
+		std::vector<int> reference, chosen;
+		double virtualNs = measure(rays, [&](const Ray& r) { HitRecord h; return closestVirtual(objects, r, &h); }, &reference);
+		printf("%10d %14.1f", n, virtualNs);
+
+		int mismatches = 0;
+		for (int k = 0; k <= best; k++)
+		{
+			set.setKernel((SphereSet::Kernel)k);
+			double ns = measure(rays, [&](const Ray& r) { HitRecord h; int i = -1; set.intersect(r, &h, &i); return i; }, &chosen);
+			printf(" %15.1f %6.1fx", ns, virtualNs / ns);
+
+			for (size_t r = 0; r < rays.size(); r++)
+			{
+				if (chosen[r] != reference[r])
+				{
+					mismatches++;
+				}
+			}
+		}
+
+		if (mismatches > 0)
+		{
+			printf("  (%d raios divergentes!)", mismatches);
+		}
+		printf("\n");
+
+		for (auto& o : objects)
+		{
+			delete o;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,365 @@
+#include "../../eigen-3.4.0/Eigen/Dense"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <SDL.h>
+
+#include "../Camera.h"
+#include "../Canvas.h"
+#include "../Framebuffer.h"
+#include "../GBuffer.h"
+#include "../Plane.h"
+#include "../RenderScene.h"
+#include "../SeasonsScene.h"
+#include "../Texture.h"
+
+/*
+Mede a amostragem da textura do gramado num plano visto de lado, com uma textura de 2048x2048
+texels (16 MB). As coordenadas e a largura do pixel são as dos raios primários de uma câmera 80 ou
+10 unidades acima do plano, olhando para o horizonte, em imagens de 500 e 125 pixels de lado, na
+ordem em que a imagem é percorrida:
+
+  GetPixelColor   leitura na SDL_Surface com SDL_GetRGB a cada amostra (a amostragem antiga)
+  nearest         texel mais próximo no nível 0 da textura decodificada
+  bilinear        interpolação no nível 0
+  nearest + mip   texel mais próximo no nível escolhido pela largura do pixel
+  trilinear       interpolação entre os dois níveis vizinhos
+
+Depois mede quadros completos da cena das estações com a câmera 10 unidades acima do gramado e cada
+modo de amostragem.
+
+Confere que a textura decodificada tem os mesmos texels que a superfície, que as repetições
+funcionam em texturas de qualquer tamanho e que Canvas::trace + Canvas::shade dá a mesma imagem que
+Canvas::raycast com o gramado texturizado. Termina com código 1 se alguma verificação falhar.
+*/
+
+// Evita que o compilador descarte os resultados
+static volatile double sink;
+
+static double elapsedMs(std::chrono::steady_clock::time_point t0, std::chrono::steady_clock::time_point t1)
+{
+	return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// A leitura antiga do Plane: o pixel da superfície convertido com SDL_GetRGB
+static SDL_Color GetPixelColor(const SDL_Surface* pSurface, const int X, const int Y)
+{
+	const Uint8 Bpp = pSurface->format->BytesPerPixel;
+	Uint8* pPixel = (Uint8*)pSurface->pixels + Y * pSurface->pitch + X * Bpp;
+	Uint32 PixelData = *(Uint32*)pPixel;
+
+	SDL_Color Color = { 0x00, 0x00, 0x00, SDL_ALPHA_OPAQUE };
+	SDL_GetRGB(PixelData, pSurface->format, &Color.r, &Color.g, &Color.b);
+	return Color;
+}
+
+// Superfície de side x side pixels com tons de verde aleatórios (como a grama, sem padrão que a cache aproveite)
+static SDL_Surface* makeGrassSurface(int width, int height)
+{
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGB888);
+	std::mt19937 random(5);
+	std::uniform_int_distribution<int> shade(0, 255);
+
+	SDL_LockSurface(surface);
+	for (int y = 0; y < height; y++)
+	{
+		Uint32* row = (Uint32*)((Uint8*)surface->pixels + y * surface->pitch);
+		for (int x = 0; x < width; x++)
+		{
+			int g = shade(random);
+			row[x] = SDL_MapRGB(surface->format, (Uint8)(g / 4), (Uint8)g, (Uint8)(g / 6));
+		}
+	}
+	SDL_UnlockSurface(surface);
+
+	return surface;
+}
+
+// Amostras de um plano y = -height visto da origem por uma janela de 60x60 a distância 30
+struct Samples
+{
+	std::vector<Scalar> u;
+	std::vector<Scalar> v;
+	std::vector<Scalar> footprint;
+};
+
+static Samples makeSamples(int side, Scalar height)
+{
+	Samples samples;
+	Scalar delta = (Scalar)60 / side;
+
+	for (int l = 0; l < side; l++)
+	{
+		for (int c = 0; c < side; c++)
+		{
+			Vector3 pJ(-30 + c * delta + delta / 2, 30 - l * delta - delta / 2, -30);
+			Vector3 direction = pJ.normalized();
+			if (direction[1] >= 0)
+			{
+				continue;
+			}
+
+			// Mesma largura do pixel que Canvas::primaryRay e Plane::getSurface usam
+			Scalar t = height / -direction[1];
+			Scalar spread = delta * 30 / pJ.squaredNorm();
+
+			samples.u.push_back(t * direction[0]);
+			samples.v.push_back(t * direction[2]);
+			samples.footprint.push_back(t * spread / -direction[1]);
+		}
+	}
+
+	return samples;
+}
+
+// Melhor tempo de repetitions execuções, em ns por amostra
+template <typename Sample>
+static double measure(const Samples& samples, int repetitions, Sample sample)
+{
+	double best = 1e30;
+	for (int r = 0; r < repetitions; r++)
+	{
+		double checksum = 0;
+		auto t0 = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < samples.u.size(); i++)
+		{
+			checksum += sample(i);
+		}
+		auto t1 = std::chrono::steady_clock::now();
+		sink = checksum;
+		best = std::min(best, elapsedMs(t0, t1) * 1e6 / samples.u.size());
+	}
+	return best;
+}
+
+// Número de texels da textura diferentes da superfície (e de amostras no centro de cada texel diferentes do texel)
+static int checkDecoding(const Texture& texture, const SDL_Surface* surface)
+{
+	int differences = 0;
+	Texture::Sampler nearest(Texture::NEAREST, Texture::REPEAT, false);
+	Texture::Sampler bilinear(Texture::BILINEAR, Texture::REPEAT, false);
+
+	for (int y = 0; y < surface->h; y++)
+	{
+		for (int x = 0; x < surface->w; x++)
+		{
+			SDL_Color color = GetPixelColor(surface, x, y);
+			Vector3 expected(color.r, color.g, color.b);
+
+			differences += Texture::unpack(texture.getTexel(0, x, y)) != expected;
+			differences += texture.sampleLevel(x + (Scalar)0.5, y + (Scalar)0.5, 0, nearest) != expected;
+			differences += texture.sampleLevel(x + (Scalar)0.5, y + (Scalar)0.5, 0, bilinear) != expected;
+		}
+	}
+
+	return differences;
+}
+
+// Repetições numa textura de 300x200 (nem potência de 2, nem quadrada)
+static int checkWrap()
+{
+	const int width = 300, height = 200;
+	std::mt19937 random(9);
+	std::uniform_int_distribution<int> byte(0, 255);
+	std::vector<uint32_t> texels(width * height);
+	for (auto& texel : texels)
+	{
+		texel = Texture::pack((uint8_t)byte(random), (uint8_t)byte(random), (uint8_t)byte(random), 255);
+	}
+	Texture texture(width, height, texels);
+
+	int failures = 0;
+
+	// 300x200, 150x100, 75x50, 37x25, 18x12, 9x6, 4x3, 2x1, 1x1
+	failures += texture.getNumLevels() != 9;
+	failures += texture.getWidth(3) != 37 || texture.getHeight(3) != 25;
+	failures += texture.getWidth(texture.getNumLevels() - 1) != 1 || texture.getHeight(texture.getNumLevels() - 1) != 1;
+
+	Texture::Sampler repeat(Texture::NEAREST, Texture::REPEAT, false);
+	Texture::Sampler mirrored(Texture::NEAREST, Texture::MIRRORED_REPEAT, false);
+	Texture::Sampler clamp(Texture::NEAREST, Texture::CLAMP_TO_EDGE, false);
+	Texture::Sampler bilinear(Texture::BILINEAR, Texture::REPEAT, false);
+	std::uniform_int_distribution<int> column(0, width - 1), line(0, height - 1), period(-5, 5);
+
+	for (int i = 0; i < 10000; i++)
+	{
+		Scalar u = column(random) + (Scalar)0.5, v = line(random) + (Scalar)0.5;
+		int k = period(random), m = period(random);
+		Vector3 color = texture.sampleLevel(u, v, 0, repeat);
+
+		failures += texture.sampleLevel(u + k * width, v + m * height, 0, repeat) != color;
+		failures += texture.sampleLevel(u + k * width, v + m * height, 0, bilinear) != color;
+		failures += texture.sampleLevel(-u, -v, 0, mirrored) != color;
+		failures += texture.sampleLevel(u + 2 * k * width, v + 2 * m * height, 0, mirrored) != color;
+		failures += texture.sampleLevel(u - 1000, v, 0, clamp) != Texture::unpack(texture.getTexel(0, 0, (int)v));
+		failures += texture.sampleLevel(u, v + 1000, 0, clamp) != Texture::unpack(texture.getTexel(0, (int)u, height - 1));
+	}
+
+	// Coordenadas enormes ou inválidas não podem sair da textura
+	Scalar extremes[] = { (Scalar)1e30, (Scalar)-1e30, (Scalar)INFINITY, (Scalar)NAN };
+	for (Scalar e : extremes)
+	{
+		Vector3 color = texture.sample(e, e, e, Texture::Sampler());
+		failures += !(color.minCoeff() >= 0 && color.maxCoeff() <= 255);
+	}
+
+	return failures;
+}
+
+// Plano do gramado da cena
+static Plane* findGrass(Scene& scene)
+{
+	for (Object* object : scene.objects)
+	{
+		Plane* plane = dynamic_cast<Plane*>(object);
+		if (plane != NULL && plane->texture != NULL)
+		{
+			return plane;
+		}
+	}
+	return NULL;
+}
+
+// Número de pixels diferentes entre duas imagens RGB_FLOAT do mesmo tamanho
+static int countDifferences(const Framebuffer& a, const Framebuffer& b)
+{
+	int differences = 0;
+
+	for (int l = 0; l < a.getNumLines(); l++)
+	{
+		if (memcmp(a.rowRGB(l), b.rowRGB(l), 3 * sizeof(float) * a.getNumColumns()) != 0)
+		{
+			for (int c = 0; c < a.getNumColumns(); c++)
+			{
+				differences += memcmp(a.rowRGB(l) + 3 * c, b.rowRGB(l) + 3 * c, 3 * sizeof(float)) != 0;
+			}
+		}
+	}
+
+	return differences;
+}
+
+int main()
+{
+	const int textureSide = 2048;
+	const int side = 500;
+	const int repetitions = 3;
+	bool failed = false;
+
+	SDL_Surface* surface = makeGrassSurface(textureSide, textureSide);
+
+	auto t0 = std::chrono::steady_clock::now();
+	Texture texture(surface);
+	auto t1 = std::chrono::steady_clock::now();
+
+	printf("Textura %dx%d: decodificação e %d níveis de mipmap em %.1f ms\n", textureSide, textureSide, texture.getNumLevels(), elapsedMs(t0, t1));
+
+	int decodingDifferences = checkDecoding(texture, surface);
+	int wrapFailures = checkWrap();
+	printf("texels diferentes da superfície: %d, falhas nas repetições: %d\n", decodingDifferences, wrapFailures);
+	failed = decodingDifferences != 0 || wrapFailures != 0;
+
+	// Amostragem sozinha, na ordem da imagem
+	Texture::Sampler nearest(Texture::NEAREST, Texture::REPEAT, false);
+	Texture::Sampler bilinear(Texture::BILINEAR, Texture::REPEAT, false);
+	Texture::Sampler nearestMip(Texture::NEAREST, Texture::REPEAT, true);
+	Texture::Sampler trilinear(Texture::BILINEAR, Texture::REPEAT, true);
+
+	const char* names[] = { "nearest", "bilinear", "nearest + mip", "trilinear" };
+	Texture::Sampler* samplers[] = { &nearest, &bilinear, &nearestMip, &trilinear };
+
+	printf("\nAmostragem num plano visto de lado, em ns/amostra (melhor de %d)\n", repetitions);
+	printf("%8s %8s %14s", "pixels", "altura", "GetPixelColor");
+	for (const char* name : names)
+	{
+		printf(" %14s", name);
+	}
+	printf("\n");
+
+	// Quanto menor a imagem ou mais baixa a câmera, mais texels cada pixel cobre perto do horizonte
+	int sides[] = { side, side / 4 };
+	Scalar heights[] = { 80, 10 };
+	for (int samplesSide : sides)
+	{
+		for (Scalar height : heights)
+		{
+			Samples samples = makeSamples(samplesSide, height);
+
+			double legacyNs = measure(samples, repetitions, [&](size_t i)
+			{
+				SDL_Color color = GetPixelColor(surface, std::abs((int)samples.u[i] % textureSide), std::abs((int)samples.v[i] % textureSide));
+				return (double)color.r + color.g + color.b;
+			});
+			printf("%8d %8.0f %14.2f", samplesSide, (double)height, legacyNs);
+
+			for (Texture::Sampler* sampler : samplers)
+			{
+				double ns = measure(samples, repetitions, [&](size_t i)
+				{
+					return (double)texture.sample(samples.u[i], samples.v[i], samples.footprint[i], *sampler).sum();
+				});
+				printf(" %14.2f", ns);
+			}
+			printf("\n");
+		}
+	}
+
+	// Quadros completos com o gramado texturizado, 10 unidades acima do plano
+	printf("\nCena das estações, %dx%d, 1 thread, câmera rente ao gramado (melhor de %d)\n", side, side, repetitions);
+	printf("%-16s %12s %12s\n", "modo", "raycast ms", "diferentes");
+
+	Scene authoring;
+	buildSeasonsScene(authoring, SUMMER, &texture);
+	delete authoring.camera;
+	authoring.setCamera(new Camera(Vector3(0, -90, -350), Vector3(0, -90, 0), Vector3(0, 1, 0)));
+	Plane* grass = findGrass(authoring);
+
+	for (int s = 0; s < 4; s++)
+	{
+		grass->sampler = *samplers[s];
+		RenderScene scene(authoring);
+		Canvas canvas(30, 60, 60, side, side);
+
+		Framebuffer reference(side, side, Framebuffer::RGB_FLOAT);
+		Framebuffer deferred(side, side, Framebuffer::RGB_FLOAT);
+		GBuffer gbuffer;
+
+		double raycastMs = 1e30;
+		for (int r = 0; r < repetitions; r++)
+		{
+			auto t2 = std::chrono::steady_clock::now();
+			canvas.raycast(Vector3(0, 0, 0), scene, &reference);
+			auto t3 = std::chrono::steady_clock::now();
+			raycastMs = std::min(raycastMs, elapsedMs(t2, t3));
+		}
+
+		// A largura do pixel tem de ser a mesma nos raios de trace + shade e nos pacotes
+		int differences = 0;
+		int packets[] = { 0, 8 };
+		for (int packet : packets)
+		{
+			canvas.setPacketSize(packet);
+			canvas.trace(Vector3(0, 0, 0), scene, &gbuffer);
+			canvas.shade(scene, gbuffer, &deferred);
+			differences += countDifferences(reference, deferred);
+		}
+
+		printf("%-16s %12.2f %12d\n", names[s], raycastMs, differences);
+		failed = failed || differences != 0;
+	}
+
+	SDL_FreeSurface(surface);
+
+	if (failed)
+	{
+		printf("FALHA: a textura difere da superfície ou trace + shade difere de raycast\n");
+		return 1;
+	}
+
+	printf("OK: a textura tem os texels da superfície e trace + shade é idêntico a raycast\n");
+	return 0;
+}
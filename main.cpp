@@ -11,15 +11,44 @@
 #include "Cilinder.h"
 #include "Cone.h"
 #include "Cube.h"
+#include "Framebuffer.h"
 #include "LightSource.h"
 #include "Object.h"
 #include "Plane.h"
 #include "PontualSource.h"
 #include "Ray.h"
+#include "RenderScene.h"
 #include "Sphere.h"
-#include "Tensor.h"
+#include "Texture.h"
 #include "TriangularFace.h"
 
+// Copia o quadro para a textura de streaming (uma única vez por quadro novo)
+static void uploadFrame(SDL_Texture* texture, const Framebuffer& display)
+{
+	void* pixels;
+	int pitch;
+
+	if (SDL_LockTexture(texture, NULL, &pixels, &pitch) == 0)
+	{
+		display.toRGBA((unsigned char*)pixels, pitch);
+		SDL_UnlockTexture(texture);
+	}
+}
+
+// Carrega e decodifica uma textura (NULL se a imagem não abrir); a superfície não é mais usada depois
+static Texture* loadTexture(const char* path)
+{
+	SDL_Surface* surface = IMG_Load(path);
+	if (surface == NULL)
+	{
+		return NULL;
+	}
+
+	Texture* texture = new Texture(surface);
+	SDL_FreeSurface(surface);
+	return texture;
+}
+
 int main(int argc, char* argv[])
 {
 	// Checando a inicializa��o do SDL
@@ -30,14 +59,14 @@ int main(int argc, char* argv[])
 	}
 
 	// Posi��o da c�mera
-	Eigen::Vector3d origin(0, 0, 0);
+	Vector3 origin(0, 0, 0);
 
 	// Par�metros da janela e canvas
-	double windowDistance = 30;
-	double windowWidth = 60;
-	double windowHeight = 60;
-	double numColumns = 500;
-	double numLines = 500;
+	Scalar windowDistance = 30;
+	Scalar windowWidth = 60;
+	Scalar windowHeight = 60;
+	Scalar numColumns = 500;
+	Scalar numLines = 500;
 
 	// Cria��o da janela
 	SDL_Window* window = SDL_CreateWindow
@@ -67,78 +96,99 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
+	// Textura que recebe cada quadro renderizado
+	SDL_Texture* frame = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, (int) numColumns, (int) numLines);
+	if (!frame)
+	{
+		SDL_Log("N�o foi poss�vel criar a textura");
+		SDL_DestroyRenderer(renderer);
+		SDL_DestroyWindow(window);
+		SDL_Quit();
+		return 1;
+	}
+
 	// Canvas e cena
 	Canvas canvas(windowDistance, windowWidth, windowHeight, numLines, numColumns);
+	canvas.setTiling(0, 16); // blocos de 16x16 pixels usando todos os núcleos
 	Scene scene;
 	Camera* camera = new Camera
 	(
-		Eigen::Vector3d(0, -20, -350),
-		Eigen::Vector3d(0, -20, 0),
-		Eigen::Vector3d(0, 1, 0)
+		Vector3(0, -20, -350),
+		Vector3(0, -20, 0),
+		Vector3(0, 1, 0)
 	);
 	scene.setCamera(camera);
 
 	// Texturas
 
-	SDL_Surface* springTexture = IMG_Load("spring.png");
-	SDL_Surface* summerTexture = IMG_Load("summer.png");
-	SDL_Surface* autumnTexture = IMG_Load("fall.png");
-	SDL_Surface* winterTexture = IMG_Load("winter.png");
+	Texture* springTexture = loadTexture("spring.png");
+	Texture* summerTexture = loadTexture("summer.png");
+	Texture* autumnTexture = loadTexture("fall.png");
+	Texture* winterTexture = loadTexture("winter.png");
+
+	// Materiais: os objetos construídos com o mesmo índice compartilham os coeficientes
+
+	Vector3 black(0, 0, 0);
+	int skyMaterial = scene.addMaterial(Material(Vector3(32, 116, 219), Vector3(32, 116, 219), black, 0));
+	int grassMaterial = scene.addMaterial(Material(black, Vector3(100, 100, 100), black, 0));
+	int woodMaterial = scene.addMaterial(Material(Vector3(50, 31, 20), Vector3(50, 31, 20), black, 0));
+	int pineMaterial = scene.addMaterial(Material(Vector3(10, 156, 53), Vector3(10, 156, 53), black, 0));
+	int tableMaterial = scene.addMaterial(Material(Vector3(50, 31, 20), Vector3(50, 31, 20), Vector3(0.3, 0.3, 0.3), 10));
+	int snowMaterial = scene.addMaterial(Material(Vector3(255, 255, 255), Vector3(255, 255, 255), black, 0));
+	int eyeMaterial = scene.addMaterial(Material(Vector3(50, 31, 20), Vector3(50, 31, 20), black, 0));
+
+	// Folhas dos carvalhos em cada estação
+	int springLeafMaterial = scene.addMaterial(Material(Vector3(255, 72, 132), Vector3(255, 72, 132), black, 0));
+	int summerLeafMaterial = scene.addMaterial(Material(Vector3(12, 242, 0), Vector3(12, 242, 0), black, 0));
+	int autumnLeafMaterial = scene.addMaterial(Material(Vector3(240, 104, 4), Vector3(240, 104, 4), black, 0));
+	int winterLeafMaterial = scene.addMaterial(Material(Vector3(255, 255, 255), Vector3(255, 255, 255), black, 0));
+
+	// Botões das estações
+	Vector3 buttonSpecular(40, 40, 40);
+	int springButtonMaterial = scene.addMaterial(Material(Vector3(255, 72, 132), Vector3(255, 72, 132), buttonSpecular, 6));
+	int summerButtonMaterial = scene.addMaterial(Material(Vector3(12, 242, 0), Vector3(12, 242, 0), buttonSpecular, 6));
+	int autumnButtonMaterial = scene.addMaterial(Material(Vector3(240, 104, 4), Vector3(240, 104, 4), buttonSpecular, 6));
+	int winterButtonMaterial = scene.addMaterial(Material(Vector3(44, 157, 201), Vector3(44, 157, 201), buttonSpecular, 6));
 
 	/* Background */
 	Object* sky = new Plane
 	(
 		NULL,
-		Eigen::Vector3d(0, 0, 1),
-		Eigen::Vector3d(0, 0, -1000),
-		Eigen::Vector3d(32, 116, 219),
-		Eigen::Vector3d(32, 116, 219),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(0, 0, 1),
+		Vector3(0, 0, -1000),
+		skyMaterial
 	);
 
 	Object* skyLeft = new Plane
 	(
 		NULL,
-		Eigen::Vector3d(1, 0, 0),
-		Eigen::Vector3d(-1000, 0, 0),
-		Eigen::Vector3d(32, 116, 219),
-		Eigen::Vector3d(32, 116, 219),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(1, 0, 0),
+		Vector3(-1000, 0, 0),
+		skyMaterial
 	);
 
 	Object* skyRight = new Plane
 	(
 		NULL,
-		Eigen::Vector3d(-1, 0, 0),
-		Eigen::Vector3d(1000, 0, 0),
-		Eigen::Vector3d(32, 116, 219),
-		Eigen::Vector3d(32, 116, 219),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(-1, 0, 0),
+		Vector3(1000, 0, 0),
+		skyMaterial
 	);
 
 	Object* skyTop = new Plane
 	(
 		NULL,
-		Eigen::Vector3d(0, -1, 0),
-		Eigen::Vector3d(0, 1000, 0),
-		Eigen::Vector3d(32, 116, 219),
-		Eigen::Vector3d(32, 116, 219),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(0, -1, 0),
+		Vector3(0, 1000, 0),
+		skyMaterial
 	);
 
 	Object* grass = new Plane
 	(
 		summerTexture,
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(0, -100, 0),
-		Eigen::Vector3d(0, 0, 0),
-		Eigen::Vector3d(100, 100, 100),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(0, 1, 0),
+		Vector3(0, -100, 0),
+		grassMaterial
 	);
 
 	/* Pinheiros */
@@ -147,72 +197,54 @@ int main(int argc, char* argv[])
 	(
 		10,
 		60,
-		Eigen::Vector3d(-130, -100, -230),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(-130, -100, -230),
+		Vector3(0, 1, 0),
+		woodMaterial
 	);
 
 	Object* pineLeaves1 = new Cone
 	(
 		30,
 		50,
-		Eigen::Vector3d(-130, -40, -230),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(10, 156, 53),
-		Eigen::Vector3d(10, 156, 53),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(-130, -40, -230),
+		Vector3(0, 1, 0),
+		pineMaterial
 	);
 
 	Object* pineLog2 = new Cilinder
 	(
 		10,
 		60,
-		Eigen::Vector3d(-130, -100, -300),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(-130, -100, -300),
+		Vector3(0, 1, 0),
+		woodMaterial
 	);
 
 	Object* pineLeaves2 = new Cone
 	(
 		30,
 		50,
-		Eigen::Vector3d(-130, -40, -300),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(10, 156, 53),
-		Eigen::Vector3d(10, 156, 53),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(-130, -40, -300),
+		Vector3(0, 1, 0),
+		pineMaterial
 	);
 
 	Object* pineLog3 = new Cilinder
 	(
 		10,
 		60,
-		Eigen::Vector3d(-130, -100, -160),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(-130, -100, -160),
+		Vector3(0, 1, 0),
+		woodMaterial
 	);
 
 	Object* pineLeaves3 = new Cone
 	(
 		30,
 		50,
-		Eigen::Vector3d(-130, -40, -160),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(10, 156, 53),
-		Eigen::Vector3d(10, 156, 53),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(-130, -40, -160),
+		Vector3(0, 1, 0),
+		pineMaterial
 	);
 
 	/* Carvalhos */
@@ -221,241 +253,146 @@ int main(int argc, char* argv[])
 	(
 		10,
 		60,
-		Eigen::Vector3d(130, -100, -230),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, -100, -230),
+		Vector3(0, 1, 0),
+		woodMaterial
 	);
 
 	Object* oakLeavesBottom1 = new Sphere
 	(
 		30,
-		Eigen::Vector3d(130, -30, -230),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, -30, -230),
+		summerLeafMaterial
 	);
 
 	Object* oakLeavesTop1 = new Sphere
 	(
 		22,
-		Eigen::Vector3d(130, 0, -230),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, 0, -230),
+		summerLeafMaterial
 	);
 
 	Object* oakLog2 = new Cilinder
 	(
 		10,
 		60,
-		Eigen::Vector3d(130, -100, -300),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, -100, -300),
+		Vector3(0, 1, 0),
+		woodMaterial
 	);
 
 	Object* oakLeavesBottom2 = new Sphere
 	(
 		30,
-		Eigen::Vector3d(130, -30, -300),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, -30, -300),
+		summerLeafMaterial
 	);
 
 	Object* oakLeavesTop2 = new Sphere
 	(
 		22,
-		Eigen::Vector3d(130, 0, -300),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, 0, -300),
+		summerLeafMaterial
 	);
 
 	Object* oakLog3 = new Cilinder
 	(
 		10,
 		60,
-		Eigen::Vector3d(130, -100, -160),
-		Eigen::Vector3d(0, 1, 0),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, -100, -160),
+		Vector3(0, 1, 0),
+		woodMaterial
 	);
 
 	Object* oakLeavesBottom3 = new Sphere
 	(
 		30,
-		Eigen::Vector3d(130, -30, -160),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, -30, -160),
+		summerLeafMaterial
 	);
 
 	Object* oakLeavesTop3 = new Sphere
 	(
 		22,
-		Eigen::Vector3d(130, 0, -160),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(130, 0, -160),
+		summerLeafMaterial
 	);
 
 	/* Mesa */
 
 	Object* table = new Cube
 	(
-		Eigen::Vector3d(-50, -80, -180),
+		Vector3(-50, -80, -180),
 		100,
 		10,
 		100,
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0.3, 0.3, 0.3),
-		10
-	);
-
-	HitBox* tableHitBox = new HitBox
-	(
-		75,
-		Eigen::Vector3d(0, -80, -230),
-		Eigen::Vector3d(0, -70, -230)
+		tableMaterial
 	);
 
 	Object* leg1 = new Cube
 	(
-		Eigen::Vector3d(-50, -100, -180),
+		Vector3(-50, -100, -180),
 		10,
 		20,
 		10,
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0.3, 0.3, 0.3),
-		10
-	);
-
-	HitBox* leg1HitBox = new HitBox
-	(
-		8,
-		Eigen::Vector3d(-45, -100, -188),
-		Eigen::Vector3d(-45, -80, -188)
+		tableMaterial
 	);
 
 	Object* leg2 = new Cube
 	(
-		Eigen::Vector3d(40, -100, -180),
+		Vector3(40, -100, -180),
 		10,
 		20,
 		10,
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0.3, 0.3, 0.3),
-		10
-	);
-
-	HitBox* leg2HitBox = new HitBox
-	(
-		8,
-		Eigen::Vector3d(45, -100, -188),
-		Eigen::Vector3d(45, -80, -188)
+		tableMaterial
 	);
 
 	Object* leg3 = new Cube
 	(
-		Eigen::Vector3d(-50, -100, -265),
+		Vector3(-50, -100, -265),
 		10,
 		20,
 		10,
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0.3, 0.3, 0.3),
-		10
-	);
-
-	HitBox* leg3HitBox = new HitBox
-	(
-		8,
-		Eigen::Vector3d(-45, -100, -273),
-		Eigen::Vector3d(-45, -80, -273)
+		tableMaterial
 	);
 
 	Object* leg4 = new Cube
 	(
-		Eigen::Vector3d(40, -100, -265),
+		Vector3(40, -100, -265),
 		10,
 		20,
 		10,
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0.3, 0.3, 0.3),
-		10
+		tableMaterial
 	);
 
-	HitBox* leg4HitBox = new HitBox
-	(
-		8,
-		Eigen::Vector3d(45, -100, -273),
-		Eigen::Vector3d(45, -80, -273)
-	);
-
-	tableHitBox->addObject(table);
-	leg1HitBox->addObject(leg1);
-	leg2HitBox->addObject(leg2);
-	leg3HitBox->addObject(leg3);
-	leg4HitBox->addObject(leg4);
-
 	/* Roger */
 
 	Object* rogerBody = new Sphere
 	(
 		30,
-		Eigen::Vector3d(0, -70, -380),
-		Eigen::Vector3d(255, 255, 255),
-		Eigen::Vector3d(255, 255, 255),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(0, -70, -380),
+		snowMaterial
 	);
 
 	Object* rogerHead = new Sphere
 	(
 		20,
-		Eigen::Vector3d(0, -30, -380),
-		Eigen::Vector3d(255, 255, 255),
-		Eigen::Vector3d(255, 255, 255),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(0, -30, -380),
+		snowMaterial
 	);
 
 	Object* rogerLeftEye = new Sphere
 	(
 		5,
-		Eigen::Vector3d(-10, -20, -365),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(-10, -20, -365),
+		eyeMaterial
 	);
 
 	Object* rogerRightEye = new Sphere
 	(
 		5,
-		Eigen::Vector3d(10, -20, -365),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(50, 31, 20),
-		Eigen::Vector3d(0, 0, 0),
-		0
+		Vector3(10, -20, -365),
+		eyeMaterial
 	);
 
 	/* Bot�es */
@@ -463,41 +400,29 @@ int main(int argc, char* argv[])
 	Object* springButton = new Sphere
 	(
 		10,
-		Eigen::Vector3d(-40, -60, -230),
-		Eigen::Vector3d(255, 72, 132),
-		Eigen::Vector3d(255, 72, 132),
-		Eigen::Vector3d(40, 40, 40),
-		6
+		Vector3(-40, -60, -230),
+		springButtonMaterial
 	);
 
 	Object* summerButton = new Sphere
 	(
 		10,
-		Eigen::Vector3d(-13.3, -60, -230),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(12, 242, 0),
-		Eigen::Vector3d(40, 40, 40),
-		6
+		Vector3(-13.3, -60, -230),
+		summerButtonMaterial
 	);
 
 	Object* autumnButton = new Sphere
 	(
 		10,
-		Eigen::Vector3d(13.3, -60, -230),
-		Eigen::Vector3d(240, 104, 4),
-		Eigen::Vector3d(240, 104, 4),
-		Eigen::Vector3d(40, 40, 40),
-		6
+		Vector3(13.3, -60, -230),
+		autumnButtonMaterial
 	);
 
 	Object* winterButton = new Sphere
 	(
 		10,
-		Eigen::Vector3d(40, -60, -230),
-		Eigen::Vector3d(44, 157, 201),
-		Eigen::Vector3d(44, 157, 201),
-		Eigen::Vector3d(40, 40, 40),
-		6
+		Vector3(40, -60, -230),
+		winterButtonMaterial
 	);
 	
 	scene.addObject(sky);
@@ -524,11 +449,11 @@ int main(int argc, char* argv[])
 	scene.addObject(oakLog2);
 	scene.addObject(oakLog3);
 	
-	scene.addHitBox(tableHitBox);
-	scene.addHitBox(leg1HitBox);
-	scene.addHitBox(leg2HitBox);
-	scene.addHitBox(leg3HitBox);
-	scene.addHitBox(leg4HitBox);
+	scene.addObject(table);
+	scene.addObject(leg1);
+	scene.addObject(leg2);
+	scene.addObject(leg3);
+	scene.addObject(leg4);
 	/*
 	scene.addObject(rogerBody);
 	scene.addObject(rogerHead);
@@ -540,11 +465,11 @@ int main(int argc, char* argv[])
 	scene.addObject(autumnButton);
 	scene.addObject(winterButton);
 	
-	Eigen::Vector3d pontualIntensity(0.7, 0.7, 0.7);
-	Eigen::Vector3d pontualOrigin(-30, 60, 0);
+	Vector3 pontualIntensity(0.7, 0.7, 0.7);
+	Vector3 pontualOrigin(-30, 60, 0);
 	LightSource* pontual = new PontualSource(pontualOrigin, pontualIntensity);
 
-	Eigen::Vector3d ambientIntensity(0.3, 0.3, 0.3);
+	Vector3 ambientIntensity(0.3, 0.3, 0.3);
 	LightSource* ambient = new AmbientSource(ambientIntensity);
 
 	scene.addSource(pontual);
@@ -553,29 +478,53 @@ int main(int argc, char* argv[])
 	// Display
 	std::cout << "Renderiza��o iniciada.\n";
 	time_t startTime = time(NULL);
-	Tensor display = canvas.raycast(origin, scene, true);
+	RenderScene* frameScene = new RenderScene(scene);
+	Framebuffer display((int) numColumns, (int) numLines, Framebuffer::RGB_FLOAT);
+	canvas.raycast(origin, *frameScene, &display);
 	time_t renderTime = time(NULL);
 	std::cout << "Tempo para renderizar objetos: " << renderTime - startTime << std::endl;
 	display.normalize();
+	uploadFrame(frame, display);
 
 	// Loop principal
 	bool isRunning = true;
+	bool redraw = true;
 	SDL_Event event;
-	double mouseX, mouseY, mouseX2, mouseY2;
+	Scalar mouseX, mouseY, mouseX2, mouseY2;
 	int season = 1;
 
 	while (isRunning)
 	{
+		// Só apresenta quando há um quadro novo ou a janela precisa ser redesenhada
+		if (redraw)
+		{
+			SDL_RenderClear(renderer);
+			SDL_RenderCopy(renderer, frame, NULL, NULL);
+			SDL_RenderPresent(renderer);
+			redraw = false;
+		}
+
+		// Dorme até chegar algum evento
+		if (!SDL_WaitEvent(NULL))
+		{
+			SDL_Log("Erro ao esperar eventos: %s", SDL_GetError());
+			break;
+		}
+
 		while (SDL_PollEvent(&event))
 		{
 			if (event.type == SDL_QUIT)
 			{
 				isRunning = false;
 			}
+			else if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_EXPOSED)
+			{
+				redraw = true;
+			}
 			else if (event.type == SDL_MOUSEBUTTONDOWN)
 			{
-				mouseX = (double) event.motion.x;
-				mouseY = (double) event.motion.y;
+				mouseX = (Scalar) event.motion.x;
+				mouseY = (Scalar) event.motion.y;
 
 				mouseY2 = canvas.jYMax - mouseY * canvas.deltaY - canvas.deltaY / 2;
 				mouseX2 = canvas.jXMin + mouseX * canvas.deltaX + canvas.deltaX / 2;
@@ -583,10 +532,13 @@ int main(int argc, char* argv[])
 				Ray pickRay
 				(
 					origin,
-					Eigen::Vector3d(mouseX2, mouseY2, -canvas.windowDistance)
+					Vector3(mouseX2, mouseY2, -canvas.windowDistance)
 				);
 
-				if (springButton->hasInterceptedRay(pickRay) < 0)
+				// O raio está em coordenadas de câmera: a seleção é feita na cena compilada
+				const Object* picked = frameScene->pick(pickRay);
+
+				if (picked == springButton)
 				{
 					if (season != 0)
 					{
@@ -595,72 +547,51 @@ int main(int argc, char* argv[])
 						Object* grass = new Plane
 						(
 							springTexture,
-							Eigen::Vector3d(0, 1, 0),
-							Eigen::Vector3d(0, -100, 0),
-							Eigen::Vector3d(0, 0, 0),
-							Eigen::Vector3d(100, 100, 100),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(0, 1, 0),
+							Vector3(0, -100, 0),
+							grassMaterial
 						);
 
 						Object* oakLeavesBottom1 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -230),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -230),
+							springLeafMaterial
 						);
 
 						Object* oakLeavesTop1 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -230),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -230),
+							springLeafMaterial
 						);
 
 						Object* oakLeavesBottom2 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -300),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -300),
+							springLeafMaterial
 						);
 
 						Object* oakLeavesTop2 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -300),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -300),
+							springLeafMaterial
 						);
 
 						Object* oakLeavesBottom3 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -160),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -160),
+							springLeafMaterial
 						);
 
 						Object* oakLeavesTop3 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -160),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(255, 72, 132),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -160),
+							springLeafMaterial
 						);
 
 						scene.addObject(grass);
@@ -670,7 +601,6 @@ int main(int argc, char* argv[])
 						scene.addObject(oakLeavesTop1);
 						scene.addObject(oakLeavesTop2);
 						scene.addObject(oakLeavesTop3);
-						scene.convertObjectsToCamera(false);
 
 						scene.addObject(sky);
 						scene.addObject(skyLeft);
@@ -688,11 +618,11 @@ int main(int argc, char* argv[])
 						scene.addObject(oakLog2);
 						scene.addObject(oakLog3);
 
-						scene.addHitBox(tableHitBox);
-						scene.addHitBox(leg1HitBox);
-						scene.addHitBox(leg2HitBox);
-						scene.addHitBox(leg3HitBox);
-						scene.addHitBox(leg4HitBox);
+						scene.addObject(table);
+						scene.addObject(leg1);
+						scene.addObject(leg2);
+						scene.addObject(leg3);
+						scene.addObject(leg4);
 
 						scene.addObject(springButton);
 						scene.addObject(summerButton);
@@ -701,10 +631,14 @@ int main(int argc, char* argv[])
 
 						std::cout << "Primavera iniciada\n";
 						startTime = time(NULL);
-						display = canvas.raycast(origin, scene, false);
+						delete frameScene;
+						frameScene = new RenderScene(scene);
+						canvas.raycast(origin, *frameScene, &display);
 						renderTime = time(NULL);
 						std::cout << "Tempo para renderizar objetos: " << renderTime - startTime << std::endl;
 						display.normalize();
+						uploadFrame(frame, display);
+						redraw = true;
 						season = 0;
 					}
 					else
@@ -712,7 +646,7 @@ int main(int argc, char* argv[])
 						std::cout << "J� est� na primavera" << std::endl;
 					}
 				}
-				else if (summerButton->hasInterceptedRay(pickRay) < 0)
+				else if (picked == summerButton)
 				{
 					if (season != 1)
 					{
@@ -721,72 +655,51 @@ int main(int argc, char* argv[])
 						Object* grass = new Plane
 						(
 							summerTexture,
-							Eigen::Vector3d(0, 1, 0),
-							Eigen::Vector3d(0, -100, 0),
-							Eigen::Vector3d(0, 0, 0),
-							Eigen::Vector3d(100, 100, 100),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(0, 1, 0),
+							Vector3(0, -100, 0),
+							grassMaterial
 						);
 
 						Object* oakLeavesBottom1 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -230),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -230),
+							summerLeafMaterial
 						);
 
 						Object* oakLeavesTop1 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -230),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -230),
+							summerLeafMaterial
 						);
 
 						Object* oakLeavesBottom2 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -300),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -300),
+							summerLeafMaterial
 						);
 
 						Object* oakLeavesTop2 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -300),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -300),
+							summerLeafMaterial
 						);
 
 						Object* oakLeavesBottom3 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -160),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -160),
+							summerLeafMaterial
 						);
 
 						Object* oakLeavesTop3 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -160),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(12, 242, 0),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -160),
+							summerLeafMaterial
 						);
 
 						scene.addObject(grass);
@@ -796,7 +709,6 @@ int main(int argc, char* argv[])
 						scene.addObject(oakLeavesTop1);
 						scene.addObject(oakLeavesTop2);
 						scene.addObject(oakLeavesTop3);
-						scene.convertObjectsToCamera(false);
 
 						scene.addObject(sky);
 						scene.addObject(skyLeft);
@@ -814,11 +726,11 @@ int main(int argc, char* argv[])
 						scene.addObject(oakLog2);
 						scene.addObject(oakLog3);
 
-						scene.addHitBox(tableHitBox);
-						scene.addHitBox(leg1HitBox);
-						scene.addHitBox(leg2HitBox);
-						scene.addHitBox(leg3HitBox);
-						scene.addHitBox(leg4HitBox);
+						scene.addObject(table);
+						scene.addObject(leg1);
+						scene.addObject(leg2);
+						scene.addObject(leg3);
+						scene.addObject(leg4);
 
 						scene.addObject(springButton);
 						scene.addObject(summerButton);
@@ -827,10 +739,14 @@ int main(int argc, char* argv[])
 
 						std::cout << "Ver�o iniciado\n";
 						startTime = time(NULL);
-						display = canvas.raycast(origin, scene, false);
+						delete frameScene;
+						frameScene = new RenderScene(scene);
+						canvas.raycast(origin, *frameScene, &display);
 						renderTime = time(NULL);
 						std::cout << "Tempo para renderizar objetos: " << renderTime - startTime << std::endl;
 						display.normalize();
+						uploadFrame(frame, display);
+						redraw = true;
 						season = 1;
 					}
 					else
@@ -838,7 +754,7 @@ int main(int argc, char* argv[])
 						std::cout << "J� est� no ver�o" << std::endl;
 					}
 				}
-				else if (autumnButton->hasInterceptedRay(pickRay) < 0)
+				else if (picked == autumnButton)
 				{
 					if (season != 2)
 					{
@@ -847,72 +763,51 @@ int main(int argc, char* argv[])
 						Object* grass = new Plane
 						(
 							autumnTexture,
-							Eigen::Vector3d(0, 1, 0),
-							Eigen::Vector3d(0, -100, 0),
-							Eigen::Vector3d(0, 0, 0),
-							Eigen::Vector3d(100, 100, 100),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(0, 1, 0),
+							Vector3(0, -100, 0),
+							grassMaterial
 						);
 
 						Object* oakLeavesBottom1 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -230),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -230),
+							autumnLeafMaterial
 						);
 
 						Object* oakLeavesTop1 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -230),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -230),
+							autumnLeafMaterial
 						);
 
 						Object* oakLeavesBottom2 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -300),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -300),
+							autumnLeafMaterial
 						);
 
 						Object* oakLeavesTop2 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -300),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -300),
+							autumnLeafMaterial
 						);
 
 						Object* oakLeavesBottom3 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -160),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -160),
+							autumnLeafMaterial
 						);
 
 						Object* oakLeavesTop3 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -160),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(240, 104, 4),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -160),
+							autumnLeafMaterial
 						);
 
 						scene.addObject(grass);
@@ -922,7 +817,6 @@ int main(int argc, char* argv[])
 						scene.addObject(oakLeavesTop1);
 						scene.addObject(oakLeavesTop2);
 						scene.addObject(oakLeavesTop3);
-						scene.convertObjectsToCamera(false);
 
 						scene.addObject(sky);
 						scene.addObject(skyLeft);
@@ -940,11 +834,11 @@ int main(int argc, char* argv[])
 						scene.addObject(oakLog2);
 						scene.addObject(oakLog3);
 
-						scene.addHitBox(tableHitBox);
-						scene.addHitBox(leg1HitBox);
-						scene.addHitBox(leg2HitBox);
-						scene.addHitBox(leg3HitBox);
-						scene.addHitBox(leg4HitBox);
+						scene.addObject(table);
+						scene.addObject(leg1);
+						scene.addObject(leg2);
+						scene.addObject(leg3);
+						scene.addObject(leg4);
 
 						scene.addObject(springButton);
 						scene.addObject(summerButton);
@@ -953,10 +847,14 @@ int main(int argc, char* argv[])
 
 						std::cout << "Outono iniciado\n";
 						startTime = time(NULL);
-						display = canvas.raycast(origin, scene, false);
+						delete frameScene;
+						frameScene = new RenderScene(scene);
+						canvas.raycast(origin, *frameScene, &display);
 						renderTime = time(NULL);
 						std::cout << "Tempo para renderizar objetos: " << renderTime - startTime << std::endl;
 						display.normalize();
+						uploadFrame(frame, display);
+						redraw = true;
 						season = 2;
 					}
 					else
@@ -964,7 +862,7 @@ int main(int argc, char* argv[])
 						std::cout << "J� est� no outono" << std::endl;
 					}
 				}
-				else if (winterButton->hasInterceptedRay(pickRay) < 0)
+				else if (picked == winterButton)
 				{
 					if (season != 3)
 					{
@@ -973,72 +871,51 @@ int main(int argc, char* argv[])
 						Object* grass = new Plane
 						(
 							winterTexture,
-							Eigen::Vector3d(0, 1, 0),
-							Eigen::Vector3d(0, -100, 0),
-							Eigen::Vector3d(0, 0, 0),
-							Eigen::Vector3d(100, 100, 100),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(0, 1, 0),
+							Vector3(0, -100, 0),
+							grassMaterial
 						);
 
 						Object* oakLeavesBottom1 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -230),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -230),
+							winterLeafMaterial
 						);
 
 						Object* oakLeavesTop1 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -230),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -230),
+							winterLeafMaterial
 						);
 
 						Object* oakLeavesBottom2 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -300),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -300),
+							winterLeafMaterial
 						);
 
 						Object* oakLeavesTop2 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -300),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -300),
+							winterLeafMaterial
 						);
 
 						Object* oakLeavesBottom3 = new Sphere
 						(
 							30,
-							Eigen::Vector3d(130, -30, -160),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, -30, -160),
+							winterLeafMaterial
 						);
 
 						Object* oakLeavesTop3 = new Sphere
 						(
 							22,
-							Eigen::Vector3d(130, 0, -160),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(255, 255, 255),
-							Eigen::Vector3d(0, 0, 0),
-							0
+							Vector3(130, 0, -160),
+							winterLeafMaterial
 						);
 
 						scene.addObject(grass);
@@ -1054,7 +931,6 @@ int main(int argc, char* argv[])
 						scene.addObject(rogerLeftEye);
 						scene.addObject(rogerRightEye);
 
-						scene.convertObjectsToCamera(false);
 
 						scene.addObject(sky);
 						scene.addObject(skyLeft);
@@ -1072,11 +948,11 @@ int main(int argc, char* argv[])
 						scene.addObject(oakLog2);
 						scene.addObject(oakLog3);
 
-						scene.addHitBox(tableHitBox);
-						scene.addHitBox(leg1HitBox);
-						scene.addHitBox(leg2HitBox);
-						scene.addHitBox(leg3HitBox);
-						scene.addHitBox(leg4HitBox);
+						scene.addObject(table);
+						scene.addObject(leg1);
+						scene.addObject(leg2);
+						scene.addObject(leg3);
+						scene.addObject(leg4);
 
 						scene.addObject(springButton);
 						scene.addObject(summerButton);
@@ -1085,10 +961,14 @@ int main(int argc, char* argv[])
 
 						std::cout << "Inverno iniciado\n";
 						startTime = time(NULL);
-						display = canvas.raycast(origin, scene, false);
+						delete frameScene;
+						frameScene = new RenderScene(scene);
+						canvas.raycast(origin, *frameScene, &display);
 						renderTime = time(NULL);
 						std::cout << "Tempo para renderizar objetos: " << renderTime - startTime << std::endl;
 						display.normalize();
+						uploadFrame(frame, display);
+						redraw = true;
 						season = 3;
 					}
 					else
@@ -1098,21 +978,14 @@ int main(int argc, char* argv[])
 				}
 			}
 		}
-
-		SDL_RenderClear(renderer);
-
-		for (int i = 0; i < numLines; i++)
-		{
-			for (int j = 0; j < numColumns; j++)
-			{
-				SDL_SetRenderDrawColor(renderer, (int)display.red(i, j), (int)display.green(i, j), (int)display.blue(i, j), 255);
-				SDL_RenderDrawPoint(renderer, j, i);
-			}
-		}
-
-		SDL_RenderPresent(renderer);
 	}
 
+	delete frameScene;
+	delete springTexture;
+	delete summerTexture;
+	delete autumnTexture;
+	delete winterTexture;
+	SDL_DestroyTexture(frame);
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
 	SDL_Quit();